@@ -31,26 +31,24 @@ namespace TFE_GameMessages
 			parser.enableBlockComments();
 
 			size_t bufferPos = 0;
+			TokenSpanList tokens;
 			while (bufferPos < len)
 			{
 				const char* line = parser.readLine(bufferPos);
 				if (!line) { break; }
 
-				TokenList tokens;
 				parser.tokenizeLine(line, tokens);
 				if (tokens.size() < 3) { continue; }
 
 				// Skip until the first token is a number.
-				const char* idStr = tokens[0].c_str();
-				if (idStr[0] < '0' || idStr[0] > '9') { continue; }
+				if (tokens[0].str[0] < '0' || tokens[0].str[0] > '9') { continue; }
 
 				// Finally read the line.
-				char* endPtr = nullptr;
-				u32 id = strtoul(idStr, &endPtr, 10);
-				u32 internal = strtoul(tokens[1].c_str(), &endPtr, 10);
+				s32 id;
+				if (!TFE_Parser::tokenToInt(tokens[0], &id)) { continue; }
 				
 				// And then add the message.
-				s_msgMap[id] = tokens[2];
+				s_msgMap[u32(id)].assign(tokens[2].str, tokens[2].len);
 			};
 			return true;
 		}
@@ -85,6 +85,26 @@ namespace TFE_Jedi_Object3d
 		vec3_computeNormalOffset(out, v0, out);
 	}
 
+	// Returns x[paddedCount], y[paddedCount], z[paddedCount].
+	s32* object3d_buildSoA(const vec3* src, s32 count, s32 paddedCount)
+	{
+		if (!src || !paddedCount) { return nullptr; }
+		s32* soa = (s32*)model_alloc(3 * paddedCount * sizeof(s32));
+		if (!soa) { return nullptr; }
+
+		memset(soa, 0, 3 * paddedCount * sizeof(s32));
+		s32* x = soa;
+		s32* y = soa + paddedCount;
+		s32* z = soa + 2 * paddedCount;
+		for (s32 i = 0; i < count; i++, src++)
+		{
+			x[i] = src->x;
+			y[i] = src->y;
+			z[i] = src->z;
+		}
+		return soa;
+	}
+
 	void object3d_computeVertexNormals(JediModel* model)
 	{
 		const s32 vertexCount = model->vertexCount;
@@ -241,6 +261,16 @@ namespace TFE_Model_Jedi
 		}
 		model->radius = maxDist;
 
+		// Structure of arrays copies for the SIMD transform.
+		model->vertexCountSoA  = (model->vertexCount + 3) & ~3;
+		model->polygonCountSoA = (model->polygonCount + 3) & ~3;
+		model->verticesSoA = object3d_buildSoA(model->vertices, model->vertexCount, model->vertexCountSoA);
+		model->polygonNormalsSoA = object3d_buildSoA(model->polygonNormals, model->polygonCount, model->polygonCountSoA);
+		if (model->vertexNormals)
+		{
+			model->vertexNormalsSoA = object3d_buildSoA(model->vertexNormals, model->vertexCount, model->vertexCountSoA);
+		}
+
 		// TODO (maybe): Cache binary models to disk so they can be
 		// directly loaded, which will reduce load time.
 		s_models[pool][name] = model;
@@ -378,6 +408,11 @@ namespace TFE_Model_Jedi
 		model->textures = nullptr;
 		model->radius = 0;
 		model->drawId = nullptr;	// invalid ID initially.
+		model->vertexCountSoA = 0;
+		model->polygonCountSoA = 0;
+		model->verticesSoA = nullptr;
+		model->vertexNormalsSoA = nullptr;
+		model->polygonNormalsSoA = nullptr;
 
 		// Check to see if the name has an underscore.
 		// If so, set the "isBridge" field.
@@ -66,6 +66,14 @@ struct JediModel
 	TextureData** textures;
 	s32 radius;
 	void* drawId;		// TFE: Added for the GPU renderer.
+
+	// TFE: Structure of arrays copies of the vertices and normals for the SIMD transform.
+	// Each holds x[], y[], z[] arrays padded to a multiple of 4 (vertexCountSoA, polygonCountSoA) and zero filled.
+	s32  vertexCountSoA;
+	s32  polygonCountSoA;
+	s32* verticesSoA;
+	s32* vertexNormalsSoA;		// nullptr unless MFLAG_VERTEX_LIT is set.
+	s32* polygonNormalsSoA;
 };
 
 namespace TFE_Model_Jedi
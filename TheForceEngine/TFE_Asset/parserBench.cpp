@@ -0,0 +1,233 @@
+#include <cstring>
+#include <cstdio>
+#include <vector>
+
+#include "parserBench.h"
+#include <TFE_System/system.h>
+#include <TFE_System/parser.h>
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+
+namespace TFE_ParserBench
+{
+	static const char* c_defaultGob = "DARK.GOB";
+	// Text formats used by Dark Forces.
+	static const char* c_textExtensions[] = { "LEV", "INF", "O", "MSG", "TXT", "GOL", "VUE", "3DO", "LST" };
+	// Numbers that are easy to get wrong: rounding halfway cases, values that round differently when computed in double
+	// and then narrowed, more digits than fit in the mantissa, and exponents at the edges of the single precision range.
+	static const char* c_floatCorpus[] =
+	{
+		"0", "-0", "0.0", "1", "-1", "0.1", "0.5", "1.5", "-2.25", "100.0", "1024.125", "-0.000001",
+		"16777216", "16777217", "16777219", "33554431", "123456789", "4294967295", "18446744073709551616",
+		"7.038531e-26", "1.00000005960464477539062500001", "1.000000059604644775390625", "0.30000001192092896",
+		"3.4028235e38", "3.4028236e38", "1e39", "1.17549435e-38", "1.4e-45", "1e-46", "1e10", "1e11", "-1e-10", "1e-11",
+		"8.589973e9", "2.7182818284590452353602874713527", "3.14159265358979323846", "0.000000000000000000000000001",
+		"123456789012345678901234567890", "1E5", "1e+5", "5e-1", ".5", "5.", "-.75",
+	};
+
+	static bool isTextAsset(const char* fileName)
+	{
+		const char* ext = strrchr(fileName, '.');
+		if (!ext) { return false; }
+		for (size_t i = 0; i < TFE_ARRAYSIZE(c_textExtensions); i++)
+		{
+			if (strcasecmp(ext + 1, c_textExtensions[i]) == 0) { return true; }
+		}
+		return false;
+	}
+
+	static f64 getElapsedMs(u64 start)
+	{
+		return TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) * 1000.0;
+	}
+
+	static bool floatBitsEqual(f32 a, f32 b)
+	{
+		return memcmp(&a, &b, sizeof(f32)) == 0;
+	}
+
+	static void checkFloat(const char* str, f32 value, ParserBenchResult* result)
+	{
+		f32 expected;
+		if (sscanf(str, "%f", &expected) != 1) { expected = 0.0f; }
+		if (!floatBitsEqual(value, expected))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Parser Bench", "readFloat('%s') = %.9g, expected %.9g.", str, value, expected);
+			result->floatMismatchCount++;
+		}
+	}
+
+	static void checkFloatCorpus(ParserBenchResult* result)
+	{
+		for (size_t i = 0; i < TFE_ARRAYSIZE(c_floatCorpus); i++)
+		{
+			f32 value;
+			if (!TFE_Parser::readFloat(c_floatCorpus[i], &value)) { value = 0.0f; }
+			checkFloat(c_floatCorpus[i], value, result);
+		}
+	}
+
+	static void initParser(TFE_Parser& parser, const std::vector<char>& buffer)
+	{
+		parser.init(buffer.data(), buffer.size());
+		parser.addCommentString("#");
+		parser.addCommentString("//");
+		parser.enableBlockComments();
+	}
+
+	static void benchFile(const std::vector<char>& buffer, ParserBenchResult* result)
+	{
+		TFE_Parser parser;
+		TokenList tokenList;
+		TokenSpanList tokenSpans;
+
+		// Copy the lines first so that only tokenizing is measured.
+		std::vector<std::string> lines;
+		initParser(parser, buffer);
+		size_t bufferPos = 0;
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		const char* line;
+		while ((line = parser.readLine(bufferPos)) != nullptr)
+		{
+			lines.push_back(line);
+		}
+		result->readLineMs += getElapsedMs(start);
+		result->lineCount += (s32)lines.size();
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			parser.tokenizeLine(lines[i].c_str(), tokenList);
+		}
+		result->tokenListMs += getElapsedMs(start);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			parser.tokenizeLine(lines[i].c_str(), tokenSpans);
+		}
+		result->tokenSpanMs += getElapsedMs(start);
+
+		start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			parser.tokenizeLine(lines[i].c_str(), tokenSpans, true);
+		}
+		result->tokenSpanUpperMs += getElapsedMs(start);
+
+		// Verify that both tokenizers agree and gather numeric tokens.
+		std::vector<std::string> numbers;
+		for (size_t i = 0; i < lines.size(); i++)
+		{
+			parser.tokenizeLine(lines[i].c_str(), tokenList);
+			parser.tokenizeLine(lines[i].c_str(), tokenSpans);
+			result->tokenCount += (s32)tokenList.size();
+			if (tokenList.size() != tokenSpans.size())
+			{
+				result->mismatchCount++;
+				continue;
+			}
+			for (size_t t = 0; t < tokenList.size(); t++)
+			{
+				const std::string& token = tokenList[t];
+				if (token.length() != tokenSpans[t].len || strncmp(token.c_str(), tokenSpans[t].str, tokenSpans[t].len) != 0)
+				{
+					result->mismatchCount++;
+				}
+				const char c = token.c_str()[0];
+				if ((c >= '0' && c <= '9') || c == '-' || c == '.')
+				{
+					numbers.push_back(token);
+				}
+			}
+		}
+		result->numberCount += (s32)numbers.size();
+
+		std::vector<f32> values(numbers.size());
+		start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < numbers.size(); i++)
+		{
+			if (sscanf(numbers[i].c_str(), "%f", &values[i]) != 1) { values[i] = 0.0f; }
+		}
+		result->sscanfMs += getElapsedMs(start);
+
+		std::vector<f32> fastValues(numbers.size());
+		start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < numbers.size(); i++)
+		{
+			if (!TFE_Parser::readFloat(numbers[i].c_str(), &fastValues[i])) { fastValues[i] = 0.0f; }
+		}
+		result->readFloatMs += getElapsedMs(start);
+
+		for (size_t i = 0; i < numbers.size(); i++)
+		{
+			if (!floatBitsEqual(values[i], fastValues[i])) { checkFloat(numbers[i].c_str(), fastValues[i], result); }
+		}
+	}
+
+	bool run(const char* archiveName, ParserBenchResult* result)
+	{
+		*result = {};
+		if (!archiveName || !archiveName[0]) { archiveName = c_defaultGob; }
+		checkFloatCorpus(result);
+
+		char archivePath[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_SOURCE_DATA, archiveName, archivePath);
+		const ArchiveType type = Archive::getArchiveTypeFromName(archiveName);
+		Archive* archive = Archive::getArchive(type, archiveName, archivePath);
+		if (!archive)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Parser Bench", "Cannot open archive '%s'.", archivePath);
+			return false;
+		}
+
+		std::vector<char> buffer;
+		const u32 fileCount = archive->getFileCount();
+		for (u32 i = 0; i < fileCount; i++)
+		{
+			if (!isTextAsset(archive->getFileName(i)) || !archive->openFile(i)) { continue; }
+
+			buffer.resize(archive->getFileLength());
+			archive->readFile(buffer.data(), buffer.size());
+			archive->closeFile();
+
+			benchFile(buffer, result);
+			result->fileCount++;
+		}
+		return result->fileCount > 0;
+	}
+
+	void console_parserBench(const ConsoleArgList& args)
+	{
+		ParserBenchResult result;
+		if (!run(args.size() > 1 ? args[1].c_str() : nullptr, &result))
+		{
+			TFE_Console::addToHistory("Parser benchmark failed, see the log for details.");
+			return;
+		}
+
+		char res[256];
+		sprintf(res, "Files: %d, Lines: %d, Tokens: %d, Numbers: %d, Token Mismatches: %d, Float Mismatches: %d", result.fileCount, result.lineCount,
+			result.tokenCount, result.numberCount, result.mismatchCount, result.floatMismatchCount);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Parser Bench", "%s", res);
+		if (result.mismatchCount || result.floatMismatchCount)
+		{
+			TFE_Console::addToHistory("Parser check FAILED, the fast parsing does not match the reference (see the log).");
+			TFE_System::logWrite(LOG_ERROR, "Parser Bench", "Parser check failed.");
+		}
+		sprintf(res, "readLine: %0.2f ms, TokenList: %0.2f ms, TokenSpanList: %0.2f ms, TokenSpanList (upper case): %0.2f ms", result.readLineMs,
+			result.tokenListMs, result.tokenSpanMs, result.tokenSpanUpperMs);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Parser Bench", "%s", res);
+		sprintf(res, "sscanf: %0.2f ms, readFloat: %0.2f ms", result.sscanfMs, result.readFloatMs);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Parser Bench", "%s", res);
+	}
+
+	void registerCommands()
+	{
+		CCMD("parserBench", console_parserBench, 0, "Benchmark text parsing on every text asset in an archive - parserBench [archive, default DARK.GOB]");
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Parser benchmark
+// Tokenizes every text asset in an archive (DARK.GOB by default)
+// using both the allocating (TokenList) and span (TokenSpanList)
+// tokenizers, and compares sscanf() with the fast number parsing.
+// readFloat() must be bit-identical to sscanf(), this is checked on
+// a fixed corpus of hard cases and on every number in the archive.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_ParserBench
+{
+	struct ParserBenchResult
+	{
+		s32 fileCount;
+		s32 lineCount;
+		s32 tokenCount;
+		s32 numberCount;
+		s32 mismatchCount;		// tokens that differ between the two tokenizers.
+		s32 floatMismatchCount;	// numbers where readFloat() is not bit-identical to sscanf().
+		f64 readLineMs;			// time spent reading lines, shared by both tokenizers.
+		f64 tokenListMs;
+		f64 tokenSpanMs;
+		f64 tokenSpanUpperMs;
+		f64 sscanfMs;
+		f64 readFloatMs;
+	};
+
+	bool run(const char* archiveName, ParserBenchResult* result);
+	void registerCommands();
+}
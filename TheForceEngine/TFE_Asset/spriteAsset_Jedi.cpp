@@ -16,6 +16,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_set>
 
 using namespace TFE_Jedi;
 
@@ -35,6 +36,62 @@ namespace TFE_Sprite_Jedi
 	static NameList   s_spriteNames[POOL_COUNT];
 	static std::vector<u8> s_buffer;
 
+	// Level assets kept across level reloads, see setLevelRetainKey().
+	static FrameMap    s_retainedFrames;
+	static SpriteMap   s_retainedSprites;
+	static std::string s_retainKey;
+
+	JediFrame* takeRetainedFrame(const char* name, AssetPool pool)
+	{
+		if (pool != POOL_LEVEL) { return nullptr; }
+		FrameMap::iterator iFrame = s_retainedFrames.find(name);
+		if (iFrame == s_retainedFrames.end()) { return nullptr; }
+
+		JediFrame* asset = iFrame->second;
+		s_retainedFrames.erase(iFrame);
+		s_frames[pool][name] = asset;
+		s_frameList[pool].push_back(asset);
+		s_frameNames[pool].push_back(name);
+		return asset;
+	}
+
+	JediWax* takeRetainedSprite(const char* name, AssetPool pool)
+	{
+		if (pool != POOL_LEVEL) { return nullptr; }
+		SpriteMap::iterator iSprite = s_retainedSprites.find(name);
+		if (iSprite == s_retainedSprites.end()) { return nullptr; }
+
+		JediWax* asset = iSprite->second;
+		s_retainedSprites.erase(iSprite);
+		s_sprites[pool][name] = asset;
+		s_spriteList[pool].push_back(asset);
+		s_spriteNames[pool].push_back(name);
+		return asset;
+	}
+
+	void freeRetained()
+	{
+		for (FrameMap::iterator iFrame = s_retainedFrames.begin(); iFrame != s_retainedFrames.end(); ++iFrame)
+		{
+			free(iFrame->second);
+		}
+		for (SpriteMap::iterator iSprite = s_retainedSprites.begin(); iSprite != s_retainedSprites.end(); ++iSprite)
+		{
+			free(iSprite->second);
+		}
+		s_retainedFrames.clear();
+		s_retainedSprites.clear();
+	}
+
+	void setLevelRetainKey(const char* key)
+	{
+		if (!key || s_retainKey != key)
+		{
+			freeRetained();
+		}
+		s_retainKey = key ? key : "";
+	}
+
 	JediFrame* getFrame(const char* name, AssetPool pool)
 	{
 		FrameMap::iterator iFrame = s_frames[pool].find(name);
@@ -42,6 +99,11 @@ namespace TFE_Sprite_Jedi
 		{
 			return iFrame->second;
 		}
+		JediFrame* retained = takeRetainedFrame(name, pool);
+		if (retained)
+		{
+			return retained;
+		}
 
 		// It doesn't exist yet, try to load the frame.
 		FilePath filePath;
@@ -155,19 +217,12 @@ namespace TFE_Sprite_Jedi
 		return asset;
 	}
 
-	static std::vector<u32> s_cellOffsets;
+	// Cells are shared between frames, views and animations so the same cell is visited many times.
+	static std::unordered_set<u32> s_cellOffsets;
 
 	bool isUniqueCell(u32 offset)
 	{
-		const size_t count = s_cellOffsets.size();
-		const u32* offsetList = s_cellOffsets.data();
-		for (u32 i = 0; i < count; i++)
-		{
-			if (offsetList[i] == offset) { return false; }
-		}
-		s_cellOffsets.push_back(offset);
-
-		return true;
+		return s_cellOffsets.insert(offset).second;
 	}
 
 	void sprite_serializeSpritesAndFrames(Stream* stream)
@@ -239,6 +294,11 @@ namespace TFE_Sprite_Jedi
 		{
 			return iSprite->second;
 		}
+		JediWax* retained = takeRetainedSprite(name, pool);
+		if (retained)
+		{
+			return retained;
+		}
 
 		// It doesn't exist yet, try to load the frame.
 		FilePath filePath;
@@ -546,11 +606,15 @@ namespace TFE_Sprite_Jedi
 
 	void freePool(AssetPool pool)
 	{
+		// Level assets are kept for the next load of the same level instead.
+		const bool retain = pool == POOL_LEVEL && !s_retainKey.empty();
+
 		const size_t frameCount = s_frameList[pool].size();
 		JediFrame** frameList = s_frameList[pool].data();
 		for (size_t i = 0; i < frameCount; i++)
 		{
-			free(frameList[i]);
+			if (retain) { s_retainedFrames[s_frameNames[pool][i]] = frameList[i]; }
+			else { free(frameList[i]); }
 		}
 		s_frames[pool].clear();
 		s_frameList[pool].clear();
@@ -560,7 +624,8 @@ namespace TFE_Sprite_Jedi
 		JediWax** waxList = s_spriteList[pool].data();
 		for (size_t i = 0; i < waxCount; i++)
 		{
-			free(waxList[i]);
+			if (retain) { s_retainedSprites[s_spriteNames[pool][i]] = waxList[i]; }
+			else { free(waxList[i]); }
 		}
 		s_sprites[pool].clear();
 		s_spriteList[pool].clear();
@@ -94,6 +94,10 @@ namespace TFE_Sprite_Jedi
 	JediWax*   getWax(const char* name, AssetPool pool = POOL_LEVEL);
 	void freeAll();
 	void freeLevelData();
+	// TFE: While a key (the level name) is set, freed level frames and sprites are kept and handed back
+	// when the same asset is requested again, so reloading the level does not read and parse them again.
+	// Changing the key (or setting it to null) frees the kept assets.
+	void setLevelRetainKey(const char* key);
 
 	JediFrame* loadFrameFromMemory(const u8* data, size_t size);
 	JediWax* loadWaxFromMemory(const u8* data, size_t size, bool transformOffsets = true);
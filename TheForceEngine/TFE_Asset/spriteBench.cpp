@@ -0,0 +1,172 @@
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <unordered_set>
+
+#include "spriteBench.h"
+#include "spriteAsset_Jedi.h"
+#include <TFE_System/system.h>
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+
+namespace TFE_SpriteBench
+{
+	static const char* c_defaultGob = "SPRITES.GOB";
+
+	static bool hasExtension(const char* fileName, const char* extension)
+	{
+		const char* ext = strrchr(fileName, '.');
+		return ext && strcasecmp(ext + 1, extension) == 0;
+	}
+
+	static f64 getElapsedMs(u64 start)
+	{
+		return TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) * 1000.0;
+	}
+
+	// Gather the cell offset of every frame reference, in the order the WAX loader visits them.
+	static void gatherCellRefs(const u8* data, std::vector<u32>& cellRefs)
+	{
+		cellRefs.clear();
+		const Wax* wax = (Wax*)data;
+		const s32* animOffset = wax->animOffsets;
+		for (s32 animIdx = 0; animIdx < WAX_MAX_ANIM && animOffset[animIdx]; animIdx++)
+		{
+			const WaxAnim* anim = (WaxAnim*)(data + animOffset[animIdx]);
+			for (s32 v = 0; v < WAX_MAX_VIEWS; v++)
+			{
+				const WaxView* view = (WaxView*)(data + anim->viewOffsets[v]);
+				const s32* frameOffset = view->frameOffsets;
+				for (s32 f = 0; f < WAX_MAX_FRAMES && frameOffset[f]; f++)
+				{
+					const WaxFrame* frame = (WaxFrame*)(data + frameOffset[f]);
+					if (frame->cellOffset)
+					{
+						cellRefs.push_back(frame->cellOffset);
+					}
+				}
+			}
+		}
+	}
+
+	static void benchDedupe(const std::vector<u32>& cellRefs, SpriteBenchResult* result)
+	{
+		// The original linear search.
+		std::vector<u32> cells;
+		u64 start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < cellRefs.size(); i++)
+		{
+			bool unique = true;
+			for (size_t c = 0; c < cells.size(); c++)
+			{
+				if (cells[c] == cellRefs[i]) { unique = false; break; }
+			}
+			if (unique) { cells.push_back(cellRefs[i]); }
+		}
+		result->linearDedupeMs += getElapsedMs(start);
+
+		std::unordered_set<u32> cellSet;
+		start = TFE_System::getCurrentTimeInTicks();
+		for (size_t i = 0; i < cellRefs.size(); i++)
+		{
+			cellSet.insert(cellRefs[i]);
+		}
+		result->hashDedupeMs += getElapsedMs(start);
+
+		result->frameRefCount += (s32)cellRefs.size();
+		result->cellCount += (s32)cellSet.size();
+	}
+
+	bool run(const char* archiveName, SpriteBenchResult* result)
+	{
+		*result = {};
+		if (!archiveName || !archiveName[0]) { archiveName = c_defaultGob; }
+
+		char archivePath[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_SOURCE_DATA, archiveName, archivePath);
+		const ArchiveType type = Archive::getArchiveTypeFromName(archiveName);
+		Archive* archive = Archive::getArchive(type, archiveName, archivePath);
+		if (!archive)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Sprite Bench", "Cannot open archive '%s'.", archivePath);
+			return false;
+		}
+
+		std::vector<u8> buffer;
+		std::vector<u32> cellRefs;
+		const u32 fileCount = archive->getFileCount();
+		for (u32 i = 0; i < fileCount; i++)
+		{
+			const char* fileName = archive->getFileName(i);
+			const bool isWax = hasExtension(fileName, "WAX");
+			const bool isFrame = hasExtension(fileName, "FME");
+			if ((!isWax && !isFrame) || !archive->openFile(i)) { continue; }
+
+			u64 start = TFE_System::getCurrentTimeInTicks();
+			buffer.resize(archive->getFileLength());
+			archive->readFile(buffer.data(), buffer.size());
+			archive->closeFile();
+			result->readMs += getElapsedMs(start);
+			if (buffer.empty()) { continue; }
+
+			if (isWax)
+			{
+				start = TFE_System::getCurrentTimeInTicks();
+				JediWax* wax = TFE_Sprite_Jedi::loadWaxFromMemory(buffer.data(), buffer.size());
+				result->waxLoadMs += getElapsedMs(start);
+				if (!wax)
+				{
+					result->failedCount++;
+					continue;
+				}
+				free(wax);
+				result->waxCount++;
+
+				gatherCellRefs(buffer.data(), cellRefs);
+				benchDedupe(cellRefs, result);
+			}
+			else
+			{
+				start = TFE_System::getCurrentTimeInTicks();
+				JediFrame* frame = TFE_Sprite_Jedi::loadFrameFromMemory(buffer.data(), buffer.size());
+				result->frameLoadMs += getElapsedMs(start);
+				if (!frame)
+				{
+					result->failedCount++;
+					continue;
+				}
+				free(frame);
+				result->frameCount++;
+			}
+		}
+		return result->waxCount + result->frameCount > 0;
+	}
+
+	void console_spriteBench(const ConsoleArgList& args)
+	{
+		SpriteBenchResult result;
+		if (!run(args.size() > 1 ? args[1].c_str() : nullptr, &result))
+		{
+			TFE_Console::addToHistory("Sprite benchmark failed, see the log for details.");
+			return;
+		}
+
+		char res[256];
+		sprintf(res, "WAX: %d, FME: %d, Failed: %d, Frame references: %d, Unique cells: %d", result.waxCount, result.frameCount, result.failedCount,
+			result.frameRefCount, result.cellCount);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Sprite Bench", "%s", res);
+		sprintf(res, "Read: %0.2f ms, WAX load: %0.2f ms, FME load: %0.2f ms", result.readMs, result.waxLoadMs, result.frameLoadMs);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Sprite Bench", "%s", res);
+		sprintf(res, "Cell dedupe - linear: %0.3f ms, hash: %0.3f ms", result.linearDedupeMs, result.hashDedupeMs);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Sprite Bench", "%s", res);
+	}
+
+	void registerCommands()
+	{
+		CCMD("spriteBench", console_spriteBench, 0, "Benchmark loading every WAX and FME in an archive - spriteBench [archive, default SPRITES.GOB]");
+	}
+}
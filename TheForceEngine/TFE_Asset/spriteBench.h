@@ -0,0 +1,28 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Sprite benchmark
+// Loads every WAX and FME in an archive (SPRITES.GOB by default) and
+// measures the load time, and compares the cost of the cell
+// de-duplication with the original linear search.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_SpriteBench
+{
+	struct SpriteBenchResult
+	{
+		s32 waxCount;
+		s32 frameCount;
+		s32 failedCount;
+		s32 frameRefCount;	// frame references visited across all animations and views.
+		s32 cellCount;		// unique cells.
+		f64 readMs;
+		f64 waxLoadMs;
+		f64 frameLoadMs;
+		f64 linearDedupeMs;
+		f64 hashDedupeMs;
+	};
+
+	bool run(const char* archiveName, SpriteBenchResult* result);
+	void registerCommands();
+}
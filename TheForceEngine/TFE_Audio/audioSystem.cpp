@@ -8,6 +8,7 @@
 #include <TFE_Settings/settings.h>
 #include <TFE_FrontEndUI/console.h>
 #include <TFE_System/profiler.h>
+#include <TFE_System/telemetry.h>
 #include <assert.h>
 #include <algorithm>
 
@@ -85,6 +86,19 @@ namespace TFE_Audio
 	static s32 s_soundIterMax = 0;
 	static s32 s_soundIterAve = 0;
 #endif
+	// Callback times recorded in the telemetry, written by the audio thread and read by the main thread.
+	static atomic_s32 s_callbackTimeLast(0);
+	static atomic_s32 s_callbackTimeMax(0);	// since the previous telemetry frame.
+
+	static f64 getCallbackTimeLast(void*)
+	{
+		return f64(s_callbackTimeLast.load(std::memory_order_relaxed));
+	}
+
+	static f64 getCallbackTimeMax(void*)
+	{
+		return f64(s_callbackTimeMax.exchange(0, std::memory_order_relaxed));
+	}
 
 	bool init(bool useNullDevice/*=false*/, s32 outputId/*=-1*/)
 	{
@@ -98,6 +112,8 @@ namespace TFE_Audio
 		TFE_COUNTER(s_soundIterMax, "SoundIterMax-MicroSec");
 		TFE_COUNTER(s_soundIterAve, "SoundIterAve-MicroSec");
 	#endif
+		TFE_Telemetry::addSource("Audio Callback (us)", getCallbackTimeLast);
+		TFE_Telemetry::addSource("Audio Callback Max (us)", getCallbackTimeMax);
 
 		TFE_Settings_Sound* soundSettings = TFE_Settings::getSoundSettings();
 		setVolume(soundSettings->soundFxVolume);
@@ -461,8 +477,12 @@ namespace TFE_Audio
 		u32 bufferSize = (u32)bufsize;
 		u32 frames = bufferSize / (AUDIO_CHANNEL_COUNT * sizeof(f32));
 
+		// Only time the callback when it is needed, the telemetry is off by default.
+		const bool telemetry = TFE_Telemetry::isEnabled();
 	#if AUDIO_TIMING == 1
 		u64 soundIterStart = TFE_System::getCurrentTimeInTicks();
+	#else
+		u64 soundIterStart = telemetry ? TFE_System::getCurrentTimeInTicks() : 0;
 	#endif
 
 		// First clear samples
@@ -598,6 +618,13 @@ namespace TFE_Audio
 		s_soundIterAve = s32(s_soundIterAveF);
 		s_soundIterMax = s32(s_soundIterMaxF);
 	#endif
+		if (telemetry)
+		{
+			const s32 callbackTime = s32(1000000.0 * TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - soundIterStart));
+			s_callbackTimeLast.store(callbackTime, std::memory_order_relaxed);
+			s32 prevMax = s_callbackTimeMax.load(std::memory_order_relaxed);
+			while (callbackTime > prevMax && !s_callbackTimeMax.compare_exchange_weak(prevMax, callbackTime, std::memory_order_relaxed)) {}
+		}
 	}
 
 	// Console functions.
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <vector>
 
 #include "actor.h"
 #include "actorInternal.h"
@@ -25,6 +26,9 @@
 #include <TFE_Jedi/Level/rsector.h>
 #include <TFE_Jedi/Level/rwall.h>
 #include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Collision/losQuery.h>
+#include <TFE_System/jobPool.h>
+#include <TFE_FrontEndUI/console.h>
 #include <TFE_Jedi/InfSystem/message.h>
 #include <TFE_Jedi/Memory/list.h>
 #include <TFE_Jedi/Memory/allocator.h>
@@ -39,6 +43,8 @@ namespace TFE_DarkForces
 	///////////////////////////////////////////
 	ActorInternalState s_istate = { 0 };
 	List* s_physicsActors = nullptr;
+	// TFE
+	static bool s_actorParallelThink = false;
 
 	///////////////////////////////////////////
 	// Shared State
@@ -521,17 +527,13 @@ namespace TFE_DarkForces
 			}
 
 			SecObject** objList = sector->objectList;
-			for (s32 i = 0, idx = 0; i < sector->objectCount && idx < sector->objectCapacity; idx++)
+			for (s32 i = 0; i < sector->objectCount; i++)
 			{
-				SecObject* obj = objList[idx];
-				if (obj)
+				SecObject* obj = objList[i];
+				if ((obj->entityFlags & ETFLAG_CORPSE) && !(obj->entityFlags & ETFLAG_KEEP_CORPSE) && !actor_canSeeObject(obj, s_playerObject))
 				{
-					if ((obj->entityFlags & ETFLAG_CORPSE) && !(obj->entityFlags & ETFLAG_KEEP_CORPSE) && !actor_canSeeObject(obj, s_playerObject))
-					{
-						freeObject(obj);
-						return;
-					}
-					i++;
+					freeObject(obj);
+					return;
 				}
 			}
 		}
@@ -1565,7 +1567,7 @@ namespace TFE_DarkForces
 	{
 		vec3_fixed p0 = { actorObj->posWS.x, actorObj->posWS.y - actorObj->worldHeight, actorObj->posWS.z };
 		vec3_fixed p1 = { obj->posWS.x, obj->posWS.y, obj->posWS.z };
-		if (collision_canHitObject(actorObj->sector, obj->sector, p0, p1, 0))
+		if (los_canHitObject(actorObj->sector, obj->sector, p0, p1))
 		{
 			return JTRUE;
 		}
@@ -1575,10 +1577,11 @@ namespace TFE_DarkForces
 		}
 
 		vec3_fixed p2 = { obj->posWS.x, obj->posWS.y - obj->worldHeight, obj->posWS.z };
-		return collision_canHitObject(actorObj->sector, obj->sector, p0, p2, 0);
+		return los_canHitObject(actorObj->sector, obj->sector, p0, p2);
 	}
 	   
-	JBool actor_canSeeObjFromDist(SecObject* actorObj, SecObject* obj)
+	// The distance used to decide if 'obj' can be seen, adjusted for crouching, lighting and the headlamp.
+	static fixed16_16 actor_getVisibilityDist(SecObject* actorObj, SecObject* obj)
 	{
 		fixed16_16 approxDist = distApprox(actorObj->posWS.x, actorObj->posWS.z, obj->posWS.x, obj->posWS.z);
 		// Crouching makes the target harder to see.
@@ -1601,7 +1604,12 @@ namespace TFE_DarkForces
 		{
 			approxDist -= s_baseAtten * 2;
 		}
+		return approxDist;
+	}
 
+	JBool actor_canSeeObjFromDist(SecObject* actorObj, SecObject* obj)
+	{
+		const fixed16_16 approxDist = actor_getVisibilityDist(actorObj, obj);
 		if (approxDist < FIXED(256))
 		{
 			// Since random() is unsigned, the real visible range is [200, 256) because of the conditional above.
@@ -1614,12 +1622,13 @@ namespace TFE_DarkForces
 		return JFALSE;
 	}
 
-	JBool actor_isObjectVisible(SecObject* actorObj, SecObject* obj, angle14_32 fov, fixed16_16 closeDist)
+	// Returns JTRUE if 'obj' is within 'closeDist' or inside of the field of view of 'actorObj'.
+	static JBool actor_isInViewCone(SecObject* actorObj, SecObject* obj, angle14_32 fov, fixed16_16 closeDist)
 	{
 		fixed16_16 approxDist = distApprox(actorObj->posWS.x, actorObj->posWS.z, obj->posWS.x, obj->posWS.z);
 		if (approxDist <= closeDist)
 		{
-			return actor_canSeeObjFromDist(actorObj, obj);
+			return JTRUE;
 		}
 
 		fixed16_16 dx = obj->posWS.x - actorObj->posWS.x;
@@ -1629,13 +1638,143 @@ namespace TFE_DarkForces
 		angle14_32 angleDiff = getAngleDifference(obj0To1Angle, yaw0);
 		angle14_32 right = fov >> 1;
 		angle14_32 left = -(fov >> 1);
-		if (angleDiff > left && angleDiff < right)
+		return (angleDiff > left && angleDiff < right) ? JTRUE : JFALSE;
+	}
+
+	JBool actor_isObjectVisible(SecObject* actorObj, SecObject* obj, angle14_32 fov, fixed16_16 closeDist)
+	{
+		if (actor_isInViewCone(actorObj, obj, fov, closeDist))
 		{
 			return actor_canSeeObjFromDist(actorObj, obj);
 		}
 		return JFALSE;
 	}
 
+	/////////////////////////////////////////////////////
+	// TFE: Parallel perception.
+	// Before the actors are updated, the line of sight rays they are likely to test against the player this tick are
+	// evaluated on the job pool using the read-only ray march and stored in the line of sight cache. The actor update
+	// itself is unchanged and runs serially in the original order, so random(), messages, movement and spawns happen
+	// exactly as before. A ray is only reused if the actor, player and level geometry are unchanged when it is queried,
+	// otherwise it is evaluated as usual - the results are identical with or without this pass.
+	/////////////////////////////////////////////////////
+	enum
+	{
+		// Below this the rays are cheaper to evaluate on demand.
+		ACTOR_MIN_PARALLEL_JOBS = 8,
+	};
+
+	struct PerceptionJob
+	{
+		RSector* startSector;
+		RSector* endSector;
+		vec3_fixed p0;
+		vec3_fixed p1;
+		vec3_fixed p2;
+		// Results, 'evaluated' is the number of rays with valid results.
+		s32 evaluated;
+		JBool canHit[2];
+		JBool wallHit[2];
+	};
+	static std::vector<PerceptionJob> s_perceptionJobs;
+
+	static void actor_perceptionJob(s32 index, void* userData)
+	{
+		PerceptionJob* job = &((PerceptionJob*)userData)[index];
+		job->evaluated = 0;
+		// Follows actor_canSeeObject(): the second ray is only tested if the first is blocked without hitting a solid wall.
+		if (!collision_canHitObjectReadOnly(job->startSector, job->endSector, job->p0, job->p1, 0, &job->canHit[0], &job->wallHit[0]))
+		{
+			return;
+		}
+		job->evaluated = 1;
+		if (job->canHit[0] || job->wallHit[0])
+		{
+			return;
+		}
+		if (collision_canHitObjectReadOnly(job->startSector, job->endSector, job->p0, job->p2, 0, &job->canHit[1], &job->wallHit[1]))
+		{
+			job->evaluated = 2;
+		}
+	}
+
+	static JBool actor_isModuleDue(ActorDispatch* dispatch)
+	{
+		for (s32 i = 0; i < ACTOR_MAX_MODULES; i++)
+		{
+			ActorModule* module = dispatch->modules[i];
+			if (module && module->func && module->nextTick < s_curTick)
+			{
+				return JTRUE;
+			}
+		}
+		return JFALSE;
+	}
+
+	static void actor_prefetchPerception()
+	{
+		SecObject* player = s_playerObject;
+		if (!player || !player->sector || !los_canPrefetch() || !TFE_JobPool::getWorkerCount()) { return; }
+
+		s_perceptionJobs.clear();
+		ActorDispatch* dispatch = (ActorDispatch*)allocator_getHead(s_istate.actorDispatch);
+		while (dispatch)
+		{
+			SecObject* obj = dispatch->logic.obj;
+			if (!obj || !obj->sector)
+			{
+				dispatch = (ActorDispatch*)allocator_getNext(s_istate.actorDispatch);
+				continue;
+			}
+
+			const u32 flags = dispatch->flags;
+			JBool likelyToLook;
+			if ((flags & 1) && (flags & 4))
+			{
+				// Waiting to be woken up, see actorLogicTaskFunc().
+				likelyToLook = dispatch->nextTick < s_curTick && actor_isInViewCone(obj, player, dispatch->fov, dispatch->awareRange);
+			}
+			else
+			{
+				likelyToLook = actor_isModuleDue(dispatch);
+			}
+
+			if (likelyToLook && actor_getVisibilityDist(obj, player) < FIXED(256))
+			{
+				PerceptionJob job;
+				job.startSector = obj->sector;
+				job.endSector = player->sector;
+				job.p0 = { obj->posWS.x, obj->posWS.y - obj->worldHeight, obj->posWS.z };
+				job.p1 = { player->posWS.x, player->posWS.y, player->posWS.z };
+				job.p2 = { player->posWS.x, player->posWS.y - player->worldHeight, player->posWS.z };
+				s_perceptionJobs.push_back(job);
+			}
+			dispatch = (ActorDispatch*)allocator_getNext(s_istate.actorDispatch);
+		}
+		if (s_perceptionJobs.size() < ACTOR_MIN_PARALLEL_JOBS) { return; }
+
+		TFE_JobPool::parallelFor(s32(s_perceptionJobs.size()), actor_perceptionJob, s_perceptionJobs.data(), 4);
+
+		// Store the results in the original order.
+		for (size_t i = 0; i < s_perceptionJobs.size(); i++)
+		{
+			const PerceptionJob* job = &s_perceptionJobs[i];
+			if (job->evaluated >= 1)
+			{
+				los_prefetch(job->startSector, job->endSector, job->p0, job->p1, job->canHit[0], job->wallHit[0]);
+			}
+			if (job->evaluated >= 2)
+			{
+				los_prefetch(job->startSector, job->endSector, job->p0, job->p2, job->canHit[1], job->wallHit[1]);
+			}
+		}
+	}
+
+	void actor_registerCommands()
+	{
+		CVAR_BOOL(s_actorParallelThink, "g_actorParallelThink", CVFLAG_DO_NOT_SERIALIZE, "Evaluate actor line of sight on worker threads before the actor update, the results are unchanged.");
+	}
+
 	MovementModule* actor_createMovementModule(ActorDispatch* dispatch)
 	{
 		MovementModule* moveMod = (MovementModule*)level_alloc(sizeof(MovementModule));
@@ -2028,6 +2167,11 @@ namespace TFE_DarkForces
 			entity_yield(TASK_NO_DELAY);
 			if (msg == MSG_RUN_TASK)
 			{
+				if (s_actorParallelThink)
+				{
+					actor_prefetchPerception();
+				}
+
 				ActorDispatch* dispatch = (ActorDispatch*)allocator_getHead(s_istate.actorDispatch);
 				while (dispatch)
 				{
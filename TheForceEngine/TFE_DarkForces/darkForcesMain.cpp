@@ -1246,6 +1246,8 @@ namespace TFE_DarkForces
 		region_clear(s_levelRegion);
 		bitmap_clearLevelData();
 		level_freeAllAssets();
+		// Assets kept from the last time this level was loaded are reused when the level data is read.
+		level_setAssetRetainKey(agent_getLevelName());
 
 		// Next
 		sound_levelStart();
@@ -1318,6 +1320,8 @@ namespace TFE_DarkForces
 			}
 		}
 
+		// Saves can be made while the game is paused, so restore the pause state afterward.
+		const JBool timePaused = time_isPaused();
 		time_pause(JTRUE);
 		if (writeState)
 		{
@@ -1327,6 +1331,7 @@ namespace TFE_DarkForces
 		{
 			serialization_setMode(SMODE_READ);
 		}
+		serialization_setStream(stream);
 
 		serializeVersion(stream);
 		serializeLoopState(stream, this);
@@ -1346,13 +1351,14 @@ namespace TFE_DarkForces
 		inf_serialize(stream);
 		pickupLogic_serializeTasks(stream);
 		mission_serialize(stream);
+		serialization_setStream(nullptr);
 
 		if (!writeState)
 		{
 			agent_restartEndLevelTask();
 		}
 
-		time_pause(JFALSE);
+		time_pause(timePaused);
 		if (!writeState)
 		{
 			task_updateTime();
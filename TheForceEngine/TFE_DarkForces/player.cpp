@@ -20,6 +20,7 @@
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/Level/levelData.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_Jedi/Renderer/rlimits.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 // Internal types need to be included in this case.
@@ -846,6 +847,7 @@ namespace TFE_DarkForces
 			s_playerUpVel  = 0;
 
 			sector_addObject(sector, s_playerEye);
+			objGrid_updateObject(s_playerEye);
 			s_playerSector = sector;
 
 			player_setupEyeObject(s_playerEye);
@@ -1212,6 +1214,7 @@ namespace TFE_DarkForces
 				s_playerObject->posWS.y = floorHeight;
 				s_playerYPos = s_playerObject->posWS.y;
 				player_changeSector(sector);
+				objGrid_updateObject(s_playerObject);
 
 				s_nextShieldDmgTick = s_curTick + 436;
 				if (s_invincibilityTask)
@@ -2759,6 +2762,7 @@ namespace TFE_DarkForces
 			s_playerPos = s_playerObject->posWS;
 
 			sector_addObject(sector, s_playerObject);
+			objGrid_updateObject(s_playerObject);
 			s_playerSector = s_playerObject->sector;
 		}
 	}
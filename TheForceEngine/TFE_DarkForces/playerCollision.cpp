@@ -12,6 +12,7 @@
 // Internal types need to be included in this case.
 #include <TFE_Jedi/InfSystem/infTypesInternal.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_System/profiler.h>
 
 // TFE
@@ -111,7 +112,6 @@ namespace TFE_DarkForces
 		if (s_objCollisionEnabled)
 		{
 			s32 objCount = sector->objectCount;
-			s32 objCapacity = sector->objectCapacity;
 			fixed16_16 relHeight = s_colDstPosY - s_colHeightBase;
 
 			fixed16_16 dirX, dirZ;
@@ -119,113 +119,109 @@ namespace TFE_DarkForces
 			fixed16_16 pathDx = s_colDstPosX - s_colSrcPosX;
 			computeDirAndLength(pathDx, pathDz, &dirX, &dirZ);
 
-			for (s32 objIndex = 0, objListIndex = 0; objIndex < objCount && objListIndex < objCapacity; objListIndex++)
+			for (s32 objIndex = 0; objIndex < objCount; objIndex++)
 			{
-				SecObject* obj = sector->objectList[objListIndex];
-				if (obj)
+				SecObject* obj = sector->objectList[objIndex];
+				if (!(obj->entityFlags & ETFLAG_PICKUP) && obj->worldWidth && (s_colSrcPosX != obj->posWS.x || s_colSrcPosZ != obj->posWS.z))
 				{
-					objIndex++;
-					if (!(obj->entityFlags & ETFLAG_PICKUP) && obj->worldWidth && (s_colSrcPosX != obj->posWS.x || s_colSrcPosZ != obj->posWS.z))
+					// Check the seperation of the object and destination position.
+					// If they are seperated by more than their combined widths on the X or Z axis, then there is no collision.
+					fixed16_16 sepX  = TFE_Jedi::abs(obj->posWS.x - s_colDstPosX);
+					fixed16_16 sepZ  = TFE_Jedi::abs(obj->posWS.z - s_colDstPosZ);
+					fixed16_16 width = obj->worldWidth + colWidth;
+					if (sepX >= width || sepZ >= width)
 					{
-						// Check the seperation of the object and destination position.
-						// If they are seperated by more than their combined widths on the X or Z axis, then there is no collision.
-						fixed16_16 sepX  = TFE_Jedi::abs(obj->posWS.x - s_colDstPosX);
-						fixed16_16 sepZ  = TFE_Jedi::abs(obj->posWS.z - s_colDstPosZ);
-						fixed16_16 width = obj->worldWidth + colWidth;
-						if (sepX >= width || sepZ >= width)
-						{
-							continue;
-						}
+						continue;
+					}
 
-						// The top of the object is *below* the final position.
-						fixed16_16 objTop = obj->posWS.y - obj->worldHeight;
-						if (objTop >= s_colDstPosY || relHeight >= obj->posWS.y)
-						{
-							continue;
-						}
+					// The top of the object is *below* the final position.
+					fixed16_16 objTop = obj->posWS.y - obj->worldHeight;
+					if (objTop >= s_colDstPosY || relHeight >= obj->posWS.y)
+					{
+						continue;
+					}
+
+					// Check XZ seperation again... (this second test can be skipped)
+					sepX = TFE_Jedi::abs(s_colDstPosX - obj->posWS.x);
+					sepZ = TFE_Jedi::abs(s_colDstPosZ - obj->posWS.z);
+					if ((sepX >= obj->worldWidth + s_colWidth) || (sepZ >= obj->worldWidth + s_colWidth))
+					{
+						continue;
+					}
 
-						// Check XZ seperation again... (this second test can be skipped)
-						sepX = TFE_Jedi::abs(s_colDstPosX - obj->posWS.x);
-						sepZ = TFE_Jedi::abs(s_colDstPosZ - obj->posWS.z);
-						if ((sepX >= obj->worldWidth + s_colWidth) || (sepZ >= obj->worldWidth + s_colWidth))
+					// Check to see if the path starts already colliding with the object.
+					// And if it is, then skip collision (so they come apart and don't get stuck).
+					fixed16_16 startSepX = TFE_Jedi::abs(s_colSrcPosX - obj->posWS.x);
+					fixed16_16 startSepZ = TFE_Jedi::abs(s_colSrcPosZ - obj->posWS.z);
+					if (startSepX < width && startSepZ < width)
+					{
+						continue;
+					}
+											
+					fixed16_16 dx = s_colDstPosX - s_colSrcPosX;
+					fixed16_16 dz = s_colDstPosZ - s_colSrcPosZ;
+					s32 xSign = (dx < 0) ? -1 : 1;
+					s32 zSign = (dz < 0) ? -1 : 1;
+
+					// Compute the object AABB edges that need to be considered for the collision.
+					// this is the same as: objEdgeX = obj->posWS.x - obj->worldWidth * xSign;
+					fixed16_16 objEdgeX = (xSign >= 0) ? (obj->posWS.x - obj->worldWidth) : (obj->posWS.x + obj->worldWidth);
+					fixed16_16 objEdgeZ = (zSign >= 0) ? (obj->posWS.z - obj->worldWidth) : (obj->posWS.z + obj->worldWidth);
+
+					// Cross product between the vector from the destination to the nearest AABB corner to the start and
+					// the path direction.
+					// This is *zero* if the corner is exactly on the path, *negative* if the corner is between the start and destination,
+					// and *positive* if the point is *past* the destination (i.e. unreachable).
+					fixed16_16 cprod = mul16(objEdgeX - s_colDstPosX, dirZ) - mul16(objEdgeZ - s_colDstPosZ, dirX);
+					s32 cSign = cprod < 0 ? -1 : 1;
+
+					// Is the sign of the product different than the sign of either x or z.
+					s32 signDiff = (cSign^xSign) ^ zSign;
+					if (signDiff < 0)	// condition above is *true*
+					{
+						s_colResponseStep = JTRUE;
+						if (zSign >= 0)
 						{
-							continue;
+							s_colResponseAngle = 4095;	// ~90 degrees
+							s_colResponsePos.x = obj->posWS.x - obj->worldWidth;
+							s_colResponsePos.z = obj->posWS.z - obj->worldWidth;
+							s_colResponseDir.x = ONE_16;
+							s_colResponseDir.z = 0;
+							return obj;
 						}
-
-						// Check to see if the path starts already colliding with the object.
-						// And if it is, then skip collision (so they come apart and don't get stuck).
-						fixed16_16 startSepX = TFE_Jedi::abs(s_colSrcPosX - obj->posWS.x);
-						fixed16_16 startSepZ = TFE_Jedi::abs(s_colSrcPosZ - obj->posWS.z);
-						if (startSepX < width && startSepZ < width)
+						else // zSign < 0
 						{
-							continue;
+							s_colResponseAngle = 12287;		// ~270 degrees
+							s_colResponsePos.x = obj->posWS.x + obj->worldWidth;
+							s_colResponsePos.z = obj->posWS.z + obj->worldWidth;
+							s_colResponseDir.x = -ONE_16;
+							s_colResponseDir.z = 0;
+
+							return obj;
 						}
-												
-						fixed16_16 dx = s_colDstPosX - s_colSrcPosX;
-						fixed16_16 dz = s_colDstPosZ - s_colSrcPosZ;
-						s32 xSign = (dx < 0) ? -1 : 1;
-						s32 zSign = (dz < 0) ? -1 : 1;
-
-						// Compute the object AABB edges that need to be considered for the collision.
-						// this is the same as: objEdgeX = obj->posWS.x - obj->worldWidth * xSign;
-						fixed16_16 objEdgeX = (xSign >= 0) ? (obj->posWS.x - obj->worldWidth) : (obj->posWS.x + obj->worldWidth);
-						fixed16_16 objEdgeZ = (zSign >= 0) ? (obj->posWS.z - obj->worldWidth) : (obj->posWS.z + obj->worldWidth);
-
-						// Cross product between the vector from the destination to the nearest AABB corner to the start and
-						// the path direction.
-						// This is *zero* if the corner is exactly on the path, *negative* if the corner is between the start and destination,
-						// and *positive* if the point is *past* the destination (i.e. unreachable).
-						fixed16_16 cprod = mul16(objEdgeX - s_colDstPosX, dirZ) - mul16(objEdgeZ - s_colDstPosZ, dirX);
-						s32 cSign = cprod < 0 ? -1 : 1;
-
-						// Is the sign of the product different than the sign of either x or z.
-						s32 signDiff = (cSign^xSign) ^ zSign;
-						if (signDiff < 0)	// condition above is *true*
+					}
+					else
+					{
+						s_colResponseStep = JTRUE;
+						if (xSign >= 0)
 						{
-							s_colResponseStep = JTRUE;
-							if (zSign >= 0)
-							{
-								s_colResponseAngle = 4095;	// ~90 degrees
-								s_colResponsePos.x = obj->posWS.x - obj->worldWidth;
-								s_colResponsePos.z = obj->posWS.z - obj->worldWidth;
-								s_colResponseDir.x = ONE_16;
-								s_colResponseDir.z = 0;
-								return obj;
-							}
-							else // zSign < 0
-							{
-								s_colResponseAngle = 12287;		// ~270 degrees
-								s_colResponsePos.x = obj->posWS.x + obj->worldWidth;
-								s_colResponsePos.z = obj->posWS.z + obj->worldWidth;
-								s_colResponseDir.x = -ONE_16;
-								s_colResponseDir.z = 0;
+							s_colResponseAngle = 8191;	// ~180 degrees
+							s_colResponsePos.x = obj->posWS.x - obj->worldWidth;
+							s_colResponsePos.z = obj->posWS.z + obj->worldWidth;
+							s_colResponseDir.x = 0;
+							s_colResponseDir.z = -ONE_16;
 
-								return obj;
-							}
+							return obj;
 						}
 						else
 						{
-							s_colResponseStep = JTRUE;
-							if (xSign >= 0)
-							{
-								s_colResponseAngle = 8191;	// ~180 degrees
-								s_colResponsePos.x = obj->posWS.x - obj->worldWidth;
-								s_colResponsePos.z = obj->posWS.z + obj->worldWidth;
-								s_colResponseDir.x = 0;
-								s_colResponseDir.z = -ONE_16;
-
-								return obj;
-							}
-							else
-							{
-								s_colResponseAngle = 0;		// 0 degrees
-								s_colResponsePos.x = obj->posWS.x + obj->worldWidth;
-								s_colResponsePos.z = obj->posWS.z - obj->worldWidth;
-								s_colResponseDir.x = 0;
-								s_colResponseDir.z = ONE_16;
+							s_colResponseAngle = 0;		// 0 degrees
+							s_colResponsePos.x = obj->posWS.x + obj->worldWidth;
+							s_colResponsePos.z = obj->posWS.z - obj->worldWidth;
+							s_colResponseDir.x = 0;
+							s_colResponseDir.z = ONE_16;
 
-								return obj;
-							}
+							return obj;
 						}
 					}
 				}
@@ -566,6 +562,7 @@ namespace TFE_DarkForces
 				// Move the player, change sectors if needed and adjust the map layer.
 				player->posWS.x += s_curPlayerLogic->move.x;
 				player->posWS.z += s_curPlayerLogic->move.z;
+				objGrid_updateObject(player);
 
 				if (alwaysMove)
 				{
@@ -674,33 +671,29 @@ namespace TFE_DarkForces
 		fixed16_16 ceilHeight = sector->ceilingHeight;
 		if (floorHeight == ceilHeight) { return JFALSE;	}
 
-		s32 objCount = sector->objectCount;
-		s32 objCapacity = sector->objectCapacity;
-		for (s32 objIndex = 0, objListIndex = 0; objIndex < objCount && objListIndex < objCapacity; objListIndex++)
+		for (s32 objIndex = 0; objIndex < sector->objectCount; )
 		{
-			SecObject* obj = sector->objectList[objListIndex];
-			if (obj)
+			SecObject* obj = sector->objectList[objIndex];
+			if (obj->worldWidth && (obj->entityFlags & ETFLAG_PICKUP))
 			{
-				objIndex++;
-				if (obj->worldWidth && (obj->entityFlags & ETFLAG_PICKUP))
+				fixed16_16 dx = obj->posWS.x - s_colDstPosX;
+				fixed16_16 dz = obj->posWS.z - s_colDstPosZ;
+				fixed16_16 adx = TFE_Jedi::abs(dx);
+				fixed16_16 adz = TFE_Jedi::abs(dz);
+				fixed16_16 radius = obj->worldWidth + s_colWidth;
+				if (adx < radius && adz < radius)
 				{
-					fixed16_16 dx = obj->posWS.x - s_colDstPosX;
-					fixed16_16 dz = obj->posWS.z - s_colDstPosZ;
-					fixed16_16 adx = TFE_Jedi::abs(dx);
-					fixed16_16 adz = TFE_Jedi::abs(dz);
-					fixed16_16 radius = obj->worldWidth + s_colWidth;
-					if (adx < radius && adz < radius)
+					fixed16_16 objTop = obj->posWS.y - obj->worldHeight;
+					fixed16_16 colliderTop = s_colDstPosY - s_colHeightBase;
+					if (objTop < s_colDstPosY && colliderTop < obj->posWS.y)
 					{
-						fixed16_16 objTop = obj->posWS.y - obj->worldHeight;
-						fixed16_16 colliderTop = s_colDstPosY - s_colHeightBase;
-						if (objTop < s_colDstPosY && colliderTop < obj->posWS.y)
-						{
-							s_msgEntity = s_colObject.obj;
-							message_sendToObj(obj, MSG_PICKUP, nullptr);
-						}
+						s_msgEntity = s_colObject.obj;
+						message_sendToObj(obj, MSG_PICKUP, nullptr);
 					}
 				}
 			}
+			// Picking up an item removes it from the sector.
+			objIndex = sector_nextObjectIndex(sector, obj, objIndex);
 		}
 		return JTRUE;
 	}
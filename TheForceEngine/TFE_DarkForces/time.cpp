@@ -43,6 +43,11 @@ namespace TFE_DarkForces
 		s_pauseTimeUpdate = pause;
 	}
 
+	JBool time_isPaused()
+	{
+		return s_pauseTimeUpdate;
+	}
+
 	void updateTime()
 	{
 		if (!s_pauseTimeUpdate)
@@ -52,6 +52,7 @@ namespace TFE_DarkForces
 	Tick time_frameRateToDelay(f32 frameRate);
 	void updateTime();
 	void time_pause(JBool pause);
+	JBool time_isPaused();
 
 	void time_serialize(Stream* stream);
 }  // namespace TFE_DarkForces
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <TFE_Jedi/InfSystem/message.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_Jedi/Serialization/serialization.h>
 
 using namespace TFE_Jedi;
@@ -202,6 +203,7 @@ namespace TFE_DarkForces
 						{
 							renderObj->posWS.x = x1;
 							renderObj->posWS.z = z1;
+							objGrid_updateObject(renderObj);
 							if (newSector != curSector)
 							{
 								sector_addObject(newSector, renderObj);
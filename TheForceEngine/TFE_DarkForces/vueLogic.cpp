@@ -11,6 +11,7 @@
 #include <TFE_Jedi/Level/levelData.h>
 #include <TFE_Jedi/Level/rwall.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_System/math.h>
 #include <TFE_System/system.h>
 #include <TFE_FileSystem/paths.h>
@@ -576,6 +577,7 @@ namespace TFE_DarkForces
 							}
 
 							local(obj)->posWS = local(frame)->offset;
+							objGrid_updateObject(local(obj));
 							local(obj)->yaw = local(frame)->yaw;
 						task_localBlockEnd;
 
@@ -9,6 +9,7 @@
 #include <TFE_Editor/EditorAsset/editorTexture.h>
 #include <TFE_Editor/EditorAsset/editorFrame.h>
 #include <TFE_Editor/EditorAsset/editorSprite.h>
+#include <TFE_Editor/EditorAsset/editorThumbnail.h>
 #include <TFE_Asset/imageAsset.h>
 #include <TFE_DarkForces/mission.h>
 #include <TFE_Input/input.h>
@@ -108,9 +109,11 @@ namespace AssetBrowser
 	void select(s32 index);
 	void exportSelected();
 	s32 getAssetPalette(const char* name);
+	void loadAssetIfNeeded(Asset* asset);
 
 	void init()
 	{
+		thumbnail_init();
 		updateAssetList();
 	}
 
@@ -128,6 +131,7 @@ namespace AssetBrowser
 		{
 			s_projectAssetList[i].clear();
 		}
+		thumbnail_clear();
 		freeAllAssetData();
 	}
 
@@ -287,6 +291,13 @@ namespace AssetBrowser
 		ImGui::SetWindowSize("Asset Info", { f32(w), f32(h) });
 		ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse;
 
+		// Assets in the list only have thumbnails until they are selected.
+		loadAssetIfNeeded(asset);
+		if (asset && asset->handle == NULL_ASSET && thumbnail_isSupported(asset->type))
+		{
+			asset = nullptr;
+		}
+
 		bool active = true;
 		ImGui::Begin("Asset Info", &active, window_flags);
 		if (multiselect)
@@ -709,6 +720,7 @@ namespace AssetBrowser
 					ImVec2 cursor((8.0f + x * itemWidth), topPos + y * itemHeight + yOffset);
 					ImGui::SetCursorPos(cursor);
 
+					const bool itemVisible = ImGui::IsRectVisible(ImVec2(f32(itemWidth), f32(itemHeight)));
 					ImGui::PushStyleColor(ImGuiCol_Border, getBorderColor(a));
 					if (ImGui::BeginChild(buttonLabel, ImVec2(f32(itemWidth), f32(itemHeight)), true, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoScrollWithMouse))
 					{
@@ -716,9 +728,36 @@ namespace AssetBrowser
 						s32 width = s_editorConfig.thumbnailSize, height = s_editorConfig.thumbnailSize;
 
 						TextureGpu* textureGpu = nullptr;
+						bool placeholder = false;
 						f32 u0 = 0.0f, v0 = 1.0f;
 						f32 u1 = 1.0f, v1 = 0.0f;
-						if (s_viewAssetList[a].type == TYPE_TEXTURE || s_viewAssetList[a].type == TYPE_PALETTE)
+						if (s_viewAssetList[a].handle == NULL_ASSET && thumbnail_isSupported(s_viewAssetList[a].type))
+						{
+							// The full asset is not loaded, use the thumbnail (only requested while on screen).
+							const Thumbnail* thumb = nullptr;
+							if (itemVisible)
+							{
+								s32 palId = getAssetPalette(s_viewAssetList[a].name.c_str());
+								thumb = thumbnail_get(&s_viewAssetList[a], s_palettes[palId].data, palId, true);
+							}
+							textureGpu = (thumb && thumb->state == THUMB_READY) ? thumb->texGpu : nullptr;
+							placeholder = !thumb || thumb->state == THUMB_PENDING;
+							if (textureGpu)
+							{
+								// Preserve the image aspect ratio.
+								if (thumb->width >= thumb->height)
+								{
+									height = thumb->height * s_editorConfig.thumbnailSize / thumb->width;
+									offsetY = (width - height) / 2;
+								}
+								else
+								{
+									width = thumb->width * s_editorConfig.thumbnailSize / thumb->height;
+									offsetX = (height - width) / 2;
+								}
+							}
+						}
+						else if (s_viewAssetList[a].type == TYPE_TEXTURE || s_viewAssetList[a].type == TYPE_PALETTE)
 						{
 							EditorTexture* tex = (EditorTexture*)getAssetData(s_viewAssetList[a].handle);
 							textureGpu = tex ? tex->frames[0] : nullptr;
@@ -830,6 +869,12 @@ namespace AssetBrowser
 							ImGui::Image(TFE_RenderBackend::getGpuPtr(textureGpu),
 								ImVec2((f32)width, (f32)height), ImVec2(u0, v0), ImVec2(u1, v1));
 						}
+						else if (placeholder)
+						{
+							// Show a placeholder until the thumbnail is ready.
+							const ImVec2 pos = ImGui::GetCursorScreenPos();
+							ImGui::GetWindowDrawList()->AddRectFilled(pos, ImVec2(pos.x + f32(width), pos.y + f32(height)), ImGui::GetColorU32(ImGuiCol_FrameBg));
+						}
 
 						// Draw the label.
 						ImGui::SetCursorPos(ImVec2(8.0f, (f32)s_editorConfig.thumbnailSize));
@@ -909,6 +954,7 @@ namespace AssetBrowser
 		{
 			s_reloadProjectAssets = true;
 			s_assetsNeedProcess = true;
+			thumbnail_clear();
 			updateAssetList();
 		}
 
@@ -930,6 +976,9 @@ namespace AssetBrowser
 		listPanel(infoWidth, infoHeight);
 
 		popFont();
+
+		// Decode and upload the next batch of thumbnails, visible items first.
+		thumbnail_update();
 	}
 
 	void render()
@@ -981,6 +1030,7 @@ namespace AssetBrowser
 	{
 		s_reloadProjectAssets = true;
 		s_assetsNeedProcess = true;
+		thumbnail_clear();
 		updateAssetList();
 	}
 
@@ -1333,6 +1383,7 @@ namespace AssetBrowser
 
 	void reloadAsset(Asset* asset, s32 palId, s32 lightLevel)
 	{
+		loadAssetIfNeeded(asset);
 		if (asset && asset->archive)
 		{
 			AssetColorData colorData = { s_palettes[palId].data, s_palettes[palId].colormap, palId, lightLevel };
@@ -1699,6 +1750,15 @@ namespace AssetBrowser
 		return loadAssetData(asset->type, asset->archive, &colorData, asset->name.c_str());
 	}
 
+	// Load the full asset data for assets that were added to the list with only a thumbnail.
+	void loadAssetIfNeeded(Asset* asset)
+	{
+		if (asset && asset->handle == NULL_ASSET && thumbnail_isSupported(asset->type))
+		{
+			asset->handle = loadAssetData(asset);
+		}
+	}
+
 	void loadAsset(const Asset* projAsset)
 	{
 		// Filter out vanilla assets if desired.
@@ -1713,6 +1773,15 @@ namespace AssetBrowser
 		asset.assetSource = projAsset->assetSource;
 		s32 palId = getAssetPalette(projAsset->name.c_str());
 
+		// Only queue the thumbnail, the full data is loaded when the asset is selected.
+		if (thumbnail_isSupported(asset.type))
+		{
+			asset.handle = NULL_ASSET;
+			thumbnail_get(&asset, s_palettes[palId].data, palId, false);
+			s_viewAssetList.push_back(asset);
+			return;
+		}
+
 		AssetColorData colorData = { s_palettes[palId].data, nullptr, palId, 32 };
 		asset.handle = loadAssetData(projAsset->type, projAsset->archive, &colorData, projAsset->name.c_str());
 		// For now allow stubbed types to squeak through...
@@ -1792,6 +1861,7 @@ namespace AssetBrowser
 		Project* project = project_get();
 		buildProjectAssetList(s_viewInfo.game);
 
+		thumbnail_cancelPending();
 		preprocessAssets();
 		s_viewAssetList.clear();
 		if (s_viewInfo.type == TYPE_TEXTURE)
@@ -1950,6 +2020,7 @@ namespace AssetBrowser
 		for (s32 i = 0; i < count; i++)
 		{
 			Asset* asset = &s_viewAssetList[index[i]];
+			loadAssetIfNeeded(asset);
 
 			char subDir[TFE_MAX_PATH];
 			sprintf(subDir, "%s%s", path, assetSubPath[asset->type]);
@@ -0,0 +1,537 @@
+#include "editorThumbnail.h"
+#include <TFE_Editor/editorConfig.h>
+#include <TFE_Asset/spriteAsset_Jedi.h>
+#include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_System/jobPool.h>
+#include <TFE_Archive/archive.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Renderer/rcommon.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+using namespace TFE_Jedi;
+using namespace TFE_Hash;
+
+namespace TFE_Editor
+{
+	enum ThumbnailConst : u32
+	{
+		THUMB_MAX_SIZE = 256,			// Largest thumbnail size the editor can be set to.
+		THUMB_JOBS_PER_THREAD = 4,		// Requests processed per frame, per thread (including the main thread).
+		THUMB_FILE_MAGIC = 0x4d485446,	// "FTHM"
+		THUMB_FILE_VERSION = 1,
+		THUMB_BM_VERSION = 30,
+		THUMB_BM_HEADER_SIZE = 32,
+		THUMB_BM_FRAME_HEADER = 0x1c,
+		THUMB_ANIM_ID = 2,
+	};
+
+	struct ThumbnailFileHeader
+	{
+		u32 magic;
+		u32 version;
+		u32 width;
+		u32 height;
+	};
+
+	struct ThumbnailEntry
+	{
+		Thumbnail thumb;
+		AssetType type;
+		Archive* archive;
+		std::string name;
+		const u32* palette;
+		u32 visibleFrame;
+		u32 batchFrame;
+		bool queued;
+	};
+
+	struct ThumbnailJob
+	{
+		// Input, filled in on the main thread.
+		AssetType type;
+		std::vector<u8> raw;
+		u32 palette[256];
+		// Output, filled in by the job.
+		std::vector<u32> image;
+		s32 width;
+		s32 height;
+		bool fromCache;
+	};
+
+	static std::vector<ThumbnailEntry> s_entries;
+	static std::unordered_map<u64, s32> s_entryMap;
+	static std::vector<s32> s_visible;		// entries requested while on screen this frame.
+	static std::vector<s32> s_queue;		// everything else, in request order.
+	static size_t s_queueHead = 0;
+	static std::vector<s32> s_batch;
+	static std::vector<ThumbnailJob> s_jobs;
+	static u32 s_frame = 1;
+	// Hash of the palette contents, so thumbnails are keyed on the colors rather than the palette index.
+	static const u32* s_hashPalette = nullptr;
+	static u32 s_hashPaletteFrame = 0;
+	static u64 s_paletteHash = 0;
+
+	static char s_cacheDir[TFE_MAX_PATH] = "";
+	static bool s_cacheEnabled = false;
+	static u32 s_cacheCount = 0;
+	static u32 s_decodeCount = 0;
+
+	void thumbnail_job(s32 index, void* userData);
+
+	void thumbnail_init()
+	{
+		s_cacheEnabled = false;
+		if (!s_editorConfig.editorPath[0]) { return; }
+
+		sprintf(s_cacheDir, "%s/Thumbnails/", s_editorConfig.editorPath);
+		FileUtil::fixupPath(s_cacheDir);
+		if (!FileUtil::directoryExits(s_cacheDir))
+		{
+			FileUtil::makeDirectory(s_cacheDir);
+		}
+		s_cacheEnabled = FileUtil::directoryExits(s_cacheDir);
+		if (!s_cacheEnabled)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Editor", "Cannot create the thumbnail cache directory '%s', thumbnails will not be cached.", s_cacheDir);
+		}
+	}
+
+	void thumbnail_clear()
+	{
+		const size_t count = s_entries.size();
+		ThumbnailEntry* entry = s_entries.data();
+		for (size_t i = 0; i < count; i++, entry++)
+		{
+			TFE_RenderBackend::freeTexture(entry->thumb.texGpu);
+		}
+		s_entries.clear();
+		s_entryMap.clear();
+		s_visible.clear();
+		s_queue.clear();
+		s_queueHead = 0;
+		s_cacheCount = 0;
+		s_decodeCount = 0;
+	}
+
+	void thumbnail_cancelPending()
+	{
+		const size_t count = s_entries.size();
+		ThumbnailEntry* entry = s_entries.data();
+		for (size_t i = 0; i < count; i++, entry++)
+		{
+			entry->queued = false;
+			entry->palette = nullptr;
+		}
+		s_visible.clear();
+		s_queue.clear();
+		s_queueHead = 0;
+	}
+
+	bool thumbnail_isSupported(AssetType type)
+	{
+		return type == TYPE_TEXTURE || type == TYPE_FRAME || type == TYPE_SPRITE;
+	}
+
+	// The palette contents are hashed once per frame, unless the palette changes within the frame.
+	static u64 thumbnail_getPaletteHash(const u32* palette)
+	{
+		if (palette != s_hashPalette || s_frame != s_hashPaletteFrame)
+		{
+			s_hashPalette = palette;
+			s_hashPaletteFrame = s_frame;
+			s_paletteHash = palette ? fnv1a64(palette, 256 * sizeof(u32)) : 0;
+		}
+		return s_paletteHash;
+	}
+
+	const Thumbnail* thumbnail_get(const Asset* asset, const u32* palette, s32 palIndex, bool visible)
+	{
+		// Assets with the same name can come from different archives (such as mods), so the archive is part of the key.
+		u64 key = fnv1a64(asset->name.c_str());
+		key = fnv1a64Value(asset->archive, key);
+		key = fnv1a64Value(s32(asset->type), key);
+		key = fnv1a64Value(palIndex, key);
+		key = fnv1a64Value(thumbnail_getPaletteHash(palette), key);
+
+		s32 index;
+		std::unordered_map<u64, s32>::iterator iEntry = s_entryMap.find(key);
+		if (iEntry == s_entryMap.end())
+		{
+			index = s32(s_entries.size());
+			ThumbnailEntry entry = {};
+			entry.thumb.state = THUMB_PENDING;
+			entry.type = asset->type;
+			entry.archive = asset->archive;
+			entry.name = asset->name;
+			s_entries.push_back(entry);
+			s_entryMap[key] = index;
+		}
+		else
+		{
+			index = iEntry->second;
+		}
+
+		ThumbnailEntry* entry = &s_entries[index];
+		if (entry->thumb.state == THUMB_PENDING)
+		{
+			entry->palette = palette;
+			if (visible && entry->visibleFrame != s_frame)
+			{
+				entry->visibleFrame = s_frame;
+				s_visible.push_back(index);
+			}
+			else if (!visible && !entry->queued)
+			{
+				entry->queued = true;
+				s_queue.push_back(index);
+			}
+		}
+		return &entry->thumb;
+	}
+
+	static void thumbnail_addToBatch(s32 index)
+	{
+		ThumbnailEntry* entry = &s_entries[index];
+		if (entry->thumb.state != THUMB_PENDING || entry->batchFrame == s_frame || !entry->palette) { return; }
+		entry->batchFrame = s_frame;
+		s_batch.push_back(index);
+	}
+
+	static void thumbnail_readFile(const ThumbnailEntry* entry, ThumbnailJob* job)
+	{
+		job->raw.clear();
+		Archive* archive = entry->archive;
+		if (!archive || !archive->openFile(entry->name.c_str())) { return; }
+
+		const size_t len = archive->getFileLength();
+		if (len)
+		{
+			job->raw.resize(len);
+			archive->readFile(job->raw.data(), len);
+		}
+		archive->closeFile();
+	}
+
+	void thumbnail_update()
+	{
+		if (s_visible.empty() && s_queueHead >= s_queue.size())
+		{
+			s_frame++;
+			return;
+		}
+
+		// Gather the batch, whatever is on screen first.
+		const size_t batchSize = THUMB_JOBS_PER_THREAD * size_t(TFE_JobPool::getWorkerCount() + 1);
+		s_batch.clear();
+		for (size_t i = 0; i < s_visible.size() && s_batch.size() < batchSize; i++)
+		{
+			thumbnail_addToBatch(s_visible[i]);
+		}
+		for (; s_queueHead < s_queue.size() && s_batch.size() < batchSize; s_queueHead++)
+		{
+			thumbnail_addToBatch(s_queue[s_queueHead]);
+		}
+		s_visible.clear();
+
+		// Read the files on the main thread, then decode in parallel.
+		const s32 jobCount = s32(s_batch.size());
+		if (s_jobs.size() < s_batch.size())
+		{
+			s_jobs.resize(s_batch.size());
+		}
+		for (s32 i = 0; i < jobCount; i++)
+		{
+			const ThumbnailEntry* entry = &s_entries[s_batch[i]];
+			ThumbnailJob* job = &s_jobs[i];
+			job->type = entry->type;
+			memcpy(job->palette, entry->palette, sizeof(job->palette));
+			thumbnail_readFile(entry, job);
+		}
+		TFE_JobPool::parallelFor(jobCount, thumbnail_job, s_jobs.data());
+
+		// Upload.
+		for (s32 i = 0; i < jobCount; i++)
+		{
+			ThumbnailEntry* entry = &s_entries[s_batch[i]];
+			const ThumbnailJob* job = &s_jobs[i];
+			entry->queued = false;
+			entry->palette = nullptr;
+			if (job->width <= 0 || job->height <= 0)
+			{
+				entry->thumb.state = THUMB_FAILED;
+				continue;
+			}
+
+			entry->thumb.texGpu = TFE_RenderBackend::createTexture(job->width, job->height, job->image.data());
+			entry->thumb.width  = job->width;
+			entry->thumb.height = job->height;
+			entry->thumb.state  = entry->thumb.texGpu ? THUMB_READY : THUMB_FAILED;
+			if (job->fromCache) { s_cacheCount++; }
+			else { s_decodeCount++; }
+		}
+
+		if (!s_queue.empty() && s_queueHead >= s_queue.size())
+		{
+			s_queue.clear();
+			s_queueHead = 0;
+			TFE_System::logWrite(LOG_MSG, "Editor", "Thumbnails: %u loaded from the cache, %u decoded.", s_cacheCount, s_decodeCount);
+		}
+		s_frame++;
+	}
+
+	//////////////////////////////////////////
+	// Jobs - these run on the job pool and
+	// only touch their own ThumbnailJob.
+	//////////////////////////////////////////
+	// Palette indexed, column major image (see loadBmFrame()).
+	static void thumbnail_writeColumns(ThumbnailJob* job, s32 width, s32 height, const u8* image, bool transparent)
+	{
+		job->image.resize(width * height);
+		u32* outImage = job->image.data();
+		for (s32 x = 0; x < width; x++, image += height)
+		{
+			for (s32 y = 0; y < height; y++)
+			{
+				const u8 index = image[y];
+				outImage[y*width + x] = (transparent && !index) ? 0 : job->palette[index];
+			}
+		}
+		job->width  = width;
+		job->height = height;
+	}
+
+	static bool thumbnail_decodeTexture(ThumbnailJob* job)
+	{
+		const u8* data = job->raw.data();
+		const size_t size = job->raw.size();
+		// bitmap_loadFromMemory() logs bad headers, which is not safe from a worker, so check the header first.
+		if (size < THUMB_BM_HEADER_SIZE || strncmp((const char*)data, "BM ", 3) || data[3] != THUMB_BM_VERSION) { return false; }
+
+		TextureData* texData = bitmap_loadFromMemory(data, size, 1);
+		if (!texData) { return false; }
+
+		if (texData->uvWidth == BM_ANIMATED_TEXTURE)
+		{
+			// Use the first frame, see loadEditorTexture().
+			const u8* base = texData->image + 2;
+			const u8* end = texData->image + texData->dataSize;
+			if (texData->image[1] == THUMB_ANIM_ID && texData->uvHeight > 0 && base + sizeof(u32) <= end)
+			{
+				const u8* frame = base + *((const u32*)base);
+				if (frame + THUMB_BM_FRAME_HEADER <= end)
+				{
+					const TextureData* frameData = (const TextureData*)frame;
+					if (frame + THUMB_BM_FRAME_HEADER + frameData->width * frameData->height <= end)
+					{
+						thumbnail_writeColumns(job, frameData->width, frameData->height, frame + THUMB_BM_FRAME_HEADER, false);
+					}
+				}
+			}
+		}
+		else
+		{
+			thumbnail_writeColumns(job, texData->width, texData->height, texData->image, false);
+		}
+
+		free(texData->image);
+		free(texData->columns);
+		free(texData);
+		return job->width > 0;
+	}
+
+	// Decode a WAX/FME cell directly from the file data, column offsets are relative to the cell (see writeCellToImage()).
+	static bool thumbnail_decodeCell(ThumbnailJob* job, s32 cellOffset)
+	{
+		const u8* data = job->raw.data();
+		const size_t size = job->raw.size();
+		if (cellOffset <= 0 || size_t(cellOffset) + sizeof(WaxCell) > size) { return false; }
+
+		const WaxCell* cell = (const WaxCell*)(data + cellOffset);
+		const s32 width  = cell->sizeX;
+		const s32 height = cell->sizeY;
+		if (width <= 0 || height <= 0 || height > WAX_DECOMPRESS_SIZE || width > 4096) { return false; }
+
+		const u8* cellData = (const u8*)cell + sizeof(WaxCell);
+		const size_t cellSize = size - cellOffset;
+		std::vector<u8> columns(width * height);
+		if (cell->compressed)
+		{
+			if (sizeof(WaxCell) + width * sizeof(u32) > cellSize) { return false; }
+			const u32* columnOffset = (const u32*)cellData;
+			for (s32 x = 0; x < width; x++)
+			{
+				if (columnOffset[x] >= cellSize) { return false; }
+				sprite_decompressColumn((const u8*)cell + columnOffset[x], &columns[x * height], height);
+			}
+		}
+		else
+		{
+			if (sizeof(WaxCell) + size_t(width * height) > cellSize) { return false; }
+			memcpy(columns.data(), cellData, width * height);
+		}
+
+		thumbnail_writeColumns(job, width, height, columns.data(), true);
+		return true;
+	}
+
+	static bool thumbnail_decodeFrame(ThumbnailJob* job)
+	{
+		if (job->raw.size() < sizeof(WaxFrame)) { return false; }
+		const WaxFrame* frame = (const WaxFrame*)job->raw.data();
+		return thumbnail_decodeCell(job, frame->cellOffset);
+	}
+
+	static bool thumbnail_offsetValid(const ThumbnailJob* job, s32 offset, size_t structSize)
+	{
+		return offset > 0 && size_t(offset) + structSize <= job->raw.size();
+	}
+
+	// The first cell of the first view of the first animation, which is the first cell packed by loadEditorSprite().
+	static bool thumbnail_decodeSprite(ThumbnailJob* job)
+	{
+		if (job->raw.size() < sizeof(Wax)) { return false; }
+		const u8* data = job->raw.data();
+		const Wax* wax = (const Wax*)data;
+		for (s32 a = 0; a < WAX_MAX_ANIM; a++)
+		{
+			if (!thumbnail_offsetValid(job, wax->animOffsets[a], sizeof(WaxAnim))) { continue; }
+			const WaxAnim* anim = (const WaxAnim*)(data + wax->animOffsets[a]);
+			for (s32 v = 0; v < WAX_MAX_VIEWS; v++)
+			{
+				if (!thumbnail_offsetValid(job, anim->viewOffsets[v], sizeof(WaxView))) { continue; }
+				const WaxView* view = (const WaxView*)(data + anim->viewOffsets[v]);
+				if (!thumbnail_offsetValid(job, view->frameOffsets[0], sizeof(WaxFrame))) { continue; }
+				const WaxFrame* frame = (const WaxFrame*)(data + view->frameOffsets[0]);
+				return thumbnail_decodeCell(job, frame->cellOffset);
+			}
+		}
+		return false;
+	}
+
+	// Nearest neighbor, these are pixel art.
+	static void thumbnail_downscale(ThumbnailJob* job)
+	{
+		const s32 maxDim = std::max(job->width, job->height);
+		if (maxDim <= s32(THUMB_MAX_SIZE)) { return; }
+
+		const s32 width  = std::max(1, job->width  * s32(THUMB_MAX_SIZE) / maxDim);
+		const s32 height = std::max(1, job->height * s32(THUMB_MAX_SIZE) / maxDim);
+		std::vector<u32> image(width * height);
+		for (s32 y = 0; y < height; y++)
+		{
+			const u32* srcRow = &job->image[(y * job->height / height) * job->width];
+			for (s32 x = 0; x < width; x++)
+			{
+				image[y*width + x] = srcRow[x * job->width / width];
+			}
+		}
+		job->image.swap(image);
+		job->width  = width;
+		job->height = height;
+	}
+
+	static bool thumbnail_readCache(const char* path, ThumbnailJob* job)
+	{
+		FileStream file;
+		if (!file.open(path, FileStream::MODE_READ)) { return false; }
+
+		ThumbnailFileHeader header;
+		bool result = false;
+		if (file.readBuffer(&header, sizeof(ThumbnailFileHeader)) && header.magic == THUMB_FILE_MAGIC && header.version == THUMB_FILE_VERSION &&
+			header.width > 0 && header.width <= THUMB_MAX_SIZE && header.height > 0 && header.height <= THUMB_MAX_SIZE &&
+			file.getSize() == sizeof(ThumbnailFileHeader) + header.width * header.height * sizeof(u32))
+		{
+			job->image.resize(header.width * header.height);
+			if (file.readBuffer(job->image.data(), u32(job->image.size() * sizeof(u32))))
+			{
+				job->width  = s32(header.width);
+				job->height = s32(header.height);
+				result = true;
+			}
+		}
+		file.close();
+		return result;
+	}
+
+	static void thumbnail_writeCache(const char* path, const ThumbnailJob* job, s32 index)
+	{
+		// Write to a temporary file first, two assets with the same contents may be written at the same time.
+		char tmpPath[TFE_MAX_PATH];
+		sprintf(tmpPath, "%s.%d.tmp", path, index);
+
+		FileStream file;
+		if (!file.open(tmpPath, FileStream::MODE_WRITE)) { return; }
+		const ThumbnailFileHeader header = { THUMB_FILE_MAGIC, THUMB_FILE_VERSION, u32(job->width), u32(job->height) };
+		file.writeBuffer(&header, sizeof(ThumbnailFileHeader));
+		file.writeBuffer(job->image.data(), u32(job->image.size() * sizeof(u32)));
+		file.close();
+
+		if (rename(tmpPath, path) != 0)
+		{
+			FileUtil::deleteFile(tmpPath);
+		}
+	}
+
+	void thumbnail_job(s32 index, void* userData)
+	{
+		ThumbnailJob* job = &((ThumbnailJob*)userData)[index];
+		job->width = 0;
+		job->height = 0;
+		job->fromCache = false;
+		if (job->raw.empty()) { return; }
+
+		// Key on the contents rather than the name, so edited mod assets get new thumbnails.
+		char path[TFE_MAX_PATH] = "";
+		if (s_cacheEnabled)
+		{
+			u64 key = fnv1a64(job->raw.data(), job->raw.size());
+			key = fnv1a64(job->palette, sizeof(job->palette), key);
+			key = fnv1a64Value(s32(job->type), key);
+			sprintf(path, "%s%016llx.thm", s_cacheDir, (unsigned long long)key);
+			if (thumbnail_readCache(path, job))
+			{
+				job->fromCache = true;
+				return;
+			}
+		}
+
+		bool decoded = false;
+		switch (job->type)
+		{
+			case TYPE_TEXTURE:
+			{
+				decoded = thumbnail_decodeTexture(job);
+			} break;
+			case TYPE_FRAME:
+			{
+				decoded = thumbnail_decodeFrame(job);
+			} break;
+			case TYPE_SPRITE:
+			{
+				decoded = thumbnail_decodeSprite(job);
+			} break;
+			default:
+				break;
+		}
+		if (!decoded)
+		{
+			job->width = 0;
+			job->height = 0;
+			return;
+		}
+
+		thumbnail_downscale(job);
+		if (s_cacheEnabled)
+		{
+			thumbnail_writeCache(path, job, index);
+		}
+	}
+}
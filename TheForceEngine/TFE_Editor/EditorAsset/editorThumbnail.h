@@ -0,0 +1,51 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Editor
+// Asset browser thumbnails.
+//
+// Instead of loading every texture, frame and sprite when the asset
+// list is rebuilt, the browser requests a small RGBA thumbnail per
+// asset. Requests for items that are on screen are handled first,
+// everything else is prefetched in list order. Each frame a small
+// batch of requests is processed: the raw file is read on the main
+// thread (archives are not thread safe), decoding is split over the
+// job pool, and the results are uploaded to the GPU.
+//
+// Decoded thumbnails are stored in <editor path>/Thumbnails, keyed on
+// a hash of the file contents and the palette, so reopening a project
+// only has to read and hash the files.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_RenderBackend/renderBackend.h>
+#include "editorAsset.h"
+
+namespace TFE_Editor
+{
+	enum ThumbnailState
+	{
+		THUMB_PENDING = 0,
+		THUMB_READY,
+		THUMB_FAILED,
+	};
+
+	struct Thumbnail
+	{
+		ThumbnailState state;
+		TextureGpu* texGpu;
+		s32 width;
+		s32 height;
+	};
+
+	void thumbnail_init();
+	// Free all thumbnails, call when the palettes or resources change.
+	void thumbnail_clear();
+	// Drop the queued requests, ready thumbnails are kept. Call when the asset list is rebuilt.
+	void thumbnail_cancelPending();
+
+	bool thumbnail_isSupported(AssetType type);
+	// Returns the thumbnail for the asset, queueing it if needed (the state is THUMB_PENDING until it is ready).
+	// Visible requests are processed before anything else, the palette must remain valid until the request is processed or cancelled.
+	const Thumbnail* thumbnail_get(const Asset* asset, const u32* palette, s32 palIndex, bool visible);
+	// Process the next batch of requests, call once per frame.
+	void thumbnail_update();
+}
@@ -0,0 +1,202 @@
+#include <cstring>
+#include "fileIndex.h"
+#include "fileutil.h"
+#include "paths.h"
+#include <TFE_System/system.h>
+#include <TFE_Archive/archive.h>
+#include <SDL_atomic.h>
+#include <unordered_map>
+#include <vector>
+
+namespace TFE_FileIndex
+{
+	typedef std::unordered_map<std::string, FileLocation> FileMap;
+	typedef std::unordered_map<Archive*, std::vector<std::string>> ArchiveNameMap;
+
+	static FileMap s_files;
+	static ArchiveNameMap s_archiveNames;		// the index names each archive provides, so an archive can be removed without a full scan.
+	static std::vector<std::string> s_directories;
+	static bool s_valid = false;
+
+	// Files can be written from worker threads, so changes are queued and applied on the next lookup.
+	static SDL_SpinLock s_changeLock = 0;
+	static std::vector<std::string> s_changedPaths;
+	static SDL_atomic_t s_changePending = {};
+
+	static void toLower(const char* name, char* nameLC)
+	{
+		size_t i = 0;
+		for (; name[i] && i < TFE_MAX_PATH - 1; i++)
+		{
+			nameLC[i] = tolower(name[i]);
+		}
+		nameLC[i] = 0;
+	}
+
+	// Add the location unless a higher precedence source already has the name.
+	static void addLocation(const char* name, Archive* archive, u32 index, const char* path)
+	{
+		char nameLC[TFE_MAX_PATH];
+		toLower(name, nameLC);
+
+		FileMap::iterator iFile = s_files.find(nameLC);
+		if (iFile != s_files.end()) { return; }
+
+		FileLocation& location = s_files[nameLC];
+		location.archive = archive;
+		location.index = index;
+		if (path) { location.path = path; }
+		if (archive) { s_archiveNames[archive].push_back(nameLC); }
+	}
+
+	// Compares directories ignoring case and the type of slash.
+	static bool directoryEquals(const char* a, const char* b, size_t len)
+	{
+		for (size_t i = 0; i < len; i++)
+		{
+			const char ca = (a[i] == '\\') ? '/' : tolower(a[i]);
+			const char cb = (b[i] == '\\') ? '/' : tolower(b[i]);
+			if (ca != cb) { return false; }
+		}
+		return true;
+	}
+
+	void invalidate()
+	{
+		s_files.clear();
+		s_archiveNames.clear();
+		s_directories.clear();
+		s_valid = false;
+	}
+
+	static bool isInIndexedDirectory(const char* path)
+	{
+		const char* slash = strrchr(path, '/');
+		const char* backSlash = strrchr(path, '\\');
+		if (!slash || (backSlash && backSlash > slash)) { slash = backSlash; }
+		if (!slash) { return false; }
+
+		// Directories are stored with a trailing slash, so compare including the slash.
+		const size_t len = size_t(slash - path) + 1;
+		const size_t dirCount = s_directories.size();
+		const std::string* dir = s_directories.data();
+		for (size_t i = 0; i < dirCount; i++, dir++)
+		{
+			if (dir->length() == len && directoryEquals(dir->c_str(), path, len))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void applyFileChanges()
+	{
+		if (!SDL_AtomicGet(&s_changePending)) { return; }
+
+		std::vector<std::string> changedPaths;
+		SDL_AtomicLock(&s_changeLock);
+		changedPaths.swap(s_changedPaths);
+		SDL_AtomicSet(&s_changePending, 0);
+		SDL_AtomicUnlock(&s_changeLock);
+
+		const size_t count = changedPaths.size();
+		for (size_t i = 0; i < count && s_valid; i++)
+		{
+			if (isInIndexedDirectory(changedPaths[i].c_str()))
+			{
+				invalidate();
+			}
+		}
+	}
+
+	bool isValid()
+	{
+		applyFileChanges();
+		return s_valid;
+	}
+
+	void beginBuild()
+	{
+		invalidate();
+	}
+
+	void addFile(const char* name, const char* path)
+	{
+		addLocation(name, nullptr, INVALID_FILE, path);
+	}
+
+	void addDirectory(const char* dir)
+	{
+		s_directories.push_back(dir);
+
+		FileList fileList;
+		FileUtil::readFiles(dir, fileList);
+
+		char fullPath[TFE_MAX_PATH];
+		const size_t count = fileList.size();
+		const std::string* fileName = fileList.data();
+		for (size_t i = 0; i < count; i++, fileName++)
+		{
+			snprintf(fullPath, TFE_MAX_PATH, "%s%s", dir, fileName->c_str());
+			addLocation(fileName->c_str(), nullptr, INVALID_FILE, fullPath);
+		}
+	}
+
+	void addArchive(Archive* archive)
+	{
+		if (!archive) { return; }
+
+		const u32 count = archive->getFileCount();
+		for (u32 i = 0; i < count; i++)
+		{
+			const char* name = archive->getFileName(i);
+			if (name && name[0])
+			{
+				addLocation(name, archive, i, nullptr);
+			}
+		}
+	}
+
+	void endBuild()
+	{
+		s_valid = true;
+	}
+
+	void removeArchive(Archive* archive)
+	{
+		ArchiveNameMap::iterator iArchive = s_archiveNames.find(archive);
+		if (iArchive == s_archiveNames.end()) { return; }
+
+		const size_t count = iArchive->second.size();
+		const std::string* name = iArchive->second.data();
+		for (size_t i = 0; i < count; i++, name++)
+		{
+			s_files.erase(*name);
+		}
+		s_archiveNames.erase(iArchive);
+	}
+
+	void fileChanged(const char* path)
+	{
+		if (!path) { return; }
+		SDL_AtomicLock(&s_changeLock);
+		s_changedPaths.push_back(path);
+		SDL_AtomicSet(&s_changePending, 1);
+		SDL_AtomicUnlock(&s_changeLock);
+	}
+
+	const FileLocation* find(const char* name)
+	{
+		char nameLC[TFE_MAX_PATH];
+		toLower(name, nameLC);
+
+		FileMap::const_iterator iFile = s_files.find(nameLC);
+		return iFile != s_files.end() ? &iFile->second : nullptr;
+	}
+
+	size_t getEntryCount()
+	{
+		return s_files.size();
+	}
+}
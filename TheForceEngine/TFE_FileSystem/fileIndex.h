@@ -0,0 +1,47 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// File Index
+// A case-insensitive name -> location index over the file mappings,
+// loose search directories and archives used by TFE_Paths.
+// Sources are added in precedence order and the first location added
+// for a name wins, matching the order TFE_Paths searches in.
+// Files created or deleted through FileStream/FileUtil invalidate the
+// index if they are in one of the indexed directories.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <string>
+
+class Archive;
+
+namespace TFE_FileIndex
+{
+	struct FileLocation
+	{
+		Archive* archive;	// nullptr for loose files.
+		u32 index;			// file index into the archive.
+		std::string path;	// full path for loose files.
+	};
+
+	// Clear the index, it needs to be rebuilt before use.
+	void invalidate();
+	bool isValid();
+
+	// Rebuild the index, add the sources in precedence order between begin and end.
+	void beginBuild();
+	void addFile(const char* name, const char* path);
+	void addDirectory(const char* dir);
+	void addArchive(Archive* archive);
+	void endBuild();
+
+	// Remove all of the entries from an archive.
+	// This is only valid for the lowest precedence archive, otherwise the index should be rebuilt.
+	void removeArchive(Archive* archive);
+
+	// Call when a loose file is created or deleted, the index is invalidated if the file is in an indexed directory.
+	// This may be called from any thread, the change is applied by the next isValid() call on the main thread.
+	void fileChanged(const char* path);
+
+	// Returns nullptr if the file is not found.
+	const FileLocation* find(const char* name);
+	size_t getEntryCount();
+}
@@ -1,4 +1,5 @@
 #include "filestream.h"
+#include "fileIndex.h"
 #include "fileutil.h"
 #include "paths.h"
 #include <TFE_Archive/archive.h>
@@ -71,6 +72,11 @@ bool FileStream::open(const char *filename, AccessMode mode)
 		free(fn2);
 	}
 	m_mode = mode;
+	if (m_file && mode == MODE_WRITE)
+	{
+		// The file may be new, such as a save game.
+		TFE_FileIndex::fileChanged(fn);
+	}
 
 	return m_file != nullptr;
 }
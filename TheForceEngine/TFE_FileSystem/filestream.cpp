@@ -1,4 +1,5 @@
 #include "filestream.h"
+#include "fileIndex.h"
 #include <TFE_Archive/archive.h>
 #include <cassert>
 #include <cstring>
@@ -35,6 +36,11 @@ bool FileStream::open(const char* filename, AccessMode mode)
 	const char* modeStrings[] = { "rb", "wb", "rb+" };
 	m_file = fopen(filename, modeStrings[mode]);
 	m_mode = mode;
+	if (m_file && mode == MODE_WRITE)
+	{
+		// The file may be new, such as a save game.
+		TFE_FileIndex::fileChanged(filename);
+	}
 
 	return m_file != nullptr;
 }
@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <TFE_System/system.h>
 #include "fileutil.h"
+#include "fileIndex.h"
 #include "filestream.h"
 
 // implement TFE FileUtil for Linux and compatibles.
@@ -58,6 +59,31 @@ namespace FileUtil
 		closedir(d);
 	}
 
+	void readFiles(const char *dir, FileList& fileList)
+	{
+		char buf[PATH_MAX];
+		struct dirent *de;
+		struct stat st;
+		DIR *d;
+
+		d = opendir(dir);
+		if (!d) {
+			TFE_System::logWrite(LOG_ERROR, "readFiles", "opendir(%s) failed with %d\n", dir, errno);
+			return;
+		}
+
+		while (NULL != (de = readdir(d))) {
+			// skip dotfiles and dotdirs.
+			if (de->d_name[0] == '.')
+				continue;
+			snprintf(buf, PATH_MAX, "%s%s", dir, de->d_name);
+			if (stat(buf, &st) || !S_ISREG(st.st_mode))
+				continue;
+			fileList.push_back(string(de->d_name));
+		}
+		closedir(d);
+	}
+
 	void readSubdirectories(const char *dir, FileList& dirList)
 	{
 		char *dn, fp[PATH_MAX];
@@ -215,6 +241,7 @@ namespace FileUtil
 		} while (rd > 0);
 		close(d);
 		close(s);
+		TFE_FileIndex::fileChanged(dst);
 	}
 
 	void deleteFile(const char *fn)
@@ -223,6 +250,7 @@ namespace FileUtil
 		if (ret) {
 			TFE_System::logWrite(LOG_WARNING, "deleteFile", "unlink(%s) failed with %d\n", fn, errno);
 		}
+		TFE_FileIndex::fileChanged(fn);
 	}
 
 	bool directoryExits(const char *path, char *outPath)
@@ -1,6 +1,7 @@
 #pragma once
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileIndex.h"
 
 #include <assert.h>
 #include <stdio.h>
@@ -30,6 +31,26 @@ namespace FileUtil
 		}
 	}
 
+	void readFiles(const char* dir, FileList& fileList)
+	{
+		char searchStr[TFE_MAX_PATH];
+		_finddata_t fileInfo;
+
+		sprintf(searchStr, "%s*", dir);
+		intptr_t hFile = _findfirst(searchStr, &fileInfo);
+		if (hFile != -1)
+		{
+			do
+			{
+				if (!(fileInfo.attrib & _A_SUBDIR))
+				{
+					fileList.push_back(string(fileInfo.name));
+				}
+			} while (_findnext(hFile, &fileInfo) == 0);
+			_findclose(hFile);
+		}
+	}
+
 	void readSubdirectories(const char* dir, FileList& dirList)
 	{
 		#ifdef _WIN32
@@ -214,11 +235,13 @@ namespace FileUtil
 	void copyFile(const char* srcFile, const char* dstFile)
 	{
 		CopyFile(srcFile, dstFile, FALSE);
+		TFE_FileIndex::fileChanged(dstFile);
 	}
 
 	void deleteFile(const char* srcFile)
 	{
 		DeleteFile(srcFile);
+		TFE_FileIndex::fileChanged(srcFile);
 	}
 
 	bool directoryExits(const char* path, char* outPath)
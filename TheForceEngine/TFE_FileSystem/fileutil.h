@@ -9,6 +9,8 @@ typedef vector<string> FileList;
 namespace FileUtil
 {
 	void readDirectory(const char* dir, const char* ext, FileList& fileList);
+	// Read the names of all regular files in a directory, regardless of extension.
+	void readFiles(const char* dir, FileList& fileList);
 	bool makeDirectory(const char* dir);
 	void getCurrentDirectory(char* dir);
 	void getExecutionDirectory(char* dir);
@@ -1,8 +1,11 @@
 #include "filewriterAsync.h"
+#include "fileIndex.h"
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
 #include <assert.h>
 #include <stdio.h>
-#include <stdarg.h>
-#include <vector>
+#include <cstring>
+#include <deque>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN 1
@@ -11,89 +14,265 @@
 
 namespace FileWriterAsync
 {
-#ifdef _WIN32
 	#define MAX_REQUEST_COUNT 32
 
 	struct WriteRequest
 	{
+		char path[TFE_MAX_PATH];
 		std::vector<u8> buffer;
-		OVERLAPPED file;
 
-		FileWriteCompletionCallback callback;
+		FileWriteProcessCallback processCallback;
+		FileWriteCompletionCallback completionCallback;
 		void* userData;
+
+		size_t bytesWritten;
+		u32 errorCode;
+	};
+
+	static const char* c_errorStrings[] =
+	{
+		"Success",							// AFW_SUCCESS
+		"Too many pending writes",			// AFW_ERROR_QUEUE_FULL
+		"Cannot process the data",			// AFW_ERROR_PROCESS
+		"Cannot create the file",			// AFW_ERROR_OPEN
+		"Cannot write the data",			// AFW_ERROR_WRITE
+		"Cannot replace the existing file",	// AFW_ERROR_RENAME
 	};
-	WriteRequest s_requests[MAX_REQUEST_COUNT];
-	s32 s_freeRequests[MAX_REQUEST_COUNT];
-	s32 s_processRequest[MAX_REQUEST_COUNT];
 
-	std::atomic<s32> s_requestCount = 0;
-	std::atomic<s32> s_freeRequestCount = 0;
-	std::atomic<s32> s_processRequestCount = 0;
+	static SDL_Thread* s_thread = nullptr;
+	static SDL_mutex* s_mutex = nullptr;
+	static SDL_cond* s_workCond = nullptr;
+	static SDL_cond* s_doneCond = nullptr;
+	static bool s_runThread = false;
+
+	// Protected by s_mutex.
+	static std::deque<WriteRequest*> s_pending;
+	static std::vector<WriteRequest*> s_completed;
+	static s32 s_inFlight = 0;	// Requests queued but not yet completed.
 
-	void CALLBACK fileWrittenCallback(DWORD dwErrorCode, DWORD dwBytesTransferred, LPOVERLAPPED lpOverlapped)
+	int writerThreadFunc(void* userData);
+	void processRequest(WriteRequest* request);
+
+	bool init()
 	{
-		// Note that this won't be called unless the calling thread is waiting in an "alertable" state.
-		const size_t id = (size_t)lpOverlapped->hEvent;
-		WriteRequest& request = s_requests[id];
+		s_mutex = SDL_CreateMutex();
+		s_workCond = SDL_CreateCond();
+		s_doneCond = SDL_CreateCond();
+		if (!s_mutex || !s_workCond || !s_doneCond)
+		{
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create synchronization objects, files will be written synchronously.");
+			return false;
+		}
 
-		if (dwErrorCode == 0 && request.callback)	// Success
+		s_runThread = true;
+		s_thread = SDL_CreateThread(writerThreadFunc, "TFE_FileWriterThread", nullptr);
+		if (!s_thread)
 		{
-			request.callback(size_t(dwBytesTransferred), request.userData, u32(dwErrorCode));
+			s_runThread = false;
+			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create the writer thread, files will be written synchronously.");
+			return false;
 		}
-		else if (request.callback)  // Failure
+		return true;
+	}
+
+	void destroy()
+	{
+		if (s_thread)
 		{
-			request.callback(0, request.userData, u32(dwErrorCode));
+			// The thread finishes the pending requests before exiting.
+			SDL_LockMutex(s_mutex);
+			s_runThread = false;
+			SDL_CondSignal(s_workCond);
+			SDL_UnlockMutex(s_mutex);
+
+			SDL_WaitThread(s_thread, nullptr);
+			s_thread = nullptr;
 		}
+		update();
 
-		request.buffer.clear();
-		s_freeRequests[s_freeRequestCount++] = id;
+		if (s_doneCond) { SDL_DestroyCond(s_doneCond); }
+		if (s_workCond) { SDL_DestroyCond(s_workCond); }
+		if (s_mutex) { SDL_DestroyMutex(s_mutex); }
+		s_doneCond = nullptr;
+		s_workCond = nullptr;
+		s_mutex = nullptr;
 	}
 
-	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback, void* userData)
+	bool writeFileToDisk(const char* path, const u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback,
+		void* userData, FileWriteProcessCallback processCallback)
 	{
-		size_t index = 0;
-		if (s_freeRequestCount)
+		if (!path || strlen(path) >= TFE_MAX_PATH) { return false; }
+		if (s_thread)
 		{
-			index = s_freeRequests[s_freeRequestCount - 1];
-			s_freeRequestCount--;
+			SDL_LockMutex(s_mutex);
+			const bool queueFull = s_inFlight >= MAX_REQUEST_COUNT;
+			SDL_UnlockMutex(s_mutex);
+			if (queueFull)
+			{
+				TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write '%s': %s.", path, getErrorString(AFW_ERROR_QUEUE_FULL));
+				return false;
+			}
 		}
-		else if (s_requestCount < MAX_REQUEST_COUNT)
+
+		WriteRequest* request = new WriteRequest();
+		strcpy(request->path, path);
+		request->buffer.resize(dataSize);
+		if (dataSize)
 		{
-			index = s_requestCount;
-			s_requestCount++;
+			memcpy(request->buffer.data(), data, dataSize);
 		}
-		else
+		request->processCallback = processCallback;
+		request->completionCallback = completionCallback;
+		request->userData = userData;
+		request->bytesWritten = 0;
+		request->errorCode = AFW_SUCCESS;
+
+		if (!s_thread)
 		{
-			return false;
+			// Fallback, write the file right away but still report the result from update().
+			processRequest(request);
+			s_completed.push_back(request);
+			return true;
 		}
 
-		WriteRequest* request = &s_requests[index];
-		request->buffer.resize(dataSize);
-		memcpy(request->buffer.data(), data, dataSize);
+		SDL_LockMutex(s_mutex);
+		s_pending.push_back(request);
+		s_inFlight++;
+		SDL_CondSignal(s_workCond);
+		SDL_UnlockMutex(s_mutex);
+		return true;
+	}
 
-		request->callback = completionCallback;
-		request->userData = userData;
+	void update()
+	{
+		std::vector<WriteRequest*> completed;
+		if (s_mutex) { SDL_LockMutex(s_mutex); }
+		completed.swap(s_completed);
+		if (s_mutex) { SDL_UnlockMutex(s_mutex); }
 
-		HANDLE hFile = CreateFile(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_OVERLAPPED, NULL);
-		if (hFile == INVALID_HANDLE_VALUE)
+		for (size_t i = 0; i < completed.size(); i++)
 		{
-			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot create file handle for: %s", path);
-			return false;
+			WriteRequest* request = completed[i];
+			if (request->errorCode != AFW_SUCCESS)
+			{
+				TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write '%s': %s.", request->path, getErrorString(request->errorCode));
+			}
+			else
+			{
+				TFE_FileIndex::fileChanged(request->path);
+			}
+			if (request->completionCallback)
+			{
+				request->completionCallback(request->bytesWritten, request->userData, request->errorCode);
+			}
+			delete request;
+		}
+	}
+
+	void flush()
+	{
+		if (s_thread)
+		{
+			SDL_LockMutex(s_mutex);
+			while (s_inFlight > 0)
+			{
+				SDL_CondWait(s_doneCond, s_mutex);
+			}
+			SDL_UnlockMutex(s_mutex);
 		}
+		update();
+	}
+
+	bool isWritePending()
+	{
+		if (!s_thread) { return false; }
+
+		SDL_LockMutex(s_mutex);
+		const bool pending = s_inFlight > 0;
+		SDL_UnlockMutex(s_mutex);
+		return pending;
+	}
+
+	const char* getErrorString(u32 errorCode)
+	{
+		if (errorCode >= AFW_ERROR_COUNT) { return "Unknown error"; }
+		return c_errorStrings[errorCode];
+	}
 
-		memset(&request->file, 0, sizeof(OVERLAPPED));
-		request->file.Offset = 0;
-		request->file.OffsetHigh = 0;
-		request->file.hEvent = HANDLE(index);
+	////////////////////////////////////////////
+	// Internal
+	////////////////////////////////////////////
+	bool replaceFile(const char* srcPath, const char* dstPath)
+	{
+	#ifdef _WIN32
+		return MoveFileExA(srcPath, dstPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+	#else
+		return rename(srcPath, dstPath) == 0;
+	#endif
+	}
 
-		if (!WriteFileEx(hFile, request->buffer.data(), DWORD(dataSize), &request->file, fileWrittenCallback))
+	// Runs on the worker thread, so no logging here - errors are reported from update().
+	void processRequest(WriteRequest* request)
+	{
+		if (request->processCallback && !request->processCallback(request->buffer, request->userData))
 		{
-			TFE_System::logWrite(LOG_ERROR, "AsyncFileWrite", "Cannot write file: %s", path);
-			return false;
+			request->errorCode = AFW_ERROR_PROCESS;
+			return;
 		}
 
-		CloseHandle(hFile);
-		return true;
+		char tmpPath[TFE_MAX_PATH + 8];
+		sprintf(tmpPath, "%s.tmp", request->path);
+		FILE* file = fopen(tmpPath, "wb");
+		if (!file)
+		{
+			request->errorCode = AFW_ERROR_OPEN;
+			return;
+		}
+
+		const size_t size = request->buffer.size();
+		const size_t written = size ? fwrite(request->buffer.data(), 1, size, file) : 0;
+		const bool closed = fclose(file) == 0;
+		if (written != size || !closed)
+		{
+			remove(tmpPath);
+			request->errorCode = AFW_ERROR_WRITE;
+			return;
+		}
+
+		if (!replaceFile(tmpPath, request->path))
+		{
+			remove(tmpPath);
+			request->errorCode = AFW_ERROR_RENAME;
+			return;
+		}
+		request->bytesWritten = written;
+	}
+
+	int writerThreadFunc(void* userData)
+	{
+		SDL_LockMutex(s_mutex);
+		while (true)
+		{
+			while (s_pending.empty() && s_runThread)
+			{
+				SDL_CondWait(s_workCond, s_mutex);
+			}
+			// Only exit once all of the pending requests have been written.
+			if (s_pending.empty()) { break; }
+
+			WriteRequest* request = s_pending.front();
+			s_pending.pop_front();
+			SDL_UnlockMutex(s_mutex);
+
+			// The buffer is owned by the request, so the work is done without holding the lock.
+			processRequest(request);
+
+			SDL_LockMutex(s_mutex);
+			s_completed.push_back(request);
+			s_inFlight--;
+			SDL_CondBroadcast(s_doneCond);
+		}
+		SDL_UnlockMutex(s_mutex);
+		return 0;
 	}
-#endif
 };
@@ -1,15 +1,49 @@
 #pragma once
+//////////////////////////////////////////////////////////////////////
+// Asynchronous file writer.
+// Files are written by a worker thread: the data is copied when the
+// request is queued, optionally processed (e.g. compressed) on the
+// worker thread, written to a temporary file and then moved over the
+// destination so a failed write never leaves a partial file behind.
+//
+// Completion callbacks are called on the main thread from update()
+// or flush().
+//////////////////////////////////////////////////////////////////////
 #include <TFE_System/system.h>
+#include <TFE_FileSystem/paths.h>
+#include <vector>
 
-// TODO: Flesh out error codes.
 enum AsyncFileWriteCodes
 {
 	AFW_SUCCESS = 0,
+	AFW_ERROR_QUEUE_FULL,	// Too many pending requests.
+	AFW_ERROR_PROCESS,		// The process callback failed.
+	AFW_ERROR_OPEN,			// Cannot create the temporary file.
+	AFW_ERROR_WRITE,		// Cannot write all of the data.
+	AFW_ERROR_RENAME,		// Cannot replace the destination file.
+	AFW_ERROR_COUNT
 };
 
 typedef void(*FileWriteCompletionCallback)(size_t bytesWritten, void* userData, u32 errorCode);
+// Called on the worker thread before writing, may modify the buffer in place. Return false on failure.
+typedef bool(*FileWriteProcessCallback)(std::vector<u8>& buffer, void* userData);
 
 namespace FileWriterAsync
 {
-	bool writeFileToDisk(const char* path, u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback = nullptr, void* userData = nullptr);
+	bool init();
+	// Finishes all pending writes before shutting down the worker thread.
+	void destroy();
+
+	// Queue a write, the data is copied so it can be freed or re-used right away.
+	// Returns false if the request cannot be queued, in which case the completion callback is not called.
+	bool writeFileToDisk(const char* path, const u8* data, size_t dataSize, FileWriteCompletionCallback completionCallback = nullptr,
+		void* userData = nullptr, FileWriteProcessCallback processCallback = nullptr);
+
+	// Call once per frame to dispatch the completion callbacks of finished writes.
+	void update();
+	// Wait for all pending writes to finish and dispatch their completion callbacks.
+	void flush();
+	bool isWritePending();
+
+	const char* getErrorString(u32 errorCode);
 };
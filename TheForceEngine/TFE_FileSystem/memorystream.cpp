@@ -208,8 +208,10 @@ void MemoryStream::resizeBuffer(size_t newSize)
 
 	if (newSize > m_capacity)
 	{
+		// Grow geometrically so large streams written in small pieces are not reallocated every page.
 		const size_t newPageCount = (newSize + MS_PAGE_SIZE - 1) >> MS_PAGE_SHIFT;
-		const size_t newCapacity = newPageCount << MS_PAGE_SHIFT;
+		size_t newCapacity = newPageCount << MS_PAGE_SHIFT;
+		if (newCapacity < m_capacity * 2) { newCapacity = m_capacity * 2; }
 		m_memory = (u8*)realloc(m_memory, newCapacity);
 		m_capacity = newCapacity;
 	}
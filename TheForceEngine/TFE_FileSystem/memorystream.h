@@ -1,6 +1,7 @@
 #pragma once
 #include <TFE_FileSystem/stream.h>
 #include <cassert>
+#include <cstring>
 
 class MemoryStream : public Stream
 {
@@ -35,6 +36,8 @@ public:
 	size_t getLoc() override;
 	size_t getSize() override;
 	bool   isOpen()  const;
+	// Bytes allocated for the stream, which may be larger than the size.
+	size_t getCapacity() const { return m_capacity; }
 
 	void read(s8*  ptr, u32 count=1) override { readType(ptr, count); }
 	void read(u8*  ptr, u32 count=1) override { readType(ptr, count); }
@@ -64,6 +67,32 @@ public:
 
 	void writeString(const char* fmt, ...) override;
 
+	MemoryStream* getMemoryStream() override { return this; }
+
+	// Non-virtual versions of readBuffer() and writeBuffer() for callers that already know the stream type.
+	inline u32 readBytes(void* ptr, size_t size)
+	{
+		assert(m_memory && (m_mode == MODE_READ || m_mode == MODE_READWRITE));
+		if (m_addr + size > m_size)
+		{
+			size = m_addr < m_size ? (m_size - m_addr) : (0u);
+		}
+		memcpy(ptr, m_memory + m_addr, size);
+		m_addr += size;
+		return (u32)size;
+	}
+
+	inline void writeBytes(const void* ptr, size_t size)
+	{
+		assert(m_memory && (m_mode == MODE_WRITE || m_mode == MODE_READWRITE));
+		if (m_addr + size > m_size)
+		{
+			resizeBuffer(m_addr + size);
+		}
+		memcpy(m_memory + m_addr, ptr, size);
+		m_addr += size;
+	}
+
 private:
 	template <typename T>
 	void readType(T* ptr, u32 count)
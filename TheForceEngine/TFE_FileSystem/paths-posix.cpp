@@ -3,6 +3,7 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileIndex.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <algorithm>
@@ -196,6 +197,7 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_back(workpath);
+		TFE_FileIndex::invalidate();
 	}
 
 	void addSearchPathToHead(const char *fullPath)
@@ -214,12 +216,14 @@ namespace TFE_Paths
 			}
 		}
 		s_searchPaths.push_front(workpath);
+		TFE_FileIndex::invalidate();
 	}
 
 	void clearSearchPaths(void)
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		TFE_FileIndex::invalidate();
 	}
 
 	void clearLocalArchives(void)
@@ -227,6 +231,7 @@ namespace TFE_Paths
 		std::for_each(s_localArchives.begin(), s_localArchives.end(),
 				[](Archive *a) { Archive::freeArchive(a); });
 		s_localArchives.clear();
+		TFE_FileIndex::invalidate();
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -242,6 +247,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		TFE_FileIndex::invalidate();
 	}
 
 	void addLocalSearchPath(const char *locpath)
@@ -271,24 +277,47 @@ namespace TFE_Paths
 		addSearchPath(p);
 	}
 
+	// Archives added to the front change the precedence of everything after them, so the index is rebuilt.
 	void addLocalArchiveToFront(Archive *a)
 	{
 		s_localArchives.push_front(a);
+		TFE_FileIndex::invalidate();
 	}
 
 	void removeFirstArchive(void)
 	{
 		s_localArchives.pop_front();
+		TFE_FileIndex::invalidate();
 	}
 
+	// The last archive has the lowest precedence, so the index can be updated in place.
 	void addLocalArchive(Archive *a)
 	{
 		s_localArchives.push_back(a);
+		if (TFE_FileIndex::isValid())
+			TFE_FileIndex::addArchive(a);
 	}
 
 	void removeLastArchive(void)
 	{
+		Archive *a = s_localArchives.back();
 		s_localArchives.pop_back();
+		if (std::find(s_localArchives.begin(), s_localArchives.end(), a) != s_localArchives.end())
+			TFE_FileIndex::invalidate();
+		else if (TFE_FileIndex::isValid())
+			TFE_FileIndex::removeArchive(a);
+	}
+
+	static void buildFileIndex(void)
+	{
+		TFE_FileIndex::beginBuild();
+		for (auto it = s_fileMappings.begin(); it != s_fileMappings.end(); it++)
+			TFE_FileIndex::addFile(it->fileName.c_str(), it->realPath.c_str());
+		for (auto it = s_searchPaths.begin(); it != s_searchPaths.end(); it++)
+			TFE_FileIndex::addDirectory(it->c_str());
+		for (auto it = s_localArchives.begin(); it != s_localArchives.end(); it++)
+			TFE_FileIndex::addArchive(*it);
+		TFE_FileIndex::endBuild();
 	}
 
 	bool getFilePath(const char *fileName, FilePath *outPath)
@@ -299,6 +328,22 @@ namespace TFE_Paths
 		outPath->index = INVALID_FILE;
 		outPath->path[0] = 0;
 
+		// Plain file names are looked up in the index, which only holds the top level of each search path.
+		if (!strchr(fileName, '/') && !strchr(fileName, '\\')) {
+			if (!TFE_FileIndex::isValid())
+				buildFileIndex();
+
+			const TFE_FileIndex::FileLocation *loc = TFE_FileIndex::find(fileName);
+			if (!loc)
+				return false;
+
+			outPath->archive = loc->archive;
+			outPath->index = loc->index;
+			if (!loc->archive)
+				strncpy(outPath->path, loc->path.c_str(), TFE_MAX_PATH);
+			return true;
+		}
+
 		// Search for any filemappings.
 		// This is usually only used with mods and usually limited to 0-3 files.
 		for (auto it = s_fileMappings.begin(); it != s_fileMappings.end(); it++) {
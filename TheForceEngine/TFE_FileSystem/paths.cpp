@@ -2,9 +2,11 @@
 #include "paths.h"
 #include "fileutil.h"
 #include "filestream.h"
+#include "fileIndex.h"
 #include <TFE_System/system.h>
 #include <TFE_Archive/archive.h>
 #include <string>
+#include <algorithm>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN 1
@@ -170,6 +172,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.push_back(fullPath);
+			TFE_FileIndex::invalidate();
 		}
 	}
 
@@ -189,6 +192,7 @@ namespace TFE_Paths
 			}
 
 			s_searchPaths.insert(s_searchPaths.begin(), fullPath);
+			TFE_FileIndex::invalidate();
 		}
 	}
 
@@ -196,6 +200,7 @@ namespace TFE_Paths
 	{
 		s_searchPaths.clear();
 		s_fileMappings.clear();
+		TFE_FileIndex::invalidate();
 	}
 
 	void clearLocalArchives()
@@ -207,6 +212,7 @@ namespace TFE_Paths
 			Archive::freeArchive(archive[i]);
 		}
 		s_localArchives.clear();
+		TFE_FileIndex::invalidate();
 	}
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -222,6 +228,7 @@ namespace TFE_Paths
 
 		FileMapping mapping = { fileNameLC, filePathFixed };
 		s_fileMappings.push_back(mapping);
+		TFE_FileIndex::invalidate();
 	}
 
 	void addLocalSearchPath(const char* localSearchPath)
@@ -251,24 +258,67 @@ namespace TFE_Paths
 		addSearchPath(fullPath);
 	}
 		
+	// Archives added to the front change the precedence of everything after them, so the index is rebuilt.
 	void addLocalArchiveToFront(Archive* archive)
 	{
 		s_localArchives.insert(s_localArchives.begin(), archive);
+		TFE_FileIndex::invalidate();
 	}
 
 	void removeFirstArchive()
 	{
 		s_localArchives.erase(s_localArchives.begin());
+		TFE_FileIndex::invalidate();
 	}
 
+	// The last archive has the lowest precedence, so the index can be updated in place.
 	void addLocalArchive(Archive* archive)
 	{
 		s_localArchives.push_back(archive);
+		if (TFE_FileIndex::isValid())
+		{
+			TFE_FileIndex::addArchive(archive);
+		}
 	}
 
 	void removeLastArchive()
 	{
+		Archive* archive = s_localArchives.back();
 		s_localArchives.pop_back();
+		if (std::find(s_localArchives.begin(), s_localArchives.end(), archive) != s_localArchives.end())
+		{
+			TFE_FileIndex::invalidate();
+		}
+		else if (TFE_FileIndex::isValid())
+		{
+			TFE_FileIndex::removeArchive(archive);
+		}
+	}
+
+	static void buildFileIndex()
+	{
+		TFE_FileIndex::beginBuild();
+		const size_t mappingCount = s_fileMappings.size();
+		const FileMapping* mapping = s_fileMappings.data();
+		for (size_t i = 0; i < mappingCount; i++, mapping++)
+		{
+			TFE_FileIndex::addFile(mapping->fileName.c_str(), mapping->realPath.c_str());
+		}
+
+		const size_t pathCount = s_searchPaths.size();
+		const std::string* localPath = s_searchPaths.data();
+		for (size_t i = 0; i < pathCount; i++, localPath++)
+		{
+			TFE_FileIndex::addDirectory(localPath->c_str());
+		}
+
+		const size_t archiveCount = s_localArchives.size();
+		Archive** archive = s_localArchives.data();
+		for (size_t i = 0; i < archiveCount; i++, archive++)
+		{
+			TFE_FileIndex::addArchive(*archive);
+		}
+		TFE_FileIndex::endBuild();
 	}
 
 	bool getFilePath(const char* fileName, FilePath* outPath)
@@ -277,6 +327,26 @@ namespace TFE_Paths
 		outPath->index = INVALID_FILE;
 		outPath->path[0] = 0;
 
+		// Plain file names are looked up in the index, which only holds the top level of each search path.
+		if (!strchr(fileName, '/') && !strchr(fileName, '\\'))
+		{
+			if (!TFE_FileIndex::isValid())
+			{
+				buildFileIndex();
+			}
+
+			const TFE_FileIndex::FileLocation* location = TFE_FileIndex::find(fileName);
+			if (!location) { return false; }
+
+			outPath->archive = location->archive;
+			outPath->index = location->index;
+			if (!location->archive)
+			{
+				strncpy(outPath->path, location->path.c_str(), TFE_MAX_PATH);
+			}
+			return true;
+		}
+
 		// Search for any filemappings.
 		// This is usually only used with mods and usually limited to 0-3 files.
 		const size_t mappingCount  = s_fileMappings.size();
@@ -52,6 +52,7 @@ namespace TFE_Paths
 	void removeLastArchive();
 	void addLocalArchiveToFront(Archive* archive);
 	void removeFirstArchive();
+	// Plain file names are resolved through an index of all search paths and archives, which is rebuilt when they change.
 	bool getFilePath(const char* fileName, FilePath* path);
 
 	// Add a single file that can be referenced by 'fileName' even though the real name may be different.
@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 
+class MemoryStream;
+
 class Stream
 {
 public:
@@ -57,4 +59,7 @@ public:
 	virtual void writeBuffer(const void* ptr, u32 size, u32 count=1)=0;
 
 	virtual void writeString(const char* fmt, ...)=0;
+
+	// Returns the stream if it is a MemoryStream, so code reading or writing many small values can bypass the virtual calls.
+	virtual MemoryStream* getMemoryStream() { return nullptr; }
 };
\ No newline at end of file
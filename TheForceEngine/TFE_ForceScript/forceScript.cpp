@@ -1,13 +1,20 @@
 #include "forceScript.h"
 #include <TFE_System/system.h>
 #include <TFE_FrontEndUI/frontEndUi.h>
+#include <TFE_FileSystem/filestream.h>
 #include <stdint.h>
+#include <stdarg.h>
 #include <cstring>
 #include <algorithm>
+#include <deque>
+#include <string>
 #include <assert.h>
 
 #ifdef ENABLE_FORCE_SCRIPT
 #include "script_system.h"
+#include "scriptCache.h"
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
 
 #define FS_TEST_MEMORY_LOAD 1
 // TFE_ForceScript wraps Anglescript, so these includes should only exist here.
@@ -25,11 +32,62 @@ namespace TFE_ForceScript
 		f32 delay;
 	};
 
+	struct ScriptMessage
+	{
+		LogWriteType type;
+		std::string tag;
+		std::string text;
+	};
+
+	struct ModuleRequest
+	{
+		std::string moduleName;
+		std::string sectionName;	// the file path if 'fromFile' is true.
+		std::string srcCode;
+		bool fromFile;
+		ModuleCallback callback;
+		void* userData;
+		ModuleHandle module;
+		std::vector<ScriptMessage> messages;	// logged on the main thread when the request is handed back.
+	};
+
 	static asIScriptEngine* s_engine = nullptr;
 	static std::vector<ScriptThread> s_scriptThreads;
 	static std::vector<s32> s_freeThreads;
 
+	// Background module builds.
+	static SDL_Thread* s_buildThread = nullptr;
+	static SDL_mutex* s_buildMutex = nullptr;		// protects the request queues.
+	static SDL_cond* s_buildCond = nullptr;
+	static SDL_mutex* s_compileMutex = nullptr;	// AngelScript only builds one module at a time.
+	static bool s_runBuildThread = false;
+	static std::deque<ModuleRequest*> s_buildQueue;
+	static std::vector<ModuleRequest*> s_buildComplete;
+	// Messages of the module being built on the build thread, logWrite() is only called from the main thread.
+	static std::vector<ScriptMessage>* s_buildMessages = nullptr;	// Protected by s_compileMutex.
+	static u64 s_apiHash = 0;
+
 	void test();
+	bool startBuildThread();
+	void stopBuildThread();
+
+	void script_logWrite(LogWriteType type, const char* tag, const char* format, ...)
+	{
+		char text[4096];
+		va_list arg;
+		va_start(arg, format);
+		vsnprintf(text, sizeof(text), format, arg);
+		va_end(arg);
+
+		if (s_buildMessages)
+		{
+			s_buildMessages->push_back({ type, tag, text });
+		}
+		else
+		{
+			TFE_System::logWrite(type, tag, "%s", text);
+		}
+	}
 
 	// Script message callback.
 	void messageCallback(const asSMessageInfo* msg, void* param)
@@ -37,7 +95,7 @@ namespace TFE_ForceScript
 		LogWriteType type = LOG_ERROR;
 		if (msg->type == asMSGTYPE_WARNING) { type = LOG_WARNING; }
 		else if (msg->type == asMSGTYPE_INFORMATION) { type = LOG_MSG; }
-		TFE_System::logWrite(type, "Script", "%s (%d, %d) : %s", msg->section, msg->row, msg->col, msg->message);
+		script_logWrite(type, "Script", "%s (%d, %d) : %s", msg->section, msg->row, msg->col, msg->message);
 	}
 		
 	void yield(f32 delay)
@@ -59,7 +117,8 @@ namespace TFE_ForceScript
 
 	void init()
 	{
-		// Create the script engine.
+		// Create the script engine, modules may be built on the build thread.
+		asPrepareMultithread();
 		s_engine = asCreateScriptEngine();
 
 		// Set the message callback to receive information on errors in human readable form.
@@ -76,6 +135,9 @@ namespace TFE_ForceScript
 
 		// Register editor functions.
 
+		// Cached bytecode is only valid for the API it was compiled against.
+		s_apiHash = scriptCache_computeApiHash(s_engine);
+
 		// Temp.
 		test();
 	}
@@ -83,16 +145,39 @@ namespace TFE_ForceScript
 	void destroy()
 	{
 		// Clean up
+		stopBuildThread();
 		stopAllFunc();
 		if (s_engine)
 		{
 			s_engine->ShutDownAndRelease();
 			s_engine = nullptr;
 		}
+		asUnprepareMultithread();
 	}
 
 	void update()
 	{
+		// Hand finished background builds to their callbacks.
+		if (s_buildMutex)
+		{
+			SDL_LockMutex(s_buildMutex);
+			std::vector<ModuleRequest*> complete;
+			complete.swap(s_buildComplete);
+			SDL_UnlockMutex(s_buildMutex);
+
+			for (size_t i = 0; i < complete.size(); i++)
+			{
+				ModuleRequest* request = complete[i];
+				for (size_t m = 0; m < request->messages.size(); m++)
+				{
+					const ScriptMessage& msg = request->messages[m];
+					TFE_System::logWrite(msg.type, msg.tag.c_str(), "%s", msg.text.c_str());
+				}
+				if (request->callback) { request->callback(request->module, request->userData); }
+				delete request;
+			}
+		}
+
 		const f32 dt = (f32)TFE_System::getDeltaTime();
 		const s32 count = (s32)s_scriptThreads.size();
 		ScriptThread* thread = s_scriptThreads.data();
@@ -138,7 +223,8 @@ namespace TFE_ForceScript
 		s_freeThreads.clear();
 	}
 		
-	ModuleHandle createModule(const char* moduleName, const char* filePath)
+	// 'includes' receives the sections added by #include.
+	static asIScriptModule* compileModule(const char* moduleName, const char* sectionName, const char* srcCode, bool fromFile, std::vector<std::string>* includes)
 	{
 		CScriptBuilder builder;
 		s32 res = builder.StartNewModule(s_engine, moduleName);
@@ -146,7 +232,7 @@ namespace TFE_ForceScript
 		{
 			return nullptr;
 		}
-		res = builder.AddSectionFromFile(filePath);
+		res = fromFile ? builder.AddSectionFromFile(sectionName) : builder.AddSectionFromMemory(sectionName, srcCode);
 		if (res < 0)
 		{
 			return nullptr;
@@ -156,28 +242,186 @@ namespace TFE_ForceScript
 		{
 			return nullptr;
 		}
+
+		// Section 0 is the source itself.
+		const u32 sectionCount = builder.GetSectionCount();
+		for (u32 i = 1; i < sectionCount; i++)
+		{
+			includes->push_back(builder.GetSectionName(i));
+		}
 		return builder.GetModule();
 	}
+
+	// Restore the module from the bytecode cache or compile it and add it to the cache.
+	// For file modules 'sectionName' is the file path, 'messages' receives the log messages when building on the build thread.
+	static ModuleHandle buildModule(const char* moduleName, const char* sectionName, const char* srcCode, bool fromFile, std::vector<ScriptMessage>* messages = nullptr)
+	{
+		u8* fileContents = nullptr;
+		size_t size = 0;
+		if (fromFile)
+		{
+			size = FileStream::readContents(sectionName, (void**)&fileContents);
+			srcCode = (const char*)fileContents;
+		}
+		else
+		{
+			size = strlen(srcCode);
+		}
+		// If the file can't be read, compile anyway so the errors are reported.
+		const bool useCache = srcCode != nullptr;
+		const u64 key = useCache ? scriptCache_computeKey(s_apiHash, moduleName, sectionName, srcCode, size) : 0;
+		free(fileContents);
+
+		if (s_compileMutex) { SDL_LockMutex(s_compileMutex); }
+		s_buildMessages = messages;
+		asIScriptModule* mod = nullptr;
+		if (useCache)
+		{
+			mod = s_engine->GetModule(moduleName, asGM_ALWAYS_CREATE);
+			if (mod && !scriptCache_read(key, mod))
+			{
+				mod = nullptr;
+			}
+		}
+		if (!mod)
+		{
+			std::vector<std::string> includes;
+			mod = compileModule(moduleName, sectionName, fromFile ? nullptr : srcCode, fromFile, &includes);
+			if (mod && useCache)
+			{
+				scriptCache_write(key, mod, includes);
+			}
+		}
+		s_buildMessages = nullptr;
+		if (s_compileMutex) { SDL_UnlockMutex(s_compileMutex); }
+		return mod;
+	}
+
+	ModuleHandle createModule(const char* moduleName, const char* filePath)
+	{
+		return buildModule(moduleName, filePath, nullptr, true);
+	}
 					
 	ModuleHandle createModule(const char* moduleName, const char* sectionName, const char* srcCode)
 	{
-		CScriptBuilder builder;
-		s32 res = builder.StartNewModule(s_engine, moduleName);
-		if (res < 0)
+		return buildModule(moduleName, sectionName, srcCode, false);
+	}
+
+	static void queueModuleRequest(ModuleRequest* request)
+	{
+		// The build thread is only started once a module is requested in the background.
+		if (!s_buildThread && !startBuildThread())
 		{
-			return nullptr;
+			// No build thread, build now but still report the result during the next update.
+			request->module = buildModule(request->moduleName.c_str(), request->sectionName.c_str(), request->srcCode.c_str(), request->fromFile);
+			if (s_buildMutex) { SDL_LockMutex(s_buildMutex); }
+			s_buildComplete.push_back(request);
+			if (s_buildMutex) { SDL_UnlockMutex(s_buildMutex); }
+			return;
 		}
-		res = builder.AddSectionFromMemory(sectionName, srcCode);
-		if (res < 0)
+
+		SDL_LockMutex(s_buildMutex);
+		s_buildQueue.push_back(request);
+		SDL_CondSignal(s_buildCond);
+		SDL_UnlockMutex(s_buildMutex);
+	}
+
+	void createModuleAsync(const char* moduleName, const char* filePath, ModuleCallback callback, void* userData)
+	{
+		ModuleRequest* request = new ModuleRequest();
+		request->moduleName = moduleName;
+		request->sectionName = filePath;
+		request->fromFile = true;
+		request->callback = callback;
+		request->userData = userData;
+		request->module = nullptr;
+		queueModuleRequest(request);
+	}
+
+	void createModuleAsync(const char* moduleName, const char* sectionName, const char* srcCode, ModuleCallback callback, void* userData)
+	{
+		ModuleRequest* request = new ModuleRequest();
+		request->moduleName = moduleName;
+		request->sectionName = sectionName;
+		request->srcCode = srcCode;
+		request->fromFile = false;
+		request->callback = callback;
+		request->userData = userData;
+		request->module = nullptr;
+		queueModuleRequest(request);
+	}
+
+	int buildThreadFunc(void* userData)
+	{
+		SDL_LockMutex(s_buildMutex);
+		while (s_runBuildThread)
 		{
-			return nullptr;
+			if (s_buildQueue.empty())
+			{
+				SDL_CondWait(s_buildCond, s_buildMutex);
+				continue;
+			}
+			ModuleRequest* request = s_buildQueue.front();
+			s_buildQueue.pop_front();
+			SDL_UnlockMutex(s_buildMutex);
+
+			request->module = buildModule(request->moduleName.c_str(), request->sectionName.c_str(), request->srcCode.c_str(), request->fromFile, &request->messages);
+
+			SDL_LockMutex(s_buildMutex);
+			s_buildComplete.push_back(request);
 		}
-		res = builder.BuildModule();
-		if (res < 0)
+		SDL_UnlockMutex(s_buildMutex);
+
+		// Release the AngelScript thread local data.
+		asThreadCleanup();
+		return 0;
+	}
+
+	bool startBuildThread()
+	{
+		// Only try once, if the thread cannot be created modules are built synchronously.
+		if (s_buildMutex) { return s_buildThread != nullptr; }
+
+		s_buildMutex = SDL_CreateMutex();
+		s_buildCond = SDL_CreateCond();
+		s_compileMutex = SDL_CreateMutex();
+		if (s_buildMutex && s_buildCond && s_compileMutex)
 		{
-			return nullptr;
+			s_runBuildThread = true;
+			s_buildThread = SDL_CreateThread(buildThreadFunc, "TFE_ScriptBuildThread", nullptr);
 		}
-		return builder.GetModule();
+		if (!s_buildThread)
+		{
+			s_runBuildThread = false;
+			TFE_System::logWrite(LOG_WARNING, "Script", "Cannot create the script build thread, modules will be built synchronously.");
+		}
+		return s_buildThread != nullptr;
+	}
+
+	void stopBuildThread()
+	{
+		if (s_buildThread)
+		{
+			SDL_LockMutex(s_buildMutex);
+			s_runBuildThread = false;
+			SDL_CondSignal(s_buildCond);
+			SDL_UnlockMutex(s_buildMutex);
+			SDL_WaitThread(s_buildThread, nullptr);
+			s_buildThread = nullptr;
+		}
+
+		// Requests that were not built or not handed back yet are dropped.
+		for (size_t i = 0; i < s_buildQueue.size(); i++) { delete s_buildQueue[i]; }
+		for (size_t i = 0; i < s_buildComplete.size(); i++) { delete s_buildComplete[i]; }
+		s_buildQueue.clear();
+		s_buildComplete.clear();
+
+		if (s_buildCond) { SDL_DestroyCond(s_buildCond); }
+		if (s_buildMutex) { SDL_DestroyMutex(s_buildMutex); }
+		if (s_compileMutex) { SDL_DestroyMutex(s_compileMutex); }
+		s_buildCond = nullptr;
+		s_buildMutex = nullptr;
+		s_compileMutex = nullptr;
 	}
 
 	FunctionHandle findScriptFunc(ModuleHandle modHandle, const char* funcName)
@@ -245,9 +489,18 @@ namespace TFE_ForceScript
 		return id;
 	}
 
+	static void testModuleBuilt(ModuleHandle mod, void* userData)
+	{
+		if (mod)
+		{
+			FunctionHandle func = findScriptFunc(mod, "void main()");
+			execFunc(func);
+		}
+	}
+
 	void test()
 	{
-		// Build a test...
+		// Build a test in the background, it runs once the build is handed back during the update.
 	#if FS_TEST_MEMORY_LOAD == 1
 		const char* c_testScript =
 			"void main()\n"
@@ -255,15 +508,10 @@ namespace TFE_ForceScript
 			"	system_print(\"Hello world\");\n"
 			"}\n";
 
-		ModuleHandle mod = createModule("Test", "Test.as", c_testScript);
+		createModuleAsync("Test", "Test.as", c_testScript, testModuleBuilt);
 	#else
-		ModuleHandle mod = createModule("Test", "Scripts/Test/Test.fs");
+		createModuleAsync("Test", "Scripts/Test/Test.fs", testModuleBuilt);
 	#endif
-		if (mod)
-		{
-			FunctionHandle func = findScriptFunc(mod, "void main()");
-			execFunc(func);
-		}
 	}
 }  // TFE_ForceScript
 
@@ -10,6 +10,8 @@ namespace TFE_ForceScript
 	// Opaque Handles.
 	typedef void* ModuleHandle;
 	typedef void* FunctionHandle;
+	// Called during the TFE_ForceScript update when a background build finishes, modHandle is null if the build failed.
+	typedef void(*ModuleCallback)(ModuleHandle modHandle, void* userData);
 
 	// Initialize and destroy script system.
 	void init();
@@ -20,8 +22,13 @@ namespace TFE_ForceScript
 	void stopAllFunc();
 
 	// Compile module.
+	// Compiled modules are cached as bytecode, so later builds of the same source skip compilation.
 	ModuleHandle createModule(const char* moduleName, const char* sectionName, const char* srcCode);
 	ModuleHandle createModule(const char* moduleName, const char* filePath);
+	// Compile module on the build thread, modules are built in the order requested.
+	// The build thread is started on the first request, build messages are logged when the callback is called.
+	void createModuleAsync(const char* moduleName, const char* sectionName, const char* srcCode, ModuleCallback callback, void* userData = nullptr);
+	void createModuleAsync(const char* moduleName, const char* filePath, ModuleCallback callback, void* userData = nullptr);
 	// Find a specific script function in a module.
 	FunctionHandle findScriptFunc(ModuleHandle modHandle, const char* funcName);
 
@@ -0,0 +1,292 @@
+#include "scriptCache.h"
+#include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <cstring>
+
+#ifdef ENABLE_FORCE_SCRIPT
+#include <angelscript.h>
+
+namespace TFE_ForceScript
+{
+	enum ScriptCacheConstants : u32
+	{
+		SCRIPT_CACHE_MAGIC = 0x31435346,	// "FSC1"
+		// Increment when the file layout changes.
+		SCRIPT_CACHE_VERSION = 1,
+	};
+
+	struct ScriptCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 key;
+		u64 checksum;		// hash of everything after the header.
+		u32 includeCount;
+		u32 byteCodeSize;
+	};
+
+	// Included sections are stored as { u32 nameLength, name, u64 contentHash } followed by the bytecode.
+
+	// Bytecode is written to and read from memory, so the file can be checked before AngelScript sees it.
+	class ScriptByteStream : public asIBinaryStream
+	{
+	public:
+		ScriptByteStream(std::vector<u8>* buffer) : m_buffer(buffer), m_readPos(0) {}
+		ScriptByteStream(const u8* data, size_t size) : m_buffer(nullptr), m_data(data), m_size(size), m_readPos(0) {}
+
+		int Write(const void* ptr, asUINT size) override
+		{
+			if (!size) { return 0; }
+			const u8* src = (const u8*)ptr;
+			m_buffer->insert(m_buffer->end(), src, src + size);
+			return 0;
+		}
+
+		int Read(void* ptr, asUINT size) override
+		{
+			if (m_readPos + size > m_size) { return -1; }
+			memcpy(ptr, m_data + m_readPos, size);
+			m_readPos += size;
+			return 0;
+		}
+
+	private:
+		std::vector<u8>* m_buffer;
+		const u8* m_data = nullptr;
+		size_t m_size = 0;
+		size_t m_readPos;
+	};
+
+	static u64 hashContents(const void* data, size_t size)
+	{
+		const u64 hash = TFE_Hash::fnv1a64Value((u64)size, TFE_Hash::FNV64_OFFSET);
+		return TFE_Hash::fnv1a64(data, size, hash);
+	}
+
+	static bool hashFile(const char* path, u64* hash)
+	{
+		u8* buffer = nullptr;
+		const u32 size = FileStream::readContents(path, (void**)&buffer);
+		if (!buffer) { return false; }
+		*hash = hashContents(buffer, size);
+		free(buffer);
+		return true;
+	}
+
+	static void getCachePath(u64 key, char* path)
+	{
+		char dir[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "ScriptCache/", dir);
+		if (!FileUtil::directoryExits(dir))
+		{
+			FileUtil::makeDirectory(dir);
+		}
+		sprintf(path, "%s%016llx.fsc", dir, (unsigned long long)key);
+	}
+
+	static u64 hashFunction(const asIScriptFunction* func, u64 hash)
+	{
+		return func ? TFE_Hash::fnv1a64(func->GetDeclaration(true, true, true), hash) : hash;
+	}
+
+	u64 scriptCache_computeApiHash(asIScriptEngine* engine)
+	{
+		u64 hash = TFE_Hash::FNV64_OFFSET;
+		const asUINT typeCount = engine->GetObjectTypeCount();
+		for (asUINT i = 0; i < typeCount; i++)
+		{
+			const asITypeInfo* type = engine->GetObjectTypeByIndex(i);
+			hash = TFE_Hash::fnv1a64(type->GetName(), hash);
+			hash = TFE_Hash::fnv1a64Value((u32)type->GetFlags(), hash);
+			hash = TFE_Hash::fnv1a64Value((u32)type->GetSize(), hash);
+			for (asUINT f = 0; f < type->GetFactoryCount(); f++)
+			{
+				hash = hashFunction(type->GetFactoryByIndex(f), hash);
+			}
+			for (asUINT b = 0; b < type->GetBehaviourCount(); b++)
+			{
+				asEBehaviours behaviour;
+				hash = hashFunction(type->GetBehaviourByIndex(b, &behaviour), hash);
+				hash = TFE_Hash::fnv1a64Value((u32)behaviour, hash);
+			}
+			for (asUINT m = 0; m < type->GetMethodCount(); m++)
+			{
+				hash = hashFunction(type->GetMethodByIndex(m), hash);
+			}
+			for (asUINT p = 0; p < type->GetPropertyCount(); p++)
+			{
+				hash = TFE_Hash::fnv1a64(type->GetPropertyDeclaration(p, true), hash);
+			}
+		}
+
+		const asUINT enumCount = engine->GetEnumCount();
+		for (asUINT i = 0; i < enumCount; i++)
+		{
+			const asITypeInfo* type = engine->GetEnumByIndex(i);
+			hash = TFE_Hash::fnv1a64(type->GetName(), hash);
+			for (asUINT v = 0; v < type->GetEnumValueCount(); v++)
+			{
+				s32 value;
+				hash = TFE_Hash::fnv1a64(type->GetEnumValueByIndex(v, &value), hash);
+				hash = TFE_Hash::fnv1a64Value(value, hash);
+			}
+		}
+
+		const asUINT funcdefCount = engine->GetFuncdefCount();
+		for (asUINT i = 0; i < funcdefCount; i++)
+		{
+			hash = hashFunction(engine->GetFuncdefByIndex(i)->GetFuncdefSignature(), hash);
+		}
+
+		const asUINT typedefCount = engine->GetTypedefCount();
+		for (asUINT i = 0; i < typedefCount; i++)
+		{
+			const asITypeInfo* type = engine->GetTypedefByIndex(i);
+			hash = TFE_Hash::fnv1a64(type->GetName(), hash);
+			hash = TFE_Hash::fnv1a64(engine->GetTypeDeclaration(type->GetTypedefTypeId(), true), hash);
+		}
+
+		const asUINT funcCount = engine->GetGlobalFunctionCount();
+		for (asUINT i = 0; i < funcCount; i++)
+		{
+			hash = hashFunction(engine->GetGlobalFunctionByIndex(i), hash);
+		}
+
+		const asUINT propCount = engine->GetGlobalPropertyCount();
+		for (asUINT i = 0; i < propCount; i++)
+		{
+			const char* name = nullptr;
+			const char* nameSpace = nullptr;
+			s32 typeId = 0;
+			bool isConst = false;
+			engine->GetGlobalPropertyByIndex(i, &name, &nameSpace, &typeId, &isConst);
+			hash = TFE_Hash::fnv1a64(name ? name : "", hash);
+			hash = TFE_Hash::fnv1a64(nameSpace ? nameSpace : "", hash);
+			hash = TFE_Hash::fnv1a64(engine->GetTypeDeclaration(typeId, true), hash);
+			hash = TFE_Hash::fnv1a64Value((u8)isConst, hash);
+		}
+		return hash;
+	}
+
+	u64 scriptCache_computeKey(u64 apiHash, const char* moduleName, const char* sectionName, const void* source, size_t size)
+	{
+		// Bytecode is only valid for the same AngelScript version and the same registered API.
+		u64 hash = TFE_Hash::fnv1a64Value((u32)ANGELSCRIPT_VERSION, TFE_Hash::FNV64_OFFSET);
+		hash = TFE_Hash::fnv1a64Value(apiHash, hash);
+		hash = TFE_Hash::fnv1a64(TFE_System::getVersionString(), hash);
+		hash = TFE_Hash::fnv1a64Value((u32)sizeof(void*), hash);
+		hash = TFE_Hash::fnv1a64(moduleName, hash);
+		hash = TFE_Hash::fnv1a64(sectionName, hash);
+		hash = TFE_Hash::fnv1a64Value((u64)size, hash);
+		return TFE_Hash::fnv1a64(source, size, hash);
+	}
+
+	bool scriptCache_read(u64 key, asIScriptModule* mod)
+	{
+		char path[TFE_MAX_PATH];
+		getCachePath(key, path);
+		if (!FileUtil::exists(path)) { return false; }
+
+		u8* buffer = nullptr;
+		const u32 size = FileStream::readContents(path, (void**)&buffer);
+		if (!buffer || size < sizeof(ScriptCacheHeader))
+		{
+			free(buffer);
+			return false;
+		}
+
+		ScriptCacheHeader header;
+		memcpy(&header, buffer, sizeof(ScriptCacheHeader));
+		const u8* payload = buffer + sizeof(ScriptCacheHeader);
+		const size_t payloadSize = size - sizeof(ScriptCacheHeader);
+		if (header.magic != SCRIPT_CACHE_MAGIC || header.version != SCRIPT_CACHE_VERSION || header.key != key ||
+			header.byteCodeSize > payloadSize || TFE_Hash::fnv1a64(payload, payloadSize) != header.checksum)
+		{
+			script_logWrite(LOG_WARNING, "Script Cache", "Discarding invalid or out of date script cache '%s'.", path);
+			free(buffer);
+			return false;
+		}
+
+		// The included sections must still match.
+		const u8* payloadEnd = payload + payloadSize - header.byteCodeSize;
+		bool valid = true;
+		for (u32 i = 0; i < header.includeCount && valid; i++)
+		{
+			u32 nameLength;
+			if (payloadEnd - payload < (ptrdiff_t)sizeof(u32)) { valid = false; break; }
+			memcpy(&nameLength, payload, sizeof(u32));
+			payload += sizeof(u32);
+			if (nameLength >= TFE_MAX_PATH || payloadEnd - payload < ptrdiff_t(nameLength + sizeof(u64))) { valid = false; break; }
+
+			char includePath[TFE_MAX_PATH];
+			memcpy(includePath, payload, nameLength);
+			includePath[nameLength] = 0;
+			payload += nameLength;
+
+			u64 cachedHash, curHash;
+			memcpy(&cachedHash, payload, sizeof(u64));
+			payload += sizeof(u64);
+			valid = hashFile(includePath, &curHash) && curHash == cachedHash;
+		}
+		if (!valid || payload != payloadEnd)
+		{
+			free(buffer);
+			return false;
+		}
+
+		ScriptByteStream stream(payload, header.byteCodeSize);
+		const s32 res = mod->LoadByteCode(&stream);
+		free(buffer);
+		if (res < 0)
+		{
+			script_logWrite(LOG_WARNING, "Script Cache", "Cannot restore the bytecode in '%s', the module will be compiled.", path);
+			return false;
+		}
+		return true;
+	}
+
+	void scriptCache_write(u64 key, asIScriptModule* mod, const std::vector<std::string>& includes)
+	{
+		std::vector<u8> payload;
+		for (size_t i = 0; i < includes.size(); i++)
+		{
+			u64 contentHash;
+			if (!hashFile(includes[i].c_str(), &contentHash)) { return; }
+
+			const u32 nameLength = (u32)includes[i].length();
+			const u8* name = (const u8*)includes[i].c_str();
+			payload.insert(payload.end(), (const u8*)&nameLength, (const u8*)&nameLength + sizeof(u32));
+			payload.insert(payload.end(), name, name + nameLength);
+			payload.insert(payload.end(), (const u8*)&contentHash, (const u8*)&contentHash + sizeof(u64));
+		}
+
+		const size_t includeSize = payload.size();
+		ScriptByteStream stream(&payload);
+		if (mod->SaveByteCode(&stream) < 0) { return; }
+
+		ScriptCacheHeader header = {};
+		header.magic = SCRIPT_CACHE_MAGIC;
+		header.version = SCRIPT_CACHE_VERSION;
+		header.key = key;
+		header.checksum = TFE_Hash::fnv1a64(payload.data(), payload.size());
+		header.includeCount = (u32)includes.size();
+		header.byteCodeSize = u32(payload.size() - includeSize);
+
+		char path[TFE_MAX_PATH];
+		getCachePath(key, path);
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			script_logWrite(LOG_WARNING, "Script Cache", "Cannot write script cache '%s'.", path);
+			return;
+		}
+		file.writeBuffer(&header, sizeof(ScriptCacheHeader));
+		file.writeBuffer(payload.data(), (u32)payload.size());
+		file.close();
+	}
+}  // TFE_ForceScript
+
+#endif
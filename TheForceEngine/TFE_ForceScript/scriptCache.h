@@ -0,0 +1,33 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// ForceScript bytecode cache
+// Compiled modules are saved as AngelScript bytecode, keyed by a hash
+// of the source, the module and section names, the engine and TFE
+// versions and the registered script API. Later runs restore the bytecode instead of compiling the
+// source again. The sections pulled in by #include are stored with a
+// hash of their contents, and the cached module is rebuilt if any of
+// them changes.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_System/system.h>
+#include <string>
+#include <vector>
+
+class asIScriptEngine;
+class asIScriptModule;
+
+namespace TFE_ForceScript
+{
+	// Hash of the types, functions and properties registered with the engine, call once the API is registered.
+	u64  scriptCache_computeApiHash(asIScriptEngine* engine);
+	u64  scriptCache_computeKey(u64 apiHash, const char* moduleName, const char* sectionName, const void* source, size_t size);
+	// Restore the module from the cache, the module should be empty.
+	// Returns false if there is no valid cache entry or an included section has changed.
+	bool scriptCache_read(u64 key, asIScriptModule* mod);
+	// Save the module bytecode, 'includes' are the paths of the included sections.
+	void scriptCache_write(u64 key, asIScriptModule* mod, const std::vector<std::string>& includes);
+
+	// Implemented in forceScript.cpp: logs the message, or queues it while a module is built on the build thread
+	// so it is logged on the main thread once the build is handed back.
+	void script_logWrite(LogWriteType type, const char* tag, const char* format, ...);
+}  // TFE_ForceScript
@@ -289,10 +289,30 @@ namespace TFE_FrontEndUI
 		return false;
 	}
 
+	void console_frameLimiterStats(const ConsoleArgList& args)
+	{
+		TFE_System::FrameLimiterStats stats;
+		TFE_System::frameLimiter_getStats(&stats);
+		if (stats.targetTime == 0.0)
+		{
+			TFE_Console::addToHistory("The frame rate limit is disabled.");
+			return;
+		}
+
+		char res[256];
+		sprintf(res, "Frame Limiter: %u frames, target %0.3f ms, average %0.3f ms, jitter %0.3f ms, max error %0.3f ms.",
+			stats.frameCount, stats.targetTime * 1000.0, stats.frameTime * 1000.0, stats.jitter * 1000.0, stats.maxError * 1000.0);
+		TFE_Console::addToHistory(res);
+		sprintf(res, "  work %0.3f ms, sleep %0.3f ms, spin %0.3f ms, spin margin %0.3f ms, cpu usage %0.1f%%.",
+			stats.workTime * 1000.0, stats.sleepTime * 1000.0, stats.spinTime * 1000.0, stats.spinMargin * 1000.0, stats.cpuUsage * 100.0);
+		TFE_Console::addToHistory(res);
+	}
+
 	void initConsole()
 	{
 		TFE_Console::init();
 		TFE_ProfilerView::init();
+		CCMD("frameLimiterStats", console_frameLimiterStats, 0, "Print the frame limiter timing statistics.");
 	}
 
 	void init()
@@ -1231,6 +1251,8 @@ namespace TFE_FrontEndUI
 	///////////////////////////////////////////////////////////////////////////////
 	static std::vector<TFE_SaveSystem::SaveHeader> s_saveDir;
 	static TextureGpu* s_saveImageView = nullptr;
+	static s32 s_saveImageIndex = -1;	// save shown in s_saveImageView, the image is decoded asynchronously.
+	static bool s_saveImageReady = false;
 	static s32 s_selectedSave = -1;
 	static s32 s_selectedSaveSlot = -1;
 	static bool s_hasQuicksave = false;
@@ -1246,11 +1268,25 @@ namespace TFE_FrontEndUI
 		u32 zero[TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT];
 		memset(zero, 0, sizeof(u32) * TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT);
 		s_saveImageView->update(zero, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+		s_saveImageIndex = -1;
+		s_saveImageReady = false;
 	}
 
 	void updateSaveImage(s32 index)
 	{
-		s_saveImageView->update(s_saveDir[index].imageData, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+		if (index == s_saveImageIndex && s_saveImageReady) { return; }
+		if (index != s_saveImageIndex)
+		{
+			clearSaveImage();
+			s_saveImageIndex = index;
+		}
+
+		const u32* image = TFE_SaveSystem::getSaveImage(&s_saveDir[index]);
+		if (image)
+		{
+			s_saveImageView->update(image, TFE_SaveSystem::SAVE_IMAGE_WIDTH * TFE_SaveSystem::SAVE_IMAGE_HEIGHT * 4);
+			s_saveImageReady = true;
+		}
 	}
 
 	void openLoadConfirmPopup()
@@ -1337,6 +1373,11 @@ namespace TFE_FrontEndUI
 		{
 			configSaveLoadBegin(save);
 		}
+		// Keep polling until the selected screenshot has been decoded.
+		if (s_saveImageIndex >= 0 && !s_saveImageReady)
+		{
+			updateSaveImage(s_saveImageIndex);
+		}
 
 		// Create the current display info to adjust menu sizes.
 		DisplayInfo displayInfo;
@@ -1423,7 +1464,14 @@ namespace TFE_FrontEndUI
 					saveName = header[i - listOffset].saveName;
 				}
 
-				if (ImGui::Selectable(saveName, selected, ImGuiSelectableFlags_None, buttonSize))
+				const bool clicked = ImGui::Selectable(saveName, selected, ImGuiSelectableFlags_None, buttonSize);
+				// Decode the screenshots of visible rows in the background, so they are ready when selected.
+				if (i >= size_t(listOffset) && ImGui::IsItemVisible())
+				{
+					TFE_SaveSystem::getSaveImage(&header[i - listOffset], true);
+				}
+
+				if (clicked)
 				{
 					if (!s_popupOpen)
 					{
@@ -2250,6 +2298,11 @@ namespace TFE_FrontEndUI
 			graphics->frameRateLimit = frameRateLimit;
 			TFE_System::frameLimiter_set(frameRateLimit);
 		}
+		ImGui::Checkbox("Late Input Sampling", &graphics->lateLatchInput);
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::SetTooltip("Read the mouse and keyboard again right before the game update to reduce input latency.");
+		}
 		ImGui::Separator();
 
 		ImGui::LabelText("##ConfigLabel", "Renderer:"); ImGui::SameLine(75 * s_uiScale);
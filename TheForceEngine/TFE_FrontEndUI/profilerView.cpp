@@ -3,12 +3,14 @@
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_System/system.h>
 #include <TFE_System/profiler.h>
+#include <TFE_System/telemetry.h>
 #include <TFE_FileSystem/fileutil.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_Archive/archive.h>
 #include <TFE_Ui/ui.h>
 #include <TFE_Ui/markdown.h>
 #include <TFE_System/parser.h>
+#include "console.h"
 
 #include <TFE_Ui/imGUI/imgui.h>
 #include <algorithm>
@@ -16,14 +18,73 @@
 namespace TFE_ProfilerView
 {
 	static bool s_open = false;
+	static bool s_telemetryDumpOnExit = false;
+
+	// Writes the telemetry ring to 'path', or to telemetry.csv/.json in the user documents folder.
+	bool dumpTelemetry(TFE_Telemetry::TelemetryFormat format, const char* path)
+	{
+		char defaultPath[TFE_MAX_PATH];
+		if (!path || !path[0])
+		{
+			TFE_Paths::appendPath(PATH_USER_DOCUMENTS, format == TFE_Telemetry::TELEMETRY_JSON ? "telemetry.json" : "telemetry.csv", defaultPath);
+			path = defaultPath;
+		}
+		if (!TFE_Telemetry::write(path, format)) { return false; }
+
+		TFE_System::logWrite(LOG_MSG, "Telemetry", "Wrote %u frames of telemetry to '%s'.", TFE_Telemetry::getFrameCount(), path);
+		return true;
+	}
+
+	void console_telemetry(const ConsoleArgList& args)
+	{
+		if (args.size() > 1)
+		{
+			TFE_Telemetry::setEnabled(strcasecmp(args[1].c_str(), "on") == 0 || strcasecmp(args[1].c_str(), "1") == 0);
+		}
+		char res[256];
+		sprintf(res, "Telemetry is %s, %u frames recorded.", TFE_Telemetry::isEnabled() ? "on" : "off", TFE_Telemetry::getFrameCount());
+		TFE_Console::addToHistory(res);
+	}
+
+	void console_telemetryDump(const ConsoleArgList& args)
+	{
+		TFE_Telemetry::TelemetryFormat format = TFE_Telemetry::TELEMETRY_CSV;
+		if (args.size() > 1 && strcasecmp(args[1].c_str(), "json") == 0)
+		{
+			format = TFE_Telemetry::TELEMETRY_JSON;
+		}
+		const char* path = args.size() > 2 ? args[2].c_str() : nullptr;
+
+		char res[TFE_MAX_PATH + 64];
+		if (!TFE_Telemetry::getFrameCount())
+		{
+			TFE_Console::addToHistory("No telemetry has been recorded.");
+		}
+		else if (dumpTelemetry(format, path))
+		{
+			sprintf(res, "Wrote %u frames of telemetry.", TFE_Telemetry::getFrameCount());
+			TFE_Console::addToHistory(res);
+		}
+		else
+		{
+			TFE_Console::addToHistory("Failed to write the telemetry.");
+		}
+	}
 
 	bool init()
 	{
+		CVAR_BOOL(s_telemetryDumpOnExit, "d_telemetryDumpOnExit", CVFLAG_DO_NOT_SERIALIZE, "Write the recorded telemetry to telemetry.csv in the user documents folder on exit.");
+		CCMD("telemetry", console_telemetry, 0, "Record the frame times, profiler zones and counters of the most recent frames - telemetry [on|off], off by default and off frees the recorded frames.");
+		CCMD("telemetryDump", console_telemetryDump, 0, "Write the recorded telemetry - telemetryDump [csv|json] [path], the default path is the user documents folder.");
 		return true;
 	}
 
 	void destroy()
 	{
+		if (s_telemetryDumpOnExit && TFE_Telemetry::getFrameCount())
+		{
+			dumpTelemetry(TFE_Telemetry::TELEMETRY_CSV, nullptr);
+		}
 	}
 
 	void update()
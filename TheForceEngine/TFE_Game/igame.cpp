@@ -1,7 +1,17 @@
 #include "igame.h"
 #include <TFE_FrontEndUI/console.h>
+#include <TFE_Asset/parserBench.h>
+#include <TFE_Asset/spriteBench.h>
+#include <TFE_Jedi/Collision/losQuery.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
+#include <TFE_Jedi/Level/level.h>
+#include <TFE_DarkForces/Actor/actor.h>
+#include <TFE_System/jobPool.h>
+#include <TFE_System/memoryPool.h>
+#include <TFE_System/telemetry.h>
 #include <TFE_DarkForces/darkForcesMain.h>
 #include <TFE_Outlaws/outlawsMain.h>
+#include <algorithm>
 
 enum GameConstants
 {
@@ -31,16 +41,160 @@ void displayMemoryUsage(const ConsoleArgList& args)
 	TFE_Console::addToHistory("-------------------------------------------------------------------");
 }
 
+void memoryTracking(const ConsoleArgList& args)
+{
+	if (args.size() > 1)
+	{
+		if (strcasecmp(args[1].c_str(), "reset") == 0)
+		{
+			region_resetTracking();
+		}
+		else
+		{
+			region_enableTracking(strcasecmp(args[1].c_str(), "on") == 0 || strcasecmp(args[1].c_str(), "1") == 0);
+		}
+	}
+	TFE_Console::addToHistory(region_isTrackingEnabled() ? "Memory tracking is on." : "Memory tracking is off.");
+}
+
+static const char* getCallsiteFile(const char* file)
+{
+	const char* name = file;
+	for (const char* c = file; *c; c++)
+	{
+		if (*c == '/' || *c == '\\') { name = c + 1; }
+	}
+	return name;
+}
+
+static void printCallsites(std::vector<RegionCallsite>& callsites, size_t maxCount, bool live)
+{
+	std::sort(callsites.begin(), callsites.end(), [live](const RegionCallsite& a, const RegionCallsite& b)
+	{
+		return live ? a.liveBytes > b.liveBytes : a.totalBytes > b.totalBytes;
+	});
+
+	char res[256];
+	TFE_Console::addToHistory("  Call Site                            | Live Count |   Live Bytes | Alloc Count |  Total Bytes");
+	const size_t count = std::min(callsites.size(), maxCount);
+	for (size_t i = 0; i < count; i++)
+	{
+		const RegionCallsite& callsite = callsites[i];
+		char location[64];
+		snprintf(location, sizeof(location), "%s:%d", getCallsiteFile(callsite.file), callsite.line);
+		sprintf(res, "  %-36s | %10u | %12zu | %11u | %12zu", location, callsite.liveCount, callsite.liveBytes, callsite.allocCount, callsite.totalBytes);
+		TFE_Console::addToHistory(res);
+	}
+}
+
+// memoryReport [region|all] [callsite count]
+void memoryReport(const ConsoleArgList& args)
+{
+	const char* regionName = args.size() > 1 ? args[1].c_str() : "all";
+	const size_t maxCallsites = args.size() > 2 ? (size_t)std::max(atoi(args[2].c_str()), 1) : 10;
+	const bool allRegions = strcasecmp(regionName, "all") == 0;
+
+	char res[256];
+	std::vector<RegionCallsite> callsites;
+	std::vector<RegionClearRecord> clears;
+	const s32 regionCount = region_getCount();
+	for (s32 r = 0; r < regionCount; r++)
+	{
+		MemoryRegion* region = region_get(r);
+		if (!allRegions && strcasecmp(regionName, region_getName(region)) != 0) { continue; }
+
+		size_t blockCount, blockSize;
+		region_getBlockInfo(region, &blockCount, &blockSize);
+		TFE_Console::addToHistory("-------------------------------------------------------------------");
+		sprintf(res, "Region '%s': %zu bytes used, capacity %zu bytes in %zu blocks of %zu bytes.", region_getName(region),
+			region_getMemoryUsed(region), region_getMemoryCapacity(region), blockCount, blockSize);
+		TFE_Console::addToHistory(res);
+
+		RegionFragmentation frag;
+		region_getFragmentation(region, &frag);
+		sprintf(res, "  Free: %zu bytes, largest free allocation %zu bytes (%0.1f%% fragmented).", frag.freeBytes, frag.largestFree,
+			frag.freeBytes ? 100.0 * (1.0 - f64(frag.largestFree) / f64(frag.freeBytes)) : 0.0);
+		TFE_Console::addToHistory(res);
+		sprintf(res, "  Free per bin: <=32: %zu (%u), <=64: %zu (%u), <=128: %zu (%u), <=256: %zu (%u), <=512: %zu (%u), 513+: %zu (%u)",
+			frag.binFreeBytes[0], frag.binFreeCount[0], frag.binFreeBytes[1], frag.binFreeCount[1], frag.binFreeBytes[2], frag.binFreeCount[2],
+			frag.binFreeBytes[3], frag.binFreeCount[3], frag.binFreeBytes[4], frag.binFreeCount[4], frag.binFreeBytes[5], frag.binFreeCount[5]);
+		TFE_Console::addToHistory(res);
+
+		size_t peakUsed, maxPeakUsed;
+		if (!region_getTrackingPeak(region, &peakUsed, &maxPeakUsed))
+		{
+			TFE_Console::addToHistory("  Nothing tracked, use 'memoryTracking on' before loading.");
+			continue;
+		}
+		sprintf(res, "  Peak: %zu bytes since the last clear, %zu bytes overall.", peakUsed, maxPeakUsed);
+		TFE_Console::addToHistory(res);
+
+		region_getTrackedCallsites(region, callsites);
+		printCallsites(callsites, maxCallsites, true);
+
+		region_getTrackedClears(region, clears);
+		if (!clears.empty())
+		{
+			TFE_Console::addToHistory("  Clears (oldest first)                |   Peak Bytes | Live Count |   Live Bytes");
+			for (size_t i = 0; i < clears.size(); i++)
+			{
+				sprintf(res, "  %-36s | %12zu | %10u | %12zu", clears[i].label[0] ? clears[i].label : "-", clears[i].peakUsed, clears[i].liveCount, clears[i].liveBytes);
+				TFE_Console::addToHistory(res);
+			}
+		}
+
+		region_getTrackedClearLive(region, callsites);
+		if (!callsites.empty())
+		{
+			TFE_Console::addToHistory("  Allocations not freed before the last clear:");
+			printCallsites(callsites, maxCallsites, true);
+		}
+	}
+
+	const s32 poolCount = MemoryPool::getPoolCount();
+	if (allRegions && poolCount)
+	{
+		TFE_Console::addToHistory("-------------------------------------------------------------------");
+		TFE_Console::addToHistory("Pool                     |       Used |       Peak |       Size | Failed");
+		for (s32 i = 0; i < poolCount; i++)
+		{
+			const MemoryPool* pool = MemoryPool::getPool(i);
+			sprintf(res, "%-24.24s | %10zu | %10zu | %10zu | %6u", pool->getName(), pool->getMemoryUsed(), pool->getPeakUsed(), pool->getPoolSize(), pool->getFailCount());
+			TFE_Console::addToHistory(res);
+		}
+	}
+	TFE_Console::addToHistory("-------------------------------------------------------------------");
+}
+
+// Memory used by a region in KB, 'userData' points to the region pointer.
+f64 getRegionMemoryUsedKB(void* userData)
+{
+	MemoryRegion* region = *(MemoryRegion**)userData;
+	return region ? f64(region_getMemoryUsed(region)) / 1024.0 : 0.0;
+}
+
 void game_init()
 {
 	s_gameRegion  = region_create("game",  GAME_MEMORY_BASE);	// Region for "permanent" game allocations.
 	s_levelRegion = region_create("level", LEVEL_MEMORY_BASE);	// Region for "per-level" game allocations.
 
 	CCMD("displayMemoryUsage", displayMemoryUsage, 0, "Display memory usage.");
+	CCMD("memoryTracking", memoryTracking, 0, "Track memory region allocations per call site, peak usage and allocations live when a region is cleared - memoryTracking [on|off|reset].");
+	CCMD("memoryReport", memoryReport, 0, "Display region usage, fragmentation, tracked call sites and pool peaks - memoryReport [region|all] [call site count].");
+	TFE_Telemetry::addSource("Game Region Used (KB)", getRegionMemoryUsedKB, &s_gameRegion);
+	TFE_Telemetry::addSource("Level Region Used (KB)", getRegionMemoryUsedKB, &s_levelRegion);
+	TFE_ParserBench::registerCommands();
+	TFE_SpriteBench::registerCommands();
+	TFE_Jedi::los_registerCommands();
+	TFE_Jedi::objGrid_registerCommands();
+	TFE_Jedi::level_registerCommands();
+	TFE_DarkForces::actor_registerCommands();
 }
 
 void game_destroy()
 {
+	TFE_JobPool::destroy();
+	TFE_Jedi::level_setAssetRetainKey(nullptr);
 	region_destroy(s_gameRegion);
 	region_destroy(s_levelRegion);
 
@@ -1,13 +1,23 @@
 #include "saveSystem.h"
+#include "snapshotRing.h"
 #include <TFE_Input/inputMapping.h>
+#include <TFE_FrontEndUI/console.h>
 #include <TFE_System/system.h>
 #include <TFE_Settings/gameSourceData.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_FileSystem/filewriterAsync.h>
+#define MINIZ_HEADER_FILE_ONLY
+#include <TFE_Archive/zip/miniz.h>
 
 #include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_Asset/imageAsset.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
 #include <cassert>
 #include <cstring>
+#include <deque>
+#include <map>
 
 using namespace TFE_Input;
 
@@ -23,7 +33,60 @@ namespace TFE_SaveSystem
 	enum SaveMasterVersion
 	{
 		SVER_INIT = 1,
-		SVER_CUR = SVER_INIT
+		SVER_COMPRESSED = 2,	// The game state following the header is compressed.
+		SVER_CUR = SVER_COMPRESSED
+	};
+
+	enum SaveIndexConst
+	{
+		SAVE_INDEX_MAGIC = 0x58444953,	// "SIDX"
+		SAVE_INDEX_VERSION = 1,
+		SAVE_INDEX_HEADER_SIZE = 12,		// magic, version, count.
+		SAVE_INDEX_ENTRY_FIXED_SIZE = 16,	// modTime, imageOffset, imageSize.
+		SAVE_INDEX_ENTRY_MIN_SIZE = 21,		// the fixed size plus the 5 string lengths.
+		SAVE_IMAGE_CACHE_SIZE = 32,
+	};
+	static const char* c_saveIndexName = "saves.idx";
+	// Load request name used to restore a snapshot from the snapshot ring.
+	static const char* c_snapshotLoadName = "<snapshot>";
+
+	// The decompressed game state of a save is never this large, larger sizes mean the file is corrupt.
+	enum SaveLimits
+	{
+		SAVE_MAX_STATE_SIZE = 256 * 1024 * 1024,
+	};
+
+	// Passed to the async writer, the header is written as-is followed by the screenshot, the rest of the buffer is compressed.
+	struct SaveWriteRequest
+	{
+		char fileName[TFE_MAX_PATH];
+		u32 headerSize;
+		f64 startTime;
+		f64 serializeTime;
+		SaveHeader header;	// added to the save index once the file is written.
+		// Screen capture at display resolution, scaled and encoded as PNG by the writer.
+		std::vector<u32> image;
+		u32 imageWidth;
+		u32 imageHeight;
+	};
+
+	enum SaveImageState
+	{
+		SIMG_QUEUED = 0,
+		SIMG_DECODING,
+		SIMG_READY,
+		SIMG_FAILED,
+	};
+
+	struct SaveImage
+	{
+		char filePath[TFE_MAX_PATH];
+		u64 modTime;
+		u32 offset;
+		u32 size;
+		u32 lastUse;
+		SaveImageState state;	// Protected by s_imageMutex.
+		u32 pixels[SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT];
 	};
 
 	static SaveRequest s_req = SF_REQ_NONE;
@@ -33,35 +96,53 @@ namespace TFE_SaveSystem
 	static IGame* s_game = nullptr;
 	static s32 s_saveDelay = 0;
 
-	static u32* s_imageBuffer[2] = { nullptr, nullptr };
-	static size_t s_imageBufferSize[2] = { 0 };
+	static MemoryStream s_saveStream;
+
+	// Screenshot decoding, the queue and image states are protected by s_imageMutex.
+	static SDL_Thread* s_imageThread = nullptr;
+	static SDL_mutex* s_imageMutex = nullptr;
+	static SDL_cond* s_imageCond = nullptr;
+	static bool s_runImageThread = false;
+	static std::deque<SaveImage*> s_imageQueue;
+	static std::vector<SaveImage*> s_imageCache;
+	static u32 s_imageUse = 0;
+
+	// In-memory game states, see snapshotRing.h.
+	// Off by default, each snapshot serializes the full game state on the main thread.
+	static bool s_snapshotsEnabled = false;
+	static f32 s_snapshotInterval = 5.0f;
+	static s32 s_snapshotMemoryMB = 32;
+	static f64 s_lastSnapshotTime = 0.0;
+	static f64 s_snapshotCaptureTime = 0.0;
+	static s32 s_snapshotLoadIndex = -1;
+	static GameID s_snapshotGame = Game_Count;
+	static MemoryStream s_snapshotStream;
+	static std::vector<u8> s_quickSaveState;	// Game state of the last quicksave made this session, so quickload does not read the file.
+
+	void console_rewind(const ConsoleArgList& args);
+	void console_snapshotStats(const ConsoleArgList& args);
 
-	void saveHeader(Stream* stream, const char* saveName)
+	// Use the file name when the save does not have a name.
+	void fixupSaveName(SaveHeader* header, const char* fileName)
 	{
-		// Generate a screenshot.
-		DisplayInfo displayInfo;
-		TFE_RenderBackend::getDisplayInfo(&displayInfo);
-		size_t size = displayInfo.width * displayInfo.height * 4;
-		if (size > s_imageBufferSize[0])
-		{
-			s_imageBuffer[0] = (u32*)realloc(s_imageBuffer[0], size);
-			s_imageBufferSize[0] = size;
-		}
-		TFE_RenderBackend::captureScreenToMemory(s_imageBuffer[0]);
-		// Save to memory.
-		u8* png = (u8*)malloc(SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT * 4);
-		u32 pngSize = 0;
-		if (png)
-		{
-			pngSize = (u32)TFE_Image::writeImageToMemory(png, displayInfo.width, displayInfo.height,
-								 SAVE_IMAGE_WIDTH, SAVE_IMAGE_HEIGHT,
-								 s_imageBuffer[0]);
-		}
-		else
+		if (header->saveName[0] == 0 || header->saveName[0] == ' ')
 		{
-			pngSize = 0;
-			png = (u8*)s_imageBuffer[0];
+			FileUtil::getFileNameFromPath(fileName, header->saveName);
 		}
+	}
+
+	// Writes the header up to the screenshot, which is encoded and written by the async writer (see compressSaveData()).
+	void saveHeader(Stream* stream, const char* saveName, SaveWriteRequest* request)
+	{
+		SaveHeader* header = &request->header;
+
+		// Capture the screen, only the raw pixels are copied here to keep the PNG encode off of the game thread.
+		DisplayInfo displayInfo;
+		TFE_RenderBackend::getDisplayInfo(&displayInfo);
+		request->imageWidth = displayInfo.width;
+		request->imageHeight = displayInfo.height;
+		request->image.resize(size_t(displayInfo.width) * size_t(displayInfo.height));
+		TFE_RenderBackend::captureScreenToMemory(request->image.data());
 
 		// Master version.
 		u32 version = SVER_CUR;
@@ -73,6 +154,8 @@ namespace TFE_SaveSystem
 		u8 len = (u8)saveNameLen;
 		stream->write(&len);
 		stream->writeBuffer(saveName, len);
+		memcpy(header->saveName, saveName, len);
+		header->saveName[len] = 0;
 
 		// Time and Date of Save.
 		char timeDate[256];
@@ -80,6 +163,7 @@ namespace TFE_SaveSystem
 		len = (u8)strlen(timeDate);
 		stream->write(&len);
 		stream->writeBuffer(timeDate, len);
+		strcpy(header->dateTime, timeDate);
 
 		// Level Name
 		char levelName[256];
@@ -87,6 +171,7 @@ namespace TFE_SaveSystem
 		len = (u8)strlen(levelName);
 		stream->write(&len);
 		stream->writeBuffer(levelName, len);
+		strcpy(header->levelName, levelName);
 
 		// Mod List
 		char modList[256];
@@ -94,17 +179,13 @@ namespace TFE_SaveSystem
 		len = (u8)strlen(modList);
 		stream->write(&len);
 		stream->writeBuffer(modList, len);
-
-		// Image.
-		stream->write(&pngSize);
-		stream->writeBuffer(png, pngSize);
-		free(png);
+		strcpy(header->modNames, modList);
 	}
 
-	void loadHeader(Stream* stream, SaveHeader* header, const char* fileName)
+	u32 loadHeader(Stream* stream, SaveHeader* header, const char* fileName)
 	{
 		// Master version.
-		u32 version;
+		u32 version = 0;
 		stream->read(&version);
 
 		// Save Name.
@@ -116,10 +197,7 @@ namespace TFE_SaveSystem
 		header->saveName[SAVE_MAX_NAME_LEN - 1] = 0;
 
 		// Handle the case when there is no save name.
-		if (header->saveName[0] == 0 || header->saveName[0] == ' ')
-		{
-			FileUtil::getFileNameFromPath(fileName, header->saveName);
-		}
+		fixupSaveName(header, fileName);
 
 		// Time and Date of Save.
 		stream->read(&len);
@@ -136,53 +214,504 @@ namespace TFE_SaveSystem
 		stream->readBuffer(header->modNames, len);
 		header->modNames[len] = 0;
 
-		// Image, re-use buffer 0 for the PNG.
-		u32 pngSize;
+		// Image, the screenshot is only decoded when the UI asks for it (see getSaveImage()).
+		u32 pngSize = 0;
 		stream->read(&pngSize);
-		if (pngSize > s_imageBufferSize[0])
+		header->imageOffset = (u32)stream->getLoc();
+		header->imageSize = pngSize;
+		stream->seek(s32(pngSize), Stream::ORIGIN_CURRENT);
+		return version;
+	}
+
+	////////////////////////////////////////////
+	// Save Index
+	////////////////////////////////////////////
+	void writeIndexString(Stream* stream, const char* str)
+	{
+		const u8 len = (u8)min(strlen(str), size_t(255));
+		stream->write(&len);
+		stream->writeBuffer(str, len);
+	}
+
+	// Returns false if the string does not fit in the remaining bytes of the index.
+	bool readIndexString(Stream* stream, char* str, size_t bufferSize, size_t* remaining)
+	{
+		str[0] = 0;
+		if (*remaining < 1) { return false; }
+		u8 len = 0;
+		stream->read(&len);
+		if (size_t(len) + 1 > *remaining) { return false; }
+		*remaining -= size_t(len) + 1;
+
+		if (len >= bufferSize)
 		{
-			s_imageBuffer[0] = (u32*)realloc(s_imageBuffer[0], pngSize);
-			s_imageBufferSize[0] = pngSize;
+			stream->readBuffer(str, u32(bufferSize - 1));
+			stream->seek(s32(len - (bufferSize - 1)), Stream::ORIGIN_CURRENT);
+			len = u8(bufferSize - 1);
 		}
-		stream->readBuffer(s_imageBuffer[0], pngSize);
+		else if (len)
+		{
+			stream->readBuffer(str, len);
+		}
+		str[len] = 0;
+		return true;
+	}
 
-		SDL_Surface* image;
-		TFE_Image::readImageFromMemory(&image, pngSize, s_imageBuffer[0]);
-		if (image)
+	bool readSaveIndex(std::vector<SaveHeader>& index)
+	{
+		index.clear();
+		char indexPath[TFE_MAX_PATH];
+		sprintf(indexPath, "%s%s", s_gameSavePath, c_saveIndexName);
+
+		FileStream file;
+		if (!file.open(indexPath, Stream::MODE_READ))
 		{
-			const u32 sz = SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT * sizeof(u32);
-			memcpy(header->imageData, image->pixels, sz);
-			TFE_Image::free(image);
+			return false;
 		}
+
+		// Validate everything against the bytes left in the file, so a truncated or corrupt index is never read past its end.
+		const size_t size = file.getSize();
+		u32 magic = 0, version = 0, count = 0;
+		bool valid = size >= SAVE_INDEX_HEADER_SIZE;
+		if (valid)
+		{
+			file.read(&magic);
+			file.read(&version);
+			file.read(&count);
+		}
+		size_t remaining = valid ? size - SAVE_INDEX_HEADER_SIZE : 0;
+		valid = valid && magic == SAVE_INDEX_MAGIC && version == SAVE_INDEX_VERSION && size_t(count) <= remaining / SAVE_INDEX_ENTRY_MIN_SIZE;
+		if (valid)
+		{
+			index.resize(count);
+			for (u32 i = 0; i < count && valid; i++)
+			{
+				SaveHeader* header = &index[i];
+				if (remaining < SAVE_INDEX_ENTRY_FIXED_SIZE)
+				{
+					valid = false;
+					break;
+				}
+				file.read(&header->modTime);
+				file.read(&header->imageOffset);
+				file.read(&header->imageSize);
+				remaining -= SAVE_INDEX_ENTRY_FIXED_SIZE;
+
+				valid = readIndexString(&file, header->fileName, sizeof(header->fileName), &remaining) &&
+					    readIndexString(&file, header->saveName, sizeof(header->saveName), &remaining) &&
+					    readIndexString(&file, header->dateTime, sizeof(header->dateTime), &remaining) &&
+					    readIndexString(&file, header->levelName, sizeof(header->levelName), &remaining) &&
+					    readIndexString(&file, header->modNames, sizeof(header->modNames), &remaining);
+				// An entry without a file name cannot be matched to a save.
+				valid = valid && header->fileName[0] != 0;
+			}
+		}
+		file.close();
+
+		if (!valid)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Save", "The save index '%s' is invalid, it will be rebuilt.", indexPath);
+			index.clear();
+		}
+		return valid;
 	}
 
-	void populateSaveDirectory(std::vector<SaveHeader>& dir)
+	void writeSaveIndex(const std::vector<SaveHeader>& index)
 	{
+		char indexPath[TFE_MAX_PATH];
+		sprintf(indexPath, "%s%s", s_gameSavePath, c_saveIndexName);
+
+		FileStream file;
+		if (!file.open(indexPath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Save", "Cannot write the save index '%s'.", indexPath);
+			return;
+		}
+
+		const u32 magic = SAVE_INDEX_MAGIC, version = SAVE_INDEX_VERSION, count = (u32)index.size();
+		file.write(&magic);
+		file.write(&version);
+		file.write(&count);
+		for (u32 i = 0; i < count; i++)
+		{
+			const SaveHeader* header = &index[i];
+			file.write(&header->modTime);
+			file.write(&header->imageOffset);
+			file.write(&header->imageSize);
+			writeIndexString(&file, header->fileName);
+			writeIndexString(&file, header->saveName);
+			writeIndexString(&file, header->dateTime);
+			writeIndexString(&file, header->levelName);
+			writeIndexString(&file, header->modNames);
+		}
+		file.close();
+	}
+
+	// Fill in 'dir' from the save directory, reusing the index entries that are still up to date, and rewrite the index if it changed.
+	void rebuildSaveIndex(std::vector<SaveHeader>& dir)
+	{
+		std::vector<SaveHeader> index;
+		const bool indexValid = readSaveIndex(index);
+		std::map<std::string, const SaveHeader*> indexMap;
+		for (size_t i = 0; i < index.size(); i++)
+		{
+			indexMap[index[i].fileName] = &index[i];
+		}
+
 		dir.clear();
 		FileList fileList;
 		FileUtil::readDirectory(s_gameSavePath, "tfe", fileList);
-		size_t saveCount = fileList.size();
-		dir.resize(saveCount);
+		const size_t saveCount = fileList.size();
+		dir.reserve(saveCount);
 
+		// Only read the headers of saves that are missing from the index or have changed since it was written.
+		bool indexChanged = !indexValid || index.size() != saveCount;
+		s32 readCount = 0;
 		const std::string* filenames = fileList.data();
-		SaveHeader* headers = dir.data();
 		for (size_t i = 0; i < saveCount; i++)
 		{
-			loadGameHeader(filenames[i].c_str(), &headers[i]);
+			char filePath[TFE_MAX_PATH];
+			sprintf(filePath, "%s%s", s_gameSavePath, filenames[i].c_str());
+			const u64 modTime = FileUtil::getModifiedTime(filePath);
+
+			std::map<std::string, const SaveHeader*>::const_iterator iEntry = indexMap.find(filenames[i]);
+			if (iEntry != indexMap.end() && iEntry->second->modTime == modTime)
+			{
+				dir.push_back(*iEntry->second);
+				continue;
+			}
+
+			SaveHeader header;
+			if (loadGameHeader(filenames[i].c_str(), &header))
+			{
+				dir.push_back(header);
+				readCount++;
+			}
+			indexChanged = true;
+		}
+
+		if (indexChanged)
+		{
+			writeSaveIndex(dir);
+			TFE_System::logWrite(LOG_MSG, "Save", "Updated the save index, read %d of %u save headers.", readCount, u32(saveCount));
 		}
 	}
 
+	// Add or replace a single entry, if there is no valid index it is rebuilt from the save directory instead.
+	void updateSaveIndex(const SaveHeader* header)
+	{
+		std::vector<SaveHeader> index;
+		if (!readSaveIndex(index))
+		{
+			rebuildSaveIndex(index);
+			return;
+		}
+
+		const size_t count = index.size();
+		size_t i = 0;
+		for (; i < count; i++)
+		{
+			if (strcasecmp(index[i].fileName, header->fileName) == 0) { break; }
+		}
+		if (i < count) { index[i] = *header; }
+		else { index.push_back(*header); }
+		writeSaveIndex(index);
+	}
+
+	void populateSaveDirectory(std::vector<SaveHeader>& dir)
+	{
+		// Pending saves update the index when they complete.
+		FileWriterAsync::flush();
+		rebuildSaveIndex(dir);
+	}
+
+	////////////////////////////////////////////
+	// Save Images
+	////////////////////////////////////////////
+	void lockImages()
+	{
+		if (s_imageMutex) { SDL_LockMutex(s_imageMutex); }
+	}
+
+	void unlockImages()
+	{
+		if (s_imageMutex) { SDL_UnlockMutex(s_imageMutex); }
+	}
+
+	// Reads and decodes the PNG, called on the image thread (or the main thread if there is no image thread).
+	bool decodeSaveImage(SaveImage* image)
+	{
+		FileStream file;
+		if (!image->size || !file.open(image->filePath, Stream::MODE_READ))
+		{
+			return false;
+		}
+		std::vector<u32> png((image->size + 3) / 4);
+		const bool readAll = file.seek(s32(image->offset)) && file.readBuffer(png.data(), image->size) == image->size;
+		file.close();
+		if (!readAll) { return false; }
+
+		SDL_Surface* surface = nullptr;
+		TFE_Image::readImageFromMemory(&surface, image->size, png.data());
+		if (!surface) { return false; }
+
+		const bool valid = surface->w == SAVE_IMAGE_WIDTH && surface->h == SAVE_IMAGE_HEIGHT && surface->format->BytesPerPixel == 4;
+		if (valid)
+		{
+			const u8* src = (u8*)surface->pixels;
+			for (s32 y = 0; y < SAVE_IMAGE_HEIGHT; y++, src += surface->pitch)
+			{
+				memcpy(&image->pixels[y * SAVE_IMAGE_WIDTH], src, SAVE_IMAGE_WIDTH * sizeof(u32));
+			}
+		}
+		TFE_Image::free(surface);
+		return valid;
+	}
+
+	int imageThreadFunc(void* userData)
+	{
+		SDL_LockMutex(s_imageMutex);
+		while (s_runImageThread)
+		{
+			if (s_imageQueue.empty())
+			{
+				SDL_CondWait(s_imageCond, s_imageMutex);
+				continue;
+			}
+			SaveImage* image = s_imageQueue.front();
+			s_imageQueue.pop_front();
+			image->state = SIMG_DECODING;
+			SDL_UnlockMutex(s_imageMutex);
+
+			const bool success = decodeSaveImage(image);
+
+			SDL_LockMutex(s_imageMutex);
+			image->state = success ? SIMG_READY : SIMG_FAILED;
+		}
+		SDL_UnlockMutex(s_imageMutex);
+		return 0;
+	}
+
+	// Returns a free cache slot, replacing the least recently used image if the cache is full. Must be called with the images locked.
+	SaveImage* allocSaveImage(bool prefetch)
+	{
+		if (s_imageCache.size() < SAVE_IMAGE_CACHE_SIZE)
+		{
+			SaveImage* image = new SaveImage();
+			s_imageCache.push_back(image);
+			return image;
+		}
+
+		// Images being decoded cannot be replaced, queued images can only be replaced by direct requests.
+		// Prefetches only replace images that have not been requested recently, so a list with more visible rows
+		// than the cache holds does not keep decoding the same images over and over.
+		SaveImage* oldest = nullptr;
+		for (size_t i = 0; i < s_imageCache.size(); i++)
+		{
+			SaveImage* image = s_imageCache[i];
+			if (image->state == SIMG_DECODING || (prefetch && image->state == SIMG_QUEUED)) { continue; }
+			if (prefetch && s_imageUse - image->lastUse < 2 * SAVE_IMAGE_CACHE_SIZE) { continue; }
+			if (!oldest || s_imageUse - image->lastUse > s_imageUse - oldest->lastUse)
+			{
+				oldest = image;
+			}
+		}
+		if (oldest && oldest->state == SIMG_QUEUED)
+		{
+			for (std::deque<SaveImage*>::iterator iImage = s_imageQueue.begin(); iImage != s_imageQueue.end(); ++iImage)
+			{
+				if (*iImage == oldest)
+				{
+					s_imageQueue.erase(iImage);
+					break;
+				}
+			}
+		}
+		return oldest;
+	}
+
+	const u32* getSaveImage(const SaveHeader* header, bool prefetch)
+	{
+		char filePath[TFE_MAX_PATH];
+		sprintf(filePath, "%s%s", s_gameSavePath, header->fileName);
+		s_imageUse++;
+
+		lockImages();
+		SaveImage* image = nullptr;
+		for (size_t i = 0; i < s_imageCache.size(); i++)
+		{
+			SaveImage* cached = s_imageCache[i];
+			if (cached->modTime == header->modTime && cached->offset == header->imageOffset && cached->size == header->imageSize &&
+				strcasecmp(cached->filePath, filePath) == 0)
+			{
+				image = cached;
+				break;
+			}
+		}
+
+		if (image)
+		{
+			// Move direct requests ahead of any prefetches.
+			if (!prefetch && image->state == SIMG_QUEUED && s_imageQueue.front() != image)
+			{
+				for (std::deque<SaveImage*>::iterator iImage = s_imageQueue.begin(); iImage != s_imageQueue.end(); ++iImage)
+				{
+					if (*iImage == image)
+					{
+						s_imageQueue.erase(iImage);
+						break;
+					}
+				}
+				s_imageQueue.push_front(image);
+			}
+		}
+		else
+		{
+			image = allocSaveImage(prefetch);
+			if (!image)
+			{
+				unlockImages();
+				return nullptr;
+			}
+
+			strcpy(image->filePath, filePath);
+			image->modTime = header->modTime;
+			image->offset = header->imageOffset;
+			image->size = header->imageSize;
+			image->state = SIMG_QUEUED;
+			if (s_imageThread)
+			{
+				if (prefetch) { s_imageQueue.push_back(image); }
+				else { s_imageQueue.push_front(image); }
+				SDL_CondSignal(s_imageCond);
+			}
+			else
+			{
+				image->state = decodeSaveImage(image) ? SIMG_READY : SIMG_FAILED;
+			}
+		}
+		image->lastUse = s_imageUse;
+		const SaveImageState state = image->state;
+		unlockImages();
+
+		return state == SIMG_READY ? image->pixels : nullptr;
+	}
+
 	void init()
 	{
+		FileWriterAsync::init();
+
+		CVAR_BOOL(s_snapshotsEnabled, "g_snapshots", CVFLAG_DO_NOT_SERIALIZE, "Periodically keep the game state in memory so it can be rewound.");
+		CVAR_FLOAT(s_snapshotInterval, "g_snapshotInterval", CVFLAG_DO_NOT_SERIALIZE, "Seconds between game state snapshots.");
+		CVAR_INT(s_snapshotMemoryMB, "g_snapshotMemoryMB", CVFLAG_DO_NOT_SERIALIZE, "Memory budget for game state snapshots in MB, the oldest snapshots are dropped first.");
+		CCMD("rewind", console_rewind, 0, "Restore the game state from memory - rewind [seconds, default 5]");
+		CCMD("snapshotStats", console_snapshotStats, 0, "Print the snapshot count and memory use.");
+
+		s_imageMutex = SDL_CreateMutex();
+		s_imageCond = SDL_CreateCond();
+		if (s_imageMutex && s_imageCond)
+		{
+			s_runImageThread = true;
+			s_imageThread = SDL_CreateThread(imageThreadFunc, "TFE_SaveImageThread", nullptr);
+		}
+		if (!s_imageThread)
+		{
+			s_runImageThread = false;
+			TFE_System::logWrite(LOG_WARNING, "Save", "Cannot create the save image thread, images will be decoded synchronously.");
+		}
 	}
 
 	void destroy()
 	{
-		for (s32 i = 0; i < 2; i++)
+		// Make sure any pending saves are written before exiting.
+		FileWriterAsync::destroy();
+		s_saveStream.clear();
+
+		if (s_imageThread)
+		{
+			SDL_LockMutex(s_imageMutex);
+			s_runImageThread = false;
+			SDL_CondSignal(s_imageCond);
+			SDL_UnlockMutex(s_imageMutex);
+			SDL_WaitThread(s_imageThread, nullptr);
+			s_imageThread = nullptr;
+		}
+		if (s_imageCond) { SDL_DestroyCond(s_imageCond); }
+		if (s_imageMutex) { SDL_DestroyMutex(s_imageMutex); }
+		s_imageCond = nullptr;
+		s_imageMutex = nullptr;
+
+		s_imageQueue.clear();
+		for (size_t i = 0; i < s_imageCache.size(); i++)
+		{
+			delete s_imageCache[i];
+		}
+		s_imageCache.clear();
+
+		TFE_Snapshot::clear();
+		s_snapshotStream.clear();
+		s_quickSaveState.clear();
+	}
+
+	// Runs on the file writer thread.
+	// Inserts the screenshot after the header: PNG size, PNG data.
+	// Then replaces the game state with: uncompressed size, compressed size, compressed data.
+	bool compressSaveData(std::vector<u8>& buffer, void* userData)
+	{
+		SaveWriteRequest* request = (SaveWriteRequest*)userData;
+		const u32 headerSize = request->headerSize;
+		if (buffer.size() < headerSize) { return false; }
+
+		// The encoded image is never larger than the raw thumbnail.
+		std::vector<u8> png(SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT * sizeof(u32));
+		u32 pngSize = 0;
+		if (!request->image.empty())
+		{
+			pngSize = (u32)TFE_Image::writeImageToMemory(png.data(), request->imageWidth, request->imageHeight,
+								 SAVE_IMAGE_WIDTH, SAVE_IMAGE_HEIGHT, request->image.data());
+		}
+		request->header.imageOffset = headerSize + sizeof(u32);
+		request->header.imageSize = pngSize;
+		const size_t stateOffset = headerSize + sizeof(u32) + pngSize;
+
+		const mz_ulong srcSize = mz_ulong(buffer.size() - headerSize);
+		mz_ulong dstSize = mz_compressBound(srcSize);
+		std::vector<u8> output(stateOffset + 2 * sizeof(u32) + dstSize);
+		if (mz_compress2(output.data() + stateOffset + 2 * sizeof(u32), &dstSize, buffer.data() + headerSize, srcSize, MZ_BEST_SPEED) != MZ_OK)
+		{
+			return false;
+		}
+
+		const u32 sizes[] = { u32(srcSize), u32(dstSize) };
+		memcpy(output.data(), buffer.data(), headerSize);
+		memcpy(output.data() + headerSize, &pngSize, sizeof(u32));
+		memcpy(output.data() + headerSize + sizeof(u32), png.data(), pngSize);
+		memcpy(output.data() + stateOffset, sizes, 2 * sizeof(u32));
+		output.resize(stateOffset + 2 * sizeof(u32) + dstSize);
+		buffer.swap(output);
+		return true;
+	}
+
+	// Called on the main thread once the save has been written.
+	void saveWriteComplete(size_t bytesWritten, void* userData, u32 errorCode)
+	{
+		SaveWriteRequest* request = (SaveWriteRequest*)userData;
+		if (errorCode == AFW_SUCCESS)
 		{
-			free(s_imageBuffer[i]);
-			s_imageBufferSize[i] = 0;
+			const f64 timeMs = (TFE_System::getTime() - request->startTime) * 1000.0;
+			TFE_System::logWrite(LOG_MSG, "Save", "Saved '%s', %u bytes in %0.2f ms (game state serialized in %0.2f ms).",
+				request->fileName, u32(bytesWritten), timeMs, request->serializeTime * 1000.0);
+
+			char filePath[TFE_MAX_PATH];
+			sprintf(filePath, "%s%s", s_gameSavePath, request->fileName);
+			request->header.modTime = FileUtil::getModifiedTime(filePath);
+			updateSaveIndex(&request->header);
+		}
+		else
+		{
+			TFE_System::logWrite(LOG_ERROR, "Save", "Failed to save '%s': %s.", request->fileName, FileWriterAsync::getErrorString(errorCode));
 		}
+		delete request;
 	}
 
 	bool saveGame(const char* filename, const char* saveName)
@@ -190,31 +719,132 @@ namespace TFE_SaveSystem
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
 
-		bool ret = false;
-		FileStream stream;
-		if (stream.open(filePath, Stream::MODE_WRITE))
+		// Serialize into memory on the game thread, compressing and writing the file is done by the async writer.
+		SaveWriteRequest* request = new SaveWriteRequest();
+		strcpy(request->fileName, filename);
+		request->startTime = TFE_System::getTime();
+		strcpy(request->header.fileName, filename);
+
+		s_saveStream.clear();
+		s_saveStream.open(Stream::MODE_WRITE);
+		saveHeader(&s_saveStream, saveName, request);
+		fixupSaveName(&request->header, filename);
+		request->headerSize = (u32)s_saveStream.getLoc();
+		const f64 serializeStart = TFE_System::getTime();
+		bool ret = s_game->serializeGameState(&s_saveStream, filename, true);
+		request->serializeTime = TFE_System::getTime() - serializeStart;
+		s_saveStream.close();
+
+		if (ret && strcasecmp(filename, c_quickSaveName) == 0)
 		{
-			saveHeader(&stream, saveName);
-			ret = s_game->serializeGameState(&stream, filename, true);
-			stream.close();
+			const u8* data = (const u8*)s_saveStream.data();
+			s_quickSaveState.assign(data + request->headerSize, data + s_saveStream.getSize());
+		}
+		if (ret)
+		{
+			ret = FileWriterAsync::writeFileToDisk(filePath, (const u8*)s_saveStream.data(), s_saveStream.getSize(), saveWriteComplete, request, compressSaveData);
+		}
+		if (!ret)
+		{
+			delete request;
+		}
+		return ret;
+	}
+
+	// Restore a snapshot or the last quicksave without touching the disk.
+	bool loadGameFromMemory(const char* filename)
+	{
+		const f64 startTime = TFE_System::getTime();
+		if (strcasecmp(filename, c_snapshotLoadName) == 0)
+		{
+			const s32 index = s_snapshotLoadIndex;
+			s_snapshotLoadIndex = -1;
+			if (!TFE_Snapshot::restore(index, &s_saveStream, true)) { return false; }
+		}
+		else if (!s_saveStream.load(s_quickSaveState.size(), s_quickSaveState.data()))
+		{
+			return false;
+		}
+
+		s_saveStream.open(Stream::MODE_READ);
+		const bool ret = s_game->serializeGameState(&s_saveStream, filename, false);
+		s_saveStream.close();
+
+		// Restoring the quicksave abandons the current timeline, only snapshot restores keep it.
+		if (strcasecmp(filename, c_snapshotLoadName) != 0)
+		{
+			TFE_Snapshot::clear();
+		}
+		s_lastSnapshotTime = TFE_System::getTime();
+		if (ret)
+		{
+			TFE_System::logWrite(LOG_MSG, "Save", "Restored '%s' from memory in %0.2f ms.", filename, (s_lastSnapshotTime - startTime) * 1000.0);
 		}
 		return ret;
 	}
 
 	bool loadGame(const char* filename)
 	{
+		if (strcasecmp(filename, c_snapshotLoadName) == 0 || (strcasecmp(filename, c_quickSaveName) == 0 && !s_quickSaveState.empty()))
+		{
+			return loadGameFromMemory(filename);
+		}
+
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		// The save may still be in the process of being written.
+		FileWriterAsync::flush();
 
 		bool ret = false;
+		const f64 startTime = TFE_System::getTime();
 		FileStream stream;
 		if (stream.open(filePath, Stream::MODE_READ))
 		{
 			SaveHeader header;
-			loadHeader(&stream, &header, filename);
-			ret = s_game->serializeGameState(&stream, filename, false);
+			const u32 version = loadHeader(&stream, &header, filename);
+			if (version >= SVER_COMPRESSED)
+			{
+				u32 sizes[2] = { 0 };
+				stream.read(sizes, 2);
+				// Validate the sizes before allocating anything so a corrupt file is reported rather than exhausting memory.
+				const u32 remaining = u32(stream.getSize() - stream.getLoc());
+				const bool validSizes = sizes[0] && sizes[0] <= SAVE_MAX_STATE_SIZE && sizes[1] && sizes[1] <= remaining;
+				std::vector<u8> compressed(validSizes ? sizes[1] : 0);
+				const bool readAll = validSizes && stream.readBuffer(compressed.data(), sizes[1]) == sizes[1];
+
+				mz_ulong dstSize = sizes[0];
+				if (readAll && s_saveStream.allocate(sizes[0]) &&
+					mz_uncompress((u8*)s_saveStream.data(), &dstSize, compressed.data(), sizes[1]) == MZ_OK && dstSize == sizes[0])
+				{
+					s_saveStream.open(Stream::MODE_READ);
+					ret = s_game->serializeGameState(&s_saveStream, filename, false);
+					s_saveStream.close();
+				}
+				else
+				{
+					TFE_System::logWrite(LOG_ERROR, "Save", "Cannot decompress save game '%s', the file is corrupt.", filename);
+				}
+			}
+			else
+			{
+				// Older saves are not compressed, read the game state in one go instead of field by field from the file.
+				const u32 size = u32(stream.getSize() - stream.getLoc());
+				if (size && s_saveStream.allocate(size) && stream.readBuffer(s_saveStream.data(), size) == size)
+				{
+					s_saveStream.open(Stream::MODE_READ);
+					ret = s_game->serializeGameState(&s_saveStream, filename, false);
+					s_saveStream.close();
+				}
+			}
 			stream.close();
 		}
+		if (ret)
+		{
+			TFE_System::logWrite(LOG_MSG, "Save", "Loaded '%s' in %0.2f ms.", filename, (TFE_System::getTime() - startTime) * 1000.0);
+		}
+		// The snapshots belong to the game that was replaced.
+		TFE_Snapshot::clear();
+		s_lastSnapshotTime = TFE_System::getTime();
 		return ret;
 	}
 
@@ -222,6 +852,7 @@ namespace TFE_SaveSystem
 	{
 		char filePath[TFE_MAX_PATH];
 		sprintf(filePath, "%s%s", s_gameSavePath, filename);
+		FileWriterAsync::flush();
 
 		bool ret = false;
 		FileStream stream;
@@ -229,6 +860,7 @@ namespace TFE_SaveSystem
 		{
 			loadHeader(&stream, header, filename);
 			strcpy(header->fileName, filename);
+			header->modTime = FileUtil::getModifiedTime(filePath);
 			stream.close();
 			ret = true;
 		}
@@ -284,6 +916,14 @@ namespace TFE_SaveSystem
 
 	void setCurrentGame(GameID id)
 	{
+		// Games are re-created when loading, so only drop the in-memory states when the game changes.
+		if (id != s_snapshotGame)
+		{
+			TFE_Snapshot::clear();
+			s_quickSaveState.clear();
+			s_snapshotGame = id;
+		}
+
 		char relativeBasePath[TFE_MAX_PATH];
 		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, "Saves/", relativeBasePath);
 		if (!FileUtil::directoryExits(s_gameSavePath))
@@ -307,10 +947,65 @@ namespace TFE_SaveSystem
 		setCurrentGame(game->id);
 	}
 
+	void captureSnapshot(f64 time)
+	{
+		s_snapshotStream.clear();
+		s_snapshotStream.open(Stream::MODE_WRITE);
+		const bool ret = s_game->serializeGameState(&s_snapshotStream, nullptr, true);
+		s_snapshotStream.close();
+
+		if (ret)
+		{
+			TFE_Snapshot::setMemoryBudget(size_t(max(s_snapshotMemoryMB, 1)) << 20);
+			TFE_Snapshot::add((const u8*)s_snapshotStream.data(), (u32)s_snapshotStream.getSize(), s_snapshotStream.getCapacity(), time);
+		}
+		s_snapshotCaptureTime = TFE_System::getTime() - time;
+		s_lastSnapshotTime = time;
+	}
+
+	bool rewind(f32 seconds)
+	{
+		if (!s_game || TFE_Snapshot::getCount() < 1) { return false; }
+		s_snapshotLoadIndex = TFE_Snapshot::findByAge(seconds, TFE_System::getTime());
+		postLoadRequest(c_snapshotLoadName);
+		return true;
+	}
+
+	void console_rewind(const ConsoleArgList& args)
+	{
+		const f32 seconds = args.size() > 1 ? TFE_Console::getFloatArg(args[1]) : 5.0f;
+		if (!rewind(seconds))
+		{
+			TFE_Console::addToHistory("There are no snapshots to rewind to.");
+		}
+	}
+
+	void console_snapshotStats(const ConsoleArgList& args)
+	{
+		TFE_Snapshot::SnapshotStats stats;
+		TFE_Snapshot::getStats(&stats);
+
+		char res[256];
+		sprintf(res, "Snapshots: %d covering %0.1f seconds, %0.2f MB used of %0.2f MB.", stats.count, stats.newestTime - stats.oldestTime,
+			f64(stats.memoryUsed) / (1024.0 * 1024.0), f64(stats.memoryBudget) / (1024.0 * 1024.0));
+		TFE_Console::addToHistory(res);
+		sprintf(res, "Last capture: %u byte state, %u byte delta, %0.2f ms. Quicksave in memory: %u bytes.", stats.lastStateSize,
+			stats.lastDeltaSize, s_snapshotCaptureTime * 1000.0, u32(s_quickSaveState.size()));
+		TFE_Console::addToHistory(res);
+	}
+
 	void update()
 	{
+		// Report finished saves.
+		FileWriterAsync::update();
 		if (!s_game) { return; }
 
+		const f64 time = TFE_System::getTime();
+		if (s_snapshotsEnabled && s_game->canSave() && !s_game->isPaused() && time - s_lastSnapshotTime >= s_snapshotInterval)
+		{
+			captureSnapshot(time);
+		}
+
 		static s32 lastState = 0;
 		const char* saveFilename = saveRequestFilename();
 
@@ -1,6 +1,17 @@
 #pragma once
 //////////////////////////////////////////////////////////////////////
 // Shared save/load functionality used  by all games.
+//
+// The save directory keeps a small index (saves.idx) with the header
+// of every save and where its screenshot is stored, so listing the
+// saves only has to parse files that were added or changed since the
+// index was written. Screenshots are decoded on a worker thread when
+// they are first requested by the UI.
+//
+// While a game is running its state is also captured into an
+// in-memory snapshot ring (see snapshotRing.h) every few seconds and
+// the last quicksave is kept in memory, so quickload and "rewind"
+// do not read from the disk.
 //////////////////////////////////////////////////////////////////////
 #include "igame.h"
 #include <TFE_Asset/imageAsset.h>
@@ -21,7 +32,9 @@ namespace TFE_SaveSystem
 		char dateTime[256];
 		char levelName[256];
 		char modNames[256];
-		u32  imageData[SAVE_IMAGE_WIDTH * SAVE_IMAGE_HEIGHT];
+		u64  modTime;		// file modification time when the header was read.
+		u32  imageOffset;	// location of the PNG screenshot in the file.
+		u32  imageSize;
 	};
 
 	void init();
@@ -41,6 +54,11 @@ namespace TFE_SaveSystem
 	const char* saveRequestFilename();
 
 	void getSaveFilenameFromIndex(s32 index, char* name);
+	// Restore the in-memory snapshot taken at least 'seconds' ago (or the oldest one), returns false if there are none.
+	bool rewind(f32 seconds);
 
 	void populateSaveDirectory(std::vector<SaveHeader>& dir);
+	// Returns the screenshot (SAVE_IMAGE_WIDTH x SAVE_IMAGE_HEIGHT) if it has been decoded, otherwise queues it and returns null.
+	// Prefetch requests are decoded after any other pending request. The image is valid until the next call.
+	const u32* getSaveImage(const SaveHeader* header, bool prefetch = false);
 }
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include "snapshotRing.h"
+#include <TFE_FileSystem/memorystream.h>
+#include <TFE_System/system.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace TFE_Snapshot
+{
+	enum SnapshotConst : u32
+	{
+		// Size of the blocks the base state is indexed in, matches shorter than this are stored as literals.
+		SNAPSHOT_BLOCK_SIZE = 32,
+		SNAPSHOT_HASH_MUL = 0x01000193,
+		SNAPSHOT_MIN_TABLE_SIZE = 1024,
+	};
+
+	struct Snapshot
+	{
+		f64 time;
+		u32 size;				// size of the full state.
+		std::vector<u8> delta;	// rebuilds this state from the next newer one, empty for the newest snapshot.
+	};
+
+	static std::deque<Snapshot> s_snapshots;	// front = newest.
+	static std::vector<u8> s_newest;			// full state of the newest snapshot.
+	static std::vector<u8> s_work[2];			// only allocated while restoring.
+	static std::vector<u32> s_blockTable;		// base block index + 1 by block hash, 0 = empty.
+	static size_t s_deltaBytes = 0;
+	static size_t s_captureBytes = 0;
+	static size_t s_memoryBudget = 32 * 1024 * 1024;
+	static u32 s_lastDeltaSize = 0;
+
+	static size_t getMemoryUsed()
+	{
+		return s_newest.capacity() + s_deltaBytes + s_work[0].capacity() + s_work[1].capacity() +
+			s_blockTable.capacity() * sizeof(u32) + s_captureBytes;
+	}
+
+	static void appendU32(std::vector<u8>& out, u32 value)
+	{
+		const size_t offset = out.size();
+		out.resize(offset + sizeof(u32));
+		memcpy(out.data() + offset, &value, sizeof(u32));
+	}
+
+	static void appendOp(std::vector<u8>& out, const u8* literal, u32 literalLength, u32 copyOffset, u32 copyLength)
+	{
+		appendU32(out, literalLength);
+		out.insert(out.end(), literal, literal + literalLength);
+		appendU32(out, copyOffset);
+		appendU32(out, copyLength);
+	}
+
+	static u32 hashBlock(const u8* data)
+	{
+		u32 hash = 0;
+		for (u32 i = 0; i < SNAPSHOT_BLOCK_SIZE; i++)
+		{
+			hash = hash * SNAPSHOT_HASH_MUL + data[i];
+		}
+		return hash;
+	}
+
+	static u32 getTableSlot(u32 hash, u32 mask)
+	{
+		return (hash ^ (hash >> 15)) & mask;
+	}
+
+	// Encode 'target' as literals and copies from anywhere in 'base':
+	// targetSize, then { literalLength, literal bytes, copyOffset, copyLength } until the target is complete.
+	static void encodeDelta(const u8* target, u32 targetSize, const u8* base, u32 baseSize, std::vector<u8>& out)
+	{
+		out.clear();
+		appendU32(out, targetSize);
+
+		// Index the aligned blocks of the base, later blocks replace earlier ones with the same slot.
+		const u32 blockCount = baseSize / SNAPSHOT_BLOCK_SIZE;
+		u32 tableSize = SNAPSHOT_MIN_TABLE_SIZE;
+		while (tableSize < blockCount * 2) { tableSize <<= 1; }
+		const u32 mask = tableSize - 1;
+		s_blockTable.assign(tableSize, 0);
+		for (u32 b = 0; b < blockCount; b++)
+		{
+			s_blockTable[getTableSlot(hashBlock(base + b * SNAPSHOT_BLOCK_SIZE), mask)] = b + 1;
+		}
+
+		// Factor that removes the oldest byte from the rolling hash.
+		u32 outFactor = 1;
+		for (u32 i = 1; i < SNAPSHOT_BLOCK_SIZE; i++) { outFactor *= SNAPSHOT_HASH_MUL; }
+
+		u32 literalStart = 0;
+		u32 pos = 0;
+		u32 hash = targetSize >= SNAPSHOT_BLOCK_SIZE ? hashBlock(target) : 0;
+		while (pos + SNAPSHOT_BLOCK_SIZE <= targetSize)
+		{
+			const u32 block = s_blockTable[getTableSlot(hash, mask)];
+			const u32 baseOffset = block ? (block - 1) * SNAPSHOT_BLOCK_SIZE : 0;
+			if (block && memcmp(target + pos, base + baseOffset, SNAPSHOT_BLOCK_SIZE) == 0)
+			{
+				// Grow the match in both directions, backwards only into the pending literal.
+				u32 start = pos, baseStart = baseOffset;
+				while (start > literalStart && baseStart > 0 && target[start - 1] == base[baseStart - 1]) { start--; baseStart--; }
+				u32 end = pos + SNAPSHOT_BLOCK_SIZE, baseEnd = baseOffset + SNAPSHOT_BLOCK_SIZE;
+				while (end < targetSize && baseEnd < baseSize && target[end] == base[baseEnd]) { end++; baseEnd++; }
+
+				appendOp(out, target + literalStart, start - literalStart, baseStart, end - start);
+				pos = end;
+				literalStart = end;
+				if (pos + SNAPSHOT_BLOCK_SIZE <= targetSize) { hash = hashBlock(target + pos); }
+				continue;
+			}
+
+			if (pos + SNAPSHOT_BLOCK_SIZE < targetSize)
+			{
+				hash = (hash - target[pos] * outFactor) * SNAPSHOT_HASH_MUL + target[pos + SNAPSHOT_BLOCK_SIZE];
+			}
+			pos++;
+		}
+		if (literalStart < targetSize)
+		{
+			appendOp(out, target + literalStart, targetSize - literalStart, 0, 0);
+		}
+	}
+
+	static bool decodeDelta(const std::vector<u8>& delta, const std::vector<u8>& base, std::vector<u8>& out)
+	{
+		const u8* src = delta.data();
+		const u8* srcEnd = src + delta.size();
+		if (delta.size() < sizeof(u32)) { return false; }
+
+		u32 targetSize;
+		memcpy(&targetSize, src, sizeof(u32));
+		src += sizeof(u32);
+		out.resize(targetSize);
+
+		u32 pos = 0;
+		while (pos < targetSize)
+		{
+			u32 literalLen;
+			if (size_t(srcEnd - src) < sizeof(u32)) { return false; }
+			memcpy(&literalLen, src, sizeof(u32));
+			src += sizeof(u32);
+			if (size_t(srcEnd - src) < size_t(literalLen) + 2 * sizeof(u32) || size_t(pos) + literalLen > targetSize) { return false; }
+			memcpy(out.data() + pos, src, literalLen);
+			pos += literalLen;
+			src += literalLen;
+
+			u32 copyOffset, copyLen;
+			memcpy(&copyOffset, src, sizeof(u32));
+			memcpy(&copyLen, src + sizeof(u32), sizeof(u32));
+			src += 2 * sizeof(u32);
+			if (size_t(copyOffset) + copyLen > base.size() || size_t(pos) + copyLen > targetSize)
+			{
+				return false;
+			}
+			memcpy(out.data() + pos, base.data() + copyOffset, copyLen);
+			pos += copyLen;
+		}
+		return true;
+	}
+
+	static void enforceBudget()
+	{
+		while (s_snapshots.size() > 1 && getMemoryUsed() > s_memoryBudget)
+		{
+			s_deltaBytes -= s_snapshots.back().delta.size();
+			s_snapshots.pop_back();
+		}
+	}
+
+	static void releaseWork()
+	{
+		for (s32 i = 0; i < 2; i++)
+		{
+			s_work[i].clear();
+			s_work[i].shrink_to_fit();
+		}
+	}
+
+	void clear()
+	{
+		s_snapshots.clear();
+		s_newest.clear();
+		s_newest.shrink_to_fit();
+		s_blockTable.clear();
+		s_blockTable.shrink_to_fit();
+		releaseWork();
+		s_deltaBytes = 0;
+		s_captureBytes = 0;
+		s_lastDeltaSize = 0;
+	}
+
+	void setMemoryBudget(size_t bytes)
+	{
+		s_memoryBudget = bytes;
+		enforceBudget();
+	}
+
+	void add(const u8* state, u32 size, size_t captureBytes, f64 time)
+	{
+		s_captureBytes = captureBytes;
+		if (!s_snapshots.empty())
+		{
+			// The current newest snapshot is now stored relative to the new state.
+			Snapshot& prev = s_snapshots.front();
+			encodeDelta(s_newest.data(), prev.size, state, size, prev.delta);
+			prev.delta.shrink_to_fit();
+			s_deltaBytes += prev.delta.size();
+			s_lastDeltaSize = (u32)prev.delta.size();
+		}
+
+		Snapshot snapshot;
+		snapshot.time = time;
+		snapshot.size = size;
+		s_snapshots.push_front(snapshot);
+		s_newest.assign(state, state + size);
+		enforceBudget();
+	}
+
+	s32 getCount()
+	{
+		return (s32)s_snapshots.size();
+	}
+
+	s32 findByAge(f64 seconds, f64 time)
+	{
+		const s32 count = (s32)s_snapshots.size();
+		for (s32 i = 0; i < count; i++)
+		{
+			if (time - s_snapshots[i].time >= seconds) { return i; }
+		}
+		return count - 1;
+	}
+
+	bool restore(s32 index, MemoryStream* stream, bool truncate)
+	{
+		if (index < 0 || index >= (s32)s_snapshots.size()) { return false; }
+
+		// Walk back from the newest state one delta at a time.
+		const std::vector<u8>* cur = &s_newest;
+		s32 workIndex = 0;
+		for (s32 i = 1; i <= index; i++)
+		{
+			std::vector<u8>& next = s_work[workIndex];
+			if (!decodeDelta(s_snapshots[i].delta, *cur, next))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Snapshot", "Snapshot %d is corrupt and cannot be restored.", i);
+				releaseWork();
+				return false;
+			}
+			cur = &next;
+			workIndex ^= 1;
+		}
+
+		const u32 size = (u32)cur->size();
+		if (!size || !stream->allocate(size))
+		{
+			releaseWork();
+			return false;
+		}
+		memcpy(stream->data(), cur->data(), size);
+
+		if (truncate && index > 0)
+		{
+			if (cur != &s_newest) { s_newest.swap(s_work[workIndex ^ 1]); }
+			for (s32 i = 0; i < index; i++)
+			{
+				s_deltaBytes -= s_snapshots.front().delta.size();
+				s_snapshots.pop_front();
+			}
+			s_deltaBytes -= s_snapshots.front().delta.size();
+			s_snapshots.front().delta.clear();
+			s_snapshots.front().delta.shrink_to_fit();
+		}
+		releaseWork();
+		return true;
+	}
+
+	void getStats(SnapshotStats* stats)
+	{
+		stats->count = (s32)s_snapshots.size();
+		stats->memoryUsed = getMemoryUsed();
+		stats->memoryBudget = s_memoryBudget;
+		stats->lastStateSize = (u32)s_newest.size();
+		stats->lastDeltaSize = s_lastDeltaSize;
+		stats->oldestTime = s_snapshots.empty() ? 0.0 : s_snapshots.back().time;
+		stats->newestTime = s_snapshots.empty() ? 0.0 : s_snapshots.front().time;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Snapshot ring
+// Keeps recent serialized game states in memory so the game can be
+// rewound without reading save files from disk.
+//
+// Only the newest snapshot is stored in full. Each older snapshot is
+// stored as a delta against the next newer one. The newer state is
+// indexed in fixed size blocks and a rolling hash finds the blocks in
+// the older state wherever they moved to, so objects or tasks added
+// or removed early in the state do not turn the rest into literals.
+// Restoring a snapshot applies the deltas from the newest state
+// backwards, and the oldest snapshots are dropped first when the ring
+// goes over its memory budget. The budget includes the work buffers
+// and the caller's capture buffer.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+class MemoryStream;
+
+namespace TFE_Snapshot
+{
+	struct SnapshotStats
+	{
+		s32 count;
+		size_t memoryUsed;		// full newest state + deltas + work and capture buffers.
+		size_t memoryBudget;
+		u32 lastStateSize;
+		u32 lastDeltaSize;		// delta stored for the previous snapshot when the last one was added.
+		f64 oldestTime;
+		f64 newestTime;
+	};
+
+	void clear();
+	void setMemoryBudget(size_t bytes);
+
+	// Add a serialized game state as the newest snapshot, 'time' is the capture time in seconds.
+	// 'captureBytes' is the memory the caller keeps to serialize the state, which counts toward the budget.
+	void add(const u8* state, u32 size, size_t captureBytes, f64 time);
+	s32  getCount();
+	// Snapshot 0 is the newest. Returns the newest snapshot captured at least 'seconds' before 'time',
+	// or the oldest snapshot if none are that old; -1 if the ring is empty.
+	s32  findByAge(f64 seconds, f64 time);
+	// Rebuild snapshot 'index' into 'stream', which is left closed. If 'truncate' is true the
+	// newer snapshots are discarded so the restored state becomes the newest.
+	bool restore(s32 index, MemoryStream* stream, bool truncate);
+
+	void getStats(SnapshotStats* stats);
+}
@@ -124,6 +124,14 @@ namespace TFE_Input
 		s_mouseMoveAccum[1] += y;
 	}
 
+	void addRelativeMousePos(s32 x, s32 y)
+	{
+		s_mouseMove[0] += x;
+		s_mouseMove[1] += y;
+		s_mouseMoveAccum[0] += x;
+		s_mouseMoveAccum[1] += y;
+	}
+
 	void setMousePos(s32 x, s32 y)
 	{
 		s_mousePos[0] = x;
@@ -33,6 +33,8 @@ namespace TFE_Input
 	void setMouseWheel(s32 dx, s32 dy);
 
 	void setRelativeMousePos(s32 x, s32 y);
+	// Add to the relative mouse movement for this frame, used when input is polled more than once per frame.
+	void addRelativeMousePos(s32 x, s32 y);
 	void setMousePos(s32 x, s32 y);
 
 	void enableRelativeMode(bool enable);
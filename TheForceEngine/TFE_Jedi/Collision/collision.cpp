@@ -6,6 +6,7 @@
 #include <TFE_Jedi/Level/rtexture.h>
 #include <TFE_Jedi/Math/core_math.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
+#include "objectGrid.h"
 // Merge player collision into collision
 #include <TFE_DarkForces/playerCollision.h>
 using namespace TFE_DarkForces;
@@ -348,6 +349,7 @@ namespace TFE_Jedi
 		{
 			obj->posWS.x = x1;
 			obj->posWS.z = z1;
+			objGrid_updateObject(obj);
 			if (newSector != sector)
 			{
 				sector_addObject(newSector, obj);
@@ -432,6 +434,33 @@ namespace TFE_Jedi
 		return (sector == sector1) ? JTRUE : JFALSE;
 	}
 
+	static bool collision_isObjectInBox(const SecObject* obj, const SecObject* excludeObj, u32 entityFlags, fixed16_16 x0, fixed16_16 y0, fixed16_16 z0, fixed16_16 x1, fixed16_16 y1, fixed16_16 z1)
+	{
+		if (excludeObj && excludeObj == obj) { return false; }
+		if (!(obj->entityFlags & entityFlags)) { return false; }
+		return obj->posWS.x >= x0 && obj->posWS.x <= x1 && obj->posWS.z >= z0 && obj->posWS.z <= z1 && obj->posWS.y >= y0 && obj->posWS.y <= y1;
+	}
+
+	// Follow the XZ path from the origin to the object, stopping at openings smaller than 0.5 units.
+	static JBool collision_isObjectReachableXZ(RSector* startSector, vec3_fixed origin, SecObject* obj)
+	{
+		RSector* curSector = startSector;
+		RWall* hitWall = collision_wallCollisionFromPath(startSector, origin.x, origin.z, obj->posWS.x, obj->posWS.z);
+		while (hitWall && curSector && curSector != obj->sector)
+		{
+			curSector = hitWall->nextSector;
+			if (curSector)
+			{
+				if (curSector->floorHeight - curSector->ceilingHeight < HALF_16)
+				{
+					break;
+				}
+				hitWall = collision_pathWallCollision(curSector);
+			}
+		}
+		return (curSector == obj->sector) ? JTRUE : JFALSE;
+	}
+
 	// Determines if an object with the correct entityFlag(s) is in range (radius) of (x,y,z) in sector and is not skipObj.
 	// Note only objects with a clear line-of-sight are accepted.
 	JBool collision_isAnyObjectInRange(RSector* sector, fixed16_16 radius, vec3_fixed origin, SecObject* skipObj, u32 entityFlags)
@@ -449,61 +478,42 @@ namespace TFE_Jedi
 		fixed16_16 y1 = origin.y + radius;
 		fixed16_16 z1 = origin.z + radius;
 
-		fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* curSector = s_levelState.sectors;
-
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, curSector++)
+		// These tests only depend on the start sector, so they are done once instead of once per sector.
+		if (x0 > sector->boundsMax.x || x1 < sector->boundsMin.x || z0 > sector->boundsMax.z || z1 < sector->boundsMin.z)
 		{
-			///////////////////////////////////////////////
-			// These tests should only happen once I think,
-			// unless x0, x1, z0, z1 change over time.
-			///////////////////////////////////////////////
-			if (x0 > sector->boundsMax.x || x1 < sector->boundsMin.x || z0 > sector->boundsMax.z || z1 < sector->boundsMin.z)
-			{
-				continue;
-			}
+			return JFALSE;
+		}
+		fixed16_16 floorHeight, ceilHeight;
+		sector_calculateFloor(sector, origin.y, &floorHeight, &ceilHeight);
+		if (floorHeight < y0 || ceilHeight > y1)
+		{
+			return JFALSE;
+		}
 
-			fixed16_16 floorHeight, ceilHeight;
-			sector_calculateFloor(sector, origin.y, &floorHeight, &ceilHeight);
-			if (floorHeight < y0 || ceilHeight > y1)
+		const ObjGridRef* refs;
+		s32 refCount;
+		if (objGrid_beginQuery(x0, z0, x1, z1, &refs, &refCount))
+		{
+			JBool inRange = JFALSE;
+			for (s32 r = 0; r < refCount && !inRange; r++)
 			{
-				continue;
+				SecObject* obj = objGrid_getObject(&refs[r]);
+				if (!obj || !collision_isObjectInBox(obj, skipObj, entityFlags, x0, y0, z0, x1, y1, z1)) { continue; }
+				inRange = collision_isObjectReachableXZ(sector, origin, obj);
 			}
-			/////////////////////////////////////////////
-			// End of checks to pull out of the loop.
-			/////////////////////////////////////////////
+			objGrid_endQuery();
+			return inRange;
+		}
 
-			s32 objCapacity = curSector->objectCapacity;
-			s32 objCount = curSector->objectCount;
-			for (s32 objListIndex = 0, objIndex = 0; objIndex < objCount && objListIndex < objCapacity; objListIndex++)
+		RSector* curSector = s_levelState.sectors;
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, curSector++)
+		{
+			SecObject** objList = curSector->objectList;
+			for (s32 objIndex = 0; objIndex < curSector->objectCount; objIndex++)
 			{
-				SecObject* obj = curSector->objectList[objListIndex];
-				if (!obj) { continue; }
-
-				objIndex++;
-				if (skipObj && skipObj == obj) { continue; }
-				if (!(obj->entityFlags & entityFlags)) { continue; }
-				if (obj->posWS.x < x0 || obj->posWS.x > x1 || obj->posWS.z < z0 || obj->posWS.z > z1 || obj->posWS.y < y0 || obj->posWS.y > y1)
-				{
-					continue;
-				}
-
-				RSector* curSector = sector;
-				RWall* hitWall = collision_wallCollisionFromPath(sector, origin.x, origin.z, obj->posWS.x, obj->posWS.z);
-				while (hitWall && curSector && curSector != obj->sector)
-				{
-					curSector = hitWall->nextSector;
-					if (curSector)
-					{
-						if (curSector->floorHeight - curSector->ceilingHeight < HALF_16)
-						{
-							break;
-						}
-						hitWall = collision_pathWallCollision(curSector);
-					}
-				}
-
-				if (curSector == obj->sector)
+				SecObject* obj = objList[objIndex];
+				if (!collision_isObjectInBox(obj, skipObj, entityFlags, x0, y0, z0, x1, y1, z1)) { continue; }
+				if (collision_isObjectReachableXZ(sector, origin, obj))
 				{
 					return JTRUE;
 				}
@@ -511,6 +521,17 @@ namespace TFE_Jedi
 		}
 		return JFALSE;
 	}
+
+	static JBool collision_canHitObject3D(RSector* startSector, vec3_fixed origin, SecObject* obj)
+	{
+		JBool canHit = collision_lineOfSight(startSector, obj->sector, origin, obj->posWS, WF3_CANNOT_FIRE_THROUGH);
+		if (!canHit)
+		{
+			vec3_fixed topPos = { obj->posWS.x, obj->posWS.y - obj->worldHeight, obj->posWS.z };
+			canHit = collision_lineOfSight(startSector, obj->sector, origin, topPos, WF3_CANNOT_FIRE_THROUGH);
+		}
+		return canHit;
+	}
 		
 	// Call the effectFunc() for each object within 'range' of point (x,y,z). This will only be called for objects in range and that have a valid collision path.
 	// Note the collision path is 3D (XYZ), in that it takes into account collision based on height.
@@ -524,49 +545,99 @@ namespace TFE_Jedi
 		const fixed16_16 y1 = origin.y + range;
 		const fixed16_16 z1 = origin.z + range;
 
-		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
+		// Checks the start sector, this does not change from sector to sector.
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
+		{
+			return;
+		}
+
+		// If an effect adds, removes or moves objects the query results are stale, so the rest of the objects
+		// are visited by the sector loops starting from where the query left off.
 		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		s32 objIndex = 0;
+
+		const ObjGridRef* refs;
+		s32 refCount;
+		if (objGrid_beginQuery(x0, z0, x1, z1, &refs, &refCount))
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
+			RSector* resumeSector = nullptr;
+			for (s32 r = 0; r < refCount; r++)
 			{
-				continue;
+				SecObject* obj = objGrid_getObject(&refs[r]);
+				if (!obj || !collision_isObjectInBox(obj, excludeObj, entityFlags, x0, y0, z0, x1, y1, z1)) { continue; }
+
+				fixed16_16 floor, ceil;
+				sector_calculateFloor(obj->sector, origin.y, &floor, &ceil);
+				if (y0 > floor || y1 < ceil) { continue; }
+
+				if (collision_canHitObject3D(startSector, origin, obj))
+				{
+					effectFunc(obj);
+					if (objGrid_queryChanged())
+					{
+						resumeSector = refs[r].sector;
+						objIndex = sector_nextObjectIndex(resumeSector, obj, refs[r].slot);
+						break;
+					}
+				}
 			}
+			objGrid_endQuery();
+			if (!resumeSector) { return; }
+			sector = resumeSector;
+		}
 
+		for (; sector < s_levelState.sectors + s_levelState.sectorCount; sector++, objIndex = 0)
+		{
 			fixed16_16 floor, ceil;
 			sector_calculateFloor(sector, origin.y, &floor, &ceil);
 			if (y0 > floor || y1 < ceil) { continue; }
-			// End of start sector check.
 
-			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
+			for (; objIndex < sector->objectCount; )
 			{
-				SecObject* obj = sector->objectList[objListIndex];
-				if (!obj) { continue; }
-				objIndex++;
-
-				if (excludeObj && excludeObj == obj) { continue; }
-				if (!(obj->entityFlags & entityFlags)) { continue; }
-				if (obj->posWS.x < x0 || obj->posWS.x > x1 || obj->posWS.z < z0 || obj->posWS.z > z1 || obj->posWS.y < y0 || obj->posWS.y > y1)
-				{
-					continue;
-				}
-								
-				JBool canHit = collision_lineOfSight(startSector, obj->sector, origin, obj->posWS, WF3_CANNOT_FIRE_THROUGH);
-				if (!canHit)
-				{
-					vec3_fixed topPos = { obj->posWS.x, obj->posWS.y - obj->worldHeight, obj->posWS.z };
-					canHit = collision_lineOfSight(startSector, obj->sector, origin, topPos, WF3_CANNOT_FIRE_THROUGH);
-				}
-				// Finally the object can be hit, so call the effect function.
-				if (canHit)
+				SecObject* obj = sector->objectList[objIndex];
+				// Call the effect function for objects in range that can be hit.
+				if (collision_isObjectInBox(obj, excludeObj, entityFlags, x0, y0, z0, x1, y1, z1) && collision_canHitObject3D(startSector, origin, obj))
 				{
 					effectFunc(obj);
 				}
+				// The effect may remove objects from the sector.
+				objIndex = sector_nextObjectIndex(sector, obj, objIndex);
 			}  // Object Loop.
 		}  // Sector loop.
 	}
 
+	static JBool collision_canReachObjectXZ(RSector* startSector, vec3_fixed origin, SecObject* obj)
+	{
+		fixed16_16 dx = obj->posWS.x - origin.x;
+		fixed16_16 dz = obj->posWS.z - origin.z;
+		RWall* hitWall = nullptr;
+		if (dx || dz)
+		{
+			s_col_path.x0 = origin.x;
+			s_col_path.z0 = origin.z;
+			s_col_path.x1 = obj->posWS.x;
+			s_col_path.z1 = obj->posWS.z;
+			s_collisionFrameWall++;
+			hitWall = collision_pathWallCollision(startSector);
+		}
+
+		RSector* nextSector = startSector;
+		while (hitWall && nextSector && nextSector != obj->sector)
+		{
+			nextSector = hitWall->nextSector;
+			if (nextSector)
+			{
+				const fixed16_16 height = nextSector->floorHeight - nextSector->ceilingHeight;
+				if (height < c_minTraversableOpening)
+				{
+					break;
+				}
+				hitWall = collision_pathWallCollision(nextSector);
+			}
+		}
+		return (nextSector == obj->sector) ? JTRUE : JFALSE;
+	}
+
 	// Call the effectFunc() for each object within 'range' of point (x,y,z). This will only be called for objects in range and that have a valid collision path.
 	// Note the collision path is 2D (XZ) but cannot pass through sectors with a gap smaller than 0.5 units.
 	void collision_effectObjectsInRangeXZ(RSector* startSector, fixed16_16 range, vec3_fixed origin, CollisionEffectFunc effectFunc, SecObject* excludeObj, u32 entityFlags)
@@ -584,69 +655,60 @@ namespace TFE_Jedi
 		const fixed16_16 y1 = origin.y + range;
 		const fixed16_16 z1 = origin.z + range;
 
-		const fixed16_16 secHeightThreshold = origin.y - COL_SEC_HEIGHT_OFFSET;
-		RSector* sector = s_levelState.sectors;
-		for (u32 i = 0; i < s_levelState.sectorCount; i++, sector++)
+		// Checks the start sector, this does not change from sector to sector.
+		if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
 		{
-			// Checks the start sector, should be pulled out of the loop.
-			if (x0 > startSector->boundsMax.x || x1 < startSector->boundsMin.x || z0 > startSector->boundsMax.z || z1 < startSector->boundsMin.z)
-			{
-				continue;
-			}
-			fixed16_16 floor, ceil;
-			sector_calculateFloor(startSector, origin.y, &floor, &ceil);
-			if (y0 > floor || y1 < ceil)
-			{
-				continue;
-			}
-			// End of start sector check.
-
-			for (s32 objIndex = 0, objListIndex = 0; objIndex < sector->objectCount && objListIndex < sector->objectCapacity; objListIndex++)
-			{
-				SecObject* obj = sector->objectList[objListIndex];
-				if (!obj) { continue; }
-				objIndex++;
-
-				if (excludeObj && excludeObj == obj) { continue; }
-				if (!(obj->entityFlags & entityFlags)) { continue; }
-				if (obj->posWS.x < x0 || obj->posWS.x > x1 || obj->posWS.z < z0 || obj->posWS.z > z1 || obj->posWS.y < y0 || obj->posWS.y > y1)
-				{
-					continue;
-				}
+			return;
+		}
+		fixed16_16 floor, ceil;
+		sector_calculateFloor(startSector, origin.y, &floor, &ceil);
+		if (y0 > floor || y1 < ceil)
+		{
+			return;
+		}
 
-				fixed16_16 dx = obj->posWS.x - origin.x;
-				fixed16_16 dz = obj->posWS.z - origin.z;
-				RWall* hitWall = nullptr;
-				if (dx || dz)
-				{
-					s_col_path.x0 = origin.x;
-					s_col_path.z0 = origin.z;
-					s_col_path.x1 = obj->posWS.x;
-					s_col_path.z1 = obj->posWS.z;
-					s_collisionFrameWall++;
-					hitWall = collision_pathWallCollision(startSector);
-				}
+		// See collision_effectObjectsInRange3D().
+		RSector* sector = s_levelState.sectors;
+		s32 objIndex = 0;
 
-				RSector* nextSector = startSector;
-				while (hitWall && nextSector && nextSector != obj->sector)
+		const ObjGridRef* refs;
+		s32 refCount;
+		if (objGrid_beginQuery(x0, z0, x1, z1, &refs, &refCount))
+		{
+			RSector* resumeSector = nullptr;
+			for (s32 r = 0; r < refCount; r++)
+			{
+				SecObject* obj = objGrid_getObject(&refs[r]);
+				if (!obj || !collision_isObjectInBox(obj, excludeObj, entityFlags, x0, y0, z0, x1, y1, z1)) { continue; }
+				// If there is a clear path from the source position to the object in range, call the specified function.
+				if (collision_canReachObjectXZ(startSector, origin, obj))
 				{
-					nextSector = hitWall->nextSector;
-					if (nextSector)
+					effectFunc(obj);
+					if (objGrid_queryChanged())
 					{
-						const fixed16_16 height = nextSector->floorHeight - nextSector->ceilingHeight;
-						if (height < c_minTraversableOpening)
-						{
-							break;
-						}
-						hitWall = collision_pathWallCollision(nextSector);
+						resumeSector = refs[r].sector;
+						objIndex = sector_nextObjectIndex(resumeSector, obj, refs[r].slot);
+						break;
 					}
 				}
+			}
+			objGrid_endQuery();
+			if (!resumeSector) { return; }
+			sector = resumeSector;
+		}
 
+		for (; sector < s_levelState.sectors + s_levelState.sectorCount; sector++, objIndex = 0)
+		{
+			for (; objIndex < sector->objectCount; )
+			{
+				SecObject* obj = sector->objectList[objIndex];
 				// If there is a clear path from the source position to the object in range, call the specified function.
-				if (nextSector == obj->sector)
+				if (collision_isObjectInBox(obj, excludeObj, entityFlags, x0, y0, z0, x1, y1, z1) && collision_canReachObjectXZ(startSector, origin, obj))
 				{
 					effectFunc(obj);
 				}
+				// The effect may remove objects from the sector.
+				objIndex = sector_nextObjectIndex(sector, obj, objIndex);
 			}  // Object Loop.
 		}  // Sector Loop.
 	}
@@ -790,6 +852,7 @@ namespace TFE_Jedi
 		// Update the object XZ position.
 		s_hcolObj->posWS.x = s_hcolDstPos.x;
 		s_hcolObj->posWS.z = s_hcolDstPos.z;
+		objGrid_updateObject(s_hcolObj);
 
 		// Determine the floor and ceiling height for the current sector based on the object position.
 		fixed16_16 floorHeight, ceilHeight;
@@ -954,8 +1017,6 @@ namespace TFE_Jedi
 		for (; s_colObjCount > 0; s_colObjList++)
 		{
 			SecObject* obj = *s_colObjList;
-			if (!obj) { continue; }
-
 			s_colObjCount--;
 			if (!obj->worldWidth || obj == s_colObjPrev) { continue; }
 
@@ -1037,6 +1098,210 @@ namespace TFE_Jedi
 		return (sector == endSector) ? JTRUE : JFALSE;
 	}
 
+	////////////////////////////////////////////////////////
+	// Read-only path collision.
+	// These match pathIntersectsWall(), computeIntersectPos()
+	// and collision_pathWallCollision() but keep their state
+	// locally and track visited walls in a list instead of
+	// tagging them with s_collisionFrameWall.
+	////////////////////////////////////////////////////////
+	enum
+	{
+		COL_MAX_VISITED_WALLS = 128,
+	};
+
+	struct ColPathState
+	{
+		ColPath path;
+		RWall* visited[COL_MAX_VISITED_WALLS];
+		s32 visitedCount;
+		fixed16_16 hitDist;
+	};
+
+	static JBool pathIntersectsWall_readOnly(const ColPath* path, const RWall* wall, vec2_fixed* pos)
+	{
+		const fixed16_16 pathX0 = path->x0;
+		const fixed16_16 pathX1 = path->x1;
+		const fixed16_16 pathZ0 = path->z0;
+		const fixed16_16 pathZ1 = path->z1;
+		const fixed16_16 wallX0 = wall->w0->x;
+		const fixed16_16 wallZ0 = wall->w0->z;
+		const fixed16_16 wallX1 = wall->w1->x;
+		const fixed16_16 wallZ1 = wall->w1->z;
+
+		const fixed16_16 pathDx = pathX1 - pathX0;
+		const fixed16_16 wallDx = wallX0 - wallX1;
+		const fixed16_16 adjPathX0 = pathDx < 0 ? pathX1 : pathX0;
+		const fixed16_16 adjPathX1 = pathDx < 0 ? pathX0 : pathX1;
+		if (wallDx > 0 && (adjPathX1 < wallX1 || wallX0 < adjPathX0))
+		{
+			return JFALSE;
+		}
+		else if (wallDx <= 0 && (adjPathX1 < wallX0 || wallX1 < adjPathX0))
+		{
+			return JFALSE;
+		}
+
+		const fixed16_16 pathDz = pathZ1 - pathZ0;
+		const fixed16_16 wallDz = wallZ0 - wallZ1;
+		const fixed16_16 adjPathZ0 = pathDz < 0 ? pathZ1 : pathZ0;
+		const fixed16_16 adjPathZ1 = pathDz < 0 ? pathZ0 : pathZ1;
+		if (wallDz > 0 && adjPathZ1 < wallZ1)
+		{
+			return JFALSE;
+		}
+		if (wallZ0 < adjPathZ0 && (adjPathZ1 < wallZ0 || wallZ1 < adjPathZ0))
+		{
+			return JFALSE;
+		}
+
+		const fixed16_16 offsetX = pathX0 - wallX0;
+		const fixed16_16 offsetZ = pathZ0 - wallZ0;
+		const fixed16_16 num = mul16(wallDz, offsetX) - mul16(wallDx, offsetZ);
+		const fixed16_16 den = mul16(pathDz, wallDx) - mul16(pathDx, wallDz);
+		if (den <= 0 && (num > 0 || num < den))
+		{
+			return JFALSE;
+		}
+		else if (den > 0 && den > num)
+		{
+			return JFALSE;
+		}
+
+		const fixed16_16 num2 = mul16(pathDx, offsetZ) - mul16(pathDz, offsetX);
+		if (den > 0 && num2 > den)
+		{
+			return JFALSE;
+		}
+		if (num2 > 0 || num2 < den)
+		{
+			return JFALSE;
+		}
+		if (den == 0)
+		{
+			return JFALSE;
+		}
+
+		const fixed16_16 param = div16(num, den);
+		pos->x = pathX0 + mul16(param, pathDx);
+		pos->z = pathZ0 + mul16(param, pathDz);
+		return JTRUE;
+	}
+
+	static JBool isWallVisited(const ColPathState* state, const RWall* wall)
+	{
+		for (s32 i = 0; i < state->visitedCount; i++)
+		{
+			if (state->visited[i] == wall) { return JTRUE; }
+		}
+		return JFALSE;
+	}
+
+	// Returns JFALSE if the visited list is full.
+	static JBool pathWallCollision_readOnly(ColPathState* state, RSector* sector, RWall** outWall)
+	{
+		const ColPath* path = &state->path;
+		RWall* wall = sector->walls;
+		RWall* hitWall = nullptr;
+		state->hitDist = c_maxCollisionDist;
+		for (s32 i = 0; i < sector->wallCount; i++, wall++)
+		{
+			vec2_fixed pos;
+			if (isWallVisited(state, wall) || !pathIntersectsWall_readOnly(path, wall, &pos))
+			{
+				continue;
+			}
+			if (pos.x != path->x0 || pos.z != path->z0)
+			{
+				const fixed16_16 dx = path->x1 - path->x0;
+				const fixed16_16 dz = path->z1 - path->z0;
+				if (mul16(dx, wall->wallDir.z) - mul16(dz, wall->wallDir.x) >= 0)
+				{
+					continue;
+				}
+			}
+			const fixed16_16 dist = distApprox(path->x0, path->z0, pos.x, pos.z);
+			if (dist < state->hitDist)
+			{
+				state->hitDist = dist;
+				hitWall = wall;
+			}
+		}
+		if (hitWall)
+		{
+			if (state->visitedCount + 2 > COL_MAX_VISITED_WALLS)
+			{
+				return JFALSE;
+			}
+			state->visited[state->visitedCount++] = hitWall;
+			if (hitWall->mirrorWall)
+			{
+				state->visited[state->visitedCount++] = hitWall->mirrorWall;
+			}
+		}
+		*outWall = hitWall;
+		return JTRUE;
+	}
+
+	void collision_skipCanHitObject(vec3_fixed p0, vec3_fixed p1)
+	{
+		if (p1.x - p0.x != 0 || p1.z - p0.z != 0)
+		{
+			s_col_path.x0 = p0.x;
+			s_col_path.z0 = p0.z;
+			s_col_path.x1 = p1.x;
+			s_col_path.z1 = p1.z;
+			s_collisionFrameWall++;
+		}
+	}
+
+	JBool collision_canHitObjectReadOnly(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3, JBool* canHit, JBool* wallHit)
+	{
+		*canHit = JFALSE;
+		*wallHit = JFALSE;
+		fixed16_16 approxDist = distApprox(p0.x, p0.z, p1.x, p1.z);
+		fixed16_16 dy = p1.y - p0.y;
+		fixed16_16 yStep = approxDist ? div16(dy, approxDist) : dy;
+
+		ColPathState state;
+		state.path = { p0.x, p1.x, p0.z, p1.z };
+		state.visitedCount = 0;
+		state.hitDist = c_maxCollisionDist;
+
+		RSector* sector = startSector;
+		RWall* hitWall = nullptr;
+		if ((p1.x - p0.x != 0 || p1.z - p0.z != 0) && !pathWallCollision_readOnly(&state, sector, &hitWall))
+		{
+			return JFALSE;
+		}
+		while (hitWall)
+		{
+			RSector* nextSector = hitWall->nextSector;
+			if (!nextSector)
+			{
+				*wallHit = JTRUE;
+				return JTRUE;
+			}
+			if (hitWall->flags3 & exclWallFlags3)
+			{
+				return JTRUE;
+			}
+			fixed16_16 yHit = p0.y + mul16(state.hitDist, yStep);
+			RSector* hitSector = hitWall->sector;
+			if (yHit < hitSector->ceilingHeight || yHit < nextSector->ceilingHeight || yHit > hitSector->floorHeight || yHit > nextSector->floorHeight)
+			{
+				return JTRUE;
+			}
+			sector = nextSector;
+			if (!pathWallCollision_readOnly(&state, nextSector, &hitWall))
+			{
+				return JFALSE;
+			}
+		}
+		*canHit = (sector == endSector) ? JTRUE : JFALSE;
+		return JTRUE;
+	}
+
 	fixed16_16 computeYIntersect(const vec3_fixed p0, const vec3_fixed p1, f32 scaleXZ)
 	{
 		const f32 dx = fixed16ToFloat(p1.x - p0.x);
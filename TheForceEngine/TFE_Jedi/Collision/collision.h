@@ -104,6 +104,13 @@ namespace TFE_Jedi
 	RWall* collision_pathWallCollision(RSector* sector);
 	RWall* collision_wallCollisionFromPath(RSector* sector, fixed16_16 srcX, fixed16_16 srcZ, fixed16_16 dstX, fixed16_16 dstZ);
 	JBool collision_canHitObject(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3);
+	// Same as collision_canHitObject() but only reads level data, so it can be called from worker threads while the level is not
+	// being modified. The results are written to 'canHit' and 'wallHit' (s_collision_wallHit), returns JFALSE if the ray
+	// crosses too many walls to be tracked, in which case collision_canHitObject() must be used instead.
+	JBool collision_canHitObjectReadOnly(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, u32 exclWallFlags3, JBool* canHit, JBool* wallHit);
+	// Advances the collision frame and sets the collision path the same way collision_canHitObject() does before tracing the ray,
+	// used when the result of the ray comes from somewhere else so later collision queries see the same state.
+	void collision_skipCanHitObject(vec3_fixed p0, vec3_fixed p1);
 
 	SecObject* collision_getObjectCollision(RSector* sector, CollisionInterval* interval, SecObject* prevObj);
 	JBool collision_isAnyObjectInRange(RSector* sector, fixed16_16 radius, vec3_fixed origin, SecObject* skipObj, u32 entityFlags);
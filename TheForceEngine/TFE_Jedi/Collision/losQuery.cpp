@@ -0,0 +1,196 @@
+#include <cstring>
+#include <cstdio>
+
+#include "losQuery.h"
+#include "collision.h"
+#include <TFE_System/hash.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_DarkForces/time.h>
+
+using namespace TFE_DarkForces;
+
+namespace TFE_Jedi
+{
+	enum LosConstants : u32
+	{
+		LOS_CACHE_SIZE  = 1024,		// Must be a power of 2.
+		LOS_CACHE_MASK  = LOS_CACHE_SIZE - 1,
+		LOS_MAX_PROBE   = 8,
+		LOS_MAX_QUANTIZE_BITS = 16,	// 1 unit.
+	};
+
+	enum LosResultFlags : u32
+	{
+		LOS_CAN_HIT  = (1 << 0),
+		LOS_WALL_HIT = (1 << 1),
+	};
+
+	struct LosEntry
+	{
+		u32 generation;
+		u32 result;
+		RSector* startSector;
+		RSector* endSector;
+		vec3_fixed p0;
+		vec3_fixed p1;
+	};
+
+	// Off by default: cached rays do not stamp the walls they cross, so wall collision frames (which are saved) can differ.
+	static bool s_losCache = false;
+	// Number of fractional bits dropped from the positions used as keys, 0 = exact.
+	static s32 s_losQuantizeBits = 0;
+
+	static LosEntry s_entries[LOS_CACHE_SIZE];
+	// Entries from a previous generation are empty, so the cache is flushed without touching them.
+	static u32 s_generation = 1;
+	static Tick s_cacheTick = 0;
+	static LosStats s_stats = {};
+
+	static void los_flush()
+	{
+		s_generation++;
+		// Generation 0 is never valid, wrap around by clearing the entries.
+		if (!s_generation)
+		{
+			memset(s_entries, 0, sizeof(s_entries));
+			s_generation = 1;
+		}
+	}
+
+	static vec3_fixed los_quantize(vec3_fixed p, fixed16_16 mask)
+	{
+		return { p.x & mask, p.y & mask, p.z & mask };
+	}
+
+	static void los_syncTick()
+	{
+		if (s_curTick != s_cacheTick)
+		{
+			s_cacheTick = s_curTick;
+			los_flush();
+		}
+	}
+
+	// Returns the entry matching the key, or the slot to store it in with 'found' = false.
+	static LosEntry* los_findEntry(RSector* startSector, RSector* endSector, vec3_fixed k0, vec3_fixed k1, bool* found)
+	{
+		u64 hash = TFE_Hash::fnv1a64Value(startSector, TFE_Hash::FNV64_OFFSET);
+		hash = TFE_Hash::fnv1a64Value(endSector, hash);
+		hash = TFE_Hash::fnv1a64Value(k0, hash);
+		hash = TFE_Hash::fnv1a64Value(k1, hash);
+
+		// Linear probing, if the probe range is full the first slot is overwritten.
+		*found = false;
+		for (u32 i = 0; i < LOS_MAX_PROBE; i++)
+		{
+			LosEntry* entry = &s_entries[(u32(hash) + i) & LOS_CACHE_MASK];
+			if (entry->generation != s_generation)
+			{
+				return entry;
+			}
+			if (entry->startSector == startSector && entry->endSector == endSector &&
+				entry->p0.x == k0.x && entry->p0.y == k0.y && entry->p0.z == k0.z &&
+				entry->p1.x == k1.x && entry->p1.y == k1.y && entry->p1.z == k1.z)
+			{
+				*found = true;
+				return entry;
+			}
+		}
+		return &s_entries[u32(hash) & LOS_CACHE_MASK];
+	}
+
+	static void los_storeEntry(LosEntry* entry, RSector* startSector, RSector* endSector, vec3_fixed k0, vec3_fixed k1, JBool canHit, JBool wallHit)
+	{
+		entry->generation = s_generation;
+		entry->result = (canHit ? LOS_CAN_HIT : 0) | (wallHit ? LOS_WALL_HIT : 0);
+		entry->startSector = startSector;
+		entry->endSector = endSector;
+		entry->p0 = k0;
+		entry->p1 = k1;
+	}
+
+	JBool los_canHitObject(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1)
+	{
+		if (!s_losCache)
+		{
+			return collision_canHitObject(startSector, endSector, p0, p1, 0);
+		}
+		los_syncTick();
+		s_stats.queryCount++;
+
+		const s32 quantizeBits = clamp(s_losQuantizeBits, 0, s32(LOS_MAX_QUANTIZE_BITS));
+		const fixed16_16 mask = ~((1 << quantizeBits) - 1);
+		const vec3_fixed k0 = los_quantize(p0, mask);
+		const vec3_fixed k1 = los_quantize(p1, mask);
+
+		bool found;
+		LosEntry* entry = los_findEntry(startSector, endSector, k0, k1, &found);
+		if (found)
+		{
+			s_stats.hitCount++;
+			// Keep the collision frame sequence and path identical to marching the ray.
+			collision_skipCanHitObject(p0, p1);
+			s_collision_wallHit = (entry->result & LOS_WALL_HIT) ? JTRUE : JFALSE;
+			return (entry->result & LOS_CAN_HIT) ? JTRUE : JFALSE;
+		}
+
+		// Evaluate the ray with the real positions of the first query.
+		s_stats.evalCount++;
+		const JBool canHit = collision_canHitObject(startSector, endSector, p0, p1, 0);
+		los_storeEntry(entry, startSector, endSector, k0, k1, canHit, s_collision_wallHit);
+		return canHit;
+	}
+
+	bool los_canPrefetch()
+	{
+		// With quantized keys the first query decides the result, so results computed ahead of time could differ.
+		return s_losCache && s_losQuantizeBits <= 0;
+	}
+
+	void los_prefetch(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, JBool canHit, JBool wallHit)
+	{
+		if (!los_canPrefetch()) { return; }
+		los_syncTick();
+
+		bool found;
+		LosEntry* entry = los_findEntry(startSector, endSector, p0, p1, &found);
+		if (!found)
+		{
+			s_stats.prefetchCount++;
+			los_storeEntry(entry, startSector, endSector, p0, p1, canHit, wallHit);
+		}
+	}
+
+	void los_onGeometryChanged()
+	{
+		s_stats.flushCount++;
+		los_flush();
+	}
+
+	void los_clear()
+	{
+		los_flush();
+		s_stats = {};
+	}
+
+	void los_getStats(LosStats* stats)
+	{
+		*stats = s_stats;
+	}
+
+	void console_losStats(const ConsoleArgList& args)
+	{
+		char res[256];
+		const f64 hitRate = s_stats.queryCount ? 100.0 * f64(s_stats.hitCount) / f64(s_stats.queryCount) : 0.0;
+		sprintf(res, "LOS queries: %u, cached: %u (%0.1f%%), ray marches: %u, prefetched: %u, geometry flushes: %u", s_stats.queryCount, s_stats.hitCount,
+			hitRate, s_stats.evalCount, s_stats.prefetchCount, s_stats.flushCount);
+		TFE_Console::addToHistory(res);
+	}
+
+	void los_registerCommands()
+	{
+		CVAR_BOOL(s_losCache, "g_losCache", CVFLAG_DO_NOT_SERIALIZE, "Reuse AI line of sight results within a tick.");
+		CVAR_INT(s_losQuantizeBits, "g_losQuantizeBits", CVFLAG_DO_NOT_SERIALIZE, "Fractional bits dropped from line of sight cache keys, 0 = exact, 16 = 1 unit.");
+		CCMD("losStats", console_losStats, 0, "Print line of sight cache statistics for the current level.");
+	}
+}  // TFE_Jedi
@@ -0,0 +1,50 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Line of sight queries
+// AI perception tests the same actor -> target rays several times per
+// tick (visibility, attack checks, both target heights). This is a
+// front end for collision_canHitObject() that remembers the results
+// for the current tick, keyed on the sectors and end points.
+//
+// Results are only reused within a tick and the cache is flushed when
+// INF changes heights, moves or rotates walls, changes wall flags or
+// adjoins. Cached results advance the wall collision frame and set the
+// collision path like the ray march would, but the walls along the
+// ray are not stamped with the new frame. Since those stamps are part
+// of the saved level state the cache is opt-in (g_losCache).
+// Quantized keys let nearby actors share a ray, in that case the
+// first query of the tick decides the result which is still
+// deterministic since the task order is.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+struct RSector;
+
+namespace TFE_Jedi
+{
+	struct LosStats
+	{
+		u32 queryCount;
+		u32 hitCount;		// queries answered from the cache.
+		u32 evalCount;		// ray marches.
+		u32 prefetchCount;	// results computed ahead of time by los_prefetch().
+		u32 flushCount;		// flushes caused by geometry changes.
+	};
+
+	// Same result as collision_canHitObject() with no excluded wall flags, including s_collision_wallHit.
+	JBool los_canHitObject(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1);
+
+	// Store a result computed ahead of time (see collision_canHitObjectReadOnly()) for the current tick.
+	// This is ignored if the cache is disabled or the keys are quantized, use los_canPrefetch() to skip the work.
+	bool los_canPrefetch();
+	void los_prefetch(RSector* startSector, RSector* endSector, vec3_fixed p0, vec3_fixed p1, JBool canHit, JBool wallHit);
+
+	// Called when level geometry that affects the rays changes.
+	void los_onGeometryChanged();
+	// Called when level data is cleared.
+	void los_clear();
+
+	void los_getStats(LosStats* stats);
+	void los_registerCommands();
+}  // TFE_Jedi
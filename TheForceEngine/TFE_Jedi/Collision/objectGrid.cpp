@@ -0,0 +1,289 @@
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+
+#include "objectGrid.h"
+#include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/rsector.h>
+#include <TFE_Jedi/Level/robject.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_DarkForces/time.h>
+
+using namespace TFE_DarkForces;
+
+namespace TFE_Jedi
+{
+	enum ObjGridConstants
+	{
+		OBJGRID_MAX_CELLS = 65536,
+		OBJGRID_MAX_QUERY_DEPTH = 4,
+	};
+	static const fixed16_16 c_objGridMinCellSize = FIXED(16);
+
+	static bool s_objGridEnable = true;
+	static bool s_built = false;
+	static fixed16_16 s_cellSize = 0;
+	static s32 s_cellShift = 0;		// log2 of the cell size.
+	static s32 s_cellsX = 0;
+	static s32 s_cellsZ = 0;
+	static vec2_fixed s_origin = { 0 };
+	static std::vector<SecObject*> s_cells;
+	static Tick s_syncTick = 0;
+
+	static std::vector<ObjGridRef> s_queries[OBJGRID_MAX_QUERY_DEPTH];
+	static u32 s_queryChangeCount[OBJGRID_MAX_QUERY_DEPTH];
+	static s32 s_queryDepth = 0;
+	static u32 s_changeCount = 0;	// incremented whenever an object is added, removed or moved.
+	static ObjGridStats s_stats = {};
+
+	static s32 objGrid_cellCoord(fixed16_16 value, fixed16_16 origin, s32 count)
+	{
+		const s32 coord = s32((s64(value) - s64(origin)) >> s_cellShift);
+		return clamp(coord, 0, count - 1);
+	}
+
+	static s32 objGrid_getCell(const SecObject* obj)
+	{
+		return objGrid_cellCoord(obj->posWS.z, s_origin.z, s_cellsZ) * s_cellsX + objGrid_cellCoord(obj->posWS.x, s_origin.x, s_cellsX);
+	}
+
+	static void objGrid_link(SecObject* obj, s32 cell)
+	{
+		SecObject* head = s_cells[cell];
+		obj->gridCell = cell;
+		obj->gridPrev = nullptr;
+		obj->gridNext = head;
+		if (head) { head->gridPrev = obj; }
+		s_cells[cell] = obj;
+	}
+
+	static void objGrid_unlink(SecObject* obj)
+	{
+		if (obj->gridPrev) { obj->gridPrev->gridNext = obj->gridNext; }
+		else { s_cells[obj->gridCell] = obj->gridNext; }
+		if (obj->gridNext) { obj->gridNext->gridPrev = obj->gridPrev; }
+
+		obj->gridCell = -1;
+		obj->gridPrev = nullptr;
+		obj->gridNext = nullptr;
+	}
+
+	// Re-bucket every object once per tick, in case it was moved without calling objGrid_updateObject().
+	static void objGrid_sync()
+	{
+		if (s_syncTick == s_curTick) { return; }
+		s_syncTick = s_curTick;
+
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			for (s32 i = 0; i < sector->objectCount; i++)
+			{
+				SecObject* obj = sector->objectList[i];
+				const s32 cell = objGrid_getCell(obj);
+				if (cell == obj->gridCell) { continue; }
+				if (obj->gridCell >= 0)
+				{
+					objGrid_unlink(obj);
+					s_stats.syncMoveCount++;
+				}
+				objGrid_link(obj, cell);
+			}
+		}
+	}
+
+	void objGrid_build()
+	{
+		objGrid_clear();
+		if (!s_levelState.sectors || !s_levelState.sectorCount) { return; }
+
+		vec2_fixed boundsMin = s_levelState.sectors[0].boundsMin;
+		vec2_fixed boundsMax = s_levelState.sectors[0].boundsMax;
+		for (u32 s = 1; s < s_levelState.sectorCount; s++)
+		{
+			const RSector* sector = &s_levelState.sectors[s];
+			boundsMin.x = min(boundsMin.x, sector->boundsMin.x);
+			boundsMin.z = min(boundsMin.z, sector->boundsMin.z);
+			boundsMax.x = max(boundsMax.x, sector->boundsMax.x);
+			boundsMax.z = max(boundsMax.z, sector->boundsMax.z);
+		}
+
+		// Use the smallest power of 2 cell size that keeps the grid within the cell budget.
+		s_cellShift = 4 + FRAC_BITS_16;
+		s_cellSize = c_objGridMinCellSize;
+		const s64 width  = s64(boundsMax.x) - s64(boundsMin.x);
+		const s64 height = s64(boundsMax.z) - s64(boundsMin.z);
+		for (;;)
+		{
+			s_cellsX = s32((width  >> s_cellShift) + 1);
+			s_cellsZ = s32((height >> s_cellShift) + 1);
+			if (s64(s_cellsX) * s64(s_cellsZ) <= OBJGRID_MAX_CELLS) { break; }
+			s_cellShift++;
+			s_cellSize *= 2;
+		}
+		s_origin = boundsMin;
+		s_cells.assign(s_cellsX * s_cellsZ, nullptr);
+		s_built = true;
+		s_syncTick = s_curTick - 1;
+
+		// Add the objects that are already in the level.
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			for (s32 i = 0; i < sector->objectCount; i++)
+			{
+				SecObject* obj = sector->objectList[i];
+				objGrid_link(obj, objGrid_getCell(obj));
+			}
+		}
+	}
+
+	void objGrid_clear()
+	{
+		// Objects are owned by the level and cleared with it, so the links do not need to be reset.
+		s_cells.clear();
+		s_built = false;
+		s_queryDepth = 0;
+		s_stats = {};
+	}
+
+	bool objGrid_isEnabled()
+	{
+		return s_objGridEnable && s_built;
+	}
+
+	void objGrid_addObject(SecObject* obj)
+	{
+		s_changeCount++;
+		if (!s_built)
+		{
+			obj->gridCell = -1;
+			return;
+		}
+		objGrid_link(obj, objGrid_getCell(obj));
+	}
+
+	void objGrid_removeObject(SecObject* obj)
+	{
+		s_changeCount++;
+		if (!s_built || obj->gridCell < 0) { return; }
+		objGrid_unlink(obj);
+	}
+
+	void objGrid_updateObject(SecObject* obj)
+	{
+		// Count every move, an object can move into the range of a query without changing cells.
+		s_changeCount++;
+		if (!s_built || obj->gridCell < 0) { return; }
+		const s32 cell = objGrid_getCell(obj);
+		if (cell != obj->gridCell)
+		{
+			objGrid_unlink(obj);
+			objGrid_link(obj, cell);
+			s_stats.moveCount++;
+		}
+	}
+
+	static bool objGrid_refLess(const ObjGridRef& a, const ObjGridRef& b)
+	{
+		if (a.sector->index != b.sector->index)
+		{
+			return a.sector->index < b.sector->index;
+		}
+		return a.slot < b.slot;
+	}
+
+	bool objGrid_beginQuery(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1, const ObjGridRef** refs, s32* count)
+	{
+		if (!objGrid_isEnabled() || s_queryDepth >= OBJGRID_MAX_QUERY_DEPTH) { return false; }
+		objGrid_sync();
+
+		std::vector<ObjGridRef>& list = s_queries[s_queryDepth];
+		s_queryChangeCount[s_queryDepth] = s_changeCount;
+		s_queryDepth++;
+		list.clear();
+
+		const s32 cx0 = objGrid_cellCoord(x0, s_origin.x, s_cellsX);
+		const s32 cx1 = objGrid_cellCoord(x1, s_origin.x, s_cellsX);
+		const s32 cz0 = objGrid_cellCoord(z0, s_origin.z, s_cellsZ);
+		const s32 cz1 = objGrid_cellCoord(z1, s_origin.z, s_cellsZ);
+		for (s32 cz = cz0; cz <= cz1; cz++)
+		{
+			for (s32 cx = cx0; cx <= cx1; cx++)
+			{
+				for (SecObject* obj = s_cells[cz * s_cellsX + cx]; obj; obj = obj->gridNext)
+				{
+					if (obj->posWS.x < x0 || obj->posWS.x > x1 || obj->posWS.z < z0 || obj->posWS.z > z1) { continue; }
+					list.push_back({ obj, obj->sector, obj->index });
+				}
+			}
+		}
+		std::sort(list.begin(), list.end(), objGrid_refLess);
+
+		s_stats.queryCount++;
+		s_stats.candidateCount += u32(list.size());
+		*refs = list.data();
+		*count = s32(list.size());
+		return true;
+	}
+
+	void objGrid_endQuery()
+	{
+		if (s_queryDepth > 0) { s_queryDepth--; }
+	}
+
+	bool objGrid_queryChanged()
+	{
+		return s_queryDepth > 0 && s_queryChangeCount[s_queryDepth - 1] != s_changeCount;
+	}
+
+	SecObject* objGrid_getObject(const ObjGridRef* ref)
+	{
+		// Once anything changed the pointer cannot be trusted: the object may have been freed and its memory reused
+		// by a new object in the same sector. Callers fall back to the sector loops instead.
+		return objGrid_queryChanged() ? nullptr : ref->obj;
+	}
+
+	void objGrid_getStats(ObjGridStats* stats)
+	{
+		*stats = s_stats;
+		stats->cellsX = s_cellsX;
+		stats->cellsZ = s_cellsZ;
+		stats->cellSize = s_cellSize;
+		stats->objectCount = 0;
+		stats->maxCellCount = 0;
+		for (size_t c = 0; c < s_cells.size(); c++)
+		{
+			s32 count = 0;
+			for (SecObject* obj = s_cells[c]; obj; obj = obj->gridNext) { count++; }
+			stats->objectCount += count;
+			stats->maxCellCount = max(stats->maxCellCount, count);
+		}
+	}
+
+	void console_objGridStats(const ConsoleArgList& args)
+	{
+		if (!s_built)
+		{
+			TFE_Console::addToHistory("No object grid, no level is loaded.");
+			return;
+		}
+		ObjGridStats stats;
+		objGrid_getStats(&stats);
+
+		char res[256];
+		sprintf(res, "Object grid: %d x %d cells of %d units, %d objects, at most %d per cell.", stats.cellsX, stats.cellsZ, floor16(stats.cellSize),
+			stats.objectCount, stats.maxCellCount);
+		TFE_Console::addToHistory(res);
+		sprintf(res, "Queries: %u, average candidates: %0.1f, cell moves: %u, found by sync: %u", stats.queryCount,
+			stats.queryCount ? f64(stats.candidateCount) / f64(stats.queryCount) : 0.0, stats.moveCount, stats.syncMoveCount);
+		TFE_Console::addToHistory(res);
+	}
+
+	void objGrid_registerCommands()
+	{
+		CVAR_BOOL(s_objGridEnable, "g_objectGrid", CVFLAG_DO_NOT_SERIALIZE, "Use the object grid for range queries instead of walking every sector.");
+		CCMD("objGridStats", console_objGridStats, 0, "Print statistics for the object grid of the current level.");
+	}
+}  // TFE_Jedi
@@ -0,0 +1,72 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Object Grid
+// A uniform XZ grid over the level bounds that tracks which sector
+// objects are near each other, so range queries (explosions, wake up
+// checks, landmines) only visit objects around the query instead of
+// every sector object list in the level.
+//
+// Objects are added and removed with their sector (see
+// sector_addObjectToList() and sector_removeObject()), code that moves
+// objects calls objGrid_updateObject() and the grid is also re-synced
+// once per tick to catch anything else. Objects outside of the level
+// bounds are stored in the border cells.
+//
+// Query results are sorted by (sector index, object list slot), which
+// is the order the original sector loops visit objects in. Results are
+// only valid until an object is added, removed or moved, callers that
+// can change objects check objGrid_queryChanged() and finish with the
+// sector loops, so objects spawned or pushed into range are still
+// visited and freed objects are never read.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+struct RSector;
+struct SecObject;
+
+namespace TFE_Jedi
+{
+	struct ObjGridRef
+	{
+		SecObject* obj;
+		RSector* sector;
+		s32 slot;		// index in sector->objectList, valid until the query changes.
+	};
+
+	struct ObjGridStats
+	{
+		s32 cellsX;
+		s32 cellsZ;
+		fixed16_16 cellSize;
+		s32 objectCount;
+		s32 maxCellCount;	// most objects in a single cell.
+		u32 queryCount;
+		u32 candidateCount;
+		u32 moveCount;		// cell changes from objGrid_updateObject().
+		u32 syncMoveCount;	// cell changes only found by the per-tick sync.
+	};
+
+	// Build the grid for the current level geometry, objects already in sectors are added.
+	void objGrid_build();
+	void objGrid_clear();
+	bool objGrid_isEnabled();
+
+	void objGrid_addObject(SecObject* obj);
+	void objGrid_removeObject(SecObject* obj);
+	// Call when the XZ position of an object changes.
+	void objGrid_updateObject(SecObject* obj);
+
+	// Gathers the objects whose XZ position is inside of [x0, x1] x [z0, z1] in sector loop order.
+	// Returns false if the grid cannot be used, in which case the caller should walk the sectors.
+	// The refs remain valid until objGrid_endQuery(), queries may be nested (up to a small depth).
+	bool objGrid_beginQuery(fixed16_16 x0, fixed16_16 z0, fixed16_16 x1, fixed16_16 z1, const ObjGridRef** refs, s32* count);
+	void objGrid_endQuery();
+	// Returns true if objects were added, removed or moved since the innermost query began.
+	bool objGrid_queryChanged();
+	// Returns the object, or null if the query has changed (in which case the object may have been freed).
+	SecObject* objGrid_getObject(const ObjGridRef* ref);
+
+	void objGrid_getStats(ObjGridStats* stats);
+	void objGrid_registerCommands();
+}  // TFE_Jedi
@@ -15,6 +15,8 @@
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/Level/levelData.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Jedi/Collision/losQuery.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/system.h>
@@ -1643,43 +1645,39 @@ namespace TFE_Jedi
 				while (teleport)
 				{
 					RSector* sector = teleport->sector;
-					s32 objCount = sector->objectCount;
-					SecObject** objList = sector->objectList;
-
-					for (s32 i = 0; i < objCount; objList++)
+					for (s32 i = 0; i < sector->objectCount; )
 					{
-						SecObject* obj = *objList;
-						if (obj)
+						SecObject* obj = sector->objectList[i];
+						taskCtx->delay = TASK_NO_DELAY;
+						TeleportType type = teleport->type;
+						if (type <= TELEPORT_BASIC)
+						{
+							// So dstPosition is actually an absolute position.
+							obj->posWS = teleport->dstPosition;
+							obj->pitch = teleport->dstAngle[0];
+							obj->yaw   = teleport->dstAngle[1];
+							obj->roll  = teleport->dstAngle[2];
+							sector_addObject(teleport->target, obj);
+							objGrid_updateObject(obj);
+						}
+						else if (type == TELEPORT_CHUTE)
 						{
-							i++;
-							taskCtx->delay = TASK_NO_DELAY;
-							TeleportType type = teleport->type;
-							if (type <= TELEPORT_BASIC)
+							sector = teleport->sector;
+							fixed16_16 floorThreshold = sector->floorHeight - HALF_16;
+							// if the object is lower than 0.5 units above the floor.
+							if (floorThreshold < obj->posWS.y)
 							{
-								// So dstPosition is actually an absolute position.
-								obj->posWS = teleport->dstPosition;
-								obj->pitch = teleport->dstAngle[0];
-								obj->yaw   = teleport->dstAngle[1];
-								obj->roll  = teleport->dstAngle[2];
 								sector_addObject(teleport->target, obj);
 							}
-							else if (type == TELEPORT_CHUTE)
-							{
-								sector = teleport->sector;
-								fixed16_16 floorThreshold = sector->floorHeight - HALF_16;
-								// if the object is lower than 0.5 units above the floor.
-								if (floorThreshold < obj->posWS.y)
-								{
-									sector_addObject(teleport->target, obj);
-								}
-							}
+						}
 
-							if (obj->entityFlags & ETFLAG_PLAYER)
-							{
-								// automap_setLayer(obj->sector->layer);
-							}
-						}  // if (obj)
-					}  // for (s32 i = 0; i < objCount; objList++)
+						if (obj->entityFlags & ETFLAG_PLAYER)
+						{
+							// automap_setLayer(obj->sector->layer);
+						}
+						// Teleporting the object removes it from the sector.
+						i = sector_nextObjectIndex(sector, obj, i);
+					}  // for (s32 i = 0; i < sector->objectCount; )
 					teleport = (Teleport*)allocator_getNext(s_infSerState.infTeleports);
 				}  // while (teleport)
 			}
@@ -2259,6 +2257,7 @@ namespace TFE_Jedi
 		else if (flagsIndex == 3)
 		{
 			wall->flags3 |= bits;
+			los_onGeometryChanged();
 
 			// If there is a mirror, also set some of the bits there.
 			RWall* mirror = wall->mirrorWall;
@@ -2293,6 +2292,7 @@ namespace TFE_Jedi
 		else if (flagsIndex == 3)
 		{
 			wall->flags3 &= ~bits;
+			los_onGeometryChanged();
 
 			// If there is a mirror, also set some of the bits there.
 			RWall* mirror = wall->mirrorWall;
@@ -2987,6 +2987,7 @@ namespace TFE_Jedi
 
 				cmd = (AdjoinCmd*)allocator_getNext(adjoinCmds);
 			}
+			los_onGeometryChanged();
 		}
 	}
 
@@ -3032,42 +3033,29 @@ namespace TFE_Jedi
 		{
 			case MSG_WAKEUP:
 			{
-				s32 objCount = sector->objectCount;
-				s32 objCapacity = sector->objectCapacity;
-				SecObject** objList = sector->objectList;
-
-				for (s32 i = 0; i < objCount && i < objCapacity; objList++)
+				// The message handlers may remove objects from the sector.
+				for (s32 i = 0; i < sector->objectCount; )
 				{
-					SecObject* obj = *objList;
-					if (obj)
+					SecObject* obj = sector->objectList[i];
+					if (obj && (obj->entityFlags & ETFLAG_CAN_WAKE))
 					{
-						if (obj->entityFlags & ETFLAG_CAN_WAKE)
-						{
-							message_sendToObj(obj, MSG_WAKEUP, nullptr);
-						}
-						i++;
+						message_sendToObj(obj, MSG_WAKEUP, nullptr);
 					}
+					i = sector_nextObjectIndex(sector, obj, i);
 				}
 			}
 			// MSG_WAKEUP drops through to MSG_MASTER_ON/MSG_MASTER_OFF
 			case MSG_MASTER_ON:
 			case MSG_MASTER_OFF:
 			{
-				s32 objCount = sector->objectCount;
-				s32 objCapacity = sector->objectCapacity;
-				SecObject** objList = sector->objectList;
-
-				for (s32 i = 0; i < objCount && i < objCapacity; objList++)
+				for (s32 i = 0; i < sector->objectCount; )
 				{
-					SecObject* obj = *objList;
-					if (obj)
+					SecObject* obj = sector->objectList[i];
+					if (obj && (obj->entityFlags & ETFLAG_CAN_DISABLE))
 					{
-						if (obj->entityFlags & ETFLAG_CAN_DISABLE)
-						{
-							message_sendToObj(obj, msgType, nullptr);
-						}
-						i++;
+						message_sendToObj(obj, msgType, nullptr);
 					}
+					i = sector_nextObjectIndex(sector, obj, i);
 				}
 			} break;
 			case MSG_SET_BITS:
@@ -3382,12 +3370,9 @@ namespace TFE_Jedi
 
 				s32 objCount = sector->objectCount;
 				SecObject** objList = sector->objectList;
-				for (; objCount > 0; objList++)
+				for (s32 i = 0; i < objCount; i++)
 				{
-					SecObject* obj = *objList;
-					if (!obj) { continue; }
-
-					objCount--;
+					SecObject* obj = objList[i];
 					fixed16_16 objHeight = obj->worldHeight + ONE_16;
 					if (obj->posWS.y > offsetHeight) // Object is below the second height
 					{
@@ -3,7 +3,9 @@
 
 #include "level.h"
 #include "levelBin.h"
+#include "levelCache.h"
 #include "levelData.h"
+#include "sectorPvs.h"
 #include "rwall.h"
 #include "rtexture.h"
 #include <TFE_Game/igame.h>
@@ -15,9 +17,12 @@
 #include <TFE_DarkForces/sound.h>
 #include <TFE_FileSystem/filestream.h>
 #include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_Archive/archive.h>
 #include <TFE_System/parser.h>
 #include <TFE_System/system.h>
 
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/InfSystem/infTypesInternal.h>
 #include <TFE_Jedi/InfSystem/message.h>
@@ -45,14 +50,20 @@ namespace TFE_Jedi
 	static s32 s_dataIndex;
 	static char s_readBuffer[256];
 	static std::vector<char> s_buffer;
+	static bool s_reuseLevelAssets = true;
 
 	JBool level_loadGeometry(const char* levelName);
+	JBool level_parseGeometry(LevelGeometryData* data);
+	JBool level_buildGeometry(const LevelGeometryData* data);
 	JBool level_loadObjects(const char* levelName, u8 difficulty);
 	JBool level_loadGoals(const char* levelName);
 
 	JBool level_load(const char* levelName, u8 difficulty)
 	{
 		if (!levelName) { return JFALSE; }
+		level_setAssetRetainKey(levelName);
+		// Memory tracking records the peak usage of the level region per level.
+		TFE_Memory::region_setTrackingLabel(s_levelRegion, levelName);
 
 		// Clear just in case.
 		for (s32 i = 0; i < NUM_COMPLETE; i++)
@@ -65,6 +76,8 @@ namespace TFE_Jedi
 		}
 
 		if (!level_loadGeometry(levelName)) { return JFALSE; }
+		pvs_build();
+		objGrid_build();
 		level_loadObjects(levelName, difficulty);
 		inf_load(levelName);
 		level_loadGoals(levelName);
@@ -166,6 +179,20 @@ namespace TFE_Jedi
 		file.readBuffer(s_buffer.data(), u32(len));
 		file.close();
 
+		// TFE: Use the binary cache of the parsed level if it matches the source file.
+		LevelGeometryData data;
+		levelGeometry_clear(&data);
+		const u64 cacheKey = levelCache_computeKey(s_buffer.data(), s_buffer.size());
+		if (!levelCache_read(cacheKey, &data))
+		{
+			if (!level_parseGeometry(&data)) { return false; }
+			levelCache_write(cacheKey, &data);
+		}
+		return level_buildGeometry(&data);
+	}
+
+	JBool level_parseGeometry(LevelGeometryData* data)
+	{
 		TFE_Parser parser;
 		size_t bufferPos = 0;
 		parser.init(s_buffer.data(), s_buffer.size());
@@ -196,13 +223,12 @@ namespace TFE_Jedi
 
 		// This gets read here just to be overwritten later... so just ignore for now.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " PALETTE %s", s_levelState.levelPaletteName) != 1)
+		if (sscanf(line, " PALETTE %s", s_readBuffer) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read palette name.");
 			return false;
 		}
-
-		level_loadPalette();
+		data->paletteName = levelGeometry_addString(data, s_readBuffer);
 		
 		// Another value that is ignored.
 		line = parser.readLine(bufferPos);
@@ -222,79 +248,48 @@ namespace TFE_Jedi
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read parallax values.");
 			return false;
 		}
-		s_levelState.parallax0 = floatToFixed16(parallax0);
-		s_levelState.parallax1 = floatToFixed16(parallax1);
+		data->parallax0 = floatToFixed16(parallax0);
+		data->parallax1 = floatToFixed16(parallax1);
 
 		// Number of textures used by the level.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, " TEXTURES %d", &s_levelState.textureCount) != 1)
+		s32 textureCount;
+		if (sscanf(line, " TEXTURES %d", &textureCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture count.");
 			return false;
 		}
-		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
-		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
 
-		// Load Textures.
-		TextureData** texture = s_levelState.textures;
-		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
-		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		// Texture names.
+		data->textures.resize(textureCount);
+		for (s32 i = 0; i < textureCount; i++)
 		{
 			line = parser.readLine(bufferPos);
 			char textureName[256];
 			if (sscanf(line, " TEXTURE: %s ", textureName) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read texture name.");
-				*texture = bitmap_load("default.bm", 1);
-				(*texture)->flags |= ENABLE_MIP_MAPS;
-			}
-			else if (strcasecmp(textureName, "<NoTexture>") == 0)
-			{
-				*texture = nullptr;
+				data->textures[i] = -1;
 			}
 			else
 			{
-				TextureData* tex = bitmap_load(textureName, 1);
-				if (!tex)
-				{
-					TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
-					tex = bitmap_load("default.bm", 1);
-					if (!tex)
-					{
-						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
-						assert(0);
-						return false;
-					}
-				}
-				// TFE - so we know which textures to mip.
-				tex->flags |= ENABLE_MIP_MAPS;
-				*texture = tex;
-				// This version never gets modified, so serialization is simpler.
-				*texBase = tex;
-
-				// Setup an animated texture.
-				if (tex->uvWidth == BM_ANIMATED_TEXTURE)
-				{
-					bitmap_setupAnimatedTexture(texture, i);
-				}
+				data->textures[i] = levelGeometry_addString(data, textureName);
 			}
 		}
 
-		// Load Sectors.
+		// Sectors.
 		line = parser.readLine(bufferPos);
-		if (sscanf(line, "NUMSECTORS %d", &s_levelState.sectorCount) != 1)
+		s32 sectorCount;
+		if (sscanf(line, "NUMSECTORS %d", &sectorCount) != 1)
 		{
 			TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector count.");
 			return false;
 		}
 
-		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
-		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
-		for (u32 i = 0; i < s_levelState.sectorCount; i++)
+		data->sectors.resize(sectorCount);
+		for (s32 i = 0; i < sectorCount; i++)
 		{
-			RSector* sector = &s_levelState.sectors[i];
-			sector_clear(sector);
-			sector->index = i;
+			LevelSectorData* sector = &data->sectors[i];
 
 			// Sector ID and Name
 			line = parser.readLine(bufferPos);
@@ -306,54 +301,30 @@ namespace TFE_Jedi
 
 			// Allow names to have '#' in them.
 			line = parser.readLine(bufferPos, false, true);
-			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
-			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
 			char name[256];
+			sector->name = -1;
 			if (sscanf(line, " NAME %s", name) == 1)
 			{
-				// Add the sector "address" for later use by the INF system.
-				message_addAddress(name, 0, 0, sector);
-
-				// Track special elevators.
-				if (!strcasecmp(name, "complete"))
-				{
-					s_levelState.completeSector = sector;
-				}
-				else if (!strcasecmp(name, "boss"))
-				{
-					s_levelState.bossSector = sector;
-				}
-				else if (!strcasecmp(name, "mohc"))
-				{
-					s_levelState.mohcSector = sector;
-				}
+				sector->name = levelGeometry_addString(data, name);
 			}
 
 			// Lighting
 			line = parser.readLine(bufferPos);
-			s32 ambient;
-			if (sscanf(line, " AMBIENT %d", &ambient) != 1)
+			if (sscanf(line, " AMBIENT %d", &sector->ambient) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector ambient.");
 				return false;
 			}
-			sector->ambient = intToFixed16(ambient);
 
 			// Floor Texture & Offset
 			line = parser.readLine(bufferPos);
-			s32 index, tmp;
+			s32 tmp;
 			f32 offsetX, offsetZ;
-			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (sscanf(line, " FLOOR TEXTURE %d %f %f %d", &sector->floorTex, &offsetX, &offsetZ, &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read floor texture.");
 				return false;
 			}
-
-			sector->floorTex = nullptr;
-			if (index != -1)
-			{
-				sector->floorTex = &s_levelState.textures[index];
-			}
 			sector->floorOffset.x = floatToFixed16(offsetX);
 			sector->floorOffset.z = floatToFixed16(offsetZ);
 
@@ -369,16 +340,11 @@ namespace TFE_Jedi
 
 			// Ceiling Texture & Offset
 			line = parser.readLine(bufferPos);
-			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &index, &offsetX, &offsetZ, &tmp) != 4)
+			if (sscanf(line, " CEILING TEXTURE %d %f %f %d", &sector->ceilTex, &offsetX, &offsetZ, &tmp) != 4)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling texture.");
 				return false;
 			}
-			sector->ceilTex = nullptr;
-			if (index != -1)
-			{
-				sector->ceilTex = &s_levelState.textures[index];
-			}
 			sector->ceilOffset.x = floatToFixed16(offsetX);
 			sector->ceilOffset.z = floatToFixed16(offsetZ);
 
@@ -389,7 +355,7 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read ceiling altitude.");
 				return false;
 			}
-			sector->ceilingHeight = floatToFixed16(alt);
+			sector->ceilHeight = floatToFixed16(alt);
 
 			// Second Altitude
 			line = parser.readLine(bufferPos);
@@ -407,22 +373,6 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector flags.");
 				return false;
 			}
-			// Create a door if needed.
-			if (sector->flags1 & SEC_FLAGS1_DOOR)
-			{
-				InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
-				if (elev) { elev->flags |= INF_EFLAG_DOOR; }
-			}
-			// Create an exploding wall if needed.
-			if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
-			{
-				inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
-			}
-			// Add secrets.
-			if (sector->flags1 & SEC_FLAGS1_SECRET)
-			{
-				s_levelState.secretCount++;
-			}
 
 			// Layer
 			line = parser.readLine(bufferPos);
@@ -431,71 +381,247 @@ namespace TFE_Jedi
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector layer.");
 				return false;
 			}
-			s_levelState.minLayer = min(s_levelState.minLayer, sector->layer);
-			s_levelState.maxLayer = max(s_levelState.maxLayer, sector->layer);
 
 			// Vertices
 			line = parser.readLine(bufferPos);
-			s32 vertexCount;
-			if (sscanf(line, " VERTICES %d", &vertexCount) != 1)
+			if (sscanf(line, " VERTICES %d", &sector->vertexCount) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector vertices.");
 				return false;
 			}
-			const size_t vtxSize = vertexCount * sizeof(vec2_fixed);
-			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
-			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
-			sector->vertexCount = vertexCount;
-
-			for (s32 v = 0; v < vertexCount; v++)
+			for (s32 v = 0; v < sector->vertexCount; v++)
 			{
 				line = parser.readLine(bufferPos);
 
-				f32 x, z;
-				sscanf(line, " X: %f Z: %f ", &x, &z);
-				sector->verticesWS[v].x = floatToFixed16(x);
-				sector->verticesWS[v].z = floatToFixed16(z);
+				f32 x = 0.0f, z = 0.0f;
+				const char* pos = TFE_Parser::readFloat(TFE_Parser::matchString(line, " X:"), &x);
+				TFE_Parser::readFloat(TFE_Parser::matchString(pos, " Z:"), &z);
+				data->vertices.push_back({ floatToFixed16(x), floatToFixed16(z) });
 			}
 
 			// Walls
 			line = parser.readLine(bufferPos);
-			s32 wallCount;
-			if (sscanf(line, " WALLS %d", &wallCount) != 1)
+			if (sscanf(line, " WALLS %d", &sector->wallCount) != 1)
 			{
 				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read sector walls.");
 				return false;
 			}
-			sector->walls = (RWall*)level_alloc(wallCount * sizeof(RWall));
-			sector->wallCount = wallCount;
-
-			for (s32 w = 0; w < wallCount; w++)
+			for (s32 w = 0; w < sector->wallCount; w++)
 			{
-				s32 light, flags3, flags2, flags1, walk, mirror, adjoin;
-				s32 signTex, unused;
-				s32 botTex, topTex, midTex, right, left;
+				s32 unused;
 				f32 signOffsetZ, signOffsetX;
 				f32 botOffsetZ, botOffsetX;
 				f32 topOffsetZ, topOffsetX;
 				f32 midOffsetZ, midOffsetX;
+				s32 walk;
+				LevelWallData wall;
 
+				// This is the bulk of the file, so avoid sscanf() and read the values directly.
+				// Format: WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d
 				line = parser.readLine(bufferPos);
-				if (sscanf(line, " WALL LEFT: %d RIGHT: %d MID: %d %f %f %d TOP: %d %f %f %d BOT: %d %f %f %d SIGN: %d %f %f ADJOIN: %d MIRROR: %d WALK: %d FLAGS: %d %d %d LIGHT: %d",
-					&left, &right, &midTex, &midOffsetX, &midOffsetZ, &unused, &topTex, &topOffsetX, &topOffsetZ, &unused, &botTex, &botOffsetX, &botOffsetZ, &unused,
-					&signTex, &signOffsetX, &signOffsetZ, &adjoin, &mirror, &walk, &flags1, &flags2, &flags3, &light) != 24)
+				const char* pos = TFE_Parser::matchString(line, " WALL LEFT:");
+				pos = TFE_Parser::readInt(pos, &wall.left);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " RIGHT:"), &wall.right);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " MID:"), &wall.midTex);
+				pos = TFE_Parser::readInt(TFE_Parser::readFloat(TFE_Parser::readFloat(pos, &midOffsetX), &midOffsetZ), &unused);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " TOP:"), &wall.topTex);
+				pos = TFE_Parser::readInt(TFE_Parser::readFloat(TFE_Parser::readFloat(pos, &topOffsetX), &topOffsetZ), &unused);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " BOT:"), &wall.botTex);
+				pos = TFE_Parser::readInt(TFE_Parser::readFloat(TFE_Parser::readFloat(pos, &botOffsetX), &botOffsetZ), &unused);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " SIGN:"), &wall.signTex);
+				pos = TFE_Parser::readFloat(TFE_Parser::readFloat(pos, &signOffsetX), &signOffsetZ);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " ADJOIN:"), &wall.adjoin);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " MIRROR:"), &wall.mirror);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " WALK:"), &walk);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " FLAGS:"), (s32*)&wall.flags1);
+				pos = TFE_Parser::readInt(TFE_Parser::readInt(pos, (s32*)&wall.flags2), (s32*)&wall.flags3);
+				pos = TFE_Parser::readInt(TFE_Parser::matchString(pos, " LIGHT:"), &wall.light);
+				if (!pos)
 				{
 					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Cannot read wall.");
 					return false;
 				}
+				wall.midOffset  = { floatToFixed16(midOffsetX) * 8,  floatToFixed16(midOffsetZ) * 8 };
+				wall.topOffset  = { floatToFixed16(topOffsetX) * 8,  floatToFixed16(topOffsetZ) * 8 };
+				wall.botOffset  = { floatToFixed16(botOffsetX) * 8,  floatToFixed16(botOffsetZ) * 8 };
+				wall.signOffset = { floatToFixed16(signOffsetX) * 8, floatToFixed16(signOffsetZ) * 8 };
+				data->walls.push_back(wall);
+			}
+		}
+		return true;
+	}
+
+	JBool level_buildGeometry(const LevelGeometryData* data)
+	{
+		const s32 sectorCount = (s32)data->sectors.size();
+		const s32 textureCount = (s32)data->textures.size();
+		const char* paletteName = levelGeometry_getString(data, data->paletteName);
+		strcpy(s_levelState.levelPaletteName, paletteName ? paletteName : "");
+		level_loadPalette();
 
+		s_levelState.parallax0 = data->parallax0;
+		s_levelState.parallax1 = data->parallax1;
+		s_levelState.textureCount = textureCount;
+		s_levelState.textures = (TextureData**)level_alloc(2 * s_levelState.textureCount * sizeof(TextureData**));
+		memset(s_levelState.textures, 0, 2 * s_levelState.textureCount * sizeof(TextureData**));
+
+		// Load Textures.
+		TextureData** texture = s_levelState.textures;
+		TextureData** texBase = s_levelState.textures + s_levelState.textureCount;
+		for (s32 i = 0; i < s_levelState.textureCount; i++, texture++, texBase++)
+		{
+			const char* textureName = levelGeometry_getString(data, data->textures[i]);
+			if (!textureName)
+			{
+				*texture = bitmap_load("default.bm", 1);
+				(*texture)->flags |= ENABLE_MIP_MAPS;
+			}
+			else if (strcasecmp(textureName, "<NoTexture>") == 0)
+			{
+				*texture = nullptr;
+			}
+			else
+			{
+				TextureData* tex = bitmap_load(textureName, 1);
+				if (!tex)
+				{
+					TFE_System::logWrite(LOG_WARNING, "level_loadGeometry", "Could not open '%s', using 'default.bm' instead.", textureName);
+					tex = bitmap_load("default.bm", 1);
+					if (!tex)
+					{
+						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "'default.bm' is not a valid BM file!");
+						assert(0);
+						return false;
+					}
+				}
+				// TFE - so we know which textures to mip.
+				tex->flags |= ENABLE_MIP_MAPS;
+				*texture = tex;
+				// This version never gets modified, so serialization is simpler.
+				*texBase = tex;
+
+				// Setup an animated texture.
+				if (tex->uvWidth == BM_ANIMATED_TEXTURE)
+				{
+					bitmap_setupAnimatedTexture(texture, i);
+				}
+			}
+		}
+
+		// Load Sectors.
+		s_levelState.sectorCount = sectorCount;
+		s_levelState.sectors = (RSector*)level_alloc(sizeof(RSector) * s_levelState.sectorCount);
+		memset(s_levelState.sectors, 0, sizeof(RSector) * s_levelState.sectorCount);
+
+		const vec2_fixed* srcVertex = data->vertices.data();
+		const vec2_fixed* srcVertexEnd = srcVertex + data->vertices.size();
+		const LevelWallData* srcWall = data->walls.data();
+		const LevelWallData* srcWallEnd = srcWall + data->walls.size();
+		for (s32 i = 0; i < sectorCount; i++)
+		{
+			const LevelSectorData* src = &data->sectors[i];
+			RSector* sector = &s_levelState.sectors[i];
+			sector_clear(sector);
+			sector->index = i;
+			sector->id = src->id;
+
+			// Sectors missing a name are valid but do not get "addresses" - and thus cannot be
+			// used by the INF system (except in the case of doors and exploding walls, see the flags section below).
+			const char* name = levelGeometry_getString(data, src->name);
+			if (name)
+			{
+				// Add the sector "address" for later use by the INF system.
+				message_addAddress(name, 0, 0, sector);
+
+				// Track special elevators.
+				if (!strcasecmp(name, "complete"))
+				{
+					s_levelState.completeSector = sector;
+				}
+				else if (!strcasecmp(name, "boss"))
+				{
+					s_levelState.bossSector = sector;
+				}
+				else if (!strcasecmp(name, "mohc"))
+				{
+					s_levelState.mohcSector = sector;
+				}
+			}
+
+			// Lighting
+			sector->ambient = intToFixed16(src->ambient);
+
+			// Floor & Ceiling
+			sector->floorTex = (src->floorTex >= 0 && src->floorTex < textureCount) ? &s_levelState.textures[src->floorTex] : nullptr;
+			sector->floorOffset = src->floorOffset;
+			sector->floorHeight = src->floorHeight;
+			sector->ceilTex = (src->ceilTex >= 0 && src->ceilTex < textureCount) ? &s_levelState.textures[src->ceilTex] : nullptr;
+			sector->ceilOffset = src->ceilOffset;
+			sector->ceilingHeight = src->ceilHeight;
+			sector->secHeight = src->secHeight;
+
+			// Sector flags
+			sector->flags1 = src->flags1;
+			sector->flags2 = src->flags2;
+			sector->flags3 = src->flags3;
+			// Create a door if needed.
+			if (sector->flags1 & SEC_FLAGS1_DOOR)
+			{
+				InfElevator* elev = inf_allocateSpecialElevator(sector, IELEV_SP_DOOR);
+				if (elev) { elev->flags |= INF_EFLAG_DOOR; }
+			}
+			// Create an exploding wall if needed.
+			if (sector->flags1 & SEC_FLAGS1_EXP_WALL)
+			{
+				inf_allocateSpecialElevator(sector, IELEV_SP_EXPLOSIVE_WALL);
+			}
+			// Add secrets.
+			if (sector->flags1 & SEC_FLAGS1_SECRET)
+			{
+				s_levelState.secretCount++;
+			}
+
+			// Layer
+			sector->layer = src->layer;
+			s_levelState.minLayer = min(s_levelState.minLayer, sector->layer);
+			s_levelState.maxLayer = max(s_levelState.maxLayer, sector->layer);
+
+			// Vertices
+			const s32 vertexCount = src->vertexCount;
+			if (vertexCount < 0 || srcVertex + vertexCount > srcVertexEnd || src->wallCount < 0 || srcWall + src->wallCount > srcWallEnd)
+			{
+				TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Invalid vertex or wall count in sector %d.", i);
+				return false;
+			}
+			const size_t vtxSize = vertexCount * sizeof(vec2_fixed);
+			sector->verticesWS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->verticesVS = (vec2_fixed*)level_alloc(vtxSize);
+			sector->vertexCount = vertexCount;
+			memcpy(sector->verticesWS, srcVertex, vtxSize);
+			srcVertex += vertexCount;
+
+			// Walls
+			const s32 wallCount = src->wallCount;
+			sector->walls = (RWall*)level_alloc(wallCount * sizeof(RWall));
+			sector->wallCount = wallCount;
+
+			for (s32 w = 0; w < wallCount; w++, srcWall++)
+			{
 				RWall* wall = &sector->walls[w];
 				wall->id = w;
 				wall->sector = sector;
 				wall->mirrorWall = nullptr;
 				wall->seen = JFALSE;
-				wall->flags1 = flags1;
-				wall->flags2 = flags2;
-				wall->flags3 = flags3;
+				wall->flags1 = srcWall->flags1;
+				wall->flags2 = srcWall->flags2;
+				wall->flags3 = srcWall->flags3;
 
+				const s32 left = srcWall->left, right = srcWall->right;
+				if (left < 0 || left >= vertexCount || right < 0 || right >= vertexCount)
+				{
+					TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Invalid wall vertex in sector %d.", i);
+					return false;
+				}
 				vec2_fixed* leftVtxWS = &sector->verticesWS[left];
 				vec2_fixed* rightVtxWS = &sector->verticesWS[right];
 				wall->w0 = leftVtxWS;
@@ -508,52 +634,48 @@ namespace TFE_Jedi
 
 				wall->nextSector = nullptr;
 				wall->mirror = -1;
-				if (adjoin != -1)
+				if (srcWall->adjoin != -1)
 				{
-					wall->nextSector = &s_levelState.sectors[adjoin];
-					if (mirror == -1)
+					wall->nextSector = &s_levelState.sectors[srcWall->adjoin];
+					if (srcWall->mirror == -1)
 					{
 						TFE_System::logWrite(LOG_ERROR, "level_loadGeometry", "Adjoining wall missing mirror.");
 					}
-					wall->mirror = mirror;
+					wall->mirror = srcWall->mirror;
 				}
 
 				wall->infLink = nullptr;
 				wall->collisionFrame = 0;
 				wall->drawFrame = 0;
 				wall->drawFlags = 0;
-				wall->wallLight = intToFixed16(light);
+				wall->wallLight = intToFixed16(srcWall->light);
 
 				wall->midTex = nullptr;
-				if (midTex != -1)
+				if (srcWall->midTex != -1)
 				{
-					wall->midTex = &s_levelState.textures[midTex];
-					wall->midOffset.x = floatToFixed16(midOffsetX) * 8;
-					wall->midOffset.z = floatToFixed16(midOffsetZ) * 8;
+					wall->midTex = &s_levelState.textures[srcWall->midTex];
+					wall->midOffset = srcWall->midOffset;
 				}
 
 				wall->topTex = nullptr;
-				if (topTex != -1)
+				if (srcWall->topTex != -1)
 				{
-					wall->topTex = &s_levelState.textures[topTex];
-					wall->topOffset.x = floatToFixed16(topOffsetX) * 8;
-					wall->topOffset.z = floatToFixed16(topOffsetZ) * 8;
+					wall->topTex = &s_levelState.textures[srcWall->topTex];
+					wall->topOffset = srcWall->topOffset;
 				}
 
 				wall->botTex = nullptr;
-				if (botTex != -1)
+				if (srcWall->botTex != -1)
 				{
-					wall->botTex = &s_levelState.textures[botTex];
-					wall->botOffset.x = floatToFixed16(botOffsetX) * 8;
-					wall->botOffset.z = floatToFixed16(botOffsetZ) * 8;
+					wall->botTex = &s_levelState.textures[srcWall->botTex];
+					wall->botOffset = srcWall->botOffset;
 				}
 
 				wall->signTex = nullptr;
-				if (signTex != -1)
+				if (srcWall->signTex != -1)
 				{
-					wall->signTex = &s_levelState.textures[signTex];
-					wall->signOffset.x = floatToFixed16(signOffsetX) * 8;
-					wall->signOffset.z = floatToFixed16(signOffsetZ) * 8;
+					wall->signTex = &s_levelState.textures[srcWall->signTex];
+					wall->signOffset = srcWall->signOffset;
 				}
 
 				fixed16_16 dx = rightVtxWS->x - leftVtxWS->x;
@@ -576,6 +698,35 @@ namespace TFE_Jedi
 		TFE_Model_Jedi::freeLevelData();
 	}
 
+	void level_setAssetRetainKey(const char* levelName)
+	{
+		if (!levelName || !s_reuseLevelAssets)
+		{
+			bitmap_setLevelRetainKey(nullptr);
+			TFE_Sprite_Jedi::setLevelRetainKey(nullptr);
+			return;
+		}
+
+		// Include where the level comes from, so the same level name in a different mod does not reuse the assets.
+		char levelPath[TFE_MAX_PATH];
+		strcpy(levelPath, levelName);
+		strcat(levelPath, ".LEV");
+		FilePath filePath;
+		std::string key = levelName;
+		if (TFE_Paths::getFilePath(levelPath, &filePath))
+		{
+			key += "|";
+			key += filePath.archive ? filePath.archive->getPath() : filePath.path;
+		}
+		bitmap_setLevelRetainKey(key.c_str());
+		TFE_Sprite_Jedi::setLevelRetainKey(key.c_str());
+	}
+
+	void level_registerCommands()
+	{
+		CVAR_BOOL(s_reuseLevelAssets, "g_reuseLevelAssets", CVFLAG_DO_NOT_SERIALIZE, "Keep decoded level textures and sprites so reloading the same level does not load them again.");
+	}
+
 	JBool level_isGoalComplete(s32 goalIndex)
 	{
 		for (s32 i = 0; i < NUM_COMPLETE; i++)
@@ -1033,5 +1184,6 @@ namespace TFE_Jedi
 		obj->posWS.y = y;
 		obj->posWS.z = z;
 		sector_addObject(sector, obj);
+		objGrid_updateObject(obj);
 	}
 }
@@ -40,6 +40,10 @@ namespace TFE_Jedi
 	JBool level_load(const char* levelName, u8 difficulty);
 	void  level_clearData();
 	void  level_freeAllAssets();
+	// TFE: Level textures and sprites are kept after they are freed and reused if the next level loaded
+	// is the same one (such as loading a save). Call before loading a level, null frees the kept assets.
+	void  level_setAssetRetainKey(const char* levelName);
+	void  level_registerCommands();
 
 	void level_serialize(Stream* stream);
 
@@ -0,0 +1,224 @@
+#include <cstring>
+
+#include "levelCache.h"
+#include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+
+namespace TFE_Jedi
+{
+	enum LevelCacheConstants : u32
+	{
+		LEVEL_CACHE_MAGIC = 0x3143564c,	// "LVC1"
+		// Increment when the records or the way they are parsed change.
+		LEVEL_CACHE_VERSION = 2,
+	};
+
+	struct LevelCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 key;
+		u64 checksum;		// hash of everything after the header.
+		s32 paletteName;
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+		u32 stringSize;
+		u32 textureCount;
+		u32 sectorCount;
+		u32 vertexCount;
+		u32 wallCount;
+	};
+
+	void levelGeometry_clear(LevelGeometryData* data)
+	{
+		data->paletteName = -1;
+		data->parallax0 = 0;
+		data->parallax1 = 0;
+		data->strings.clear();
+		data->textures.clear();
+		data->sectors.clear();
+		data->vertices.clear();
+		data->walls.clear();
+	}
+
+	s32 levelGeometry_addString(LevelGeometryData* data, const char* str)
+	{
+		const s32 offset = (s32)data->strings.size();
+		data->strings.insert(data->strings.end(), str, str + strlen(str) + 1);
+		return offset;
+	}
+
+	const char* levelGeometry_getString(const LevelGeometryData* data, s32 offset)
+	{
+		if (offset < 0 || offset >= (s32)data->strings.size()) { return nullptr; }
+		return data->strings.data() + offset;
+	}
+
+	static bool isValidIndex(s32 index, size_t count)
+	{
+		return index >= -1 && index < (s32)count;
+	}
+
+	// Checks that every index in the records is in range, so building the level cannot read out of bounds.
+	static bool levelGeometry_isValid(const LevelGeometryData* data)
+	{
+		const size_t textureCount = data->textures.size();
+		const size_t sectorCount = data->sectors.size();
+		size_t vertexStart = 0, wallStart = 0;
+		for (size_t s = 0; s < sectorCount; s++)
+		{
+			const LevelSectorData* sector = &data->sectors[s];
+			if (sector->vertexCount < 0 || sector->wallCount < 0 ||
+				vertexStart + sector->vertexCount > data->vertices.size() || wallStart + sector->wallCount > data->walls.size() ||
+				!isValidIndex(sector->floorTex, textureCount) || !isValidIndex(sector->ceilTex, textureCount))
+			{
+				return false;
+			}
+
+			const LevelWallData* wall = &data->walls[wallStart];
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->left < 0 || wall->left >= sector->vertexCount || wall->right < 0 || wall->right >= sector->vertexCount ||
+					!isValidIndex(wall->midTex, textureCount) || !isValidIndex(wall->topTex, textureCount) ||
+					!isValidIndex(wall->botTex, textureCount) || !isValidIndex(wall->signTex, textureCount) ||
+					!isValidIndex(wall->adjoin, sectorCount))
+				{
+					return false;
+				}
+				if (wall->adjoin >= 0 && !isValidIndex(wall->mirror, data->sectors[wall->adjoin].wallCount))
+				{
+					return false;
+				}
+			}
+			vertexStart += sector->vertexCount;
+			wallStart += sector->wallCount;
+		}
+		return true;
+	}
+
+	u64 levelCache_computeKey(const void* source, size_t size)
+	{
+		const u64 hash = TFE_Hash::fnv1a64Value((u64)size, TFE_Hash::FNV64_OFFSET);
+		return TFE_Hash::fnv1a64(source, size, hash);
+	}
+
+	static void getCachePath(u64 key, char* path)
+	{
+		char dir[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "LevelCache/", dir);
+		if (!FileUtil::directoryExits(dir))
+		{
+			FileUtil::makeDirectory(dir);
+		}
+		sprintf(path, "%s%016llx.lvc", dir, (unsigned long long)key);
+	}
+
+	template <typename T>
+	static const u8* readSection(const u8* src, std::vector<T>& dst, u32 count)
+	{
+		dst.resize(count);
+		if (count)
+		{
+			memcpy(dst.data(), src, sizeof(T) * count);
+		}
+		return src + sizeof(T) * count;
+	}
+
+	template <typename T>
+	static u64 hashSection(const std::vector<T>& src, u64 hash)
+	{
+		return src.empty() ? hash : TFE_Hash::fnv1a64(src.data(), sizeof(T) * src.size(), hash);
+	}
+
+	bool levelCache_read(u64 key, LevelGeometryData* data)
+	{
+		char path[TFE_MAX_PATH];
+		getCachePath(key, path);
+		if (!FileUtil::exists(path)) { return false; }
+
+		u8* buffer = nullptr;
+		const u32 size = FileStream::readContents(path, (void**)&buffer);
+		if (!buffer || size < sizeof(LevelCacheHeader))
+		{
+			free(buffer);
+			return false;
+		}
+
+		LevelCacheHeader header;
+		memcpy(&header, buffer, sizeof(LevelCacheHeader));
+		const size_t payloadSize = size_t(header.stringSize) + sizeof(s32) * header.textureCount + sizeof(LevelSectorData) * header.sectorCount +
+			sizeof(vec2_fixed) * header.vertexCount + sizeof(LevelWallData) * header.wallCount;
+		const u8* payload = buffer + sizeof(LevelCacheHeader);
+		if (header.magic != LEVEL_CACHE_MAGIC || header.version != LEVEL_CACHE_VERSION || header.key != key ||
+			payloadSize != size - sizeof(LevelCacheHeader) || TFE_Hash::fnv1a64(payload, payloadSize) != header.checksum)
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Discarding invalid or out of date level cache '%s'.", path);
+			free(buffer);
+			return false;
+		}
+
+		data->paletteName = header.paletteName;
+		data->parallax0 = header.parallax0;
+		data->parallax1 = header.parallax1;
+		payload = readSection(payload, data->strings, header.stringSize);
+		payload = readSection(payload, data->textures, header.textureCount);
+		payload = readSection(payload, data->sectors, header.sectorCount);
+		payload = readSection(payload, data->vertices, header.vertexCount);
+		payload = readSection(payload, data->walls, header.wallCount);
+		free(buffer);
+
+		if (!levelGeometry_isValid(data))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Discarding level cache '%s', it contains out of range indices.", path);
+			levelGeometry_clear(data);
+			return false;
+		}
+		return true;
+	}
+
+	void levelCache_write(u64 key, const LevelGeometryData* data)
+	{
+		// Levels with out of range indices would be rejected when read, so parse them every time instead.
+		if (!levelGeometry_isValid(data)) { return; }
+
+		LevelCacheHeader header = {};
+		header.magic = LEVEL_CACHE_MAGIC;
+		header.version = LEVEL_CACHE_VERSION;
+		header.key = key;
+		header.paletteName = data->paletteName;
+		header.parallax0 = data->parallax0;
+		header.parallax1 = data->parallax1;
+		header.stringSize = (u32)data->strings.size();
+		header.textureCount = (u32)data->textures.size();
+		header.sectorCount = (u32)data->sectors.size();
+		header.vertexCount = (u32)data->vertices.size();
+		header.wallCount = (u32)data->walls.size();
+
+		u64 checksum = TFE_Hash::FNV64_OFFSET;
+		checksum = hashSection(data->strings, checksum);
+		checksum = hashSection(data->textures, checksum);
+		checksum = hashSection(data->sectors, checksum);
+		checksum = hashSection(data->vertices, checksum);
+		checksum = hashSection(data->walls, checksum);
+		header.checksum = checksum;
+
+		char path[TFE_MAX_PATH];
+		getCachePath(key, path);
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Level Cache", "Cannot write level cache '%s'.", path);
+			return;
+		}
+		file.writeBuffer(&header, sizeof(LevelCacheHeader));
+		file.writeBuffer(data->strings.data(), header.stringSize);
+		file.writeBuffer(data->textures.data(), sizeof(s32) * header.textureCount);
+		file.writeBuffer(data->sectors.data(), sizeof(LevelSectorData) * header.sectorCount);
+		file.writeBuffer(data->vertices.data(), sizeof(vec2_fixed) * header.vertexCount);
+		file.writeBuffer(data->walls.data(), sizeof(LevelWallData) * header.wallCount);
+		file.close();
+	}
+}
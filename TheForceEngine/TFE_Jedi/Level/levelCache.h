@@ -0,0 +1,80 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// LevelCache
+// Parsed LEV geometry in a flat, pointer-free form. The text loader
+// parses into this structure and the level is then built from it.
+// The data is also written to a versioned, checksummed binary cache
+// keyed by a hash of the source file, so later loads of the same
+// level skip the text parsing.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/fixedPoint.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+	// All records only contain 32-bit fields so they can be read directly from the cache.
+	struct LevelSectorData
+	{
+		s32 id;
+		s32 name;			// offset into the string table or -1.
+		s32 ambient;
+		s32 floorTex;
+		vec2_fixed floorOffset;
+		fixed16_16 floorHeight;
+		s32 ceilTex;
+		vec2_fixed ceilOffset;
+		fixed16_16 ceilHeight;
+		fixed16_16 secHeight;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 layer;
+		s32 vertexCount;
+		s32 wallCount;
+	};
+
+	struct LevelWallData
+	{
+		s32 left;
+		s32 right;
+		s32 midTex;
+		s32 topTex;
+		s32 botTex;
+		s32 signTex;
+		// Texture offsets, already scaled to texels.
+		vec2_fixed midOffset;
+		vec2_fixed topOffset;
+		vec2_fixed botOffset;
+		vec2_fixed signOffset;
+		s32 adjoin;
+		s32 mirror;
+		u32 flags1;
+		u32 flags2;
+		u32 flags3;
+		s32 light;
+	};
+
+	struct LevelGeometryData
+	{
+		s32 paletteName;				// offset into the string table.
+		fixed16_16 parallax0;
+		fixed16_16 parallax1;
+		std::vector<char> strings;		// null terminated strings.
+		std::vector<s32>  textures;		// offset into the string table for each texture name, -1 if the name is missing.
+		std::vector<LevelSectorData> sectors;
+		std::vector<vec2_fixed>      vertices;	// vertices for all sectors, in sector order.
+		std::vector<LevelWallData>   walls;		// walls for all sectors, in sector order.
+	};
+
+	void levelGeometry_clear(LevelGeometryData* data);
+	s32  levelGeometry_addString(LevelGeometryData* data, const char* str);
+	const char* levelGeometry_getString(const LevelGeometryData* data, s32 offset);
+
+	// Cache key of the source LEV file.
+	u64  levelCache_computeKey(const void* source, size_t size);
+	// Returns false if the cache is missing, out of date or corrupt, including records with out of range indices.
+	bool levelCache_read(u64 key, LevelGeometryData* data);
+	void levelCache_write(u64 key, const LevelGeometryData* data);
+}
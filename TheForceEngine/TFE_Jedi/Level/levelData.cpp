@@ -5,6 +5,9 @@
 #include "rsector.h"
 #include "rwall.h"
 #include "robjData.h"
+#include "sectorPvs.h"
+#include <TFE_Jedi/Collision/losQuery.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_Asset/spriteAsset_Jedi.h>
@@ -49,6 +52,9 @@ namespace TFE_Jedi
 	{
 		s_levelState = { 0 };
 		s_levelIntState = { 0 };
+		pvs_clear();
+		los_clear();
+		objGrid_clear();
 
 		s_levelState.controlSector = (RSector*)level_alloc(sizeof(RSector));
 		sector_clear(s_levelState.controlSector);
@@ -215,6 +221,8 @@ namespace TFE_Jedi
 			}
 
 			level_serializeFixupMirrors();
+			pvs_build();
+			objGrid_build();
 		}
 
 		// Serialize objects.
@@ -1,6 +1,7 @@
 #include "robjData.h"
 #include "robject.h"
 #include "level.h"
+#include "levelData.h"
 #include <TFE_Game/igame.h>
 #include <TFE_Jedi/Memory/allocator.h>
 #include <TFE_Jedi/Serialization/serialization.h>
@@ -8,7 +9,9 @@
 #include <TFE_DarkForces/generator.h>
 #include <TFE_Memory/chunkedArray.h>
 #include <TFE_System/system.h>
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 // Required for serialization.
 namespace TFE_DarkForces
@@ -24,6 +27,8 @@ namespace TFE_Jedi
 		ChunkedArray* objectList = nullptr;
 	};
 	static SectorObjectData s_objData = {};
+	// Sector object list slots read from the save, indexed by serialization ID.
+	static std::vector<s16> s_savedSlots;
 		
 	void objData_clear()
 	{
@@ -104,11 +109,8 @@ namespace TFE_Jedi
 		SERIALIZE(ObjState_InitVersion, obj->yaw, 0);
 		SERIALIZE(ObjState_InitVersion, obj->roll, 0);
 
-		// obj->index will be reset once the object is re-added to its sector.
-		if (serialization_getMode() == SMODE_READ)
-		{
-			obj->index = -1;
-		}
+		// obj->index will be reset once the object is re-added to its sector, the saved value is used to restore the list order.
+		SERIALIZE(ObjState_SectorSlot, obj->index, -1);
 
 		SERIALIZE(ObjState_InitVersion, obj->serializeIndex, 0);
 	}
@@ -125,6 +127,29 @@ namespace TFE_Jedi
 		return (SecObject*)TFE_Memory::chunkedArrayGet(s_objData.objectList, id);
 	}
 		
+	static bool objData_savedSlotLess(const SecObject* a, const SecObject* b)
+	{
+		return s_savedSlots[a->serializeIndex] < s_savedSlots[b->serializeIndex];
+	}
+
+	// Objects are added to the end of their sector object list as they are read, so put them back in the order they
+	// had when the game was saved. Older saves did not store the slots, and keep the load order.
+	static void objData_restoreSectorOrder()
+	{
+		RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			SecObject** list = sector->objectList;
+			if (sector->objectCount < 2) { continue; }
+
+			std::stable_sort(list, list + sector->objectCount, objData_savedSlotLess);
+			for (s32 i = 0; i < sector->objectCount; i++)
+			{
+				list[i]->index = i;
+			}
+		}
+	}
+
 	void objData_serialize(Stream* stream)
 	{
 		SERIALIZE_VERSION(ObjState_CurVersion);
@@ -198,11 +223,17 @@ namespace TFE_Jedi
 			{
 				TFE_Memory::chunkedArrayClear(s_objData.objectList);
 			}
+			const bool restoreSectorOrder = s_sVersion >= ObjState_SectorSlot;
+			s_savedSlots.resize(writeCount);
 
 			for (u32 i = 0; i < writeCount; i++)
 			{
 				SecObject* obj = (SecObject*)TFE_Memory::allocFromChunkedArray(s_objData.objectList);
+				obj->gridNext = nullptr;
+				obj->gridPrev = nullptr;
+				obj->gridCell = -1;
 				objData_serializeObject(obj, stream);
+				s_savedSlots[i] = obj->index;
 
 				if (obj->sector)
 				{
@@ -239,6 +270,11 @@ namespace TFE_Jedi
 				}
 			}
 
+			if (restoreSectorOrder)
+			{
+				objData_restoreSectorOrder();
+			}
+
 			// Fix-up generator references.
 			for (u32 i = 0; i < writeCount; i++)
 			{
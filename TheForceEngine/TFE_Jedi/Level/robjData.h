@@ -61,7 +61,8 @@ enum ObjStateVersion : u32
 	ObjState_FlyModeAdded = 2,
 	ObjState_VueSmoothing = 3,
 	ObjState_OneHitCheats = 4,
-	ObjState_CurVersion = ObjState_OneHitCheats,
+	ObjState_SectorSlot = 5,
+	ObjState_CurVersion = ObjState_SectorSlot,
 };
 
 #define SPRITE_SCALE_FIXED FIXED(10)
@@ -109,6 +110,10 @@ struct SecObject
 
 	// TFE
 	u32 serializeIndex;
+	// Object grid cell links, see objectGrid.h
+	SecObject* gridNext;
+	SecObject* gridPrev;
+	s32 gridCell;
 };
 
 namespace TFE_Jedi
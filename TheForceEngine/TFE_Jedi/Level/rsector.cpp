@@ -6,11 +6,14 @@
 #include "robject.h"
 #include "level.h"
 #include "levelData.h"
+#include "sectorPvs.h"
 #include <TFE_Game/igame.h>
 #include <TFE_System/system.h>
 #include <TFE_DarkForces/player.h>
 #include <TFE_DarkForces/projectile.h>
 #include <TFE_Jedi/Collision/collision.h>
+#include <TFE_Jedi/Collision/losQuery.h>
+#include <TFE_Jedi/Collision/objectGrid.h>
 #include <TFE_Jedi/InfSystem/infSystem.h>
 #include <TFE_Jedi/InfSystem/message.h>
 // TODO: Find a better way to handle this.
@@ -99,16 +102,15 @@ namespace TFE_Jedi
 	void sector_adjustHeights(RSector* sector, fixed16_16 floorOffset, fixed16_16 ceilOffset, fixed16_16 secondHeightOffset)
 	{
 		sector->dirtyFlags |= SDF_HEIGHTS;
+		los_onGeometryChanged();
 
 		// Adjust objects.
 		if (sector->objectCount)
 		{
 			fixed16_16 heightOffset = secondHeightOffset + floorOffset;
-			for (s32 i = 0; i < sector->objectCapacity; i++)
+			for (s32 i = 0; i < sector->objectCount; i++)
 			{
 				SecObject* obj = sector->objectList[i];
-				if (!obj) { continue; }
-				
 				if (obj->posWS.y == sector->floorHeight)
 				{
 					obj->posWS.y += floorOffset;
@@ -214,14 +216,9 @@ namespace TFE_Jedi
 	{
 		s32 maxObjHeight = 0;
 		SecObject** objectList = sector->objectList;
-		for (s32 count = sector->objectCount; count > 0; objectList++)
+		for (s32 i = 0; i < sector->objectCount; i++)
 		{
-			SecObject* obj = *objectList;
-			if (obj)
-			{
-				maxObjHeight = max(maxObjHeight, obj->worldHeight + ONE_16);
-				count--;
-			}
+			maxObjHeight = max(maxObjHeight, objectList[i]->worldHeight + ONE_16);
 		}
 		return maxObjHeight;
 	}
@@ -268,6 +265,8 @@ namespace TFE_Jedi
 			}
 			sector_moveObjects(sector, flags, offsetX, offsetZ);
 			sector_computeBounds(sector);
+			pvs_onWallsMoved(sector);
+			los_onGeometryChanged();
 		}
 
 		return ~sectorBlocked;
@@ -404,20 +403,15 @@ namespace TFE_Jedi
 
 	void sector_addObjectToList(RSector* sector, SecObject* obj)
 	{
-		// Then add the object to the first free slot.
-		// Note that this scheme is optimized for deletion rather than addition.
-		SecObject** list = sector->objectList;
-		for (s32 i = 0; i < sector->objectCapacity; i++, list++)
-		{
-			if (!(*list))
-			{
-				*list = obj;
-				obj->index = i;
-				obj->sector = sector;
-				sector->objectCount++;
-				break;
-			}
-		}
+		// Then add the object to the end of the list.
+		// TFE: the original added objects to the first free slot and left holes on removal, the list is now kept dense
+		// so loops do not have to skip over empty slots. The caller has already grown the list if necessary.
+		const s32 index = sector->objectCount;
+		sector->objectList[index] = obj;
+		obj->index = index;
+		obj->sector = sector;
+		sector->objectCount++;
+		objGrid_addObject(obj);
 	}
 
 	// Skips some of the checks and does not send messages.
@@ -435,7 +429,7 @@ namespace TFE_Jedi
 		// Grow the object list if necessary.
 		sector_growObjectList(sector);
 
-		// Then add the object to the first free slot.
+		// Then append the object to the end of the list.
 		sector_addObjectToList(sector, obj);
 	}
 
@@ -464,7 +458,7 @@ namespace TFE_Jedi
 			// Grow the object list if necessary.
 			sector_growObjectList(sector);
 
-			// Then add the object to the first free slot.
+			// Then append the object to the end of the list.
 			sector_addObjectToList(sector, obj);
 		}
 	}
@@ -477,10 +471,18 @@ namespace TFE_Jedi
 		obj->sector = nullptr;
 		sector->dirtyFlags |= SDF_CHANGE_OBJ;
 
-		// Remove the object from the object list.
+		// Remove the object from the object list, shifting the following objects down so the list stays dense
+		// and the remaining objects keep their order.
 		SecObject** objList = sector->objectList;
-		objList[obj->index] = nullptr;
+		const s32 lastIndex = sector->objectCount - 1;
+		for (s32 i = obj->index; i < lastIndex; i++)
+		{
+			objList[i] = objList[i + 1];
+			objList[i]->index = i;
+		}
+		objList[lastIndex] = nullptr;
 		sector->objectCount--;
+		objGrid_removeObject(obj);
 
 		if (!((obj->entityFlags & ETFLAG_PLAYER) && s_playerDying))
 		{
@@ -492,6 +494,20 @@ namespace TFE_Jedi
 		}
 	}
 
+	// Returns the index of the next object to visit in a loop over the sector object list, given the object
+	// that was at 'index' before the loop body ran. The body may remove objects, including ones other than 'obj'.
+	// Removal keeps the order, so if 'obj' is still in the list the next object directly follows it. Otherwise the
+	// following objects moved down into 'index' (this is only off if objects before 'obj' were also removed).
+	// 'obj' may have been freed, so it is only compared and never read.
+	s32 sector_nextObjectIndex(RSector* sector, SecObject* obj, s32 index)
+	{
+		for (s32 i = min(index, sector->objectCount - 1); i >= 0; i--)
+		{
+			if (sector->objectList[i] == obj) { return i + 1; }
+		}
+		return min(index, sector->objectCount);
+	}
+
 	void sector_changeGlobalLightLevel()
 	{
 		RSector* sector = s_levelState.sectors;
@@ -824,24 +840,20 @@ namespace TFE_Jedi
 		s32 freeCount = 0;
 		SecObject* freeList[128];
 
-		for (s32 i = 0, idx = 0; i < objectCount && idx < sector->objectCapacity; idx++)
+		for (s32 i = 0; i < objectCount; i++)
 		{
-			SecObject* obj = sector->objectList[idx];
-			if (obj)
-			{
-				i++;
+			SecObject* obj = sector->objectList[i];
 
-				JBool canRemove = (obj->entityFlags & ETFLAG_CORPSE) != 0;
-				canRemove |= ((obj->entityFlags & ETFLAG_PICKUP) && !(obj->flags & OBJ_FLAG_MISSION));
+			JBool canRemove = (obj->entityFlags & ETFLAG_CORPSE) != 0;
+			canRemove |= ((obj->entityFlags & ETFLAG_PICKUP) && !(obj->flags & OBJ_FLAG_MISSION));
 
-				const u32 projType = (obj->projectileLogic) ? ((TFE_DarkForces::ProjectileLogic*)obj->projectileLogic)->type : (0);
-				const JBool isLandMine = projType == PROJ_LAND_MINE || projType == PROJ_LAND_MINE_PROX || projType == PROJ_LAND_MINE_PLACED;
-				canRemove |= ((obj->entityFlags & ETFLAG_PROJECTILE) && isLandMine);
+			const u32 projType = (obj->projectileLogic) ? ((TFE_DarkForces::ProjectileLogic*)obj->projectileLogic)->type : (0);
+			const JBool isLandMine = projType == PROJ_LAND_MINE || projType == PROJ_LAND_MINE_PROX || projType == PROJ_LAND_MINE_PLACED;
+			canRemove |= ((obj->entityFlags & ETFLAG_PROJECTILE) && isLandMine);
 
-				if (canRemove && freeCount < 128)
-				{
-					freeList[freeCount++] = obj;
-				}
+			if (canRemove && freeCount < 128)
+			{
+				freeList[freeCount++] = obj;
 			}
 		}
 
@@ -974,6 +986,8 @@ namespace TFE_Jedi
 		}
 		sector_computeBounds(sector);
 		sector->dirtyFlags |= SDF_WALL_SHAPE;
+		pvs_onWallsMoved(sector);
+		los_onGeometryChanged();
 	}
 
 	void sector_rotateObj(SecObject* obj, angle14_32 deltaAngle, fixed16_16 cosdAngle, fixed16_16 sindAngle, fixed16_16 centerX, fixed16_16 centerZ)
@@ -1048,16 +1062,9 @@ namespace TFE_Jedi
 			moveCeil = JTRUE;
 		}
 
-		SecObject** objList = sector->objectList;
-		s32 objCount = sector->objectCount;
-		for (s32 i = 0; i < objCount; i++, objList++)
+		for (s32 i = 0; i < sector->objectCount; )
 		{
-			SecObject* obj = *objList;
-			while (!obj)
-			{
-				objList++;
-				obj = *objList;
-			}
+			SecObject* obj = sector->objectList[i];
 			// The first 3 conditionals can be collapsed since the resulting values are the same.
 			if ((moveFloor && obj->posWS.y == sector->floorHeight) ||
 				(moveSecHgt && sector->secHeight && sector->floorHeight + sector->secHeight == obj->posWS.y) ||
@@ -1065,6 +1072,8 @@ namespace TFE_Jedi
 			{
 				sector_rotateObj(obj, deltaAngle, cosdAngle, sindAngle, centerX, centerZ);
 			}
+			// The object may have left the sector.
+			i = sector_nextObjectIndex(sector, obj, i);
 		}
 	}
 
@@ -1275,23 +1284,20 @@ namespace TFE_Jedi
 		JBool offset   = (flags & INF_EFLAG_MOVE_SECHT)!=0 ? JTRUE : JFALSE;
 		JBool floor    = (flags & INF_EFLAG_MOVE_FLOOR)!=0 ? JTRUE : JFALSE;
 
-		SecObject** objList = sector->objectList;
-		for (s32 i = 0, idx = 0; i < sector->objectCount && idx < sector->objectCapacity; idx++)
+		for (s32 i = 0; i < sector->objectCount; )
 		{
-			SecObject* obj = objList[idx];
-			if (obj)
+			SecObject* obj = sector->objectList[i];
+			if ((obj->flags & OBJ_FLAG_MOVABLE) && (obj->entityFlags != ETFLAG_PLAYER))
 			{
-				i++;
-				if ((obj->flags & OBJ_FLAG_MOVABLE) && (obj->entityFlags != ETFLAG_PLAYER))
+				if ((floor   && obj->posWS.y == sector->floorHeight) ||
+					(offset  && sector->secHeight && sector->floorHeight + sector->secHeight == obj->posWS.y) ||
+					(ceiling && obj->posWS.y == sector->ceilingHeight))
 				{
-					if ((floor   && obj->posWS.y == sector->floorHeight) ||
-						(offset  && sector->secHeight && sector->floorHeight + sector->secHeight == obj->posWS.y) ||
-						(ceiling && obj->posWS.y == sector->ceilingHeight))
-					{
-						sector_moveObject(obj, offsetX, offsetZ);
-					}
+					sector_moveObject(obj, offsetX, offsetZ);
 				}
 			}
+			// The object may have left the sector.
+			i = sector_nextObjectIndex(sector, obj, i);
 		}
 	}
 		
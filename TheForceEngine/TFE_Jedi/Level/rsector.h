@@ -109,6 +109,7 @@ struct RSector
 	vec2_fixed ceilOffset;
 
 	// Objects
+	// TFE: the list is kept dense, objectList[0, objectCount) are valid and obj->index is the slot.
 	s32 objectCount;
 	SecObject** objectList;
 	s32 objectCapacity;
@@ -152,6 +153,7 @@ namespace TFE_Jedi
 	void sector_addObject(RSector* sector, SecObject* obj);
 	void sector_addObjectDirect(RSector* sector, SecObject* obj);
 	void sector_removeObject(SecObject* obj);
+	s32  sector_nextObjectIndex(RSector* sector, SecObject* obj, s32 index);
 	
 	RSector* sector_which3D(fixed16_16 dx, fixed16_16 dy, fixed16_16 dz);
 	RSector* sector_which3D_Map(fixed16_16 dx, fixed16_16 dz, s32 layer);
@@ -30,6 +30,16 @@ namespace TFE_Jedi
 	};
 	typedef std::vector<LevelTexture> TextureList;
 	typedef std::unordered_map<std::string, s32> TextureTable;
+
+	// A level texture as it was right after loading, the texture itself lives in the level region.
+	struct RetainedTexture
+	{
+		TextureData header;
+		u32 decompress;
+		std::vector<u8> image;
+		std::vector<u32> columns;
+	};
+	typedef std::unordered_map<std::string, RetainedTexture> RetainedTextureMap;
 		
 	struct TextureState
 	{
@@ -44,6 +54,8 @@ namespace TFE_Jedi
 
 	static TextureList  s_textureList[POOL_COUNT];
 	static TextureTable s_textureTable[POOL_COUNT];
+	static RetainedTextureMap s_retainedTextures;
+	static std::string s_retainKey;
 
 	void decompressColumn_Type1(const u8* src, u8* dst, s32 pixelCount);
 	void decompressColumn_Type2(const u8* src, u8* dst, s32 pixelCount);
@@ -106,6 +118,46 @@ namespace TFE_Jedi
 		s_textureTable[POOL_LEVEL].clear();
 	}
 
+	void bitmap_setLevelRetainKey(const char* key)
+	{
+		if (!key || s_retainKey != key)
+		{
+			s_retainedTextures.clear();
+		}
+		s_retainKey = key ? key : "";
+	}
+
+	static TextureData* bitmap_copyRetained(const RetainedTexture* retained)
+	{
+		TextureData* texture = (TextureData*)region_alloc(s_texState.memoryRegion, sizeof(TextureData));
+		*texture = retained->header;
+		texture->image = (u8*)region_alloc(s_texState.memoryRegion, retained->image.size());
+		memcpy(texture->image, retained->image.data(), retained->image.size());
+		texture->columns = nullptr;
+		if (!retained->columns.empty())
+		{
+			texture->columns = (u32*)region_alloc(s_texState.memoryRegion, retained->columns.size() * sizeof(u32));
+			memcpy(texture->columns, retained->columns.data(), retained->columns.size() * sizeof(u32));
+		}
+		return texture;
+	}
+
+	static void bitmap_retain(const char* name, u32 decompress, const TextureData* texture)
+	{
+		RetainedTexture& retained = s_retainedTextures[name];
+		retained.header = *texture;
+		retained.decompress = decompress;
+		retained.image.assign(texture->image, texture->image + texture->dataSize);
+		if (texture->columns)
+		{
+			retained.columns.assign(texture->columns, texture->columns + texture->width);
+		}
+		else
+		{
+			retained.columns.clear();
+		}
+	}
+
 	void bitmap_clearAll()
 	{
 		s_texState = {};
@@ -212,6 +264,23 @@ namespace TFE_Jedi
 			return s_textureList[pool][iTex->second].texture;
 		}
 
+		const bool retain = pool == POOL_LEVEL && !s_retainKey.empty();
+		if (retain)
+		{
+			RetainedTextureMap::const_iterator iRetained = s_retainedTextures.find(name);
+			if (iRetained != s_retainedTextures.end() && iRetained->second.decompress == decompress)
+			{
+				TextureData* texture = bitmap_copyRetained(&iRetained->second);
+				if (addToCache)
+				{
+					s32 index = (s32)s_textureList[pool].size();
+					s_textureList[pool].push_back({ name, texture });
+					s_textureTable[pool][name] = index;
+				}
+				return texture;
+			}
+		}
+
 		FilePath filepath;
 		if (!TFE_Paths::getFilePath(name, &filepath))
 		{
@@ -339,6 +408,10 @@ namespace TFE_Jedi
 		texture->frameIdx = -1;
 		texture->animPtr = nullptr;
 
+		if (retain)
+		{
+			bitmap_retain(name, decompress, texture);
+		}
 		return texture;
 	}
 
@@ -95,6 +95,10 @@ namespace TFE_Jedi
 	MemoryRegion* bitmap_getAllocator();
 	void bitmap_clearLevelData();
 	void bitmap_clearAll();
+	// TFE: While a key (the level name) is set, decoded level textures are kept so reloading the same level
+	// copies them into the level region instead of reading and decompressing the files again.
+	// Changing the key (or setting it to null) frees the kept textures.
+	void bitmap_setLevelRetainKey(const char* key);
 
 	// levelTexture bool was added for TFE to make serializing texture state easier.
 	// if levelTexture is false, then textures are not serialized and not cleared at level end.
@@ -0,0 +1,505 @@
+#include <cstring>
+#include <cmath>
+
+#include "sectorPvs.h"
+#include "levelData.h"
+#include "rsector.h"
+#include "rwall.h"
+#include <TFE_Game/igame.h>
+#include <TFE_System/system.h>
+#include <TFE_System/hash.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_Jedi/Math/fixedPoint.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Jedi/Renderer/rlimits.h>
+
+namespace TFE_Jedi
+{
+	enum PvsRowState : u8
+	{
+		PVS_ROW_VALID = 0,	// The row holds the potentially visible set.
+		PVS_ROW_ALL,		// The flow budget was exceeded, everything is treated as visible.
+		PVS_ROW_DIRTY,		// Walls moved, everything is treated as visible until the row is rebuilt.
+	};
+
+	struct PvsSegment
+	{
+		Vec2f v0;
+		Vec2f v1;
+	};
+
+	struct PvsCacheHeader
+	{
+		u32 magic;
+		u32 version;
+		u64 geometryHash;
+		u32 sectorCount;
+		u32 wordsPerRow;
+	};
+
+	struct PvsState
+	{
+		u32* rows;			// sectorCount rows of 'wordsPerRow' bits.
+		u8*  rowState;		// PvsRowState per row.
+		s32* dirtyFrame;	// frame when the row was last marked dirty.
+		s32* movedFrame;	// frame when the sector walls last moved.
+		u32  sectorCount;
+		u32  wordsPerRow;
+		s32  frame;
+		u32* viewRow;		// row of the current camera sector or null if everything is visible.
+
+		PvsStats stats;
+	};
+
+	static const u32 c_pvsCacheMagic   = 0x31535650;	// "PVS1"
+	static const u32 c_pvsCacheVersion = 1;
+	// Maximum number of portals visited while building a single row.
+	static const s32 c_pvsMaxFlowSteps = 32768;
+	static const f32 c_pvsEps = 0.01f;
+
+	static PvsState s_pvs = {};
+	static bool s_pvsEnable = true;
+
+	// Flow state.
+	static u32* s_flowRow = nullptr;
+	static s32  s_flowSteps = 0;
+	static bool s_flowOverflow = false;
+
+	/////////////////////////////////////////////
+	// Geometry helpers
+	/////////////////////////////////////////////
+	static PvsSegment getWallSegment(const RWall* wall)
+	{
+		PvsSegment seg;
+		seg.v0 = { fixed16ToFloat(wall->w0->x), fixed16ToFloat(wall->w0->z) };
+		seg.v1 = { fixed16ToFloat(wall->w1->x), fixed16ToFloat(wall->w1->z) };
+		return seg;
+	}
+
+	// Adjoins where both sides do not share the same vertices do not continue straight lines,
+	// so the flow through them has to start over.
+	static bool portalIsContinuous(const RWall* wall)
+	{
+		const RWall* mirror = wall->mirrorWall;
+		if (!mirror) { return false; }
+		const fixed16_16 eps = FIXED(1) / 64;
+		return TFE_Jedi::abs(wall->w0->x - mirror->w1->x) <= eps && TFE_Jedi::abs(wall->w0->z - mirror->w1->z) <= eps &&
+			   TFE_Jedi::abs(wall->w1->x - mirror->w0->x) <= eps && TFE_Jedi::abs(wall->w1->z - mirror->w0->z) <= eps;
+	}
+
+	// Signed distance of 'p' from the line through 'a' and 'b', scaled by 'invLen'.
+	static f32 lineSide(Vec2f a, Vec2f b, f32 invLen, Vec2f p)
+	{
+		return ((b.x - a.x)*(p.z - a.z) - (b.z - a.z)*(p.x - a.x)) * invLen;
+	}
+
+	// Clip 'seg' to the side of the line (a, b) given by 'keepSign'. Returns false if nothing is left.
+	static bool clipSegmentToLine(PvsSegment* seg, Vec2f a, Vec2f b, f32 invLen, f32 keepSign)
+	{
+		const f32 d0 = lineSide(a, b, invLen, seg->v0) * keepSign;
+		const f32 d1 = lineSide(a, b, invLen, seg->v1) * keepSign;
+		if (d0 < -c_pvsEps && d1 < -c_pvsEps) { return false; }
+		if (d0 >= -c_pvsEps && d1 >= -c_pvsEps) { return true; }
+
+		const f32 s = d0 / (d0 - d1);
+		const Vec2f p = { seg->v0.x + (seg->v1.x - seg->v0.x)*s, seg->v0.z + (seg->v1.z - seg->v0.z)*s };
+		if (d0 < -c_pvsEps) { seg->v0 = p; }
+		else { seg->v1 = p; }
+		return true;
+	}
+
+	static f32 getInvLength(Vec2f a, Vec2f b)
+	{
+		const f32 dx = b.x - a.x, dz = b.z - a.z;
+		const f32 lenSq = dx*dx + dz*dz;
+		return lenSq > c_pvsEps*c_pvsEps ? 1.0f / sqrtf(lenSq) : 0.0f;
+	}
+
+	// Clip 'target' to the region that can be reached by lines passing through 'source' and then 'pass'.
+	// Any approximation must keep more of the target, never less.
+	static bool clipToAntipenumbra(const PvsSegment& source, const PvsSegment& pass, PvsSegment* target)
+	{
+		// The target must be beyond the pass portal, if the source is fully on one side.
+		const f32 passInvLen = getInvLength(pass.v0, pass.v1);
+		if (passInvLen > 0.0f)
+		{
+			const f32 s0 = lineSide(pass.v0, pass.v1, passInvLen, source.v0);
+			const f32 s1 = lineSide(pass.v0, pass.v1, passInvLen, source.v1);
+			if (s0 < -c_pvsEps && s1 < -c_pvsEps)
+			{
+				if (!clipSegmentToLine(target, pass.v0, pass.v1, passInvLen, 1.0f)) { return false; }
+			}
+			else if (s0 > c_pvsEps && s1 > c_pvsEps)
+			{
+				if (!clipSegmentToLine(target, pass.v0, pass.v1, passInvLen, -1.0f)) { return false; }
+			}
+		}
+
+		// Clip by the separating lines: lines through a source vertex and a pass vertex with the source and pass on opposite sides.
+		const Vec2f* sv = &source.v0;
+		const Vec2f* pv = &pass.v0;
+		for (s32 i = 0; i < 2; i++)
+		{
+			for (s32 j = 0; j < 2; j++)
+			{
+				const Vec2f a = sv[i];
+				const Vec2f b = pv[j];
+				const f32 invLen = getInvLength(a, b);
+				if (invLen == 0.0f) { continue; }
+
+				const f32 sideSource = lineSide(a, b, invLen, sv[1 - i]);
+				const f32 sidePass   = lineSide(a, b, invLen, pv[1 - j]);
+				if ((sideSource < -c_pvsEps && sidePass > c_pvsEps) || (sideSource > c_pvsEps && sidePass < -c_pvsEps))
+				{
+					if (!clipSegmentToLine(target, a, b, invLen, sidePass > 0.0f ? 1.0f : -1.0f)) { return false; }
+				}
+			}
+		}
+		return true;
+	}
+
+	/////////////////////////////////////////////
+	// Flow
+	/////////////////////////////////////////////
+	static void setVisible(u32* row, s32 index)
+	{
+		row[index >> 5] |= (1u << (index & 31));
+	}
+
+	static bool isVisible(const u32* row, s32 index)
+	{
+		return (row[index >> 5] & (1u << (index & 31))) != 0;
+	}
+
+	// Flow through 'sector', which was entered through 'entry'.
+	// 'pass' is the (clipped) portal used to enter the sector and 'source' is the first portal on the path, which may be null
+	// when the flow starts at 'pass'.
+	static void pvsFlow(RSector* sector, const RWall* entry, const PvsSegment* source, const PvsSegment& pass, s32 depth)
+	{
+		if (depth >= MAX_ADJOIN_DEPTH_EXT) { return; }
+
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount && !s_flowOverflow; w++, wall++)
+		{
+			RSector* next = wall->nextSector;
+			if (!next || wall == entry) { continue; }
+
+			s_flowSteps++;
+			if (s_flowSteps > c_pvsMaxFlowSteps)
+			{
+				s_flowOverflow = true;
+				break;
+			}
+
+			PvsSegment target = getWallSegment(wall);
+			if (source && !clipToAntipenumbra(*source, pass, &target)) { continue; }
+			setVisible(s_flowRow, next->index);
+
+			if (portalIsContinuous(wall))
+			{
+				pvsFlow(next, wall->mirrorWall, source ? source : &pass, target, depth + 1);
+			}
+			else if (wall->mirrorWall)
+			{
+				pvsFlow(next, wall->mirrorWall, nullptr, getWallSegment(wall->mirrorWall), depth + 1);
+			}
+		}
+	}
+
+	static void buildRow(u32 index)
+	{
+		u32* row = &s_pvs.rows[index * s_pvs.wordsPerRow];
+		memset(row, 0, sizeof(u32) * s_pvs.wordsPerRow);
+
+		s_flowRow = row;
+		s_flowSteps = 0;
+		s_flowOverflow = false;
+
+		RSector* sector = &s_levelState.sectors[index];
+		setVisible(row, sector->index);
+
+		// Every sector adjoined to the source sector is visible, then flow out from each adjoin.
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount && !s_flowOverflow; w++, wall++)
+		{
+			RSector* next = wall->nextSector;
+			if (!next) { continue; }
+			setVisible(row, next->index);
+
+			const RWall* mirror = wall->mirrorWall;
+			const PvsSegment pass = getWallSegment(mirror ? mirror : wall);
+			pvsFlow(next, mirror, nullptr, pass, 1);
+		}
+		s_pvs.rowState[index] = s_flowOverflow ? PVS_ROW_ALL : PVS_ROW_VALID;
+	}
+
+	/////////////////////////////////////////////
+	// Cache
+	/////////////////////////////////////////////
+	// The hash uses the original wall positions (worldPos0) rather than the live vertices, so saves made after
+	// sectors have moved or rotated map to the same cache entry as the level itself.
+	static u64 computeGeometryHash()
+	{
+		u64 hash = TFE_Hash::fnv1a64Value(s_levelState.sectorCount, TFE_Hash::FNV64_OFFSET);
+		hash = TFE_Hash::fnv1a64Value(c_pvsMaxFlowSteps, hash);
+		const RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			hash = TFE_Hash::fnv1a64Value(sector->vertexCount, hash);
+			hash = TFE_Hash::fnv1a64Value(sector->wallCount, hash);
+
+			const RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				const s32 wallData[] =
+				{
+					wall->worldPos0.x,
+					wall->worldPos0.z,
+					s32(wall->w0 - sector->verticesWS),
+					s32(wall->w1 - sector->verticesWS),
+					wall->nextSector ? wall->nextSector->index : -1,
+					wall->mirror,
+				};
+				hash = TFE_Hash::fnv1a64(wallData, sizeof(wallData), hash);
+			}
+		}
+		return hash;
+	}
+
+	// Returns true if no wall has moved from its original position, only then does the cache match the live geometry.
+	static bool isOriginalGeometry()
+	{
+		const RSector* sector = s_levelState.sectors;
+		for (u32 s = 0; s < s_levelState.sectorCount; s++, sector++)
+		{
+			const RWall* wall = sector->walls;
+			for (s32 w = 0; w < sector->wallCount; w++, wall++)
+			{
+				if (wall->w0->x != wall->worldPos0.x || wall->w0->z != wall->worldPos0.z) { return false; }
+			}
+		}
+		return true;
+	}
+
+	static void getCachePath(u64 hash, char* path)
+	{
+		char dir[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_PROGRAM_DATA, "PVS/", dir);
+		if (!FileUtil::directoryExits(dir))
+		{
+			FileUtil::makeDirectory(dir);
+		}
+		sprintf(path, "%s%016llx.pvs", dir, (unsigned long long)hash);
+	}
+
+	static bool readCache(const char* path, u64 hash)
+	{
+		FileStream file;
+		if (!file.open(path, Stream::MODE_READ)) { return false; }
+
+		PvsCacheHeader header = { 0 };
+		file.readBuffer(&header, sizeof(PvsCacheHeader));
+		const u32 rowSize = sizeof(u32) * s_pvs.wordsPerRow * s_pvs.sectorCount;
+		bool valid = header.magic == c_pvsCacheMagic && header.version == c_pvsCacheVersion && header.geometryHash == hash &&
+			header.sectorCount == s_pvs.sectorCount && header.wordsPerRow == s_pvs.wordsPerRow &&
+			file.getSize() == sizeof(PvsCacheHeader) + s_pvs.sectorCount + rowSize;
+		if (valid)
+		{
+			file.readBuffer(s_pvs.rowState, s_pvs.sectorCount);
+			file.readBuffer(s_pvs.rows, rowSize);
+			for (u32 s = 0; s < s_pvs.sectorCount && valid; s++)
+			{
+				valid = s_pvs.rowState[s] == PVS_ROW_VALID || s_pvs.rowState[s] == PVS_ROW_ALL;
+			}
+		}
+		file.close();
+		return valid;
+	}
+
+	static void writeCache(const char* path, u64 hash)
+	{
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_WARNING, "PVS", "Cannot write the PVS cache '%s'.", path);
+			return;
+		}
+
+		const PvsCacheHeader header = { c_pvsCacheMagic, c_pvsCacheVersion, hash, s_pvs.sectorCount, s_pvs.wordsPerRow };
+		file.writeBuffer(&header, sizeof(PvsCacheHeader));
+		file.writeBuffer(s_pvs.rowState, s_pvs.sectorCount);
+		file.writeBuffer(s_pvs.rows, sizeof(u32) * s_pvs.wordsPerRow * s_pvs.sectorCount);
+		file.close();
+	}
+
+	/////////////////////////////////////////////
+	// API
+	/////////////////////////////////////////////
+	void pvs_clear()
+	{
+		// The memory itself is owned by the level region.
+		s_pvs = {};
+	}
+
+	void pvs_build()
+	{
+		pvs_clear();
+		if (!s_levelState.sectors || !s_levelState.sectorCount) { return; }
+
+		const u64 start = TFE_System::getCurrentTimeInTicks();
+		s_pvs.sectorCount = s_levelState.sectorCount;
+		s_pvs.wordsPerRow = (s_pvs.sectorCount + 31) >> 5;
+		s_pvs.rows = (u32*)level_alloc(sizeof(u32) * s_pvs.wordsPerRow * s_pvs.sectorCount);
+		s_pvs.rowState   = (u8*)level_alloc(s_pvs.sectorCount);
+		s_pvs.dirtyFrame = (s32*)level_alloc(sizeof(s32) * s_pvs.sectorCount);
+		s_pvs.movedFrame = (s32*)level_alloc(sizeof(s32) * s_pvs.sectorCount);
+		memset(s_pvs.dirtyFrame, 0, sizeof(s32) * s_pvs.sectorCount);
+		for (u32 s = 0; s < s_pvs.sectorCount; s++)
+		{
+			s_pvs.movedFrame[s] = -1;
+		}
+		s_pvs.frame = 1;
+
+		// Moved geometry (such as a save made after a door rotated) is built without touching the cache.
+		char cachePath[TFE_MAX_PATH];
+		const bool useCache = isOriginalGeometry();
+		const u64 hash = useCache ? computeGeometryHash() : 0;
+		if (useCache)
+		{
+			getCachePath(hash, cachePath);
+		}
+
+		s_pvs.stats.fromCache = useCache && readCache(cachePath, hash);
+		if (!s_pvs.stats.fromCache)
+		{
+			for (u32 s = 0; s < s_pvs.sectorCount; s++)
+			{
+				buildRow(s);
+			}
+			if (useCache)
+			{
+				writeCache(cachePath, hash);
+			}
+		}
+		s_pvs.stats.buildTimeMs = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) * 1000.0;
+
+		PvsStats stats;
+		pvs_getStats(&stats);
+		TFE_System::logWrite(LOG_MSG, "PVS", "%s PVS for %d sectors in %0.2f ms, average visible: %0.1f, overflow: %d.",
+			stats.fromCache ? "Loaded" : "Built", stats.sectorCount, stats.buildTimeMs, stats.avgVisible, stats.sectorCount - stats.validCount);
+	}
+
+	void pvs_onWallsMoved(RSector* sector)
+	{
+		if (!s_pvs.rows || !sector || u32(sector->index) >= s_pvs.sectorCount) { return; }
+		// Walls may move several times in the same frame.
+		if (s_pvs.movedFrame[sector->index] == s_pvs.frame) { return; }
+		s_pvs.movedFrame[sector->index] = s_pvs.frame;
+
+		// A set is affected if it can see the sector or one of its neighbors, since only their adjoins change shape.
+		const s32 maxMaskCount = 256;
+		s32 mask[maxMaskCount];
+		s32 maskCount = 0;
+		mask[maskCount++] = sector->index;
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount && maskCount < maxMaskCount; w++, wall++)
+		{
+			if (wall->nextSector) { mask[maskCount++] = wall->nextSector->index; }
+		}
+		const bool maskComplete = maskCount < maxMaskCount;
+
+		for (u32 r = 0; r < s_pvs.sectorCount; r++)
+		{
+			if (s_pvs.rowState[r] == PVS_ROW_ALL) { continue; }
+
+			bool affected = !maskComplete;
+			const u32* row = &s_pvs.rows[r * s_pvs.wordsPerRow];
+			for (s32 m = 0; m < maskCount && !affected; m++)
+			{
+				affected = isVisible(row, mask[m]);
+			}
+			if (affected)
+			{
+				s_pvs.rowState[r] = PVS_ROW_DIRTY;
+				s_pvs.dirtyFrame[r] = s_pvs.frame;
+			}
+		}
+	}
+
+	void pvs_beginView(RSector* sector)
+	{
+		s_pvs.viewRow = nullptr;
+		s_pvs.frame++;
+		if (!s_pvsEnable || !s_pvs.rows || !sector || u32(sector->index) >= s_pvs.sectorCount) { return; }
+
+		const s32 index = sector->index;
+		// Wait until the walls have stopped moving before rebuilding.
+		if (s_pvs.rowState[index] == PVS_ROW_DIRTY && s_pvs.frame > s_pvs.dirtyFrame[index] + 1)
+		{
+			buildRow(index);
+			s_pvs.stats.rebuildCount++;
+		}
+		if (s_pvs.rowState[index] == PVS_ROW_VALID)
+		{
+			s_pvs.viewRow = &s_pvs.rows[index * s_pvs.wordsPerRow];
+		}
+	}
+
+	bool pvs_isVisible(RSector* sector)
+	{
+		if (!s_pvs.viewRow || u32(sector->index) >= s_pvs.sectorCount) { return true; }
+		return isVisible(s_pvs.viewRow, sector->index);
+	}
+
+	void pvs_getStats(PvsStats* stats)
+	{
+		*stats = s_pvs.stats;
+		stats->sectorCount = s_pvs.sectorCount;
+		stats->validCount = 0;
+		stats->dirtyCount = 0;
+		stats->avgVisible = 0.0;
+		for (u32 r = 0; r < s_pvs.sectorCount; r++)
+		{
+			if (s_pvs.rowState[r] == PVS_ROW_DIRTY) { stats->dirtyCount++; }
+			if (s_pvs.rowState[r] != PVS_ROW_VALID) { continue; }
+
+			const u32* row = &s_pvs.rows[r * s_pvs.wordsPerRow];
+			s32 count = 0;
+			for (u32 i = 0; i < s_pvs.wordsPerRow; i++)
+			{
+				for (u32 bits = row[i]; bits; bits &= bits - 1) { count++; }
+			}
+			stats->validCount++;
+			stats->avgVisible += f64(count);
+		}
+		if (stats->validCount)
+		{
+			stats->avgVisible /= f64(stats->validCount);
+		}
+	}
+
+	void console_pvsStats(const ConsoleArgList& args)
+	{
+		PvsStats stats;
+		pvs_getStats(&stats);
+		if (!stats.sectorCount)
+		{
+			TFE_Console::addToHistory("No PVS data, no level is loaded.");
+			return;
+		}
+
+		char res[256];
+		sprintf(res, "PVS %s in %0.2f ms: %d sectors, %d valid, %d dirty, %d rebuilds, average visible %0.1f.", stats.fromCache ? "loaded" : "built",
+			stats.buildTimeMs, stats.sectorCount, stats.validCount, stats.dirtyCount, stats.rebuildCount, stats.avgVisible);
+		TFE_Console::addToHistory(res);
+	}
+
+	void pvs_registerCommands()
+	{
+		CVAR_BOOL(s_pvsEnable, "r_sectorPvs", CVFLAG_DO_NOT_SERIALIZE, "Use the sector PVS to reject adjoins during traversal.");
+		CCMD("pvsStats", console_pvsStats, 0, "Print statistics for the sector PVS of the current level.");
+	}
+}  // TFE_Jedi
@@ -0,0 +1,46 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Sector PVS (potentially visible sets)
+// For each sector, the set of sectors that can ever be seen through
+// its adjoins. This is computed from the 2D (XZ) adjoin geometry when
+// the level is loaded - ignoring heights so it is always conservative -
+// and cached on disk keyed by a hash of the geometry.
+//
+// The renderers use the set of the camera sector to reject adjoins
+// early during traversal. When INF moves or rotates walls, the sets
+// that may be affected fall back to "everything is visible" and are
+// rebuilt once the walls stop moving.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+struct RSector;
+
+namespace TFE_Jedi
+{
+	struct PvsStats
+	{
+		s32 sectorCount;
+		s32 validCount;		// number of sectors with a usable PVS.
+		s32 dirtyCount;		// number of sectors waiting for a rebuild after walls moved.
+		s32 rebuildCount;	// number of runtime rebuilds.
+		f64 avgVisible;		// average number of potentially visible sectors per valid set.
+		bool fromCache;
+		f64 buildTimeMs;
+	};
+
+	// Build the PVS for the currently loaded level geometry, or read it from the cache.
+	void pvs_build();
+	// Called when level data is cleared, the PVS memory is owned by the level.
+	void pvs_clear();
+
+	// Called when walls in 'sector' have moved.
+	void pvs_onWallsMoved(RSector* sector);
+
+	// Set the camera sector at the start of a traversal, this may rebuild its set.
+	void pvs_beginView(RSector* sector);
+	// Returns false only if 'sector' can never be seen from the current camera sector.
+	bool pvs_isVisible(RSector* sector);
+
+	void pvs_getStats(PvsStats* stats);
+	void pvs_registerCommands();
+}  // TFE_Jedi
@@ -0,0 +1,61 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// SIMD helpers
+// SSE2 is part of the x86-64 baseline so it is used whenever the
+// compiler targets it, TFE_SIMD_SSE2 is left undefined on other
+// targets and the callers fall back to their scalar code.
+//////////////////////////////////////////////////////////////////////
+#include "fixedPoint.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TFE_SIMD_SSE2 1
+#include <emmintrin.h>
+
+namespace TFE_Jedi
+{
+	// 4-wide mul16(), bit exact with the scalar version.
+	// SSE2 only has an unsigned 32x32->64 multiply, the result is corrected to the signed product and
+	// only bits 16-47 are kept, matching fixed16_16((s64(x) * s64(y)) >> 16).
+	inline __m128i mul16_x4(__m128i x, __m128i y)
+	{
+		const __m128i prodEven = _mm_srli_epi64(_mm_mul_epu32(x, y), FRAC_BITS_16);
+		const __m128i prodOdd  = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32)), FRAC_BITS_16);
+		const __m128i prod = _mm_unpacklo_epi32(_mm_shuffle_epi32(prodEven, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(prodOdd, _MM_SHUFFLE(3, 1, 2, 0)));
+
+		// signed(x*y) = unsigned(x*y) - ((x < 0 ? y : 0) + (y < 0 ? x : 0)) << 32
+		const __m128i correction = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(x, 31), y), _mm_and_si128(_mm_srai_epi32(y, 31), x));
+		return _mm_sub_epi32(prod, _mm_slli_epi32(correction, 32 - FRAC_BITS_16));
+	}
+
+	inline __m128i select_x4(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	inline __m128i max_x4(__m128i a, __m128i b)
+	{
+		return select_x4(_mm_cmpgt_epi32(a, b), a, b);
+	}
+
+	inline __m128i min_x4(__m128i a, __m128i b)
+	{
+		return select_x4(_mm_cmplt_epi32(a, b), a, b);
+	}
+
+	inline __m128 select_x4(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	// Matches the scalar max() and min(): a > b ? a : b and a < b ? a : b
+	inline __m128 max_x4(__m128 a, __m128 b)
+	{
+		return select_x4(_mm_cmpgt_ps(a, b), a, b);
+	}
+
+	inline __m128 min_x4(__m128 a, __m128 b)
+	{
+		return select_x4(_mm_cmplt_ps(a, b), a, b);
+	}
+}
+#endif
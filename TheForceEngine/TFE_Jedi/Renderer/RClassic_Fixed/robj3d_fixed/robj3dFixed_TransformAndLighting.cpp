@@ -1,6 +1,7 @@
 #include <TFE_System/profiler.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Jedi/Math/simd.h>
 #include "robj3dFixed_TransformAndLighting.h"
 #include "../rclassicFixedSharedState.h"
 #include "../rlightingFixed.h"
@@ -31,6 +32,12 @@ namespace RClassic_Fixed
 	/////////////////////////////////////////////
 	// Polygon normals in viewspace (used for culling).
 	std::vector<vec3_fixed> s_polygonNormalsVS;
+
+#ifdef TFE_SIMD_SSE2
+	// View space vertices and vertex normals as x[], y[], z[] arrays for the SIMD lighting.
+	static std::vector<s32> s_verticesVS_SoA;
+	static std::vector<s32> s_vertexNormalsVS_SoA;
+#endif
 			
 	void robj3d_transformVertices(s32 vertexCount, vec3_fixed* vtxIn, s32* xform, vec3_fixed* offset, vec3_fixed* vtxOut)
 	{
@@ -115,6 +122,117 @@ namespace RClassic_Fixed
 		}
 	}
 
+#ifdef TFE_SIMD_SSE2
+	// Transforms 4 vertices per iteration from the model SoA data, bit exact with robj3d_transformVertices().
+	// Writes 'count' vec3 results and optionally all 'paddedCount' SoA results.
+	void robj3d_transformVerticesSimd(s32 count, s32 paddedCount, const s32* vtxIn, const s32* xform, const vec3_fixed* offset, vec3_fixed* vtxOut, s32* vtxOutSoA)
+	{
+		const s32* inX = vtxIn;
+		const s32* inY = vtxIn + paddedCount;
+		const s32* inZ = vtxIn + 2 * paddedCount;
+		const __m128i m0 = _mm_set1_epi32(xform[0]), m1 = _mm_set1_epi32(xform[1]), m2 = _mm_set1_epi32(xform[2]);
+		const __m128i m3 = _mm_set1_epi32(xform[3]), m4 = _mm_set1_epi32(xform[4]), m5 = _mm_set1_epi32(xform[5]);
+		const __m128i m6 = _mm_set1_epi32(xform[6]), m7 = _mm_set1_epi32(xform[7]), m8 = _mm_set1_epi32(xform[8]);
+		const __m128i offsetX = _mm_set1_epi32(offset->x);
+		const __m128i offsetY = _mm_set1_epi32(offset->y);
+		const __m128i offsetZ = _mm_set1_epi32(offset->z);
+
+		alignas(16) s32 outX[4], outY[4], outZ[4];
+		for (s32 v = 0; v < paddedCount; v += 4)
+		{
+			const __m128i x = _mm_loadu_si128((const __m128i*)&inX[v]);
+			const __m128i y = _mm_loadu_si128((const __m128i*)&inY[v]);
+			const __m128i z = _mm_loadu_si128((const __m128i*)&inZ[v]);
+
+			const __m128i rx = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(mul16_x4(x, m0), mul16_x4(y, m3)), mul16_x4(z, m6)), offsetX);
+			const __m128i ry = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(mul16_x4(x, m1), mul16_x4(y, m4)), mul16_x4(z, m7)), offsetY);
+			const __m128i rz = _mm_add_epi32(_mm_add_epi32(_mm_add_epi32(mul16_x4(x, m2), mul16_x4(y, m5)), mul16_x4(z, m8)), offsetZ);
+			if (vtxOutSoA)
+			{
+				_mm_storeu_si128((__m128i*)&vtxOutSoA[v], rx);
+				_mm_storeu_si128((__m128i*)&vtxOutSoA[v + paddedCount], ry);
+				_mm_storeu_si128((__m128i*)&vtxOutSoA[v + 2 * paddedCount], rz);
+			}
+
+			_mm_store_si128((__m128i*)outX, rx);
+			_mm_store_si128((__m128i*)outY, ry);
+			_mm_store_si128((__m128i*)outZ, rz);
+			const s32 laneCount = min(4, count - v);
+			for (s32 i = 0; i < laneCount; i++)
+			{
+				vtxOut[v + i] = { outX[i], outY[i], outZ[i] };
+			}
+		}
+	}
+
+	// Lights 4 vertices per iteration, bit exact with robj3d_shadeVertices().
+	void robj3d_shadeVerticesSimd(s32 count, s32 paddedCount, fixed16_16* outShading, const s32* vertices, const s32* normals)
+	{
+		if (s_sectorAmbient >= 31)
+		{
+			for (s32 i = 0; i < count; i++) { outShading[i] = VSHADE_MAX_INTENSITY; }
+			return;
+		}
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ambientFraction = _mm_set1_epi32(s_sectorAmbientFraction);
+		const __m128i sectorAmbient = _mm_set1_epi32(intToFixed16(s_sectorAmbient));
+		const __m128i scaledAmbient = _mm_set1_epi32(s_scaledAmbient);
+		const __m128i maxIntensity = _mm_set1_epi32(VSHADE_MAX_INTENSITY);
+		const __m128i maxDepth = _mm_set1_epi32(127);
+		const bool cameraLight = s_worldAmbient < 31 || s_cameraLightSource;
+
+		alignas(16) s32 depthScaled[4], cameraSource[4], intensityOut[4];
+		for (s32 v = 0; v < paddedCount; v += 4)
+		{
+			const __m128i vx = _mm_loadu_si128((const __m128i*)&vertices[v]);
+			const __m128i vy = _mm_loadu_si128((const __m128i*)&vertices[v + paddedCount]);
+			const __m128i vz = _mm_loadu_si128((const __m128i*)&vertices[v + 2 * paddedCount]);
+			// Normals are stored as position + direction.
+			const __m128i nx = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)&normals[v]), vx);
+			const __m128i ny = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)&normals[v + paddedCount]), vy);
+			const __m128i nz = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)&normals[v + 2 * paddedCount]), vz);
+
+			// Lighting
+			__m128i lightIntensity = zero;
+			for (s32 i = 0; i < s_lightCount; i++)
+			{
+				const CameraLight* light = &s_cameraLight[i];
+				const __m128i I = _mm_add_epi32(_mm_add_epi32(mul16_x4(nx, _mm_set1_epi32(light->lightVS.x)), mul16_x4(ny, _mm_set1_epi32(light->lightVS.y))),
+					mul16_x4(nz, _mm_set1_epi32(light->lightVS.z)));
+				const __m128i sourceIntensity = _mm_set1_epi32(mul16(VSHADE_MAX_INTENSITY, light->brightness));
+				lightIntensity = _mm_add_epi32(lightIntensity, _mm_and_si128(_mm_cmpgt_epi32(I, zero), mul16_x4(I, sourceIntensity)));
+			}
+			__m128i intensity = mul16_x4(lightIntensity, ambientFraction);
+
+			// Distance falloff
+			const __m128i z = max_x4(zero, vz);
+			if (cameraLight)
+			{
+				_mm_store_si128((__m128i*)depthScaled, min_x4(_mm_srai_epi32(z, 14), maxDepth));
+				for (s32 i = 0; i < 4; i++)
+				{
+					const s32 source = MAX_LIGHT_LEVEL - (s_lightSourceRamp[depthScaled[i]] + s_worldAmbient);
+					cameraSource[i] = source > 0 ? intToFixed16(source) : 0;
+				}
+				intensity = _mm_add_epi32(intensity, _mm_load_si128((const __m128i*)cameraSource));
+			}
+			intensity = max_x4(intensity, sectorAmbient);
+
+			const __m128i falloff = _mm_add_epi32(_mm_srai_epi32(z, LIGHT_ATTEN0), _mm_srai_epi32(z, LIGHT_ATTEN1));
+			intensity = max_x4(_mm_sub_epi32(intensity, falloff), scaledAmbient);
+			intensity = min_x4(max_x4(intensity, zero), maxIntensity);
+
+			_mm_store_si128((__m128i*)intensityOut, intensity);
+			const s32 laneCount = min(4, count - v);
+			for (s32 i = 0; i < laneCount; i++)
+			{
+				outShading[v + i] = intensityOut[i];
+			}
+		}
+	}
+#endif
+
 	void robj3d_allocateBuffers(JediModel* model)
 	{
 		if (model->vertexCount > s_verticesVS.size())
@@ -127,6 +245,13 @@ namespace RClassic_Fixed
 		{
 			s_polygonNormalsVS.resize(model->polygonCount);
 		}
+	#ifdef TFE_SIMD_SSE2
+		if (3 * model->vertexCountSoA > (s32)s_verticesVS_SoA.size())
+		{
+			s_verticesVS_SoA.resize(3 * model->vertexCountSoA);
+			s_vertexNormalsVS_SoA.resize(3 * model->vertexCountSoA);
+		}
+	#endif
 	}
 		
 	void robj3d_transformAndLight(SecObject* obj, JediModel* model)
@@ -147,6 +272,22 @@ namespace RClassic_Fixed
 		fixed16_16 xform[9];
 		mulMatrix3x3(s_rcfState.cameraMtx, obj->transform, xform);
 
+	#ifdef TFE_SIMD_SSE2
+		if (s_simdModelTransform && model->verticesSoA && (model->vertexNormalsSoA || !(model->flags & MFLAG_VERTEX_LIT)))
+		{
+			robj3d_transformVerticesSimd(model->vertexCount, model->vertexCountSoA, model->verticesSoA, xform, &offsetVS, s_verticesVS.data(), s_verticesVS_SoA.data());
+			if (model->flags & MFLAG_DRAW_VERTICES) { return; }
+
+			robj3d_transformVerticesSimd(model->polygonCount, model->polygonCountSoA, model->polygonNormalsSoA, xform, &offsetVS, s_polygonNormalsVS.data(), nullptr);
+			if (model->flags & MFLAG_VERTEX_LIT)
+			{
+				robj3d_transformVerticesSimd(model->vertexCount, model->vertexCountSoA, model->vertexNormalsSoA, xform, &offsetVS, s_vertexNormalsVS.data(), s_vertexNormalsVS_SoA.data());
+				robj3d_shadeVerticesSimd(model->vertexCount, model->vertexCountSoA, s_vertexIntensity.data(), s_verticesVS_SoA.data(), s_vertexNormalsVS_SoA.data());
+			}
+			return;
+		}
+	#endif
+
 		// Transform model vertices into view space.
 		robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertices, xform, &offsetVS, s_verticesVS.data());
 
@@ -164,4 +305,34 @@ namespace RClassic_Fixed
 		}
 	}
 
-}}  // TFE_Jedi
\ No newline at end of file
+	s32 robj3d_compareTransformAndLight(SecObject* obj, JediModel* model, s32* valueCount)
+	{
+		const bool simdEnabled = s_simdModelTransform;
+		s_simdModelTransform = false;
+		robj3d_transformAndLight(obj, model);
+		const std::vector<vec3_fixed> vertices(s_verticesVS.begin(), s_verticesVS.begin() + model->vertexCount);
+		const std::vector<vec3_fixed> polygonNormals(s_polygonNormalsVS.begin(), s_polygonNormalsVS.begin() + model->polygonCount);
+		const std::vector<fixed16_16> intensity(s_vertexIntensity.begin(), s_vertexIntensity.begin() + model->vertexCount);
+
+		s_simdModelTransform = true;
+		robj3d_transformAndLight(obj, model);
+		s_simdModelTransform = simdEnabled;
+
+		const bool lit = (model->flags & MFLAG_VERTEX_LIT) && !(model->flags & MFLAG_DRAW_VERTICES);
+		const bool normals = !(model->flags & MFLAG_DRAW_VERTICES);
+		s32 mismatchCount = 0;
+		for (s32 i = 0; i < model->vertexCount; i++)
+		{
+			if (vertices[i].x != s_verticesVS[i].x || vertices[i].y != s_verticesVS[i].y || vertices[i].z != s_verticesVS[i].z) { mismatchCount++; }
+			if (lit && intensity[i] != s_vertexIntensity[i]) { mismatchCount++; }
+		}
+		for (s32 i = 0; normals && i < model->polygonCount; i++)
+		{
+			const vec3_fixed& n = polygonNormals[i];
+			if (n.x != s_polygonNormalsVS[i].x || n.y != s_polygonNormalsVS[i].y || n.z != s_polygonNormalsVS[i].z) { mismatchCount++; }
+		}
+		*valueCount = model->vertexCount * (lit ? 2 : 1) + (normals ? model->polygonCount : 0);
+		return mismatchCount;
+	}
+
+}}  // TFE_Jedi
@@ -25,5 +25,7 @@ namespace TFE_Jedi
 		extern std::vector<vec3_fixed> s_polygonNormalsVS;
 
 		void robj3d_transformAndLight(SecObject* obj, JediModel* model);
+		// Runs both the scalar and SIMD paths and returns the number of values that differ.
+		s32  robj3d_compareTransformAndLight(SecObject* obj, JediModel* model, s32* valueCount);
 	}
 }
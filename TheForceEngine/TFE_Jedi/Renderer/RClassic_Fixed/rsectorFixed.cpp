@@ -5,6 +5,7 @@
 #include <TFE_Jedi/Level/rsector.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Level/sectorPvs.h>
 #include <TFE_Jedi/Math/fixedPoint.h>
 #include <TFE_Jedi/Math/core_math.h>
 
@@ -77,13 +78,7 @@ namespace TFE_Jedi
 
 			for (s32 i = count - 1; i >= 0 && drawCount < MAX_VIEW_OBJ_COUNT; i--, obj++)
 			{
-				// Search for the next allocated object.
 				SecObject* curObj = *obj;
-				while (!curObj)
-				{
-					obj++;
-					curObj = *obj;
-				}
 
 				if (curObj->flags & OBJ_FLAG_NEEDS_TRANSFORM)
 				{
@@ -235,11 +230,6 @@ namespace TFE_Jedi
 				for (s32 i = s_curSector->objectCount - 1; i >= 0; i--, obj++)
 				{
 					SecObject* curObj = *obj;
-					while (!curObj)
-					{
-						obj++;
-						curObj = *obj;
-					}
 
 					if (curObj->flags & OBJ_FLAG_NEEDS_TRANSFORM)
 					{
@@ -440,7 +430,10 @@ namespace TFE_Jedi
 					}
 
 					s_rcfState.windowMinZ = min(curAdjoinSeg->z0, curAdjoinSeg->z1);
-					draw(nextSector);
+					if (pvs_isVisible(nextSector))
+					{
+						draw(nextSector);
+					}
 					
 					if (s_adjoinDepth)
 					{
@@ -6,6 +6,7 @@
 #include "redgePairFloat.h"
 #include "rclassicFloat.h"
 #include "rclassicFloatSharedState.h"
+#include "rrasterFloat.h"
 #include "fixedPoint20.h"
 #include "../rscanline.h"
 #include "../rsectorRender.h"
@@ -77,76 +78,150 @@ namespace RClassic_Float
 		}
 	}
 				
+	enum ScanlineFuncId
+	{
+		SCANLINE_LIT = 0,
+		SCANLINE_FULLBRIGHT,
+		SCANLINE_LIT_TRANS,
+		SCANLINE_FULLBRIGHT_TRANS,
+
+		SCANLINE_COUNT
+	};
+
+	// Scanline parameters, copied from the scanline state so the scanline can also be drawn later by the deferred raster.
+	struct ScanlineParams
+	{
+		u8* out;		// output for the left most pixel.
+		const u8* tex;
+		const u8* light;
+		fixed44_20 U0;	// texture coordinates of the right most pixel.
+		fixed44_20 V0;
+		fixed44_20 dUdX;
+		fixed44_20 dVdX;
+		s32 x0;
+		s32 width;
+		s32 texDataEnd;
+		s32 func;
+	};
+
+	// Scanlines are drawn from right to left, starting at U0, V0. Only pixels [i0, i1] are drawn, the starting
+	// texture coordinates are stepped to pixel i1 so a partial scanline matches the same pixels of the full scanline.
 	// This produces functionally identical results to the original but splits apart the U/V and dUdx/dVdx into seperate variables
 	// to account for C vs ASM differences.
-	void drawScanline()
+	static void scanline_lit(const ScanlineParams* scan, s32 i0, s32 i1)
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
+		const fixed44_20 dVdX = scan->dVdX;
+		const fixed44_20 dUdX = scan->dUdX;
+		const fixed44_20 skip = fixed44_20(scan->width - 1 - i1);
+		fixed44_20 V = scan->V0 + skip * dVdX;
+		fixed44_20 U = scan->U0 + skip * dUdX;
+		const u8* tex = scan->tex;
+		const u8* light = scan->light;
+		const s32 dataEnd = scan->texDataEnd;
+		u8* out = scan->out;
 
 		// Note this produces a distorted mapping if the texture is not 64x64.
 		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		for (s32 i = i1; i >= i0; i--, U += dUdX, V += dVdX)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			s_scanlineOut[i] = s_scanlineLight[s_ftexImage[texel]];
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			out[i] = light[tex[texel]];
 		}
 	}
 
-	void drawScanline_Fullbright()
+	static void scanline_fullbright(const ScanlineParams* scan, s32 i0, s32 i1)
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
+		const fixed44_20 dVdX = scan->dVdX;
+		const fixed44_20 dUdX = scan->dUdX;
+		const fixed44_20 skip = fixed44_20(scan->width - 1 - i1);
+		fixed44_20 V = scan->V0 + skip * dVdX;
+		fixed44_20 U = scan->U0 + skip * dUdX;
+		const u8* tex = scan->tex;
+		const s32 dataEnd = scan->texDataEnd;
+		u8* out = scan->out;
 
 		// Note this produces a distorted mapping if the texture is not 64x64.
 		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		for (s32 i = i1; i >= i0; i--, U += dUdX, V += dVdX)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			s_scanlineOut[i] = s_ftexImage[texel];
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			out[i] = tex[texel];
 		}
 	}
 
-	void drawScanline_Trans()
+	static void scanline_litTrans(const ScanlineParams* scan, s32 i0, s32 i1)
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
+		const fixed44_20 dVdX = scan->dVdX;
+		const fixed44_20 dUdX = scan->dUdX;
+		const fixed44_20 skip = fixed44_20(scan->width - 1 - i1);
+		fixed44_20 V = scan->V0 + skip * dVdX;
+		fixed44_20 U = scan->U0 + skip * dUdX;
+		const u8* tex = scan->tex;
+		const u8* light = scan->light;
+		const s32 dataEnd = scan->texDataEnd;
+		u8* out = scan->out;
 
 		// Note this produces a distorted mapping if the texture is not 64x64.
 		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		for (s32 i = i1; i >= i0; i--, U += dUdX, V += dVdX)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			const u8 baseColor = s_ftexImage[texel];
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			const u8 baseColor = tex[texel];
 
-			if (baseColor) { s_scanlineOut[i] = s_scanlineLight[baseColor]; }
+			if (baseColor) { out[i] = light[baseColor]; }
 		}
 	}
 
-	void drawScanline_Fullbright_Trans()
+	static void scanline_fullbrightTrans(const ScanlineParams* scan, s32 i0, s32 i1)
 	{
-		const fixed44_20 dVdX = s_scanline_dVdX;
-		const fixed44_20 dUdX = s_scanline_dUdX;
-		fixed44_20 V = s_scanlineV0;
-		fixed44_20 U = s_scanlineU0;
+		const fixed44_20 dVdX = scan->dVdX;
+		const fixed44_20 dUdX = scan->dUdX;
+		const fixed44_20 skip = fixed44_20(scan->width - 1 - i1);
+		fixed44_20 V = scan->V0 + skip * dVdX;
+		fixed44_20 U = scan->U0 + skip * dUdX;
+		const u8* tex = scan->tex;
+		const s32 dataEnd = scan->texDataEnd;
+		u8* out = scan->out;
 
 		// Note this produces a distorted mapping if the texture is not 64x64.
 		// This behavior matches the original.
-		for (s32 i = s_scanlineWidth - 1; i >= 0; i--, U += dUdX, V += dVdX)
+		for (s32 i = i1; i >= i0; i--, U += dUdX, V += dVdX)
 		{
-			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & s_ftexDataEnd;
-			const u8 baseColor = s_ftexImage[texel];
+			const u32 texel = ((floor20(U) & 63) * 64 + (floor20(V) & 63)) & dataEnd;
+			const u8 baseColor = tex[texel];
+
+			if (baseColor) { out[i] = baseColor; }
+		}
+	}
+
+	typedef void(*ScanlineKernel)(const ScanlineParams* scan, s32 i0, s32 i1);
+	static const ScanlineKernel c_scanlineKernel[SCANLINE_COUNT] =
+	{
+		scanline_lit,				// SCANLINE_LIT
+		scanline_fullbright,		// SCANLINE_FULLBRIGHT
+		scanline_litTrans,			// SCANLINE_LIT_TRANS
+		scanline_fullbrightTrans,	// SCANLINE_FULLBRIGHT_TRANS
+	};
+
+	static void drawDeferredScanline(const void* params, s32 x0, s32 x1)
+	{
+		const ScanlineParams* scan = (const ScanlineParams*)params;
+		c_scanlineKernel[scan->func](scan, x0 - scan->x0, x1 - scan->x0);
+	}
 
-			if (baseColor) { s_scanlineOut[i] = baseColor; }
+	static void drawScanline(ScanlineFuncId func)
+	{
+		const ScanlineParams scan = { s_scanlineOut, s_ftexImage, s_scanlineLight, s_scanlineU0, s_scanlineV0, s_scanline_dUdX, s_scanline_dVdX,
+		                              s_scanlineX0, s_scanlineWidth, s_ftexDataEnd, func };
+		if (!raster_isDeferred())
+		{
+			c_scanlineKernel[func](&scan, 0, s_scanlineWidth - 1);
+			return;
 		}
+		ScanlineParams* deferred = (ScanlineParams*)raster_push(drawDeferredScanline, s_scanlineX0, s_scanlineX0 + s_scanlineWidth - 1, sizeof(ScanlineParams), 1);
+		*deferred = scan;
 	}
-			   
+
 	bool flat_setTexture(TextureData* tex)
 	{
 		if (!tex) { return false; }
@@ -212,14 +287,7 @@ namespace RClassic_Float
 					s_scanline_dUdX = -floatToFixed20(negCosRelCeil * worldTexelScaleAspect);
 					s_scanlineLight =  computeLighting(z, 0);
 					
-					if (s_scanlineLight)
-					{
-						drawScanline();
-					}
-					else
-					{
-						drawScanline_Fullbright();
-					}
+					drawScanline(s_scanlineLight ? SCANLINE_LIT : SCANLINE_FULLBRIGHT);
 				}
 			} // while (i < count)
 		}
@@ -279,14 +347,7 @@ namespace RClassic_Float
 					s_scanline_dUdX = -floatToFixed20(negCosRelFloor * worldTexelScaleAspect);
 					s_scanlineLight = computeLighting(z, 0);
 
-					if (s_scanlineLight)
-					{
-						drawScanline();
-					}
-					else
-					{
-						drawScanline_Fullbright();
-					}
+					drawScanline(s_scanlineLight ? SCANLINE_LIT : SCANLINE_FULLBRIGHT);
 				}
 			} // while (i < count)
 		}
@@ -295,15 +356,6 @@ namespace RClassic_Float
 	//////////////////////////////////////////////////////////////////////
 	// Polygon Scanline rendering using the same algorithms as flats.
 	//////////////////////////////////////////////////////////////////////
-	typedef void(*ScanlineFunction)();
-	static const ScanlineFunction c_scanlineDrawFunc[] =
-	{
-		drawScanline,
-		drawScanline_Fullbright,
-		drawScanline_Trans,
-		drawScanline_Fullbright_Trans
-	};
-
 	static f32 s_poly_offsetX;
 	static f32 s_poly_offsetZ;
 
@@ -361,7 +413,7 @@ namespace RClassic_Float
 
 		s_scanlineLight = computeLighting(z, 0);
 		const s32 index = (!s_scanlineLight) + trans*2;
-		c_scanlineDrawFunc[index]();
+		drawScanline(ScanlineFuncId(index));
 	}
 
 }  // RFlatFixed
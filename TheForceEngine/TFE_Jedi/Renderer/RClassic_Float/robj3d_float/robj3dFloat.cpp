@@ -12,6 +12,7 @@
 #include "robj3dFloat_Clipping.h"
 #include "robj3dFloat_PolygonDraw.h"
 #include "../rclassicFloatSharedState.h"
+#include "../rrasterFloat.h"
 #include "../../rcommon.h"
 
 namespace TFE_Jedi
@@ -79,6 +80,18 @@ namespace RClassic_Float
 		}
 	}
 		
+	struct DeferredPixel
+	{
+		u8* out;
+		u8  color;
+	};
+
+	static void robj3d_drawDeferredPixel(const void* params, s32 x0, s32 x1)
+	{
+		const DeferredPixel* pixel = (const DeferredPixel*)params;
+		*pixel->out = pixel->color;
+	}
+
 	void robj3d_drawVertices(s32 vertexCount, const vec3_float* vertices, u8 color, s32 size)
 	{
 		// cannot draw if the color is transparent.
@@ -111,7 +124,16 @@ namespace RClassic_Float
 			{
 				const s32 x = clamp(pixel_x - halfSize + (i % size), s_minScreenX_Pixels, s_maxScreenX_Pixels);
 				const s32 y = clamp(pixel_y - halfSize + (i / size), s_windowMinY_Pixels, s_windowMaxY_Pixels);
-				s_display[y*s_width + x] = color;
+				if (raster_isDeferred())
+				{
+					DeferredPixel* pixel = (DeferredPixel*)raster_push(robj3d_drawDeferredPixel, x, x, sizeof(DeferredPixel), 1);
+					pixel->out = &s_display[y*s_width + x];
+					pixel->color = color;
+				}
+				else
+				{
+					s_display[y*s_width + x] = color;
+				}
 			}
 		}
 	}
@@ -167,98 +167,129 @@ s32 robj3d_findPrevEdge(s32 minXIndex)
 }
 
 #if !defined(POLY_INTENSITY) && !defined(POLY_UV)
-void robj3d_drawColumnFlatColor()
+void robj3d_columnFlatColor(const PolyColumnParams* col)
 {
-	s32 end = s_columnHeight - 1;
+	u8* columnOut = col->out;
+	const u8 colorIndex = col->colorIndex;
+
+	s32 end = col->height - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
 	{
-		s_pcolumnOut[offset] = s_polyColorIndex;
+		columnOut[offset] = colorIndex;
 	}
 }
+
+void robj3d_drawColumnFlatColor()
+{
+	robj3d_drawColumn(robj3d_columnFlatColor);
+}
 #endif
 
 #if defined(POLY_INTENSITY) && !defined(POLY_UV)
-void robj3d_drawColumnShadedColor()
+void robj3d_columnShadedColor(const PolyColumnParams* col)
 {
-	const u8* colorMap = s_polyColorMap;
+	const u8* colorMap = col->colorMap;
+	u8* columnOut = col->out;
 
-	fixed44_20 intensity = s_col_I0;
-	u8  colorIndex = s_polyColorIndex;
-	s32 dither = s_dither;
+	fixed44_20 intensity = col->I0;
+	const fixed44_20 dIdY = col->dIdY;
+	const fixed44_20 ditherOffset = col->ditherOffset;
+	u8  colorIndex = col->colorIndex;
+	s32 dither = col->dither;
 
-	s32 end = s_columnHeight - 1;
+	s32 end = col->height - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
 	{
 		s32 pixelIntensity = floor20(intensity);
 		if (dither)
 		{
-			const fixed44_20 iOffset = intensity - s_ditherOffset;
+			const fixed44_20 iOffset = intensity - ditherOffset;
 			if (iOffset >= 0)
 			{
 				pixelIntensity = floor20(iOffset);
 			}
 		}
-		s_pcolumnOut[offset] = colorMap[(pixelIntensity&31)*256 + colorIndex];
+		columnOut[offset] = colorMap[(pixelIntensity&31)*256 + colorIndex];
 
-		intensity += s_col_dIdY;
+		intensity += dIdY;
 		dither = !dither;
 	}
 }
+
+void robj3d_drawColumnShadedColor()
+{
+	robj3d_drawColumn(robj3d_columnShadedColor);
+}
 #endif
 
 #if !defined(POLY_INTENSITY) && defined(POLY_UV)
-void robj3d_drawColumnFlatTexture()
+void robj3d_columnFlatTexture(const PolyColumnParams* col)
 {
-	const u8* colorMap = &s_polyColorMap[s_polyColorIndex * 256];
-	const u8* textureData = s_polyTexture->image;
-	const s32 texHeight = s_polyTexture->height;
-	const s32 texWidthMask = s_polyTexture->width - 1;
+	const u8* colorMap = &col->colorMap[col->colorIndex * 256];
+	const u8* textureData = col->texture->image;
+	const s32 texHeight = col->texture->height;
+	const s32 texWidthMask = col->texture->width - 1;
 	const s32 texHeightMask = texHeight - 1;
+	const vec2_fixed20 dUVdY = col->dUVdY;
+	u8* columnOut = col->out;
 
-	fixed44_20 U = s_col_Uv0.x;
-	fixed44_20 V = s_col_Uv0.z;
+	fixed44_20 U = col->Uv0.x;
+	fixed44_20 V = col->Uv0.z;
 	
-	s32 end = s_columnHeight - 1;
+	s32 end = col->height - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
 	{
 		const u8 colorIndex = textureData[(floor20(U)&texWidthMask)*texHeight + (floor20(V)&texHeightMask)];
-		s_pcolumnOut[offset] = colorMap[colorIndex];
+		columnOut[offset] = colorMap[colorIndex];
 
-		U += s_col_dUVdY.x;
-		V += s_col_dUVdY.z;
+		U += dUVdY.x;
+		V += dUVdY.z;
 	}
 }
+
+void robj3d_drawColumnFlatTexture()
+{
+	robj3d_drawColumn(robj3d_columnFlatTexture);
+}
 #endif
 
 #if defined(POLY_INTENSITY) && defined(POLY_UV)
-void robj3d_drawColumnShadedTexture()
+void robj3d_columnShadedTexture(const PolyColumnParams* col)
 {
-	const u8* colorMap = s_polyColorMap;
-	const u8* textureData = s_polyTexture->image;
-	const s32 texHeight = s_polyTexture->height;
-	const s32 texWidthMask = s_polyTexture->width - 1;
+	const u8* colorMap = col->colorMap;
+	const u8* textureData = col->texture->image;
+	const s32 texHeight = col->texture->height;
+	const s32 texWidthMask = col->texture->width - 1;
 	const s32 texHeightMask = texHeight - 1;
+	const vec2_fixed20 dUVdY = col->dUVdY;
+	const fixed44_20 dIdY = col->dIdY;
+	u8* columnOut = col->out;
 
-	fixed44_20 U = s_col_Uv0.x;
-	fixed44_20 V = s_col_Uv0.z;
-	fixed44_20 I = s_col_I0;
+	fixed44_20 U = col->Uv0.x;
+	fixed44_20 V = col->Uv0.z;
+	fixed44_20 I = col->I0;
 
-	s32 end = s_columnHeight - 1;
+	s32 end = col->height - 1;
 	s32 offset = end * s_width;
 	for (s32 i = end; i >= 0; i--, offset -= s_width)
 	{
 		const u8 colorIndex = textureData[(floor20(U)&texWidthMask)*texHeight + (floor20(V)&texHeightMask)];
 		const s32 pixelIntensity = floor20(I)&31;
-		s_pcolumnOut[offset] = colorMap[pixelIntensity*256 + colorIndex];
+		columnOut[offset] = colorMap[pixelIntensity*256 + colorIndex];
 
-		I += s_col_dIdY;
-		U += s_col_dUVdY.x;
-		V += s_col_dUVdY.z;
+		I += dIdY;
+		U += dUVdY.x;
+		V += dUVdY.z;
 	}
 }
+
+void robj3d_drawColumnShadedTexture()
+{
+	robj3d_drawColumn(robj3d_columnShadedTexture);
+}
 #endif
 
 #undef FIND_NEXT_EDGE
@@ -13,6 +13,7 @@
 #include "../rsectorFloat.h"
 #include "../rflatFloat.h"
 #include "../rclassicFloatSharedState.h"
+#include "../rrasterFloat.h"
 #include "../rlightingFloat.h"
 #include "../../rcommon.h"
 
@@ -95,6 +96,48 @@ namespace RClassic_Float
 	static s32 s_edgeLeftLength;
 	static s32 s_edgeRightLength;
 
+	// Column parameters, copied from the column state so the column can also be drawn later by the deferred raster.
+	struct PolyColumnParams
+	{
+		u8* out;
+		const u8* colorMap;
+		const TextureData* texture;
+		fixed44_20 I0;
+		fixed44_20 dIdY;
+		fixed44_20 ditherOffset;
+		vec2_fixed20 Uv0;
+		vec2_fixed20 dUVdY;
+		s32 height;
+		s32 dither;
+		u8  colorIndex;
+	};
+	typedef void(*PolyColumnKernel)(const PolyColumnParams* col);
+
+	struct DeferredPolyColumn
+	{
+		PolyColumnParams col;
+		PolyColumnKernel kernel;
+	};
+
+	static void robj3d_drawDeferredColumn(const void* params, s32 x0, s32 x1)
+	{
+		const DeferredPolyColumn* deferred = (const DeferredPolyColumn*)params;
+		deferred->kernel(&deferred->col);
+	}
+
+	static void robj3d_drawColumn(PolyColumnKernel kernel)
+	{
+		const PolyColumnParams col = { s_pcolumnOut, s_polyColorMap, s_polyTexture, s_col_I0, s_col_dIdY, s_ditherOffset, s_col_Uv0, s_col_dUVdY, s_columnHeight, s_dither, s_polyColorIndex };
+		if (!raster_isDeferred())
+		{
+			kernel(&col);
+			return;
+		}
+		DeferredPolyColumn* deferred = (DeferredPolyColumn*)raster_push(robj3d_drawDeferredColumn, s_columnX, s_columnX, sizeof(DeferredPolyColumn), s_columnHeight);
+		deferred->col = col;
+		deferred->kernel = kernel;
+	}
+
 	u8 robj3d_computePolygonColor(vec3_float* normal, u8 color, f32 z)
 	{
 		if (s_sectorAmbient >= 31) { return color; }
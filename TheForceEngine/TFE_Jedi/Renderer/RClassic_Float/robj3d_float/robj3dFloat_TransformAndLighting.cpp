@@ -1,6 +1,7 @@
 #include <TFE_System/profiler.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Math/core_math.h>
+#include <TFE_Jedi/Math/simd.h>
 #include "robj3dFloat_TransformAndLighting.h"
 #include "../rclassicFloatSharedState.h"
 #include "../rlightingFloat.h"
@@ -30,6 +31,12 @@ namespace RClassic_Float
 	/////////////////////////////////////////////
 	// Polygon normals in viewspace (used for culling).
 	std::vector<vec3_float> s_polygonNormalsVS;
+
+#ifdef TFE_SIMD_SSE2
+	// View space vertices and vertex normals as x[], y[], z[] arrays for the SIMD lighting.
+	static std::vector<f32> s_verticesVS_SoA;
+	static std::vector<f32> s_vertexNormalsVS_SoA;
+#endif
 			
 	void robj3d_transformVertices(s32 vertexCount, vec3_fixed* vtxIn, f32* xform, vec3_float* offset, vec3_float* vtxOut)
 	{
@@ -139,6 +146,131 @@ namespace RClassic_Float
 		}
 	}
 
+#ifdef TFE_SIMD_SSE2
+	// Transforms 4 vertices per iteration from the model SoA data, using the same operation order as robj3d_transformVertices().
+	// Writes 'count' vec3 results and optionally all 'paddedCount' SoA results.
+	void robj3d_transformVerticesSimd(s32 count, s32 paddedCount, const s32* vtxIn, const f32* xform, const vec3_float* offset, vec3_float* vtxOut, f32* vtxOutSoA)
+	{
+		const s32* inX = vtxIn;
+		const s32* inY = vtxIn + paddedCount;
+		const s32* inZ = vtxIn + 2 * paddedCount;
+		const __m128 m0 = _mm_set1_ps(xform[0]), m1 = _mm_set1_ps(xform[1]), m2 = _mm_set1_ps(xform[2]);
+		const __m128 m3 = _mm_set1_ps(xform[3]), m4 = _mm_set1_ps(xform[4]), m5 = _mm_set1_ps(xform[5]);
+		const __m128 m6 = _mm_set1_ps(xform[6]), m7 = _mm_set1_ps(xform[7]), m8 = _mm_set1_ps(xform[8]);
+		const __m128 offsetX = _mm_set1_ps(offset->x);
+		const __m128 offsetY = _mm_set1_ps(offset->y);
+		const __m128 offsetZ = _mm_set1_ps(offset->z);
+		const __m128 scale = _mm_set1_ps(INV_FLOAT_SCALE_16);
+
+		alignas(16) f32 outX[4], outY[4], outZ[4];
+		for (s32 v = 0; v < paddedCount; v += 4)
+		{
+			const __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&inX[v])), scale);
+			const __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&inY[v])), scale);
+			const __m128 z = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&inZ[v])), scale);
+
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m0), _mm_mul_ps(y, m3)), _mm_mul_ps(z, m6)), offsetX);
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m1), _mm_mul_ps(y, m4)), _mm_mul_ps(z, m7)), offsetY);
+			const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m2), _mm_mul_ps(y, m5)), _mm_mul_ps(z, m8)), offsetZ);
+			if (vtxOutSoA)
+			{
+				_mm_storeu_ps(&vtxOutSoA[v], rx);
+				_mm_storeu_ps(&vtxOutSoA[v + paddedCount], ry);
+				_mm_storeu_ps(&vtxOutSoA[v + 2 * paddedCount], rz);
+			}
+
+			_mm_store_ps(outX, rx);
+			_mm_store_ps(outY, ry);
+			_mm_store_ps(outZ, rz);
+			const s32 laneCount = min(4, count - v);
+			for (s32 i = 0; i < laneCount; i++)
+			{
+				vtxOut[v + i] = { outX[i], outY[i], outZ[i] };
+			}
+		}
+	}
+
+	// Lights 4 vertices per iteration, see robj3d_shadeVertices().
+	void robj3d_shadeVerticesSimd(s32 count, s32 paddedCount, f32* outShading, const f32* vertices, const f32* normals)
+	{
+		if (s_sectorAmbient >= 31)
+		{
+			for (s32 i = 0; i < count; i++) { outShading[i] = VSHADE_MAX_INTENSITY_FLT; }
+			return;
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 ambientFraction = _mm_set1_ps(fixed16ToFloat(s_sectorAmbientFraction));
+		const __m128 sectorAmbient = _mm_set1_ps(f32(s_sectorAmbient));
+		const __m128 scaledAmbient = _mm_set1_ps(f32(s_scaledAmbient));
+		const __m128 maxIntensity = _mm_set1_ps(VSHADE_MAX_INTENSITY_FLT);
+		const __m128 maxDepth = _mm_set1_ps(127.0f);
+		const __m128 four = _mm_set1_ps(4.0f);
+		const __m128 sixteen = _mm_set1_ps(16.0f);
+		const __m128 thirtyTwo = _mm_set1_ps(32.0f);
+		const bool cameraLight = s_worldAmbient < 31 || s_cameraLightSource;
+
+		alignas(16) s32 depthScaled[4];
+		alignas(16) f32 cameraSource[4];
+		alignas(16) f32 intensityOut[4];
+		for (s32 v = 0; v < paddedCount; v += 4)
+		{
+			const __m128 vx = _mm_loadu_ps(&vertices[v]);
+			const __m128 vy = _mm_loadu_ps(&vertices[v + paddedCount]);
+			const __m128 vz = _mm_loadu_ps(&vertices[v + 2 * paddedCount]);
+			// Normals are stored as position + direction.
+			const __m128 nx = _mm_sub_ps(_mm_loadu_ps(&normals[v]), vx);
+			const __m128 ny = _mm_sub_ps(_mm_loadu_ps(&normals[v + paddedCount]), vy);
+			const __m128 nz = _mm_sub_ps(_mm_loadu_ps(&normals[v + 2 * paddedCount]), vz);
+
+			// Lighting
+			__m128 lightIntensity = zero;
+			for (s32 i = 0; i < s_lightCount; i++)
+			{
+				const CameraLightFlt* light = &s_cameraLight[i];
+				const __m128 lx = _mm_set1_ps(light->lightVS.x);
+				const __m128 ly = _mm_set1_ps(light->lightVS.y);
+				const __m128 lz = _mm_set1_ps(light->lightVS.z);
+				// (vertex + light) - vertex, to match the scalar rounding.
+				const __m128 dx = _mm_sub_ps(_mm_add_ps(vx, lx), vx);
+				const __m128 dy = _mm_sub_ps(_mm_add_ps(vy, ly), vy);
+				const __m128 dz = _mm_sub_ps(_mm_add_ps(vz, lz), vz);
+
+				const __m128 I = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, dx), _mm_mul_ps(ny, dy)), _mm_mul_ps(nz, dz));
+				const __m128 sourceIntensity = _mm_set1_ps(VSHADE_MAX_INTENSITY_FLT * light->brightness);
+				lightIntensity = _mm_add_ps(lightIntensity, _mm_and_ps(_mm_cmpgt_ps(I, zero), _mm_mul_ps(I, sourceIntensity)));
+			}
+			__m128 intensity = _mm_mul_ps(lightIntensity, ambientFraction);
+
+			// Distance falloff
+			const __m128 z = max_x4(zero, vz);
+			if (cameraLight)
+			{
+				// Clamp before converting so very distant vertices cannot overflow the index.
+				_mm_store_si128((__m128i*)depthScaled, _mm_cvttps_epi32(min_x4(_mm_mul_ps(z, four), maxDepth)));
+				for (s32 i = 0; i < 4; i++)
+				{
+					const s32 source = MAX_LIGHT_LEVEL - (s_lightSourceRamp[depthScaled[i]] + s_worldAmbient);
+					cameraSource[i] = source > 0 ? f32(source) : 0.0f;
+				}
+				intensity = _mm_add_ps(intensity, _mm_load_ps(cameraSource));
+			}
+			intensity = max_x4(intensity, sectorAmbient);
+
+			const __m128i falloffInt = _mm_add_epi32(_mm_cvttps_epi32(_mm_div_ps(z, sixteen)), _mm_cvttps_epi32(_mm_div_ps(z, thirtyTwo)));
+			intensity = max_x4(_mm_sub_ps(intensity, _mm_cvtepi32_ps(falloffInt)), scaledAmbient);
+			intensity = min_x4(max_x4(intensity, zero), maxIntensity);
+
+			_mm_store_ps(intensityOut, intensity);
+			const s32 laneCount = min(4, count - v);
+			for (s32 i = 0; i < laneCount; i++)
+			{
+				outShading[v + i] = intensityOut[i];
+			}
+		}
+	}
+#endif
+
 	void robj3d_allocateBuffers(JediModel* model)
 	{
 		if (model->vertexCount > s_verticesVS.size())
@@ -151,6 +283,13 @@ namespace RClassic_Float
 		{
 			s_polygonNormalsVS.resize(model->polygonCount);
 		}
+	#ifdef TFE_SIMD_SSE2
+		if (3 * model->vertexCountSoA > (s32)s_verticesVS_SoA.size())
+		{
+			s_verticesVS_SoA.resize(3 * model->vertexCountSoA);
+			s_vertexNormalsVS_SoA.resize(3 * model->vertexCountSoA);
+		}
+	#endif
 	}
 		
 	void robj3d_transformAndLight(SecObject* obj, JediModel* model)
@@ -171,6 +310,22 @@ namespace RClassic_Float
 		f32 xform[9];
 		robj3d_mulMatrix3x3(s_rcfltState.cameraMtx, obj->transform, xform);
 
+	#ifdef TFE_SIMD_SSE2
+		if (s_simdModelTransform && model->verticesSoA && (model->vertexNormalsSoA || !(model->flags & MFLAG_VERTEX_LIT)))
+		{
+			robj3d_transformVerticesSimd(model->vertexCount, model->vertexCountSoA, model->verticesSoA, xform, &offsetVS, s_verticesVS.data(), s_verticesVS_SoA.data());
+			if (model->flags & MFLAG_DRAW_VERTICES) { return; }
+
+			robj3d_transformVerticesSimd(model->polygonCount, model->polygonCountSoA, model->polygonNormalsSoA, xform, &offsetVS, s_polygonNormalsVS.data(), nullptr);
+			if (model->flags & MFLAG_VERTEX_LIT)
+			{
+				robj3d_transformVerticesSimd(model->vertexCount, model->vertexCountSoA, model->vertexNormalsSoA, xform, &offsetVS, s_vertexNormalsVS.data(), s_vertexNormalsVS_SoA.data());
+				robj3d_shadeVerticesSimd(model->vertexCount, model->vertexCountSoA, s_vertexIntensity.data(), s_verticesVS_SoA.data(), s_vertexNormalsVS_SoA.data());
+			}
+			return;
+		}
+	#endif
+
 		// Transform model vertices into view space.
 		robj3d_transformVertices(model->vertexCount, (vec3_fixed*)model->vertices, xform, &offsetVS, s_verticesVS.data());
 
@@ -188,4 +343,45 @@ namespace RClassic_Float
 		}
 	}
 
-}}  // TFE_Jedi
\ No newline at end of file
+	static bool robj3d_nearlyEqual(f32 a, f32 b, f32 tolerance)
+	{
+		return fabsf(a - b) <= tolerance * max(1.0f, max(fabsf(a), fabsf(b)));
+	}
+
+	static bool robj3d_nearlyEqual(const vec3_float& a, const vec3_float& b)
+	{
+		const f32 tolerance = 1e-4f;
+		return robj3d_nearlyEqual(a.x, b.x, tolerance) && robj3d_nearlyEqual(a.y, b.y, tolerance) && robj3d_nearlyEqual(a.z, b.z, tolerance);
+	}
+
+	s32 robj3d_compareTransformAndLight(SecObject* obj, JediModel* model, s32* valueCount)
+	{
+		const bool simdEnabled = s_simdModelTransform;
+		s_simdModelTransform = false;
+		robj3d_transformAndLight(obj, model);
+		const std::vector<vec3_float> vertices(s_verticesVS.begin(), s_verticesVS.begin() + model->vertexCount);
+		const std::vector<vec3_float> polygonNormals(s_polygonNormalsVS.begin(), s_polygonNormalsVS.begin() + model->polygonCount);
+		const std::vector<f32> intensity(s_vertexIntensity.begin(), s_vertexIntensity.begin() + model->vertexCount);
+
+		s_simdModelTransform = true;
+		robj3d_transformAndLight(obj, model);
+		s_simdModelTransform = simdEnabled;
+
+		// The float paths may round differently when the compiler contracts or reorders the scalar math.
+		const bool lit = (model->flags & MFLAG_VERTEX_LIT) && !(model->flags & MFLAG_DRAW_VERTICES);
+		const bool normals = !(model->flags & MFLAG_DRAW_VERTICES);
+		s32 mismatchCount = 0;
+		for (s32 i = 0; i < model->vertexCount; i++)
+		{
+			if (!robj3d_nearlyEqual(vertices[i], s_verticesVS[i])) { mismatchCount++; }
+			if (lit && !robj3d_nearlyEqual(intensity[i], s_vertexIntensity[i], 1e-3f)) { mismatchCount++; }
+		}
+		for (s32 i = 0; normals && i < model->polygonCount; i++)
+		{
+			if (!robj3d_nearlyEqual(polygonNormals[i], s_polygonNormalsVS[i])) { mismatchCount++; }
+		}
+		*valueCount = model->vertexCount * (lit ? 2 : 1) + (normals ? model->polygonCount : 0);
+		return mismatchCount;
+	}
+
+}}  // TFE_Jedi
@@ -0,0 +1,146 @@
+#include <TFE_System/profiler.h>
+#include <TFE_System/jobPool.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "rrasterFloat.h"
+#include "../rcommon.h"
+#include <assert.h>
+#include <vector>
+
+namespace TFE_Jedi
+{
+
+namespace RClassic_Float
+{
+	enum RasterConstants
+	{
+		// Ranges per thread (including the calling thread), so ranges that end up more expensive than estimated still balance.
+		RASTER_RANGES_PER_THREAD = 2,
+		// Views with fewer recorded pixels are drawn on the calling thread.
+		RASTER_MIN_PARALLEL_COST = 16384,
+	};
+
+	struct RasterCommand
+	{
+		RasterFunc func;
+		s32 x0;
+		s32 x1;
+		u32 offset;		// offset into s_params, in 8 byte units.
+	};
+
+	struct RasterRange
+	{
+		s32 x0;
+		s32 x1;
+	};
+
+	static bool s_deferred = false;
+	static std::vector<RasterCommand> s_commands;
+	static std::vector<u64> s_params;
+	// Per column pixel counts, stored as differences while recording: cost[x] = sum(s_columnCost[0..x]).
+	static std::vector<s64> s_columnCost;
+	// Non-zero where a top-level adjoin window starts or the column after one ends.
+	static std::vector<u8> s_viewEdge;
+	static std::vector<RasterRange> s_ranges;
+
+	bool raster_isDeferred()
+	{
+		return s_deferred;
+	}
+
+	void raster_begin()
+	{
+		s_deferred = s_parallelPortals && TFE_JobPool::getWorkerCount() > 0;
+		if (!s_deferred) { return; }
+
+		s_commands.clear();
+		s_params.clear();
+		s_columnCost.assign(s_width + 1, 0);
+		s_viewEdge.assign(s_width + 1, 0);
+	}
+
+	void raster_addViewRange(s32 x0, s32 x1)
+	{
+		if (!s_deferred) { return; }
+		x0 = clamp(x0, 0, s_width - 1);
+		x1 = clamp(x1, 0, s_width - 1);
+		if (x0 > x1) { return; }
+
+		s_viewEdge[x0] = 1;
+		s_viewEdge[x1 + 1] = 1;
+	}
+
+	void* raster_push(RasterFunc func, s32 x0, s32 x1, u32 size, s32 cost)
+	{
+		assert(s_deferred && x0 >= 0 && x0 <= x1 && x1 < s_width);
+		const u32 offset = u32(s_params.size());
+		s_params.resize(offset + (size + sizeof(u64) - 1) / sizeof(u64));
+		s_commands.push_back({ func, x0, x1, offset });
+
+		s_columnCost[x0] += cost;
+		s_columnCost[x1 + 1] -= cost;
+		return &s_params[offset];
+	}
+
+	static void raster_drawRange(s32 index, void* userData)
+	{
+		const RasterRange range = s_ranges[index];
+		const RasterCommand* cmd = s_commands.data();
+		const u64* params = s_params.data();
+		const size_t count = s_commands.size();
+		for (size_t i = 0; i < count; i++, cmd++)
+		{
+			if (cmd->x1 < range.x0 || cmd->x0 > range.x1) { continue; }
+			cmd->func(&params[cmd->offset], max(cmd->x0, range.x0), min(cmd->x1, range.x1));
+		}
+	}
+
+	// Split the screen into column ranges with roughly equal pixel counts, preferring to split at the edges of the top-level adjoin windows.
+	static void raster_splitColumns()
+	{
+		s64 total = 0;
+		s64 cost = 0;
+		for (s32 x = 0; x < s_width; x++)
+		{
+			cost += s_columnCost[x];
+			s_columnCost[x] = cost;
+			total += cost;
+		}
+
+		s_ranges.clear();
+		const s32 rangeCount = (TFE_JobPool::getWorkerCount() + 1) * RASTER_RANGES_PER_THREAD;
+		if (total < RASTER_MIN_PARALLEL_COST)
+		{
+			s_ranges.push_back({ 0, s_width - 1 });
+			return;
+		}
+
+		// A range ends at the first window edge past the target cost, or is split anyway once it gets too large.
+		const s64 target = total / rangeCount;
+		const s64 maxCost = target + target / 2;
+		s32 x0 = 0;
+		cost = 0;
+		for (s32 x = 0; x < s_width - 1; x++)
+		{
+			cost += s_columnCost[x];
+			if ((cost >= target && s_viewEdge[x + 1]) || cost >= maxCost)
+			{
+				s_ranges.push_back({ x0, x });
+				x0 = x + 1;
+				cost = 0;
+			}
+		}
+		s_ranges.push_back({ x0, s_width - 1 });
+	}
+
+	void raster_end()
+	{
+		if (!s_deferred) { return; }
+		s_deferred = false;
+
+		TFE_ZONE("Parallel Raster");
+		raster_splitColumns();
+		TFE_JobPool::parallelFor(s32(s_ranges.size()), raster_drawRange, nullptr);
+	}
+}  // RClassic_Float
+
+}  // TFE_Jedi
@@ -0,0 +1,35 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Deferred Raster
+// When r_parallelPortals is enabled, the sector traversal records the
+// column and scanline draws instead of writing to the framebuffer.
+// Once the view has been traversed, the screen is split into column
+// ranges. The splits are made at the edges of the top-level adjoin
+// windows where possible, and balanced by the recorded pixel counts.
+// Each range is drawn as a job on the job pool.
+//
+// A job replays every draw that touches its columns in the order it
+// was recorded, clipped to those columns. The draws never read the
+// framebuffer, so the image matches drawing in place exactly.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_Jedi
+{
+	namespace RClassic_Float
+	{
+		// Draws the part of a recorded draw that lies within columns [x0, x1].
+		typedef void(*RasterFunc)(const void* params, s32 x0, s32 x1);
+
+		// Called around the sector traversal, raster_end() draws the recorded view.
+		void raster_begin();
+		void raster_end();
+		bool raster_isDeferred();
+
+		// Adds the column range of a top-level adjoin window.
+		void raster_addViewRange(s32 x0, s32 x1);
+		// Records a draw covering columns [x0, x1], 'cost' is the number of pixels drawn per column.
+		// Returns storage for 'size' bytes of parameters, which is valid until the next call.
+		void* raster_push(RasterFunc func, s32 x0, s32 x1, u32 size, s32 cost);
+	}
+}
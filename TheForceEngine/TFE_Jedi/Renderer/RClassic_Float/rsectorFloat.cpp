@@ -8,6 +8,7 @@
 #include <TFE_Jedi/Level/rsector.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/rtexture.h>
+#include <TFE_Jedi/Level/sectorPvs.h>
 #include <TFE_Jedi/Math/fixedPoint.h>
 #include <TFE_Jedi/Math/core_math.h>
 
@@ -17,6 +18,7 @@
 #include "rlightingFloat.h"
 #include "redgePairFloat.h"
 #include "rclassicFloatSharedState.h"
+#include "rrasterFloat.h"
 #include "robj3d_float/robj3dFloat.h"
 #include "../rcommon.h"
 
@@ -88,13 +90,7 @@ namespace TFE_Jedi
 
 			for (s32 i = count - 1; i >= 0 && drawCount < MAX_VIEW_OBJ_COUNT; i--, obj++)
 			{
-				// Search for the next allocated object.
 				SecObject* curObj = *obj;
-				while (!curObj)
-				{
-					obj++;
-					curObj = *obj;
-				}
 
 				if (curObj->flags & OBJ_FLAG_NEEDS_TRANSFORM)
 				{
@@ -200,6 +196,14 @@ namespace TFE_Jedi
 	}
 	
 	void TFE_Sectors_Float::draw(RSector* sector)
+	{
+		// With r_parallelPortals the traversal records the pixel writes, which are drawn as jobs once the view is complete.
+		raster_begin();
+		drawSector(sector);
+		raster_end();
+	}
+
+	void TFE_Sectors_Float::drawSector(RSector* sector)
 	{
 		s_ctx = this;
 		s_curSector = sector;
@@ -251,12 +255,12 @@ namespace TFE_Jedi
 			TFE_ZONE_END(secUpdateCache);
 
 			TFE_ZONE_BEGIN(secXform, "Sector Vertex Transform");
-				vec2_fixed* vtxWS = s_curSector->verticesWS;
+				const vec2_float* vtxWS = cachedSector->verticesWS;
 				vec2_float* vtxVS = cachedSector->verticesVS;
 				for (s32 v = 0; v < s_curSector->vertexCount; v++)
 				{
-					const f32 x = fixed16ToFloat(vtxWS->x);
-					const f32 z = fixed16ToFloat(vtxWS->z);
+					const f32 x = vtxWS->x;
+					const f32 z = vtxWS->z;
 
 					vtxVS->x = x*s_rcfltState.cosYaw     + z*s_rcfltState.sinYaw + s_rcfltState.cameraTrans.x;
 					vtxVS->z = x*s_rcfltState.negSinYaw  + z*s_rcfltState.cosYaw + s_rcfltState.cameraTrans.z;
@@ -271,11 +275,6 @@ namespace TFE_Jedi
 				for (s32 i = s_curSector->objectCount - 1; i >= 0; i--, obj++)
 				{
 					SecObject* curObj = *obj;
-					while (!curObj)
-					{
-						obj++;
-						curObj = *obj;
-					}
 
 					if (curObj->flags & OBJ_FLAG_NEEDS_TRANSFORM)
 					{
@@ -451,6 +450,10 @@ namespace TFE_Jedi
 					saveValues(index);
 
 					adjoin_computeWindowBounds(adjoinEdges);
+					if (s_adjoinDepth == 1)
+					{
+						raster_addViewRange(s_windowMinX_Pixels, s_windowMaxX_Pixels);
+					}
 					s_adjoinDepth++;
 					if (s_adjoinDepth > s_maxAdjoinDepth)
 					{
@@ -476,7 +479,10 @@ namespace TFE_Jedi
 					}
 
 					s_rcfltState.windowMinZ = min(curAdjoinSeg->z0, curAdjoinSeg->z1);
-					draw(nextSector);
+					if (pvs_isVisible(nextSector))
+					{
+						drawSector(nextSector);
+					}
 					
 					if (s_adjoinDepth)
 					{
@@ -694,7 +700,7 @@ namespace TFE_Jedi
 		
 	void TFE_Sectors_Float::updateCachedWalls(SectorCached* cached, u32 flags)
 	{
-		if (!(flags & SDF_WALL_CHANGE)) { return; }
+		if (!(flags & (SDF_WALL_CHANGE | SDF_VERTICES))) { return; }
 
 		RSector* srcSector = cached->sector;
 		if (flags & SDF_INIT_SETUP)
@@ -743,6 +749,15 @@ namespace TFE_Jedi
 				wcached->wallDir.z = fixed16ToFloat(srcWall->wallDir.z);
 				wcached->length = fixed16ToFloat(srcWall->length);
 			}
+
+			if (flags & (SDF_VERTICES | SDF_WALL_SHAPE))
+			{
+				const vec2_float* w0 = &cached->verticesWS[wcached->v0 - cached->verticesVS];
+				const vec2_float* w1 = &cached->verticesWS[wcached->v1 - cached->verticesVS];
+				wcached->delta.x = w1->x - w0->x;
+				wcached->delta.z = w1->z - w0->z;
+				wcached->lineDist = w0->z*wcached->delta.x - w0->x*wcached->delta.z;
+			}
 		}
 	}
 
@@ -752,9 +767,20 @@ namespace TFE_Jedi
 
 		if (flags & SDF_INIT_SETUP)
 		{
+			cached->verticesWS = (vec2_float*)level_alloc(sizeof(vec2_float) * srcSector->vertexCount);
 			cached->verticesVS = (vec2_float*)level_alloc(sizeof(vec2_float) * srcSector->vertexCount);
 		}
 
+		if (flags & (SDF_VERTICES | SDF_WALL_SHAPE))
+		{
+			const vec2_fixed* srcVtx = srcSector->verticesWS;
+			for (s32 v = 0; v < srcSector->vertexCount; v++)
+			{
+				cached->verticesWS[v].x = fixed16ToFloat(srcVtx[v].x);
+				cached->verticesWS[v].z = fixed16ToFloat(srcVtx[v].z);
+			}
+		}
+
 		if (flags & SDF_HEIGHTS)
 		{
 			cached->floorHeight = fixed16ToFloat(srcSector->floorHeight);
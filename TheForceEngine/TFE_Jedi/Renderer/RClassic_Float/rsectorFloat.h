@@ -20,6 +20,8 @@ namespace TFE_Jedi
 		RSector* sector;		// base sector.
 		WallCached* cachedWalls;
 		s32 objectCapacity;
+		// Floating point version of world space vertices, updated when the vertices move.
+		vec2_float* verticesWS;
 		// Floating point version of view space vertices.
 		vec2_float* verticesVS;
 		// Space for floating point positions.
@@ -45,6 +47,7 @@ namespace TFE_Jedi
 		void subrendererChanged() override;
 
 	private:
+		void drawSector(RSector* sector);
 		void saveValues(s32 index);
 		void restoreValues(s32 index);
 		void adjoin_computeWindowBounds(EdgePairFloat* adjoinEdges);
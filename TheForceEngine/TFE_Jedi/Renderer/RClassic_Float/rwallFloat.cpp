@@ -12,6 +12,7 @@
 #include "rsectorFloat.h"
 #include "redgePairFloat.h"
 #include "rclassicFloatSharedState.h"
+#include "rrasterFloat.h"
 #include "../rcommon.h"
 #include "../jediRenderer.h"
 
@@ -21,6 +22,8 @@ namespace TFE_Jedi
 namespace RClassic_Float
 {
 	#define SKY_BASE_HEIGHT 200
+	// Distance the camera must be behind a wall, in world units, for the world space back face test to reject it.
+	static const f32 c_wallPlaneCullMargin = 0.05f;
 
 	enum SegSide
 	{
@@ -284,6 +287,19 @@ namespace RClassic_Float
 		const vec2_float* p1 = wallCached->v1;
 		RWall* wall = wallCached->wall;
 
+		// Cull the wall if the camera is clearly behind it, using the cached world space line.
+		// This is the same test as the view space back face test below (rotation preserves the sign), but done before clipping.
+		// Walls within the margin are left to the view space test so the result does not change.
+		if (s_wallPlaneCull)
+		{
+			const f32 side = wallCached->lineDist - (s_rcfltState.cameraPos.z*wallCached->delta.x - s_rcfltState.cameraPos.x*wallCached->delta.z);
+			if (side < -c_wallPlaneCullMargin * wallCached->length)
+			{
+				wall->visible = 0;
+				return;
+			}
+		}
+
 		// viewspace wall coordinates.
 		f32 x0 = p0->x;
 		f32 x1 = p1->x;
@@ -2140,64 +2156,168 @@ namespace RClassic_Float
 		return z;
 	}
 
-	void drawColumn_Fullbright()
+	// Column parameters, copied from the column state so the column can also be drawn later by the deferred raster.
+	struct ColumnParams
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
+		u8* out;
+		const u8* tex;
+		const u8* light;
+		fixed44_20 vCoord;
+		fixed44_20 vCoordStep;
+		s32 pixelCount;
+		s32 texHeightMask;
+	};
+
+	// A recorded column, followed by 'texelCount' texels if the texture is the sprite work buffer.
+	struct DeferredColumn
+	{
+		ColumnParams col;
+		s32 func;
+		s32 texelCount;
+	};
+
+	static void column_fullbright(const ColumnParams* col)
+	{
+		fixed44_20 vCoordFixed = col->vCoord;
+		const fixed44_20 vCoordStep = col->vCoordStep;
+		const s32 texHeightMask = col->texHeightMask;
+		const u8* tex = col->tex;
+		u8* out = col->out;
+		const s32 end = col->pixelCount - 1;
 
 		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += vCoordStep)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			s_columnOut[offset] = tex[v];
+			const s32 v = floor20(vCoordFixed) & texHeightMask;
+			out[offset] = tex[v];
 		}
 	}
 
-	void drawColumn_Lit()
+	static void column_lit(const ColumnParams* col)
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
+		fixed44_20 vCoordFixed = col->vCoord;
+		const fixed44_20 vCoordStep = col->vCoordStep;
+		const s32 texHeightMask = col->texHeightMask;
+		const u8* tex = col->tex;
+		const u8* light = col->light;
+		u8* out = col->out;
+		const s32 end = col->pixelCount - 1;
 
 		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += vCoordStep)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
-			s_columnOut[offset] = s_columnLight[tex[v]];
+			const s32 v = floor20(vCoordFixed) & texHeightMask;
+			out[offset] = light[tex[v]];
 		}
 	}
 
-	void drawColumn_Fullbright_Trans()
+	static void column_fullbrightTrans(const ColumnParams* col)
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
+		fixed44_20 vCoordFixed = col->vCoord;
+		const fixed44_20 vCoordStep = col->vCoordStep;
+		const s32 texHeightMask = col->texHeightMask;
+		const u8* tex = col->tex;
+		u8* out = col->out;
+		const s32 end = col->pixelCount - 1;
 
 		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += vCoordStep)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
+			const s32 v = floor20(vCoordFixed) & texHeightMask;
 			const u8 c = tex[v];
-			if (c) { s_columnOut[offset] = c; }
+			if (c) { out[offset] = c; }
 		}
 	}
 
-	void drawColumn_Lit_Trans()
+	static void column_litTrans(const ColumnParams* col)
 	{
-		fixed44_20 vCoordFixed = s_vCoordFixed;
-		const u8* tex = s_texImage;
-		const s32 end = s_yPixelCount - 1;
+		fixed44_20 vCoordFixed = col->vCoord;
+		const fixed44_20 vCoordStep = col->vCoordStep;
+		const s32 texHeightMask = col->texHeightMask;
+		const u8* tex = col->tex;
+		const u8* light = col->light;
+		u8* out = col->out;
+		const s32 end = col->pixelCount - 1;
 
 		s32 offset = end * s_width;
-		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += s_vCoordStep)
+		for (s32 i = end; i >= 0; i--, offset -= s_width, vCoordFixed += vCoordStep)
 		{
-			const s32 v = floor20(vCoordFixed) & s_texHeightMask;
+			const s32 v = floor20(vCoordFixed) & texHeightMask;
 			const u8 c = tex[v];
-			if (c) { s_columnOut[offset] = s_columnLight[c]; }
+			if (c) { out[offset] = light[c]; }
 		}
 	}
 
+	typedef void(*ColumnKernel)(const ColumnParams* col);
+	static const ColumnKernel c_columnKernel[COLFUNC_COUNT] =
+	{
+		column_fullbright,			// COLFUNC_FULLBRIGHT
+		column_lit,					// COLFUNC_LIT
+		column_fullbrightTrans,		// COLFUNC_FULLBRIGHT_TRANS
+		column_litTrans,			// COLFUNC_LIT_TRANS
+	};
+
+	static void drawDeferredColumn(const void* params, s32 x0, s32 x1)
+	{
+		const DeferredColumn* deferred = (const DeferredColumn*)params;
+		ColumnParams col = deferred->col;
+		if (deferred->texelCount)
+		{
+			col.tex = (const u8*)(deferred + 1);
+		}
+		c_columnKernel[deferred->func](&col);
+	}
+
+	static void drawColumn(ColumnFuncId func)
+	{
+		const ColumnParams col = { s_columnOut, s_texImage, s_columnLight, s_vCoordFixed, s_vCoordStep, s_yPixelCount, s_texHeightMask };
+		if (!raster_isDeferred())
+		{
+			c_columnKernel[func](&col);
+			return;
+		}
+		if (s_yPixelCount <= 0) { return; }
+
+		// The sprite work buffer is reused by the next column, so copy the texels that the column reads.
+		s32 texelCount = 0;
+		if (s_texImage == s_workBuffer)
+		{
+			const s32 vLast = floor20(s_vCoordFixed + s_vCoordStep * (s_yPixelCount - 1));
+			const bool inBuffer = s_vCoordFixed >= 0 && s_vCoordStep >= 0 && vLast < WAX_DECOMPRESS_SIZE;
+			texelCount = inBuffer ? vLast + 1 : WAX_DECOMPRESS_SIZE;
+		}
+
+		const s32 x = s32(size_t(s_columnOut - s_display) % size_t(s_width));
+		DeferredColumn* deferred = (DeferredColumn*)raster_push(drawDeferredColumn, x, x, u32(sizeof(DeferredColumn) + texelCount), s_yPixelCount);
+		deferred->col = col;
+		deferred->func = func;
+		deferred->texelCount = texelCount;
+		if (texelCount)
+		{
+			memcpy(deferred + 1, s_workBuffer, texelCount);
+		}
+	}
+
+	void drawColumn_Fullbright()
+	{
+		drawColumn(COLFUNC_FULLBRIGHT);
+	}
+
+	void drawColumn_Lit()
+	{
+		drawColumn(COLFUNC_LIT);
+	}
+
+	void drawColumn_Fullbright_Trans()
+	{
+		drawColumn(COLFUNC_FULLBRIGHT_TRANS);
+	}
+
+	void drawColumn_Lit_Trans()
+	{
+		drawColumn(COLFUNC_LIT_TRANS);
+	}
+
 	void wall_addAdjoinSegment(s32 length, s32 x0, f32 top_dydx, f32 y1, f32 bot_dydx, f32 y0, RWallSegmentFloat* wallSegment)
 	{
 		if (s_adjoinSegCount < s_maxAdjoinSegCount)
@@ -43,6 +43,10 @@ namespace TFE_Jedi
 		// Direction and length.
 		vec2_float wallDir;
 		f32 length;
+
+		// World space wall line, updated when the vertices move: side = lineDist - cross(cameraPos, delta).
+		vec2_float delta;	// v1 - v0
+		f32 lineDist;		// cross(v0, delta)
 	};
 
 	namespace RClassic_Float
@@ -31,12 +31,16 @@ namespace TFE_Jedi
 	static u32* s_objectPlaneInfo = nullptr;
 	static Vec4f* s_objectPlanes = nullptr;
 	static ShaderBuffer s_objectPlanesGPU;
+	static bool s_gpuBuffers = false;
 		
-	void objectPortalPlanes_init()
+	void objectPortalPlanes_init(bool gpuBuffers)
 	{
 		s_objectPlaneInfo = (u32*)malloc(sizeof(u32)*MAX_DISP_ITEMS);
 		s_objectPlanes = (Vec4f*)malloc(sizeof(Vec4f)*MAX_BUFFER_SIZE);
 
+		s_gpuBuffers = gpuBuffers;
+		if (!gpuBuffers) { return; }
+
 		const ShaderBufferDef bufferDefDisplayListPlanes = { 4, sizeof(f32), BUF_CHANNEL_FLOAT };
 		s_objectPlanesGPU.create(MAX_BUFFER_SIZE, bufferDefDisplayListPlanes, true);
 	}
@@ -49,6 +53,8 @@ namespace TFE_Jedi
 		s_objectPlanes = nullptr;
 
 		s_objectPlaneCount = 0;
+		if (!s_gpuBuffers) { return; }
+		s_gpuBuffers = false;
 		s_objectPlanesGPU.destroy();
 	}
 
@@ -59,7 +65,7 @@ namespace TFE_Jedi
 
 	void objectPortalPlanes_finish()
 	{
-		if (s_objectPlaneCount)
+		if (s_objectPlaneCount && s_gpuBuffers)
 		{
 			s_objectPlanesGPU.update(s_objectPlanes, sizeof(Vec4f) * s_objectPlaneCount);
 		}
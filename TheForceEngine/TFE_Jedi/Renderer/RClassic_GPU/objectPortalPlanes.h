@@ -8,7 +8,7 @@
 
 namespace TFE_Jedi
 {
-	void objectPortalPlanes_init();
+	void objectPortalPlanes_init(bool gpuBuffers = true);
 	void objectPortalPlanes_destroy();
 
 	void objectPortalPlanes_clear();
@@ -77,8 +77,9 @@ namespace TFE_Jedi
 	static s32 s_dataIndex[SECTOR_PASS_COUNT];
 	static s32 s_planesIndex = -1;
 	static s32 s_maxPlaneCount = 0;
+	static bool s_gpuBuffers = false;
 
-	void sdisplayList_init(s32* posIndex, s32* dataIndex, s32 planesIndex)
+	void sdisplayList_init(s32* posIndex, s32* dataIndex, s32 planesIndex, bool gpuBuffers)
 	{
 		TFE_COUNTER(s_displayPortalCount, "GPU Portal Count");
 		TFE_COUNTER(s_displayPlaneCount, "GPU Plane Count");
@@ -96,6 +97,13 @@ namespace TFE_Jedi
 		s_portalPlaneInfo   = (u32*)malloc(sizeof(u32) * MAX_BUFFER_SIZE);
 		s_portalFrustumVert = (Frustum*)malloc(sizeof(Frustum) * MAX_BUFFER_SIZE);
 
+		s_gpuBuffers = gpuBuffers;
+		if (!gpuBuffers)
+		{
+			sdisplayList_clear();
+			return;
+		}
+
 		const ShaderBufferDef bufferDefDisplayListPos  = { 4, sizeof(f32), BUF_CHANNEL_FLOAT };
 		const ShaderBufferDef bufferDefDisplayListData = { 4, sizeof(u32), BUF_CHANNEL_UINT };
 		for (s32 i = 0; i < SECTOR_PASS_COUNT; i++)
@@ -127,6 +135,8 @@ namespace TFE_Jedi
 		s_portalPlaneInfo = nullptr;
 		s_portalFrustumVert = nullptr;
 
+		if (!s_gpuBuffers) { return; }
+		s_gpuBuffers = false;
 		for (s32 i = 0; i < SECTOR_PASS_COUNT; i++)
 		{
 			s_displayListPosGPU[i].destroy();
@@ -148,6 +158,7 @@ namespace TFE_Jedi
 
 	void sdisplayList_finish()
 	{
+		if (!s_gpuBuffers) { return; }
 		for (s32 i = 0; i < SECTOR_PASS_COUNT; i++)
 		{
 			if (!s_displayListCount[i]) { continue; }
@@ -45,7 +45,8 @@ namespace TFE_Jedi
 		s32 wallStart;
 	};
 
-	void sdisplayList_init(s32* posIndex, s32* dataIndex, s32 planesIndex);
+	// If 'gpuBuffers' is false, only the CPU side of the display list is allocated (no graphics context required).
+	void sdisplayList_init(s32* posIndex, s32* dataIndex, s32 planesIndex, bool gpuBuffers = true);
 	void sdisplayList_destroy();
 
 	void sdisplayList_clear();
@@ -0,0 +1,84 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// CPU visibility traversal for the GPU sub-renderer.
+// Walks the sector/adjoin graph from the camera, clips walls using
+// the s-buffer and fills the sector, sprite and object display lists.
+// This code has no GPU dependencies so it can run (and be profiled)
+// without a graphics context; uploads are handled by the caller.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/fixedPoint.h>
+#include <TFE_Jedi/Math/core_math.h>
+#include "sectorDisplayList.h"
+
+struct RSector;
+struct SecObject;
+struct JediModel;
+
+namespace TFE_Jedi
+{
+	enum TraversalUploadFlags
+	{
+		UPLOAD_NONE     = 0,
+		UPLOAD_SECTORS  = FLAG_BIT(0),
+		UPLOAD_VERTICES = FLAG_BIT(1),
+		UPLOAD_WALLS    = FLAG_BIT(2),
+		UPLOAD_ALL      = UPLOAD_SECTORS | UPLOAD_VERTICES | UPLOAD_WALLS
+	};
+
+	// CPU copy of the sector and wall data consumed by the GPU shaders.
+	struct TraversalSourceData
+	{
+		Vec4f* sectors;
+		Vec4f* walls;
+		u32 sectorSize;
+		u32 wallSize;
+		s32 wallCount;
+	};
+
+	// A visible 3D object, added to the GPU model draw list by the caller.
+	struct TraversalModel
+	{
+		SecObject* obj;
+		JediModel* model;
+		Vec3f posWS;
+		f32   ambient;
+		Vec2f floorOffset;
+		Vec2f ceilOffset;
+		u32   portalInfo;
+	};
+
+	// Statistics for the last traversal.
+	struct TraversalStats
+	{
+		s32 sectors;
+		s32 wallSegments;
+		s32 portals;
+		s32 sprites;
+		s32 models;
+	};
+
+	// Allocates the CPU scratch memory used by the traversal.
+	void traversal_init();
+	void traversal_destroy();
+	bool traversal_isInitialized();
+
+	// Builds the cached sector and wall data from the current level (level memory).
+	void traversal_levelInit();
+	void traversal_levelReset();
+	// Frees the cached data, only used when the traversal is run without the GPU sub-renderer.
+	void traversal_levelDestroy();
+	bool traversal_isLevelInitialized();
+	const TraversalSourceData* traversal_getSourceData();
+
+	// Advance the traversal frame, used to avoid processing a wall more than once per frame.
+	void traversal_nextFrame();
+
+	// Build the display lists for the current camera starting at 'sector'.
+	// The display lists must be cleared and finished by the caller.
+	// Returns the UPLOAD_* flags for the source data modified during the traversal.
+	u32 traversal_buildDisplayLists(RSector* sector);
+
+	s32 traversal_getModelList(const TraversalModel** list);
+	const TraversalStats* traversal_getStats();
+}  // TFE_Jedi
@@ -49,6 +49,7 @@ namespace TFE_Jedi
 	static s32 s_posYUTextureIndex;
 	static s32 s_texIdTextureIndex;
 	static s32 s_planesIndex;
+	static bool s_gpuBuffers = false;
 
 	// TODO: Refactor
 	extern s32 s_displayCurrentPortalId;
@@ -59,7 +60,7 @@ namespace TFE_Jedi
 	extern Vec3f s_cameraRight;
 	void sprdisplayList_sort();
 
-	void sprdisplayList_init(s32 startIndex)
+	void sprdisplayList_init(s32 startIndex, bool gpuBuffers)
 	{
 		for (s32 i = 0; i < SPRITE_BUFFER_COUNT; i++)
 		{
@@ -68,6 +69,14 @@ namespace TFE_Jedi
 			s_displayListTexIdTexture[i] = (Vec2i*)malloc(sizeof(Vec2i*) * MAX_DISP_ITEMS);
 		}
 		s_displayListObjList = (void**)malloc(sizeof(void**) * MAX_DISP_ITEMS);
+		TFE_COUNTER(s_displayListCount, "Sprites Rendered");
+
+		s_gpuBuffers = gpuBuffers;
+		if (!gpuBuffers)
+		{
+			sprdisplayList_clear();
+			return;
+		}
 
 		const ShaderBufferDef bufferDefDisplayList = { 4, sizeof(f32), BUF_CHANNEL_FLOAT };
 		const ShaderBufferDef bufferDefTexDisplayList = { 2, sizeof(s32), BUF_CHANNEL_INT };
@@ -82,8 +91,6 @@ namespace TFE_Jedi
 		// TODO: Refactor
 		s_planesIndex = 7;
 
-		TFE_COUNTER(s_displayListCount, "Sprites Rendered");
-
 		sprdisplayList_clear();
 	}
 
@@ -101,6 +108,8 @@ namespace TFE_Jedi
 		free(s_displayListObjList);
 		s_displayListObjList = nullptr;
 
+		if (!s_gpuBuffers) { return; }
+		s_gpuBuffers = false;
 		s_displayListPosXZTextureGPU.destroy();
 		s_displayListPosYUTextureGPU.destroy();
 		s_displayListTexIdTextureGPU.destroy();
@@ -115,6 +124,7 @@ namespace TFE_Jedi
 	{
 		if (!s_displayListCount) { return; }
 		sprdisplayList_sort();
+		if (!s_gpuBuffers) { return; }
 
 		s_displayListPosXZTextureGPU.update(s_displayListPosXZTexture[1], sizeof(Vec4f) * s_displayListCount);
 		s_displayListPosYUTextureGPU.update(s_displayListPosYUTexture[1], sizeof(Vec4f) * s_displayListCount);
@@ -29,7 +29,8 @@ namespace TFE_Jedi
 		u32 portalInfo;
 	};
 
-	void sprdisplayList_init(s32 startIndex);
+	// If 'gpuBuffers' is false, only the CPU side of the display list is allocated (no graphics context required).
+	void sprdisplayList_init(s32 startIndex, bool gpuBuffers = true);
 	void sprdisplayList_destroy();
 
 	void sprdisplayList_clear();
@@ -0,0 +1,296 @@
+#include <cstring>
+#include <cfloat>
+#include <vector>
+
+#include <TFE_System/system.h>
+#include <TFE_System/math.h>
+#include <TFE_System/parser.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_FrontEndUI/console.h>
+#include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/rsector.h>
+#include <TFE_Jedi/Level/sectorPvs.h>
+#include <TFE_Jedi/Math/fixedPoint.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+#include "traversalBench.h"
+#include "sectorTraversal.h"
+#include "sectorDisplayList.h"
+#include "spriteDisplayList.h"
+#include "objectPortalPlanes.h"
+#include "rclassicGPU.h"
+#include "../rcommon.h"
+
+namespace TFE_Jedi
+{
+	struct BenchCamera
+	{
+		Vec3f pos;
+		f32 yaw;
+		f32 pitch;
+	};
+
+	// Saved sector state, so that running the benchmark does not affect the automap or the other sub-renderers.
+	struct BenchSectorState
+	{
+		u32 flags1;
+		u32 dirtyFlags;
+	};
+
+	static const f32 c_benchEyeHeight = 5.8f;
+
+	extern Mat3  s_cameraMtx;
+	extern Mat4  s_cameraProj;
+	extern Vec3f s_cameraPos;
+	extern Vec3f s_cameraDir;
+	extern Vec3f s_cameraDirXZ;
+	extern Vec3f s_cameraRight;
+
+	static f32 degreesToAngle(f32 deg)
+	{
+		return deg * 16384.0f / 360.0f;
+	}
+
+	static void buildSectorTour(s32 viewsPerSector, std::vector<BenchCamera>& path)
+	{
+		viewsPerSector = max(1, viewsPerSector);
+		const f32 yawStep = 16384.0f / f32(viewsPerSector);
+		for (u32 s = 0; s < s_levelState.sectorCount; s++)
+		{
+			const RSector* sector = &s_levelState.sectors[s];
+			if (!sector->vertexCount || sector->floorHeight <= sector->ceilingHeight) { continue; }
+
+			Vec3f center = { 0.0f, fixed16ToFloat(sector->floorHeight) - c_benchEyeHeight, 0.0f };
+			for (s32 v = 0; v < sector->vertexCount; v++)
+			{
+				center.x += fixed16ToFloat(sector->verticesWS[v].x);
+				center.z += fixed16ToFloat(sector->verticesWS[v].z);
+			}
+			const f32 scale = 1.0f / f32(sector->vertexCount);
+			center.x *= scale;
+			center.z *= scale;
+
+			for (s32 v = 0; v < viewsPerSector; v++)
+			{
+				path.push_back({ center, f32(v) * yawStep, 0.0f });
+			}
+		}
+	}
+
+	static bool readCameraPath(const char* pathFile, std::vector<BenchCamera>& path)
+	{
+		char* buffer = nullptr;
+		const u32 size = FileStream::readContents(pathFile, (void**)&buffer);
+		if (!size)
+		{
+			free(buffer);
+			return false;
+		}
+
+		TFE_Parser parser;
+		size_t bufferPos = 0;
+		parser.init(buffer, size);
+		parser.addCommentString("#");
+		parser.addCommentString("//");
+
+		const char* line;
+		while ((line = parser.readLine(bufferPos)) != nullptr)
+		{
+			BenchCamera camera = { 0 };
+			if (sscanf(line, "%f %f %f %f %f", &camera.pos.x, &camera.pos.y, &camera.pos.z, &camera.yaw, &camera.pitch) >= 4)
+			{
+				camera.yaw = degreesToAngle(camera.yaw);
+				camera.pitch = degreesToAngle(camera.pitch);
+				path.push_back(camera);
+			}
+		}
+		free(buffer);
+		return !path.empty();
+	}
+
+	bool traversalBench_run(const char* pathFile, s32 viewsPerSector, const char* csvFile, TraversalBenchResult* result)
+	{
+		if (!s_levelState.sectors || !s_levelState.sectorCount)
+		{
+			TFE_System::logWrite(LOG_ERROR, "Traversal Bench", "No level is loaded.");
+			return false;
+		}
+
+		std::vector<BenchCamera> path;
+		if (pathFile && pathFile[0])
+		{
+			if (!readCameraPath(pathFile, path))
+			{
+				TFE_System::logWrite(LOG_ERROR, "Traversal Bench", "Cannot read camera path '%s'.", pathFile);
+				return false;
+			}
+		}
+		else
+		{
+			buildSectorTour(viewsPerSector, path);
+		}
+
+		// Initialize CPU-only display lists if the GPU sub-renderer is not active.
+		const bool ownTraversal = !traversal_isInitialized();
+		if (ownTraversal)
+		{
+			sdisplayList_init(nullptr, nullptr, -1, false);
+			sprdisplayList_init(0, false);
+			objectPortalPlanes_init(false);
+			traversal_init();
+		}
+		const bool ownLevelData = !traversal_isLevelInitialized();
+		if (ownLevelData)
+		{
+			traversal_levelInit();
+		}
+
+		// Save state modified by the traversal.
+		std::vector<BenchSectorState> sectorState(s_levelState.sectorCount);
+		for (u32 s = 0; s < s_levelState.sectorCount; s++)
+		{
+			sectorState[s] = { s_levelState.sectors[s].flags1, s_levelState.sectors[s].dirtyFlags };
+		}
+		const Mat3  cameraMtx = s_cameraMtx;
+		const Mat4  cameraProj = s_cameraProj;
+		const Vec3f cameraPos = s_cameraPos;
+		const Vec3f cameraDir = s_cameraDir;
+		const Vec3f cameraDirXZ = s_cameraDirXZ;
+		const Vec3f cameraRight = s_cameraRight;
+
+		FileStream csv;
+		const bool writeCsv = csvFile && csvFile[0] && csv.open(csvFile, Stream::MODE_WRITE);
+		if (writeCsv)
+		{
+			csv.writeString("frame,x,y,z,yaw,pitch,sectors,segments,portals,sprites,models,microseconds\r\n");
+		}
+
+		TraversalBenchResult res = { 0 };
+		res.minMicroseconds = FLT_MAX;
+		const s32 count = (s32)path.size();
+		for (s32 i = 0; i < count; i++)
+		{
+			const BenchCamera* camera = &path[i];
+			RSector* sector = sector_which3D(floatToFixed16(camera->pos.x), floatToFixed16(camera->pos.y), floatToFixed16(camera->pos.z));
+			if (!sector) { continue; }
+
+			RClassic_GPU::computeCameraTransform(sector, camera->pitch, camera->yaw, camera->pos.x, camera->pos.y, camera->pos.z);
+			// Use the original 320x200 projection so results do not depend on the current resolution or sub-renderer.
+			s_cameraProj = TFE_Math::computeProjMatrixExplicit(1.0f, 1.6f, 0.01f, 4096.0f);
+
+			const u64 start = TFE_System::getCurrentTimeInTicks();
+			sdisplayList_clear();
+			sprdisplayList_clear();
+			objectPortalPlanes_clear();
+			pvs_beginView(sector);
+			traversal_buildDisplayLists(sector);
+			traversal_nextFrame();
+			const f64 microseconds = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - start) * 1000000.0;
+
+			const TraversalStats* stats = traversal_getStats();
+			res.frameCount++;
+			res.avgMicroseconds += microseconds;
+			res.minMicroseconds = min(res.minMicroseconds, microseconds);
+			res.maxMicroseconds = max(res.maxMicroseconds, microseconds);
+			res.avgSegments += f64(stats->wallSegments);
+			res.avgPortals  += f64(stats->portals);
+			res.avgSectors  += f64(stats->sectors);
+			res.maxSegments = max(res.maxSegments, stats->wallSegments);
+			res.maxPortals  = max(res.maxPortals, stats->portals);
+
+			if (writeCsv)
+			{
+				csv.writeString("%d,%0.3f,%0.3f,%0.3f,%0.1f,%0.1f,%d,%d,%d,%d,%d,%0.2f\r\n", i, camera->pos.x, camera->pos.y, camera->pos.z,
+					camera->yaw, camera->pitch, stats->sectors, stats->wallSegments, stats->portals, stats->sprites, stats->models, microseconds);
+			}
+		}
+		if (writeCsv)
+		{
+			csv.close();
+		}
+		if (res.frameCount)
+		{
+			const f64 scale = 1.0 / f64(res.frameCount);
+			res.avgMicroseconds *= scale;
+			res.avgSegments *= scale;
+			res.avgPortals  *= scale;
+			res.avgSectors  *= scale;
+		}
+		else
+		{
+			res.minMicroseconds = 0.0;
+		}
+
+		// Restore state.
+		for (u32 s = 0; s < s_levelState.sectorCount; s++)
+		{
+			s_levelState.sectors[s].flags1 = sectorState[s].flags1;
+			s_levelState.sectors[s].dirtyFlags |= sectorState[s].dirtyFlags;
+		}
+		s_cameraMtx = cameraMtx;
+		s_cameraProj = cameraProj;
+		s_cameraPos = cameraPos;
+		s_cameraDir = cameraDir;
+		s_cameraDirXZ = cameraDirXZ;
+		s_cameraRight = cameraRight;
+
+		if (ownLevelData)
+		{
+			traversal_levelDestroy();
+		}
+		if (ownTraversal)
+		{
+			traversal_destroy();
+			objectPortalPlanes_destroy();
+			sprdisplayList_destroy();
+			sdisplayList_destroy();
+		}
+
+		if (result)
+		{
+			*result = res;
+		}
+		return res.frameCount > 0;
+	}
+
+	void console_benchTraversal(const ConsoleArgList& args)
+	{
+		s32 viewsPerSector = 8;
+		const char* pathFile = nullptr;
+		if (args.size() > 1)
+		{
+			char* endPtr = nullptr;
+			const s32 value = (s32)strtol(args[1].c_str(), &endPtr, 10);
+			if (endPtr && *endPtr == 0) { viewsPerSector = value; }
+			else { pathFile = args[1].c_str(); }
+		}
+
+		char csvPath[TFE_MAX_PATH];
+		TFE_Paths::appendPath(PATH_USER_DOCUMENTS, "traversal_bench.csv", csvPath);
+
+		TraversalBenchResult result;
+		if (!traversalBench_run(pathFile, viewsPerSector, csvPath, &result))
+		{
+			TFE_Console::addToHistory("Traversal benchmark failed, see the log for details.");
+			return;
+		}
+
+		char res[256];
+		sprintf(res, "Frames: %d, Time (us): avg %0.2f, min %0.2f, max %0.2f", result.frameCount, result.avgMicroseconds, result.minMicroseconds, result.maxMicroseconds);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Traversal Bench", "%s", res);
+		sprintf(res, "Segments: avg %0.1f, max %d; Portals: avg %0.1f, max %d; Sectors: avg %0.1f", result.avgSegments, result.maxSegments,
+			result.avgPortals, result.maxPortals, result.avgSectors);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Traversal Bench", "%s", res);
+		sprintf(res, "Per-frame results written to '%s'", csvPath);
+		TFE_Console::addToHistory(res);
+	}
+
+	void traversalBench_registerCommands()
+	{
+		CCMD("rbenchTraversal", console_benchTraversal, 0, "Benchmark the CPU visibility traversal in the current level - rbenchTraversal [viewsPerSector | cameraPathFile]");
+	}
+}  // TFE_Jedi
@@ -0,0 +1,31 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Visibility traversal benchmark.
+// Runs the CPU sector traversal over a scripted camera path in the
+// currently loaded level and reports wall segments, portals and
+// time per frame. No graphics context is required.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+namespace TFE_Jedi
+{
+	struct TraversalBenchResult
+	{
+		s32 frameCount;
+		f64 avgMicroseconds;
+		f64 minMicroseconds;
+		f64 maxMicroseconds;
+		f64 avgSegments;
+		f64 avgPortals;
+		f64 avgSectors;
+		s32 maxSegments;
+		s32 maxPortals;
+	};
+
+	// Camera path: if 'pathFile' is null, the camera visits every sector center and looks in 'viewsPerSector' directions.
+	// Otherwise the path is read from a text file with one "x y z yaw pitch" entry per line (angles in degrees).
+	// Per-frame results are written to 'csvFile' if it is not null.
+	bool traversalBench_run(const char* pathFile, s32 viewsPerSector, const char* csvFile, TraversalBenchResult* result);
+
+	void traversalBench_registerCommands();
+}  // TFE_Jedi
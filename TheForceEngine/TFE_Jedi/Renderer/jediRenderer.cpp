@@ -2,20 +2,25 @@
 #include <TFE_Jedi/Math/fixedPoint.h>
 #include <TFE_Jedi/Level/robject.h>
 #include <TFE_Jedi/Level/level.h>
+#include <TFE_Jedi/Level/sectorPvs.h>
 #include "rcommon.h"
+#include "staticView.h"
 #include "rsectorRender.h"
 #include "screenDraw.h"
 #include "RClassic_Fixed/rclassicFixedSharedState.h"
 #include "RClassic_Fixed/rclassicFixed.h"
 #include "RClassic_Fixed/rsectorFixed.h"
+#include "RClassic_Fixed/robj3d_fixed/robj3dFixed_TransformAndLighting.h"
 
 #include "RClassic_Float/rclassicFloat.h"
 #include "RClassic_Float/rsectorFloat.h"
 #include "RClassic_Float/rclassicFloatSharedState.h"
+#include "RClassic_Float/robj3d_float/robj3dFloat_TransformAndLighting.h"
 
 #include "RClassic_GPU/rclassicGPU.h"
 #include "RClassic_GPU/rsectorGPU.h"
 #include "RClassic_GPU/screenDrawGPU.h"
+#include "RClassic_GPU/traversalBench.h"
 
 #include <TFE_System/profiler.h>
 #include <TFE_RenderBackend/renderBackend.h>
@@ -28,6 +33,13 @@ namespace TFE_Jedi
 {
 	static bool s_init = false;
 	static TFE_SubRenderer s_subRenderer = TSR_CLASSIC_FIXED;
+	// Separate zones per sub-renderer, so the telemetry shows which renderer drew the frame.
+	static const char* c_sectorDrawZone[] =
+	{
+		"Sector Draw (Classic_Fixed)",	// TSR_CLASSIC_FIXED
+		"Sector Draw (Classic_Float)",	// TSR_CLASSIC_FLOAT
+		"Sector Draw (Classic_GPU)",	// TSR_CLASSIC_GPU
+	};
 	static std::vector<TextureListCallback> s_hudTextureCallbacks;
 	static TFE_Sectors* s_sectorRendererCache[TSR_COUNT] = { nullptr };
 	static bool s_trueColor = false;
@@ -45,6 +57,7 @@ namespace TFE_Jedi
 	void clear1dDepth();
 	void console_setSubRenderer(const std::vector<std::string>& args);
 	void console_getSubRenderer(const std::vector<std::string>& args);
+	void console_testModelSimd(const std::vector<std::string>& args);
 
 	/////////////////////////////////////////////
 	// Implementation
@@ -72,6 +85,7 @@ namespace TFE_Jedi
 		s_init = false;
 		s_trueColor = false;
 		s_enableMips = false;
+		staticView_invalidate();
 		vfb_setMode();
 	}
 
@@ -116,10 +130,17 @@ namespace TFE_Jedi
 		CVAR_INT(s_maxDepthCount, "d_maxDepthCount", CVFLAG_DO_NOT_SERIALIZE, "Maximum adjoin depth count.");
 		CVAR_INT(s_sectorAmbient, "d_sectorAmbient", CVFLAG_DO_NOT_SERIALIZE, "Current Sector Ambient.");
 		CVAR_BOOL(s_showWireframe, "d_enableWireframe", CVFLAG_DO_NOT_SERIALIZE, "Enable wireframe rendering.");
+		CVAR_BOOL(s_simdModelTransform, "r_simdModelTransform", CVFLAG_DO_NOT_SERIALIZE, "Use the SIMD 3D object vertex transform and lighting when available.");
+		CVAR_BOOL(s_wallPlaneCull, "r_wallPlaneCull", CVFLAG_DO_NOT_SERIALIZE, "Reject back facing walls before projection using the cached world space wall lines.");
+		CVAR_BOOL(s_parallelPortals, "r_parallelPortals", CVFLAG_DO_NOT_SERIALIZE, "Draw the Classic_Float view on the job pool, split into column ranges at the top-level adjoin windows.");
 
 		// Remove temporarily until they do something useful again.
 		CCMD("rsetSubRenderer", console_setSubRenderer, 1, "Set the sub-renderer - valid values are: Classic_Fixed, Classic_Float, Classic_GPU.");
 		CCMD("rgetSubRenderer", console_getSubRenderer, 0, "Get the current sub-renderer.");
+		CCMD("r_testModelSimd", console_testModelSimd, 0, "Compare the scalar and SIMD 3D object transform and lighting for every loaded model.");
+		traversalBench_registerCommands();
+		pvs_registerCommands();
+		staticView_registerCommands();
 
 		// Setup performance counters.
 		TFE_COUNTER(s_maxAdjoinDepth, "Maximum Adjoin Depth");
@@ -168,6 +189,12 @@ namespace TFE_Jedi
 
 	void renderer_setType(RendererType type)
 	{
+		// The GPU renderer needs a GPU context.
+		if (type == RENDERER_HARDWARE && TFE_RenderBackend::isHeadless())
+		{
+			TFE_System::logWrite(LOG_WARNING, "Jedi Renderer", "The GPU renderer is not available in headless mode, using the software renderer.");
+			type = RENDERER_SOFTWARE;
+		}
 		s_rendererType = type;
 		render_setResolution();
 	}
@@ -234,6 +261,56 @@ namespace TFE_Jedi
 		TFE_Console::addToHistory(c_subRenderers[s_subRenderer]);
 	}
 
+	void console_testModelSimd(const std::vector<std::string>& args)
+	{
+		if (!s_lightSourceRamp)
+		{
+			TFE_Console::addToHistory("A level must be loaded to test the model transform.");
+			return;
+		}
+
+		// A few object placements relative to the camera, near and far, with different orientations.
+		const vec3_fixed offsets[] = { { 0, 0, FIXED(10) }, { FIXED(-20), FIXED(2), FIXED(5) }, { FIXED(3), FIXED(-1), FIXED(60) }, { FIXED(40), 0, FIXED(-150) } };
+		const angle14_16 angles[] = { 0, 1234, 4096, 9000 };
+		const s32 placementCount = TFE_ARRAYSIZE(offsets);
+
+		s32 modelCount = 0, valueCount = 0;
+		s32 fixedMismatch = 0, floatMismatch = 0;
+		for (s32 pool = POOL_GAME; pool <= POOL_LEVEL; pool++)
+		{
+			const std::vector<JediModel*>& models = TFE_Model_Jedi::getModelList(AssetPool(pool));
+			for (size_t m = 0; m < models.size(); m++)
+			{
+				JediModel* model = models[m];
+				if (!model || !model->vertexCount) { continue; }
+				modelCount++;
+
+				for (s32 p = 0; p < placementCount; p++)
+				{
+					SecObject obj = {};
+					obj.posWS.x = s_rcfState.cameraPos.x + offsets[p].x;
+					obj.posWS.y = s_rcfState.eyeHeight   + offsets[p].y;
+					obj.posWS.z = s_rcfState.cameraPos.z + offsets[p].z;
+					obj.yaw = angles[p];
+					obj.pitch = angles[(p + 1) % placementCount];
+					obj.roll = angles[(p + 2) % placementCount];
+					obj.model = model;
+					obj3d_computeTransform(&obj);
+
+					s32 count = 0;
+					fixedMismatch += RClassic_Fixed::robj3d_compareTransformAndLight(&obj, model, &count);
+					valueCount += count;
+					floatMismatch += RClassic_Float::robj3d_compareTransformAndLight(&obj, model, &count);
+				}
+			}
+		}
+
+		char res[256];
+		sprintf(res, "Models: %d, values per path: %d, fixed point mismatches: %d, float mismatches: %d", modelCount, valueCount, fixedMismatch, floatMismatch);
+		TFE_Console::addToHistory(res);
+		TFE_System::logWrite(LOG_MSG, "Renderer", "Model SIMD test - %s", res);
+	}
+
 	static s32 s_fov = -1;
 	static bool s_clearCachedTextures = false;
 
@@ -361,6 +438,7 @@ namespace TFE_Jedi
 		}
 
 		s_subRenderer = subRenderer;
+		staticView_invalidate();
 		if (s_sectorRenderer)
 		{
 			s_sectorRenderer->subrendererChanged();
@@ -453,6 +531,7 @@ namespace TFE_Jedi
 		RClassic_Fixed::computeCameraTransform(sector, pitch, yaw, camX, camY, camZ);
 		RClassic_Float::computeCameraTransform(sector, f32(pitch), f32(yaw), fixed16ToFloat(camX), fixed16ToFloat(camY), fixed16ToFloat(camZ));
 		RClassic_GPU::computeCameraTransform(sector, f32(pitch), f32(yaw), fixed16ToFloat(camX), fixed16ToFloat(camY), fixed16ToFloat(camZ));
+		staticView_setCamera(sector, pitch, yaw, camX, camY, camZ);
 	}
 		
 	void beginRender()
@@ -485,6 +564,12 @@ namespace TFE_Jedi
 
 	void drawWorld(u8* display, RSector* sector, const u8* colormap, const u8* lightSourceRamp)
 	{
+		// The software view is unchanged from the last frame, so copy it instead of drawing it again.
+		if (s_subRenderer != TSR_CLASSIC_GPU && staticView_reuse(display, sector, colormap, lightSourceRamp, s_subRenderer))
+		{
+			return;
+		}
+
 		// Clear the top pixel row.
 		if (s_subRenderer != TSR_CLASSIC_GPU)
 		{
@@ -506,6 +591,8 @@ namespace TFE_Jedi
 			RClassic_GPU::computeSkyOffsets();
 		}
 
+		pvs_beginView(sector);
+
 		s_display = display;
 		s_colorMap = colormap;
 		s_lightSourceRamp = lightSourceRamp;
@@ -547,10 +634,15 @@ namespace TFE_Jedi
 				
 		// Recursively draws sectors and their contents (sprites, 3D objects).
 		{
-			TFE_ZONE("Sector Draw");
+			TFE_ZONE(c_sectorDrawZone[s_subRenderer]);
 			s_sectorRenderer->prepare();
 			s_sectorRenderer->draw(sector);
 		}
+
+		if (s_subRenderer != TSR_CLASSIC_GPU)
+		{
+			staticView_store(display, sector, colormap, lightSourceRamp, s_subRenderer);
+		}
 	}
 
 	/////////////////////////////////////////////
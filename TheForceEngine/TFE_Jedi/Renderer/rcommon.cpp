@@ -76,6 +76,15 @@ namespace TFE_Jedi
 	s32 s_lightCount = 3;
 	JBool s_flatLighting = JFALSE;
 
+	// 3D Objects
+	bool s_simdModelTransform = true;
+
+	// Walls
+	bool s_wallPlaneCull = true;
+
+	// Raster
+	bool s_parallelPortals = false;
+
 	// Limits
 	s32 s_maxSegCount = MAX_SEG;
 	s32 s_maxAdjoinSegCount = MAX_ADJOIN_SEG;
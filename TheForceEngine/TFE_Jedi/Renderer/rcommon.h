@@ -79,6 +79,15 @@ namespace TFE_Jedi
 
 	extern JBool s_flatLighting;
 
+	// 3D Objects
+	extern bool s_simdModelTransform;	// Use the SIMD model transform and lighting when available.
+
+	// Walls
+	extern bool s_wallPlaneCull;		// Reject back facing walls using the cached world space wall lines (float renderer).
+
+	// Raster
+	extern bool s_parallelPortals;		// Draw the view as parallel column ranges split at the top-level adjoin windows (float renderer).
+
 	// Limits
 	extern s32 s_maxSegCount;
 	extern s32 s_maxAdjoinSegCount;
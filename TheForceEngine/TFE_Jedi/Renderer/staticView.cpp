@@ -0,0 +1,259 @@
+#include <cstring>
+#include <cstdio>
+#include <vector>
+
+#include "staticView.h"
+#include "jediRenderer.h"
+#include "rcommon.h"
+#include <TFE_Jedi/Level/levelData.h>
+#include <TFE_Jedi/Level/rsector.h>
+#include <TFE_Jedi/Level/rwall.h>
+#include <TFE_Jedi/Level/robject.h>
+#include <TFE_Jedi/Renderer/RClassic_Fixed/rlightingFixed.h>
+#include <TFE_Jedi/Renderer/RClassic_Float/rlightingFloat.h>
+#include <TFE_System/hash.h>
+#include <TFE_FrontEndUI/console.h>
+
+using namespace TFE_Hash;
+
+namespace TFE_Jedi
+{
+	struct StaticViewCamera
+	{
+		RSector* sector;
+		angle14_32 pitch;
+		angle14_32 yaw;
+		vec3_fixed pos;
+	};
+
+	enum StaticViewConst
+	{
+		STATIC_VIEW_MAX_LIGHTS = 3,		// size of the sub-renderer s_cameraLight[] arrays.
+	};
+
+	static bool s_staticViewEnable = true;
+	static StaticViewCamera s_camera = {};
+	static std::vector<u8> s_savedView;
+	// The camera and render state are checked first, the drawn sectors are only hashed once those are unchanged.
+	static u64 s_savedStateSignature = 0;
+	static u64 s_savedSignature = 0;
+	static bool s_savedValid = false;
+	static StaticViewStats s_stats = {};
+
+	static u64 hashTexture(TextureData** texture, u64 hash)
+	{
+		// Hash the current texture rather than the slot, so animated texture frame changes are picked up.
+		const TextureData* tex = texture ? *texture : nullptr;
+		return fnv1a64Value(tex, hash);
+	}
+
+	static u64 hashSector(const RSector* sector, u64 hash)
+	{
+		hash = fnv1a64Value(sector, hash);
+		hash = fnv1a64Value(sector->dirtyFlags, hash);
+		hash = fnv1a64Value(sector->flags1, hash);
+		hash = fnv1a64Value(sector->floorHeight, hash);
+		hash = fnv1a64Value(sector->ceilingHeight, hash);
+		hash = fnv1a64Value(sector->secHeight, hash);
+		hash = fnv1a64Value(sector->ambient, hash);
+		hash = fnv1a64Value(sector->floorOffset, hash);
+		hash = fnv1a64Value(sector->ceilOffset, hash);
+		hash = hashTexture(sector->floorTex, hash);
+		hash = hashTexture(sector->ceilTex, hash);
+		hash = fnv1a64(sector->verticesWS, sizeof(vec2_fixed) * sector->vertexCount, hash);
+
+		const RWall* wall = sector->walls;
+		for (s32 w = 0; w < sector->wallCount; w++, wall++)
+		{
+			hash = fnv1a64Value(wall->nextSector, hash);
+			hash = fnv1a64Value(wall->flags1, hash);
+			hash = fnv1a64Value(wall->flags3, hash);
+			hash = fnv1a64Value(wall->wallLight, hash);
+			hash = fnv1a64Value(wall->topOffset, hash);
+			hash = fnv1a64Value(wall->midOffset, hash);
+			hash = fnv1a64Value(wall->botOffset, hash);
+			hash = fnv1a64Value(wall->signOffset, hash);
+			hash = hashTexture(wall->topTex, hash);
+			hash = hashTexture(wall->midTex, hash);
+			hash = hashTexture(wall->botTex, hash);
+			hash = hashTexture(wall->signTex, hash);
+		}
+
+		hash = fnv1a64Value(sector->objectCount, hash);
+		for (s32 i = 0; i < sector->objectCount; i++)
+		{
+			const SecObject* obj = sector->objectList[i];
+			hash = fnv1a64Value(obj, hash);
+			hash = fnv1a64Value(obj->ptr, hash);
+			hash = fnv1a64Value(obj->posWS, hash);
+			hash = fnv1a64Value(obj->frame, hash);
+			hash = fnv1a64Value(obj->anim, hash);
+			hash = fnv1a64Value(obj->flags, hash);
+			hash = fnv1a64Value(obj->pitch, hash);
+			hash = fnv1a64Value(obj->yaw, hash);
+			hash = fnv1a64Value(obj->roll, hash);
+			if (obj->type == OBJ_TYPE_3D)
+			{
+				hash = fnv1a64(obj->transform, sizeof(obj->transform), hash);
+			}
+		}
+		return hash;
+	}
+
+	static u64 hashCameraLights(u32 subRenderer, u64 hash)
+	{
+		const s32 lightCount = clamp(s_lightCount, 0, s32(STATIC_VIEW_MAX_LIGHTS));
+		hash = fnv1a64Value(s_lightCount, hash);
+		if (subRenderer == TSR_CLASSIC_FIXED)
+		{
+			for (s32 i = 0; i < lightCount; i++)
+			{
+				hash = fnv1a64Value(RClassic_Fixed::s_cameraLight[i].lightWS, hash);
+				hash = fnv1a64Value(RClassic_Fixed::s_cameraLight[i].brightness, hash);
+			}
+		}
+		else
+		{
+			for (s32 i = 0; i < lightCount; i++)
+			{
+				hash = fnv1a64Value(RClassic_Float::s_cameraLight[i].lightWS, hash);
+				hash = fnv1a64Value(RClassic_Float::s_cameraLight[i].brightness, hash);
+			}
+		}
+		return hash;
+	}
+
+	// The camera, lighting, palette and screen state the software view depends on, this is cheap to compute.
+	static u64 computeStateSignature(const u8* display, RSector* sector, const u8* colormap, const u8* lightSourceRamp, u32 subRenderer)
+	{
+		u64 hash = FNV64_OFFSET;
+		hash = fnv1a64Value(subRenderer, hash);
+		hash = fnv1a64Value(display, hash);
+		hash = fnv1a64Value(sector, hash);
+		hash = fnv1a64Value(colormap, hash);
+		hash = fnv1a64Value(lightSourceRamp, hash);
+		hash = fnv1a64Value(s_camera.sector, hash);
+		hash = fnv1a64Value(s_camera.pitch, hash);
+		hash = fnv1a64Value(s_camera.yaw, hash);
+		hash = fnv1a64Value(s_camera.pos, hash);
+
+		hash = fnv1a64Value(s_width, hash);
+		hash = fnv1a64Value(s_height, hash);
+		hash = fnv1a64Value(s_minScreenX_Pixels, hash);
+		hash = fnv1a64Value(s_maxScreenX_Pixels, hash);
+		hash = fnv1a64Value(s_minScreenY, hash);
+		hash = fnv1a64Value(s_maxScreenY, hash);
+		hash = fnv1a64Value(s_screenYMidBase, hash);
+		hash = fnv1a64Value(s_enableFlatShading, hash);
+		hash = fnv1a64Value(s_flatLighting, hash);
+		hash = fnv1a64Value(s_flatAmbient, hash);
+		hash = fnv1a64Value(s_cameraLightSource, hash);
+		hash = fnv1a64Value(s_worldAmbient, hash);
+		hash = fnv1a64Value(s_showWireframe, hash);
+		hash = hashCameraLights(subRenderer, hash);
+
+		Vec3f lumMask, palFx;
+		renderer_getPalFx(&lumMask, &palFx);
+		hash = fnv1a64Value(lumMask, hash);
+		hash = fnv1a64Value(palFx, hash);
+
+		hash = fnv1a64Value(s_levelState.sectors, hash);
+		hash = fnv1a64Value(s_levelState.parallax0, hash);
+		return fnv1a64Value(s_levelState.parallax1, hash);
+	}
+
+	// The state of the sectors drawn in the last rendered frame.
+	static u64 computeSectorSignature(u64 stateSignature)
+	{
+		u64 hash = stateSignature;
+		s32 drawnCount = 0;
+		RSector* curSector = s_levelState.sectors;
+		for (u32 i = 0; i < s_levelState.sectorCount; i++, curSector++)
+		{
+			if (curSector->prevDrawFrame != s_drawFrame && curSector->prevDrawFrame2 != s_drawFrame) { continue; }
+			hash = hashSector(curSector, hash);
+			drawnCount++;
+		}
+		return fnv1a64Value(drawnCount, hash);
+	}
+
+	void staticView_setCamera(RSector* sector, angle14_32 pitch, angle14_32 yaw, fixed16_16 camX, fixed16_16 camY, fixed16_16 camZ)
+	{
+		s_camera.sector = sector;
+		s_camera.pitch = pitch;
+		s_camera.yaw = yaw;
+		s_camera.pos = { camX, camY, camZ };
+	}
+
+	bool staticView_reuse(u8* display, RSector* sector, const u8* colormap, const u8* lightSourceRamp, u32 subRenderer)
+	{
+		const size_t size = size_t(s_width) * size_t(s_height);
+		if (!s_staticViewEnable || !s_savedValid || s_savedView.size() != size)
+		{
+			return false;
+		}
+		// Early out before walking the sectors when the camera or render state changed.
+		const u64 stateSignature = computeStateSignature(display, sector, colormap, lightSourceRamp, subRenderer);
+		if (stateSignature != s_savedStateSignature || computeSectorSignature(stateSignature) != s_savedSignature)
+		{
+			return false;
+		}
+
+		memcpy(display, s_savedView.data(), size);
+		s_stats.reuseCount++;
+		return true;
+	}
+
+	void staticView_store(const u8* display, RSector* sector, const u8* colormap, const u8* lightSourceRamp, u32 subRenderer)
+	{
+		s_stats.drawCount++;
+		if (!s_staticViewEnable)
+		{
+			s_savedValid = false;
+			return;
+		}
+
+		// While the camera or render state keeps changing the view cannot be reused next frame, so skip hashing the
+		// sectors and copying the view until it has been unchanged for a frame.
+		const u64 stateSignature = computeStateSignature(display, sector, colormap, lightSourceRamp, subRenderer);
+		if (stateSignature != s_savedStateSignature)
+		{
+			s_savedStateSignature = stateSignature;
+			s_savedValid = false;
+			return;
+		}
+
+		const size_t size = size_t(s_width) * size_t(s_height);
+		s_savedView.resize(size);
+		memcpy(s_savedView.data(), display, size);
+		// The sector renderers may have consumed the dirty flags, so the signature is computed after drawing.
+		s_savedSignature = computeSectorSignature(stateSignature);
+		s_savedValid = true;
+	}
+
+	void staticView_invalidate()
+	{
+		s_savedValid = false;
+		s_savedStateSignature = 0;
+	}
+
+	void staticView_getStats(StaticViewStats* stats)
+	{
+		*stats = s_stats;
+	}
+
+	void console_staticViewStats(const ConsoleArgList& args)
+	{
+		const u32 total = s_stats.drawCount + s_stats.reuseCount;
+		char res[256];
+		sprintf(res, "Static view: %u views drawn, %u reused (%0.1f%%).", s_stats.drawCount, s_stats.reuseCount,
+			total ? 100.0 * f64(s_stats.reuseCount) / f64(total) : 0.0);
+		TFE_Console::addToHistory(res);
+	}
+
+	void staticView_registerCommands()
+	{
+		CVAR_BOOL(s_staticViewEnable, "r_reuseStaticView", CVFLAG_DO_NOT_SERIALIZE, "Reuse the previous software 3D view when nothing visible has changed.");
+		CCMD("r_staticViewStats", console_staticViewStats, 0, "Print how often the software 3D view was reused.");
+	}
+}
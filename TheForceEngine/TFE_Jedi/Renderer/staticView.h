@@ -0,0 +1,43 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Static view reuse
+// When the camera and everything visible in the previous frame are
+// unchanged (the game is paused, the automap is open over the view,
+// the player is standing still in an idle area), the software
+// renderers would produce exactly the same 3D view again.
+//
+// After each software drawWorld() the 3D view is copied aside along
+// with a signature of what it depends on: the camera, lighting
+// (including flat lighting and the camera lights) and palette state
+// and, for every sector drawn that frame, its dirty flags, heights,
+// vertices, walls (including the current animated texture frames)
+// and object state. If the signature still matches at the start of
+// the next frame the copy is restored instead. The camera and render
+// state are compared first, so the sectors are only hashed once the
+// view has stopped moving.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+#include <TFE_Jedi/Math/core_math.h>
+
+struct RSector;
+
+namespace TFE_Jedi
+{
+	struct StaticViewStats
+	{
+		u32 drawCount;		// views that were rendered.
+		u32 reuseCount;		// views restored from the previous frame.
+	};
+
+	// Called from renderer_computeCameraTransform().
+	void staticView_setCamera(RSector* sector, angle14_32 pitch, angle14_32 yaw, fixed16_16 camX, fixed16_16 camY, fixed16_16 camZ);
+
+	// Returns true if the previous view was copied into 'display', in which case the view does not need to be drawn.
+	bool staticView_reuse(u8* display, RSector* sector, const u8* colormap, const u8* lightSourceRamp, u32 subRenderer);
+	// Call after the view has been drawn into 'display'.
+	void staticView_store(const u8* display, RSector* sector, const u8* colormap, const u8* lightSourceRamp, u32 subRenderer);
+	void staticView_invalidate();
+
+	void staticView_getStats(StaticViewStats* stats);
+	void staticView_registerCommands();
+}
@@ -16,6 +16,7 @@ namespace TFE_Jedi
 
 	u32 s_sVersion = 0;
 	SerializationMode s_sMode = SMODE_UNKNOWN;
+	MemoryStream* s_sMemStream = nullptr;
 		
 	void serialization_serializeDfSound(Stream* stream, u32 version, SoundSourceId* id)
 	{
@@ -7,6 +7,7 @@
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/stream.h>
+#include <TFE_FileSystem/memorystream.h>
 #include <TFE_DarkForces/sound.h>
 #include <TFE_Jedi/Level/level.h>
 #include <TFE_Jedi/Level/rtexture.h>
@@ -30,6 +31,21 @@ namespace TFE_Jedi
 
 	extern u32 s_sVersion;
 	extern SerializationMode s_sMode;
+	extern MemoryStream* s_sMemStream;
+
+	// Values are read and written one at a time, so when the stream is a MemoryStream it is accessed directly
+	// rather than paying for a virtual call per field. See serialization_setStream().
+	inline void serialization_readBuffer(Stream* stream, void* ptr, u32 size)
+	{
+		if (stream == s_sMemStream) { s_sMemStream->readBytes(ptr, size); }
+		else { stream->readBuffer(ptr, size); }
+	}
+
+	inline void serialization_writeBuffer(Stream* stream, const void* ptr, u32 size)
+	{
+		if (stream == s_sMemStream) { s_sMemStream->writeBytes(ptr, size); }
+		else { stream->writeBuffer(ptr, size); }
+	}
 
 	// This will generate an signed 32-bit index from a pointer, given a base pointer (start of an array, for example) and size of each element.
 	// Note this will produce invalid results if index > INT_MAX (~2 billion).
@@ -39,22 +55,22 @@ namespace TFE_Jedi
 	#define SERIALIZE_VERSION(curVer) \
         { \
 			u32 ver = curVer; \
-			if (s_sMode == SMODE_WRITE) { stream->writeBuffer(&ver, sizeof(ver)); } \
-			else if (s_sMode == SMODE_READ) { stream->readBuffer(&ver, sizeof(ver)); } \
+			if (s_sMode == SMODE_WRITE) { serialization_writeBuffer(stream, &ver, sizeof(ver)); } \
+			else if (s_sMode == SMODE_READ) { serialization_readBuffer(stream, &ver, sizeof(ver)); } \
 			serialization_setVersion(ver); \
 		}
 
 	#define SERIALIZE(v, x, def) \
-		if (s_sMode == SMODE_WRITE && s_sVersion >= v) { stream->writeBuffer(&x, sizeof(x)); } \
+		if (s_sMode == SMODE_WRITE && s_sVersion >= v) { serialization_writeBuffer(stream, &x, sizeof(x)); } \
 		else if (s_sMode == SMODE_READ) \
 		{ \
-			if (s_sVersion >= v) { stream->readBuffer(&x, sizeof(x)); } \
+			if (s_sVersion >= v) { serialization_readBuffer(stream, &x, sizeof(x)); } \
 			else { x = def; } \
 		}
-	#define SERIALIZE_BUF(v, x, s) if (s_sMode == SMODE_WRITE && s_sVersion >= v) { stream->writeBuffer(x, s); } \
+	#define SERIALIZE_BUF(v, x, s) if (s_sMode == SMODE_WRITE && s_sVersion >= v) { serialization_writeBuffer(stream, x, s); } \
 		else if (s_sMode == SMODE_READ) \
 		{ \
-			if (s_sVersion >= v) { stream->readBuffer(x, s); } \
+			if (s_sVersion >= v) { serialization_readBuffer(stream, x, s); } \
 			else { memset(x, 0, s); } \
 		}
 
@@ -67,6 +83,8 @@ namespace TFE_Jedi
 	inline void serialization_setVersion(u32 version) { s_sVersion = version; }
 	inline void serialization_setMode(SerializationMode mode) { s_sMode = mode; }
 	inline SerializationMode serialization_getMode() { return s_sMode; }
+	// Set the stream being serialized before serializing the game state and clear it (nullptr) when done.
+	inline void serialization_setStream(Stream* stream) { s_sMemStream = stream ? stream->getMemoryStream() : nullptr; }
 		
 	void serialization_serializeDfSound(Stream* stream, u32 version, SoundSourceId* id);
 	void serialization_serializeSectorPtr(Stream* stream, u32 version, RSector*& sector);
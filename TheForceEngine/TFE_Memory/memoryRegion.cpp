@@ -10,6 +10,11 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <algorithm>
+#include <map>
+
+// This file defines the functions behind the tracking macros.
+#undef region_alloc
+#undef region_realloc
 
 // #define _VERIFY_MEMORY
 
@@ -41,7 +46,8 @@ struct RegionAllocHeader
 	u8  free;
 	u8  bin;
 	u8  pad8[2];
-	u32 pad4[2];	// pad to 16 bytes.
+	u32 callsite;	// tracked call site index + 1, or 0 if the allocation is not tracked.
+	u32 pad4;		// pad to 16 bytes.
 };
 
 // free structure is larger than header, because it fits within the
@@ -76,6 +82,17 @@ struct MemoryBlock
 	AllocHeaderFree* freeListBins[ALLOC_BIN_COUNT];
 };
 
+struct RegionTracking
+{
+	std::vector<TFE_Memory::RegionCallsite> callsites;
+	std::map<std::pair<const char*, s32>, u32> callsiteMap;
+	std::vector<TFE_Memory::RegionCallsite> clearLive;
+	std::vector<TFE_Memory::RegionClearRecord> clears;
+	char label[32];
+	size_t peakUsed;
+	size_t maxPeakUsed;
+};
+
 struct MemoryRegion
 {
 	char name[32];
@@ -85,6 +102,9 @@ struct MemoryRegion
 	size_t blockCount;
 	size_t blockSize;
 	size_t maxBlocks;
+
+	// Allocated once something is tracked, not serialized.
+	RegionTracking* tracking;
 };
 
 static_assert(sizeof(RegionAllocHeader) == 16, "RegionAllocHeader is the wrong size.");
@@ -97,12 +117,19 @@ namespace TFE_Memory
 	static const u32 c_relativeBlockShift = 24u;
 	static const u32 c_relativeOffsetMask = (1u << c_relativeBlockShift) - 1u;
 
+	static bool s_trackingEnabled = false;
+	static std::vector<MemoryRegion*> s_regions;
+
 	void freeSlot(RegionAllocHeader* alloc, RegionAllocHeader* next, MemoryBlock* block);
 	size_t alloc_align(size_t baseSize);
 	s32  getBinFromSize(u32 size);
 	bool allocateNewBlock(MemoryRegion* region);
 	void removeHeaderFromFreelist(MemoryBlock* block, RegionAllocHeader* header);
 	void insertBlockIntoFreelist(MemoryBlock* block, RegionAllocHeader* header);
+	void* regionAlloc(MemoryRegion* region, size_t size);
+	void* regionRealloc(MemoryRegion* region, void* ptr, size_t size);
+	void  regionFree(MemoryRegion* region, void* ptr);
+	void  trackClear(MemoryRegion* region, bool record);
 
 	void verifyMemory(MemoryRegion* region)
 	{
@@ -160,6 +187,7 @@ namespace TFE_Memory
 		region->blockCount = 0;
 		region->blockSize = blockSize;
 		region->maxBlocks = maxSize ? (maxSize + blockSize - 1) / blockSize : 0;
+		region->tracking = nullptr;
 		if (!allocateNewBlock(region))
 		{
 			free(region);
@@ -167,6 +195,7 @@ namespace TFE_Memory
 			return nullptr;
 		}
 		VERIFY_MEMORY();
+		s_regions.push_back(region);
 
 		return region;
 	}
@@ -174,6 +203,7 @@ namespace TFE_Memory
 	void region_clear(MemoryRegion* region)
 	{
 		assert(region);
+		trackClear(region, true);
 		for (s32 i = 0; i < region->blockCount; i++)
 		{
 			MemoryBlock* block = region->memBlocks[i];
@@ -197,6 +227,13 @@ namespace TFE_Memory
 			free(region->memBlocks[i]);
 		}
 		free(region->memBlocks);
+		delete region->tracking;
+
+		const auto iter = std::find(s_regions.begin(), s_regions.end(), region);
+		if (iter != s_regions.end())
+		{
+			s_regions.erase(iter);
+		}
 		free(region);
 	}
 		
@@ -227,11 +264,13 @@ namespace TFE_Memory
 			// Consume the whole block.
 			removeHeaderFromFreelist(block, header);
 		}
+		// The call site overlaps the free list pointers, so it must be reset.
+		header->callsite = 0;
 		block->sizeFree -= header->size;
 		return (u8*)header + sizeof(RegionAllocHeader);
 	}
 
-	void* region_alloc(MemoryRegion* region, size_t size)
+	void* regionAlloc(MemoryRegion* region, size_t size)
 	{
 		assert(region);
 		if (size == 0) { return nullptr; }
@@ -272,7 +311,7 @@ namespace TFE_Memory
 			if (allocateNewBlock(region))
 			{
 				VERIFY_MEMORY();
-				void* mem = region_alloc(region, size);
+				void* mem = regionAlloc(region, size);
 				VERIFY_MEMORY();
 				return mem;
 			}
@@ -283,10 +322,10 @@ namespace TFE_Memory
 		return nullptr;
 	}
 
-	void* region_realloc(MemoryRegion* region, void* ptr, size_t size)
+	void* regionRealloc(MemoryRegion* region, void* ptr, size_t size)
 	{
 		assert(region);
-		if (!ptr) { return region_alloc(region, size); }
+		if (!ptr) { return regionAlloc(region, size); }
 		if (size == 0) { return nullptr; }
 
 		size = alloc_align(size + sizeof(RegionAllocHeader));
@@ -363,7 +402,7 @@ namespace TFE_Memory
 		}
 
 		// Allocate a new block of memory.
-		void* newMem = region_alloc(region, size);
+		void* newMem = regionAlloc(region, size);
 		if (!newMem) { return nullptr; }
 		// Copy over the contents from the previous block.
 		if (prevSize > sizeof(RegionAllocHeader))
@@ -371,13 +410,13 @@ namespace TFE_Memory
 			memcpy(newMem, ptr, std::min((u32)size, prevSize) - sizeof(RegionAllocHeader));
 		}
 		// Free the previous block
-		region_free(region, ptr);
+		regionFree(region, ptr);
 		// Then return the new block.
 		VERIFY_MEMORY();
 		return newMem;
 	}
 		
-	void region_free(MemoryRegion* region, void* ptr)
+	void regionFree(MemoryRegion* region, void* ptr)
 	{
 		if (!ptr || !region) { return; }
 
@@ -408,6 +447,164 @@ namespace TFE_Memory
 		}
 	}
 		
+	static RegionAllocHeader* getHeader(void* ptr)
+	{
+		return (RegionAllocHeader*)((u8*)ptr - sizeof(RegionAllocHeader));
+	}
+
+	static RegionTracking* getTracking(MemoryRegion* region)
+	{
+		if (!region->tracking)
+		{
+			region->tracking = new RegionTracking();
+			region->tracking->label[0] = 0;
+			region->tracking->peakUsed = 0;
+			region->tracking->maxPeakUsed = 0;
+		}
+		return region->tracking;
+	}
+
+	static void trackAlloc(MemoryRegion* region, void* ptr, const char* file, s32 line)
+	{
+		RegionTracking* tracking = getTracking(region);
+
+		u32 index;
+		const auto key = std::make_pair(file, line);
+		const auto iter = tracking->callsiteMap.find(key);
+		if (iter == tracking->callsiteMap.end())
+		{
+			index = (u32)tracking->callsites.size();
+			tracking->callsiteMap[key] = index;
+			tracking->callsites.push_back({ file, line, 0, 0, 0, 0 });
+		}
+		else
+		{
+			index = iter->second;
+		}
+
+		RegionAllocHeader* header = getHeader(ptr);
+		RegionCallsite& callsite = tracking->callsites[index];
+		callsite.allocCount++;
+		callsite.liveCount++;
+		callsite.totalBytes += header->size;
+		callsite.liveBytes += header->size;
+		header->callsite = index + 1;
+
+		const size_t used = region_getMemoryUsed(region);
+		tracking->peakUsed = std::max(tracking->peakUsed, used);
+		tracking->maxPeakUsed = std::max(tracking->maxPeakUsed, used);
+	}
+
+	static void trackFree(MemoryRegion* region, void* ptr)
+	{
+		RegionAllocHeader* header = getHeader(ptr);
+		if (!region->tracking || !header->callsite || header->callsite > region->tracking->callsites.size())
+		{
+			return;
+		}
+
+		RegionCallsite& callsite = region->tracking->callsites[header->callsite - 1];
+		if (callsite.liveCount)
+		{
+			callsite.liveCount--;
+			callsite.liveBytes -= std::min(callsite.liveBytes, (size_t)header->size);
+		}
+		header->callsite = 0;
+	}
+
+	// Called before the region is cleared, everything still allocated goes away.
+	void trackClear(MemoryRegion* region, bool record)
+	{
+		RegionTracking* tracking = region->tracking;
+		if (!tracking) { return; }
+
+		if (record)
+		{
+			RegionClearRecord clear = {};
+			strncpy(clear.label, tracking->label, sizeof(clear.label) - 1);
+			clear.peakUsed = tracking->peakUsed;
+
+			tracking->clearLive.clear();
+			const size_t count = tracking->callsites.size();
+			for (size_t i = 0; i < count; i++)
+			{
+				const RegionCallsite& callsite = tracking->callsites[i];
+				if (!callsite.liveCount) { continue; }
+
+				tracking->clearLive.push_back(callsite);
+				clear.liveCount += callsite.liveCount;
+				clear.liveBytes += callsite.liveBytes;
+			}
+
+			if (tracking->clears.size() >= REGION_TRACKED_CLEAR_COUNT)
+			{
+				tracking->clears.erase(tracking->clears.begin());
+			}
+			tracking->clears.push_back(clear);
+
+			if (clear.liveCount)
+			{
+				TFE_System::logWrite(LOG_MSG, "MemoryRegion", "Region '%s' cleared with %u live allocations (%zu bytes) from %zu call sites, peak usage %zu bytes.",
+					region->name, clear.liveCount, clear.liveBytes, tracking->clearLive.size(), clear.peakUsed);
+			}
+		}
+
+		const size_t count = tracking->callsites.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			tracking->callsites[i].liveCount = 0;
+			tracking->callsites[i].liveBytes = 0;
+		}
+		tracking->peakUsed = 0;
+		tracking->label[0] = 0;
+	}
+
+	void* region_alloc(MemoryRegion* region, size_t size)
+	{
+		return region_allocTracked(region, size, "unknown", 0);
+	}
+
+	void* region_realloc(MemoryRegion* region, void* ptr, size_t size)
+	{
+		return region_reallocTracked(region, ptr, size, "unknown", 0);
+	}
+
+	void region_free(MemoryRegion* region, void* ptr)
+	{
+		if (!ptr || !region) { return; }
+		if (region->tracking)
+		{
+			trackFree(region, ptr);
+		}
+		regionFree(region, ptr);
+	}
+
+	void* region_allocTracked(MemoryRegion* region, size_t size, const char* file, s32 line)
+	{
+		void* mem = regionAlloc(region, size);
+		if (mem && s_trackingEnabled)
+		{
+			trackAlloc(region, mem, file, line);
+		}
+		return mem;
+	}
+
+	void* region_reallocTracked(MemoryRegion* region, void* ptr, size_t size, const char* file, s32 line)
+	{
+		if (ptr && region && region->tracking)
+		{
+			trackFree(region, ptr);
+		}
+		void* mem = regionRealloc(region, ptr, size);
+		if (s_trackingEnabled)
+		{
+			// Reallocation failures leave the original allocation in place.
+			if (mem) { trackAlloc(region, mem, file, line); }
+			else if (ptr) { trackAlloc(region, ptr, file, line); }
+		}
+		return mem;
+	}
+
 	size_t region_getMemoryUsed(MemoryRegion* region)
 	{
 		size_t used = 0;
@@ -428,6 +625,114 @@ namespace TFE_Memory
 	{
 		return region->blockCount * region->blockSize;
 	}
+
+	const char* region_getName(MemoryRegion* region)
+	{
+		return region->name;
+	}
+
+	void region_getFragmentation(MemoryRegion* region, RegionFragmentation* info)
+	{
+		memset(info, 0, sizeof(RegionFragmentation));
+		for (s32 i = 0; i < region->blockCount; i++)
+		{
+			const MemoryBlock* block = region->memBlocks[i];
+			for (s32 b = 0; b < ALLOC_BIN_COUNT; b++)
+			{
+				for (const AllocHeaderFree* slot = block->freeListBins[b]; slot; slot = slot->binNext)
+				{
+					info->binFreeBytes[b] += slot->size;
+					info->binFreeCount[b]++;
+					info->largestFree = std::max(info->largestFree, (size_t)slot->size);
+				}
+			}
+			info->freeBytes += block->sizeFree;
+		}
+		// Usable size, after the allocation header.
+		info->largestFree = info->largestFree > sizeof(RegionAllocHeader) ? info->largestFree - sizeof(RegionAllocHeader) : 0;
+	}
+
+	s32 region_getCount()
+	{
+		return (s32)s_regions.size();
+	}
+
+	MemoryRegion* region_get(s32 index)
+	{
+		return index >= 0 && index < (s32)s_regions.size() ? s_regions[index] : nullptr;
+	}
+
+	void region_enableTracking(bool enable)
+	{
+		s_trackingEnabled = enable;
+	}
+
+	bool region_isTrackingEnabled()
+	{
+		return s_trackingEnabled;
+	}
+
+	void region_resetTracking()
+	{
+		const size_t count = s_regions.size();
+		for (size_t r = 0; r < count; r++)
+		{
+			MemoryRegion* region = s_regions[r];
+			if (!region->tracking) { continue; }
+
+			// Untrack the live allocations so stale indices are never used.
+			for (s32 i = 0; i < region->blockCount; i++)
+			{
+				MemoryBlock* block = region->memBlocks[i];
+				u8* mem = (u8*)block + sizeof(MemoryBlock);
+				for (u32 a = 0; a < block->count; a++)
+				{
+					RegionAllocHeader* header = (RegionAllocHeader*)mem;
+					if (!header->free)
+					{
+						header->callsite = 0;
+					}
+					mem += header->size;
+				}
+			}
+			delete region->tracking;
+			region->tracking = nullptr;
+		}
+	}
+
+	void region_setTrackingLabel(MemoryRegion* region, const char* label)
+	{
+		if (!region || (!region->tracking && !s_trackingEnabled)) { return; }
+		RegionTracking* tracking = getTracking(region);
+		strncpy(tracking->label, label ? label : "", sizeof(tracking->label) - 1);
+		tracking->label[sizeof(tracking->label) - 1] = 0;
+	}
+
+	bool region_getTrackingPeak(MemoryRegion* region, size_t* peakUsed, size_t* maxPeakUsed)
+	{
+		if (!region->tracking) { return false; }
+		*peakUsed = region->tracking->peakUsed;
+		*maxPeakUsed = region->tracking->maxPeakUsed;
+		return true;
+	}
+
+	void region_getTrackedCallsites(MemoryRegion* region, std::vector<RegionCallsite>& callsites)
+	{
+		callsites.clear();
+		if (region->tracking) { callsites = region->tracking->callsites; }
+	}
+
+	void region_getTrackedClearLive(MemoryRegion* region, std::vector<RegionCallsite>& callsites)
+	{
+		callsites.clear();
+		if (region->tracking) { callsites = region->tracking->clearLive; }
+	}
+
+	void region_getTrackedClears(MemoryRegion* region, std::vector<RegionClearRecord>& clears)
+	{
+		clears.clear();
+		if (region->tracking) { clears = region->tracking->clears; }
+	}
 		
 	RelativePointer region_getRelativePointer(MemoryRegion* region, void* ptr)
 	{
@@ -531,13 +836,20 @@ namespace TFE_Memory
 		if (!region)
 		{
 			region = (MemoryRegion*)malloc(sizeof(MemoryRegion));
-			region->blockArrCapacity = 0;
+			if (region)
+			{
+				region->blockArrCapacity = 0;
+				region->tracking = nullptr;
+				s_regions.push_back(region);
+			}
 		}
 		if (!region)
 		{
 			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate region.");
 			return nullptr;
 		}
+		// The restored allocations are not tracked.
+		trackClear(region, false);
 
 		size_t blockAllocStart = 0;
 		file->readBuffer(region->name, 32);
@@ -592,6 +904,12 @@ namespace TFE_Memory
 
 		if (!region->memBlocks)
 		{
+			const auto iter = std::find(s_regions.begin(), s_regions.end(), region);
+			if (iter != s_regions.end())
+			{
+				s_regions.erase(iter);
+			}
+			delete region->tracking;
 			free(region);
 			TFE_System::logWrite(LOG_ERROR, "MemoryRegion", "Failed to allocate region.");
 			return nullptr;
@@ -641,6 +959,7 @@ namespace TFE_Memory
 				else
 				{
 					file->readBuffer((u8*)header + SHARED_HEADER_SIZE, header->size - SHARED_HEADER_SIZE);
+					header->callsite = 0;
 				}
 
 				memPtr += header->size;
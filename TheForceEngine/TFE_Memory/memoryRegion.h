@@ -2,6 +2,12 @@
 //////////////////////////////////////////////////////////////////////
 // General purpose memory allocator which acts as a region of
 // memory which can be quickly cleared.
+//
+// Allocation tracking is optional and off by default. While enabled,
+// each region records the allocation count and bytes per call site,
+// its peak usage between clears and the allocations that are still
+// live when it is cleared. The call site is captured by the
+// region_alloc() and region_realloc() macros below.
 //////////////////////////////////////////////////////////////////////
 #include <TFE_System/types.h>
 #include <TFE_FileSystem/filestream.h>
@@ -15,6 +21,39 @@ typedef u32 RelativePointer;
 
 namespace TFE_Memory
 {
+	enum RegionTrackingConstants
+	{
+		REGION_BIN_COUNT = 6,
+		REGION_TRACKED_CLEAR_COUNT = 16,
+	};
+
+	struct RegionCallsite
+	{
+		const char* file;
+		s32 line;
+		u32 allocCount;		// allocations and reallocations made from this call site.
+		u32 liveCount;		// allocations that have not been freed.
+		size_t totalBytes;	// sizes include the allocation header and alignment.
+		size_t liveBytes;
+	};
+
+	// Recorded each time a tracked region is cleared.
+	struct RegionClearRecord
+	{
+		char label[32];		// see region_setTrackingLabel(), such as the level name.
+		size_t peakUsed;
+		size_t liveBytes;	// bytes that were still allocated when the region was cleared.
+		u32 liveCount;
+	};
+
+	struct RegionFragmentation
+	{
+		size_t freeBytes;
+		size_t largestFree;	// the largest single allocation that can succeed without adding a block.
+		size_t binFreeBytes[REGION_BIN_COUNT];
+		u32 binFreeCount[REGION_BIN_COUNT];
+	};
+
 	MemoryRegion* region_create(const char* name, size_t blockSize, size_t maxSize = 0u);
 	void region_clear(MemoryRegion* region);
 	void region_destroy(MemoryRegion* region);
@@ -22,10 +61,34 @@ namespace TFE_Memory
 	void* region_alloc(MemoryRegion* region, size_t size);
 	void* region_realloc(MemoryRegion* region, void* ptr, size_t size);
 	void  region_free(MemoryRegion* region, void* ptr);
+	// Use region_alloc() and region_realloc(), which fill in the call site.
+	void* region_allocTracked(MemoryRegion* region, size_t size, const char* file, s32 line);
+	void* region_reallocTracked(MemoryRegion* region, void* ptr, size_t size, const char* file, s32 line);
 
 	size_t region_getMemoryUsed(MemoryRegion* region);
 	size_t region_getMemoryCapacity(MemoryRegion* region);
 	void region_getBlockInfo(MemoryRegion* region, size_t* blockCount, size_t* blockSize);
+	const char* region_getName(MemoryRegion* region);
+	void region_getFragmentation(MemoryRegion* region, RegionFragmentation* info);
+
+	// All regions that currently exist.
+	s32 region_getCount();
+	MemoryRegion* region_get(s32 index);
+
+	// Allocation tracking.
+	void region_enableTracking(bool enable);
+	bool region_isTrackingEnabled();
+	// Discard the tracking data of every region, allocations made before the reset are no longer tracked.
+	void region_resetTracking();
+	// The label is stored with the peak usage when the region is next cleared.
+	void region_setTrackingLabel(MemoryRegion* region, const char* label);
+	// Returns false if nothing has been tracked in the region.
+	bool region_getTrackingPeak(MemoryRegion* region, size_t* peakUsed, size_t* maxPeakUsed);
+	void region_getTrackedCallsites(MemoryRegion* region, std::vector<RegionCallsite>& callsites);
+	// Callsites with allocations that were still live the last time the region was cleared.
+	void region_getTrackedClearLive(MemoryRegion* region, std::vector<RegionCallsite>& callsites);
+	// The oldest record is first.
+	void region_getTrackedClears(MemoryRegion* region, std::vector<RegionClearRecord>& clears);
 
 	RelativePointer region_getRelativePointer(MemoryRegion* region, void* ptr);
 	void* region_getRealPointer(MemoryRegion* region, RelativePointer ptr);
@@ -37,4 +100,7 @@ namespace TFE_Memory
 	MemoryRegion* region_restoreFromDisk(MemoryRegion* region, FileStream* file);
 
 	void region_test();
-}
\ No newline at end of file
+}
+
+#define region_alloc(region, size) region_allocTracked(region, size, __FILE__, __LINE__)
+#define region_realloc(region, ptr, size) region_reallocTracked(region, ptr, size, __FILE__, __LINE__)
@@ -0,0 +1,304 @@
+#include <cstring>
+#include "headlessDisplay.h"
+#include <TFE_System/system.h>
+#include <TFE_System/profiler.h>
+#include <TFE_FileSystem/filestream.h>
+#include <TFE_FileSystem/fileutil.h>
+#include <TFE_FileSystem/paths.h>
+#include <TFE_Asset/imageAsset.h>
+#include <algorithm>
+#include <vector>
+
+namespace TFE_HeadlessDisplay
+{
+	static u32 s_width = 0;
+	static u32 s_height = 0;
+	static std::vector<u32> s_surface;
+
+	static u32 s_virtualWidth = 0;
+	static u32 s_virtualHeight = 0;
+	static std::vector<u8> s_virtualDisplay;
+	static bool s_virtualDisplayRgba = false;
+	static bool s_hasFrame = false;
+
+	static s32 s_rectX = 0, s_rectY = 0, s_rectW = 0, s_rectH = 0;
+	static bool s_clearBorder = true;
+	// Source column for each destination column of the display rect.
+	static std::vector<u32> s_columnMap;
+	// The current source row converted to RGBA.
+	static std::vector<u32> s_rowRgba;
+
+	static u32 s_palette[256];
+	static u32 s_clearColor = 0xff000000;
+	static u32 s_frame = 0;
+
+	static HeadlessOutput s_output = HOUT_NONE;
+	static char s_outputPath[TFE_MAX_PATH];
+	static u32 s_outputInterval = 1;
+	static u32 s_outputIndex = 0;
+	static FileStream s_rawFile;
+
+	void buildColumnMap();
+	void writeFrame();
+
+	bool init(u32 width, u32 height)
+	{
+		memset(s_palette, 0, sizeof(u32) * 256);
+		s_frame = 0;
+		s_hasFrame = false;
+		resize(width, height);
+		TFE_System::logWrite(LOG_MSG, "Headless Display", "Headless display created, surface size %u x %u.", width, height);
+		return true;
+	}
+
+	void destroy()
+	{
+		setOutput(HOUT_NONE, nullptr);
+		s_surface.clear();
+		s_virtualDisplay.clear();
+		s_columnMap.clear();
+		s_rowRgba.clear();
+		s_width = 0;
+		s_height = 0;
+	}
+
+	void resize(u32 width, u32 height)
+	{
+		if (s_rawFile.isOpen() && (width != s_width || height != s_height))
+		{
+			TFE_System::logWrite(LOG_WARNING, "Headless Display", "Surface resized to %u x %u while writing raw frames.", width, height);
+		}
+		s_width = width;
+		s_height = height;
+		s_surface.resize(width * height);
+		clear();
+
+		// Default to stretching over the whole surface until the display rect is set.
+		setDisplayRect(0, 0, width, height, false);
+	}
+
+	void setVirtualDisplay(u32 width, u32 height)
+	{
+		s_virtualWidth = width;
+		s_virtualHeight = height;
+		s_virtualDisplay.resize(width * height * 4);
+		s_rowRgba.resize(width);
+		s_hasFrame = false;
+		buildColumnMap();
+	}
+
+	void setDisplayRect(s32 x, s32 y, s32 w, s32 h, bool clearBorder)
+	{
+		// Clip to the surface.
+		s_rectX = std::max(0, x);
+		s_rectY = std::max(0, y);
+		s_rectW = std::min(w, s32(s_width)  - s_rectX);
+		s_rectH = std::min(h, s32(s_height) - s_rectY);
+		// No need to clear if the display covers the whole surface.
+		s_clearBorder = clearBorder && (s_rectX > 0 || s_rectY > 0 || s_rectW < s32(s_width) || s_rectH < s32(s_height));
+		buildColumnMap();
+	}
+
+	void setPalette(const u32* palette)
+	{
+		if (!palette) { return; }
+		memcpy(s_palette, palette, sizeof(u32) * 256);
+	}
+
+	void setClearColor(const f32* color)
+	{
+		const u32 r = u32(std::min(std::max(color[0], 0.0f), 1.0f) * 255.0f);
+		const u32 g = u32(std::min(std::max(color[1], 0.0f), 1.0f) * 255.0f);
+		const u32 b = u32(std::min(std::max(color[2], 0.0f), 1.0f) * 255.0f);
+		s_clearColor = r | (g << 8) | (b << 16) | 0xff000000;
+	}
+
+	void update(const void* buffer, size_t size)
+	{
+		if (!buffer || !s_virtualWidth || !s_virtualHeight) { return; }
+
+		const size_t pixelCount = s_virtualWidth * s_virtualHeight;
+		s_virtualDisplayRgba = size >= pixelCount * 4;
+		memcpy(s_virtualDisplay.data(), buffer, s_virtualDisplayRgba ? pixelCount * 4 : std::min(size, pixelCount));
+		s_hasFrame = true;
+	}
+
+	void clear()
+	{
+		std::fill(s_surface.begin(), s_surface.end(), s_clearColor);
+	}
+
+	// Convert one row of palette indices, 4 pixels per iteration.
+	static void convertRow(const u8* src, u32* dst, u32 width)
+	{
+		const u32* pal = s_palette;
+		u32 x = 0;
+		for (; x + 4 <= width; x += 4, src += 4, dst += 4)
+		{
+			const u32 c0 = pal[src[0]], c1 = pal[src[1]], c2 = pal[src[2]], c3 = pal[src[3]];
+			dst[0] = c0; dst[1] = c1; dst[2] = c2; dst[3] = c3;
+		}
+		for (; x < width; x++, src++, dst++)
+		{
+			*dst = pal[*src];
+		}
+	}
+
+	static void blitVirtualDisplay()
+	{
+		if (s_rectW <= 0 || s_rectH <= 0) { return; }
+		const u32* columnMap = s_columnMap.data();
+		const s32 rectW = s_rectW;
+
+		// Each source row is converted once and then replicated, so the palette lookups scale
+		// with the virtual display size rather than the output size.
+		s32 prevSrcY = -1;
+		u32* prevRow = nullptr;
+		for (s32 y = 0; y < s_rectH; y++)
+		{
+			u32* dst = &s_surface[(s_rectY + y) * s_width + s_rectX];
+			const s32 srcY = s32(u64(y) * s_virtualHeight / s_rectH);
+			if (srcY == prevSrcY)
+			{
+				memcpy(dst, prevRow, rectW * sizeof(u32));
+				continue;
+			}
+
+			const u32* srcRow;
+			if (s_virtualDisplayRgba)
+			{
+				srcRow = (const u32*)s_virtualDisplay.data() + srcY * s_virtualWidth;
+			}
+			else
+			{
+				convertRow(s_virtualDisplay.data() + srcY * s_virtualWidth, s_rowRgba.data(), s_virtualWidth);
+				srcRow = s_rowRgba.data();
+			}
+
+			for (s32 x = 0; x < rectW; x++)
+			{
+				dst[x] = srcRow[columnMap[x]];
+			}
+			prevSrcY = srcY;
+			prevRow = dst;
+		}
+	}
+
+	void present(bool blitDisplay)
+	{
+		TFE_ZONE("Headless Present");
+		if (!blitDisplay || !s_hasFrame || s_clearBorder)
+		{
+			clear();
+		}
+		if (blitDisplay && s_hasFrame)
+		{
+			blitVirtualDisplay();
+		}
+
+		if (s_output != HOUT_NONE && (s_frame % s_outputInterval) == 0)
+		{
+			writeFrame();
+		}
+		s_frame++;
+	}
+
+	bool setOutput(HeadlessOutput output, const char* path, u32 frameInterval)
+	{
+		if (s_rawFile.isOpen())
+		{
+			s_rawFile.close();
+		}
+		s_output = HOUT_NONE;
+		s_outputIndex = 0;
+		s_outputInterval = std::max(1u, frameInterval);
+		if (output == HOUT_NONE || output >= HOUT_COUNT || !path || !path[0]) { return output == HOUT_NONE; }
+
+		strncpy(s_outputPath, path, TFE_MAX_PATH - 1);
+		s_outputPath[TFE_MAX_PATH - 1] = 0;
+		if (output == HOUT_PNG)
+		{
+			const size_t len = strlen(s_outputPath);
+			if (len && s_outputPath[len - 1] != '/' && s_outputPath[len - 1] != '\\' && len + 1 < TFE_MAX_PATH)
+			{
+				strcat(s_outputPath, "/");
+			}
+			if (!FileUtil::directoryExits(s_outputPath))
+			{
+				FileUtil::makeDirectory(s_outputPath);
+			}
+		}
+		else if (!s_rawFile.open(s_outputPath, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Headless Display", "Cannot open raw frame output '%s'.", s_outputPath);
+			return false;
+		}
+
+		s_output = output;
+		TFE_System::logWrite(LOG_MSG, "Headless Display", "Writing every %u frame(s) as %s to '%s', %u x %u RGBA8.", s_outputInterval,
+			output == HOUT_PNG ? "PNG" : "raw", s_outputPath, s_width, s_height);
+		return true;
+	}
+
+	HeadlessOutput getOutput()
+	{
+		return s_output;
+	}
+
+	const u32* getSurface(u32* width, u32* height)
+	{
+		if (width)  { *width = s_width; }
+		if (height) { *height = s_height; }
+		return s_surface.data();
+	}
+
+	void copySurfaceBottomUp(u32* mem)
+	{
+		for (u32 y = 0; y < s_height; y++)
+		{
+			memcpy(&mem[(s_height - y - 1) * s_width], &s_surface[y * s_width], s_width * sizeof(u32));
+		}
+	}
+
+	void writeScreenshot(const char* path)
+	{
+		// writeImage() expects the bottom-up layout of a GPU read back.
+		std::vector<u32> image(s_width * s_height);
+		copySurfaceBottomUp(image.data());
+		TFE_Image::writeImage(path, s_width, s_height, image.data());
+	}
+
+	u32 getFrameCount()
+	{
+		return s_frame;
+	}
+
+	////////////////////////////
+	// Internal
+	////////////////////////////
+	void buildColumnMap()
+	{
+		if (s_rectW <= 0 || !s_virtualWidth) { s_columnMap.clear(); return; }
+		s_columnMap.resize(s_rectW);
+		for (s32 x = 0; x < s_rectW; x++)
+		{
+			s_columnMap[x] = u32(u64(x) * s_virtualWidth / s_rectW);
+		}
+	}
+
+	void writeFrame()
+	{
+		TFE_ZONE("Headless Frame Output");
+		if (s_output == HOUT_PNG)
+		{
+			char framePath[TFE_MAX_PATH];
+			snprintf(framePath, TFE_MAX_PATH, "%sframe_%06u.png", s_outputPath, s_outputIndex);
+			writeScreenshot(framePath);
+		}
+		else if (s_output == HOUT_RAW)
+		{
+			s_rawFile.writeBuffer(s_surface.data(), u32(s_surface.size() * sizeof(u32)));
+		}
+		s_outputIndex++;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Headless Display
+// CPU only presentation used by the render backend when it runs
+// without a window or GPU context (see WINFLAG_HEADLESS).
+//
+// The 8-bit virtual display is converted through the palette and
+// scaled into an RGBA memory surface the size of the "window", using
+// the same aspect correct rectangle as the GPU blit. Frames can be
+// written out as PNG images or appended to a raw RGBA file.
+//////////////////////////////////////////////////////////////////////
+#include <TFE_System/types.h>
+
+enum HeadlessOutput
+{
+	HOUT_NONE = 0,	// Keep the surface in memory only.
+	HOUT_PNG,		// One PNG image per output frame: <path>/frame_000000.png
+	HOUT_RAW,		// Frames appended to a single file as top-down RGBA8.
+	HOUT_COUNT
+};
+
+namespace TFE_HeadlessDisplay
+{
+	bool init(u32 width, u32 height);
+	void destroy();
+	void resize(u32 width, u32 height);
+
+	// Virtual display setup, the rectangle is where the virtual display is placed on the surface.
+	void setVirtualDisplay(u32 width, u32 height);
+	void setDisplayRect(s32 x, s32 y, s32 w, s32 h, bool clearBorder);
+	void setPalette(const u32* palette);
+	void setClearColor(const f32* color);
+
+	// The virtual display data, either 8-bit palette indices or 32-bit RGBA.
+	void update(const void* buffer, size_t size);
+	// Build the surface for the current frame and write it out if requested.
+	void present(bool blitVirtualDisplay);
+	void clear();
+
+	// Frame output, every 'frameInterval' presented frames are written.
+	bool setOutput(HeadlessOutput output, const char* path, u32 frameInterval = 1);
+	HeadlessOutput getOutput();
+
+	const u32* getSurface(u32* width, u32* height);
+	// Copies the surface bottom-up, matching a GPU front buffer read.
+	void copySurfaceBottomUp(u32* mem);
+	void writeScreenshot(const char* path);
+	u32  getFrameCount();
+}
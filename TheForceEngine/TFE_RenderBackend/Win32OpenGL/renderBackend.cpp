@@ -11,6 +11,7 @@
 #include <TFE_PostProcess/bloomDownsample.h>
 #include <TFE_PostProcess/bloomMerge.h>
 #include <TFE_PostProcess/postprocess.h>
+#include <TFE_RenderBackend/Headless/headlessDisplay.h>
 #include "renderTarget.h"
 #include "screenCapture.h"
 #include <SDL.h>
@@ -58,6 +59,7 @@ namespace TFE_RenderBackend
 	static bool s_gpuColorConvert = false;
 	static bool s_useRenderTarget = false;
 	static bool s_bloomEnable = false;
+	static bool s_headless = false;
 	static DisplayMode s_displayMode;
 	static f32 s_clearColor[4] = { 0.0f };
 	static u32 s_rtWidth, s_rtHeight;
@@ -70,6 +72,7 @@ namespace TFE_RenderBackend
 
 	void drawVirtualDisplay();
 	void setupPostEffectChain(bool useDynamicTexture, bool useBloom);
+	void computeDisplayRect(s32* x, s32* y, s32* w, s32* h);
 		
 	SDL_Window* createWindow(const WindowState& state)
 	{
@@ -138,8 +141,25 @@ namespace TFE_RenderBackend
 		return window;
 	}
 		
+	// Headless: no window, GPU context or post effects.
+	// The UI still runs (without drawing) so the front end and game logic behave the same.
+	bool initHeadless(const WindowState& state)
+	{
+		m_window = nullptr;
+		m_windowState = state;
+		TFE_RenderState::clear();
+		TFE_Ui::init(nullptr, nullptr);
+		return TFE_HeadlessDisplay::init(state.width, state.height);
+	}
+
 	bool init(const WindowState& state)
 	{
+		s_headless = (state.flags & WINFLAG_HEADLESS) != 0;
+		if (s_headless)
+		{
+			return initHeadless(state);
+		}
+
 		m_window = createWindow(state);
 		m_windowState = state;
 
@@ -177,6 +197,12 @@ namespace TFE_RenderBackend
 
 	void destroy()
 	{
+		if (s_headless)
+		{
+			TFE_Ui::shutdown();
+			TFE_HeadlessDisplay::destroy();
+			return;
+		}
 		delete s_screenCapture;
 
 		// TODO: Move effect destruction into post effect system.
@@ -208,26 +234,56 @@ namespace TFE_RenderBackend
 		m_window = nullptr;
 	}
 
+	bool isHeadless()
+	{
+		return s_headless;
+	}
+
 	bool getVsyncEnabled()
 	{
+		if (s_headless) { return false; }
 		return SDL_GL_GetSwapInterval() > 0;
 	}
 
 	void enableVsync(bool enable)
 	{
+		if (s_headless) { return; }
 		SDL_GL_SetSwapInterval(enable ? 1 : 0);
 	}
 
 	void setClearColor(const f32* color)
 	{
+		memcpy(s_clearColor, color, sizeof(f32) * 4);
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::setClearColor(color);
+			return;
+		}
+
 		glClearColor(color[0], color[1], color[2], color[3]);
 		glClearDepth(0.0f);
+	}
 
-		memcpy(s_clearColor, color, sizeof(f32) * 4);
+	void swapHeadless(bool blitVirtualDisplay)
+	{
+		// The system UI is updated but not drawn.
+		TFE_Ui::render();
+		TFE_HeadlessDisplay::present(blitVirtualDisplay);
+		if (s_screenshotQueued)
+		{
+			s_screenshotQueued = false;
+			TFE_HeadlessDisplay::writeScreenshot(s_screenshotPath);
+		}
 	}
 		
 	void swap(bool blitVirtualDisplay)
 	{
+		if (s_headless)
+		{
+			swapHeadless(blitVirtualDisplay);
+			return;
+		}
+
 		// Blit the texture or render target to the screen.
 		if (blitVirtualDisplay) { drawVirtualDisplay(); }
 		else { glClear(GL_COLOR_BUFFER_BIT); }
@@ -254,6 +310,11 @@ namespace TFE_RenderBackend
 
 	void captureScreenToMemory(u32* mem)
 	{
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::copySurfaceBottomUp(mem);
+			return;
+		}
 		s_screenCapture->captureFrontBufferToMemory(mem);
 	}
 
@@ -265,18 +326,24 @@ namespace TFE_RenderBackend
 		
 	void startGifRecording(const char* path)
 	{
+		if (s_headless)
+		{
+			TFE_System::logWrite(LOG_WARNING, "RenderBackend", "GIF recording is not available in headless mode, use the frame output instead.");
+			return;
+		}
 		s_screenCapture->beginRecording(path);
 	}
 
 	void stopGifRecording()
 	{
+		if (s_headless) { return; }
 		s_screenCapture->endRecording();
 	}
 
 	void updateSettings()
 	{
 		TFE_Settings_Window* windowSettings = TFE_Settings::getWindowSettings();
-		if (!(m_windowState.flags & WINFLAG_FULLSCREEN))
+		if (!s_headless && !(m_windowState.flags & WINFLAG_FULLSCREEN))
 		{
 			SDL_GetWindowPosition((SDL_Window*)m_window, &windowSettings->x, &windowSettings->y);
 		}
@@ -299,6 +366,12 @@ namespace TFE_RenderBackend
 			windowSettings->baseWidth = width;
 			windowSettings->baseHeight = height;
 		}
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::resize(width, height);
+			setupPostEffectChain(true, false);
+			return;
+		}
 		glViewport(0, 0, width, height);
 		setupPostEffectChain(!s_useRenderTarget, s_bloomEnable);
 
@@ -358,6 +431,7 @@ namespace TFE_RenderBackend
 
 	f32 getDisplayRefreshRate()
 	{
+		if (s_headless) { return 0.0f; }
 		s32 x, y;
 		SDL_GetWindowPosition((SDL_Window*)m_window, &x, &y);
 		s32 displayIndex = getDisplayIndex(x, y);
@@ -385,6 +459,7 @@ namespace TFE_RenderBackend
 	{
 		TFE_Settings_Window* windowSettings = TFE_Settings::getWindowSettings();
 		windowSettings->fullscreen = enable;
+		if (s_headless) { return; }
 
 		if (enable)
 		{
@@ -441,6 +516,11 @@ namespace TFE_RenderBackend
 
 	void clearWindow()
 	{
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::clear();
+			return;
+		}
 		glClear(GL_COLOR_BUFFER_BIT);
 	}
 
@@ -455,6 +535,16 @@ namespace TFE_RenderBackend
 
 	bool recreateDisplay(bool setupPostFx)
 	{
+		if (s_headless)
+		{
+			// The 3D GPU renderer is not available without a GPU context, only the 8-bit virtual display.
+			s_useRenderTarget = false;
+			s_bloomEnable = false;
+			TFE_HeadlessDisplay::setVirtualDisplay(s_virtualWidth, s_virtualHeight);
+			setupPostEffectChain(true, false);
+			return true;
+		}
+
 		if (s_virtualDisplay)
 		{
 			delete s_virtualDisplay;
@@ -574,6 +664,7 @@ namespace TFE_RenderBackend
 
 	void* getVirtualDisplayGpuPtr()
 	{
+		if (!s_virtualDisplay) { return nullptr; }
 		return (void*)(iptr)s_virtualDisplay->getTexture()->getHandle();
 	}
 
@@ -595,7 +686,11 @@ namespace TFE_RenderBackend
 	void updateVirtualDisplay(const void* buffer, size_t size)
 	{
 		TFE_ZONE("Update Virtual Display");
-		if (s_virtualDisplay)
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::update(buffer, size);
+		}
+		else if (s_virtualDisplay)
 		{
 			s_virtualDisplay->update(buffer, size);
 		}
@@ -623,6 +718,7 @@ namespace TFE_RenderBackend
 
 	void copyToVirtualDisplay(RenderTargetHandle src)
 	{
+		if (!s_virtualRenderTarget || !src) { return; }
 		RenderTarget::copy(s_virtualRenderTarget, (RenderTarget*)src);
 	}
 		
@@ -633,7 +729,12 @@ namespace TFE_RenderBackend
 
 	void setPalette(const u32* palette)
 	{
-		if (palette && getGPUColorConvert())
+		if (!palette) { return; }
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::setPalette(palette);
+		}
+		else if (getGPUColorConvert())
 		{
 			TFE_ZONE("Update Palette");
 			s_palette->update(palette, 256 * sizeof(u32));
@@ -648,11 +749,14 @@ namespace TFE_RenderBackend
 
 	const TextureGpu* getPaletteTexture()
 	{
+		if (!s_palette) { return nullptr; }
 		return s_palette->getTexture();
 	}
 
 	void setColorCorrection(bool enabled, const ColorCorrection* color/* = nullptr*/, bool bloomChanged/* = false*/)
 	{
+		// Color correction is a GPU post effect.
+		if (s_headless) { return; }
 		if (bloomChanged)
 		{
 			TFE_Settings_Graphics* graphicsSettings = TFE_Settings::getGraphicsSettings();
@@ -692,6 +796,7 @@ namespace TFE_RenderBackend
 	// Render target.
 	RenderTargetHandle createRenderTarget(u32 width, u32 height, bool hasDepthBuffer)
 	{
+		if (s_headless) { return nullptr; }
 		RenderTarget* newTarget = new RenderTarget();
 		TextureGpu* texture = new TextureGpu();
 		texture->create(width, height);
@@ -711,6 +816,7 @@ namespace TFE_RenderBackend
 
 	void bindRenderTarget(RenderTargetHandle handle)
 	{
+		if (!handle) { return; }
 		RenderTarget* renderTarget = (RenderTarget*)handle;
 		renderTarget->bind();
 
@@ -721,6 +827,7 @@ namespace TFE_RenderBackend
 
 	void clearRenderTarget(RenderTargetHandle handle, const f32* clearColor, f32 clearDepth)
 	{
+		if (!handle) { return; }
 		RenderTarget* renderTarget = (RenderTarget*)handle;
 		renderTarget->clear(clearColor, clearDepth);
 		setClearColor(s_clearColor);
@@ -728,6 +835,7 @@ namespace TFE_RenderBackend
 
 	void clearRenderTargetDepth(RenderTargetHandle handle, f32 clearDepth)
 	{
+		if (!handle) { return; }
 		RenderTarget* renderTarget = (RenderTarget*)handle;
 		renderTarget->clearDepth(clearDepth);
 	}
@@ -740,6 +848,7 @@ namespace TFE_RenderBackend
 
 	void unbindRenderTarget()
 	{
+		if (s_headless) { return; }
 		RenderTarget::unbind();
 		glViewport(0, 0, m_windowState.width, m_windowState.height);
 
@@ -752,12 +861,19 @@ namespace TFE_RenderBackend
 
 	const TextureGpu* getRenderTargetTexture(RenderTargetHandle rtHandle)
 	{
+		if (!rtHandle) { return nullptr; }
 		RenderTarget* renderTarget = (RenderTarget*)rtHandle;
 		return renderTarget->getTexture();
 	}
 
 	void getRenderTargetDim(RenderTargetHandle rtHandle, u32* width, u32* height)
 	{
+		if (!rtHandle)
+		{
+			*width = 0;
+			*height = 0;
+			return;
+		}
 		RenderTarget* renderTarget = (RenderTarget*)rtHandle;
 		const TextureGpu* texture = renderTarget->getTexture();
 		*width = texture->getWidth();
@@ -794,22 +910,31 @@ namespace TFE_RenderBackend
 
 	void getTextureDim(TextureGpu* texture, u32* width, u32* height)
 	{
+		if (!texture)
+		{
+			*width = 0;
+			*height = 0;
+			return;
+		}
 		*width = texture->getWidth();
 		*height = texture->getHeight();
 	}
 
 	void* getGpuPtr(const TextureGpu* texture)
 	{
+		if (!texture) { return nullptr; }
 		return (void*)(iptr)texture->getHandle();
 	}
 
 	void drawIndexedTriangles(u32 triCount, u32 indexStride, u32 indexStart)
 	{
+		if (s_headless) { return; }
 		glDrawElements(GL_TRIANGLES, triCount * 3, indexStride == 4 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT, (void*)(iptr)(indexStart * indexStride));
 	}
 
 	void drawLines(u32 lineCount)
 	{
+		if (s_headless) { return; }
 		glDrawArrays(GL_LINES, 0, lineCount * 2);
 	}
 
@@ -899,14 +1024,13 @@ namespace TFE_RenderBackend
 	// A quick way of toggling the bloom, but just for the final blit.
 	void bloomPostEnable(bool enable)
 	{
-		if (!s_bloomEnable) { return; }
+		if (!s_bloomEnable || s_headless) { return; }
 		if (enable) { s_postEffectBlit->enableFeatures(BLIT_BLOOM); }
 		else        { s_postEffectBlit->disableFeatures(BLIT_BLOOM); }
 	}
 
-	// Setup the Post effect chain based on current settings.
-	// TODO: Move out of render backend since this should be independent of the backend.
-	void setupPostEffectChain(bool useDynamicTexture, bool useBloom)
+	// Where the virtual display is placed in the window, based on the display mode and widescreen settings.
+	void computeDisplayRect(s32* outX, s32* outY, s32* outW, s32* outH)
 	{
 		s32 x = 0, y = 0;
 		s32 w = m_windowState.width;
@@ -935,6 +1059,23 @@ namespace TFE_RenderBackend
 			// letterbox
 			y = std::max(0, ((s32)m_windowState.height - h) / 2);
 		}
+		*outX = x;
+		*outY = y;
+		*outW = w;
+		*outH = h;
+	}
+
+	// Setup the Post effect chain based on current settings.
+	// TODO: Move out of render backend since this should be independent of the backend.
+	void setupPostEffectChain(bool useDynamicTexture, bool useBloom)
+	{
+		s32 x, y, w, h;
+		computeDisplayRect(&x, &y, &w, &h);
+		if (s_headless)
+		{
+			TFE_HeadlessDisplay::setDisplayRect(x, y, w, h, s_displayMode != DMODE_STRETCH);
+			return;
+		}
 		TFE_PostProcess::clearEffectStack();
 
 		if (useDynamicTexture)
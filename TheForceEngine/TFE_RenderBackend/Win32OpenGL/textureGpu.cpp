@@ -1,4 +1,5 @@
 #include <TFE_RenderBackend/textureGpu.h>
+#include <TFE_RenderBackend/renderBackend.h>
 #include <TFE_System/system.h>
 #include <TFE_Settings/settings.h>
 #include "openGL_Caps.h"
@@ -46,6 +47,8 @@ bool TextureGpu::create(u32 width, u32 height, TexFormat format, bool hasMipmaps
 	m_channels = c_channelCount[format];
 	m_bytesPerChannel = c_bytesPerChannel[format];
 	m_layers = 1;
+	// Headless textures only keep their dimensions.
+	if (TFE_RenderBackend::isHeadless()) { return true; }
 
 	// Catch a case where a pre-existing error is causing failures.
 	GLenum error = glGetError();
@@ -100,6 +103,7 @@ bool TextureGpu::createArray(u32 width, u32 height, u32 layers, u32 channels, u3
 	m_bytesPerChannel = 1;
 	m_mipCount = mipCount;
 	m_layers = layers;
+	if (TFE_RenderBackend::isHeadless()) { return true; }
 
 	glGenTextures(1, &m_gpuHandle);
 	if (!m_gpuHandle) { return false; }
@@ -138,6 +142,7 @@ bool TextureGpu::createWithData(u32 width, u32 height, const void* buffer, MagFi
 	m_channels = 4;
 	m_bytesPerChannel = 1;
 	m_layers = 1;
+	if (TFE_RenderBackend::isHeadless()) { return true; }
 
 	glGenTextures(1, &m_gpuHandle);
 	if (!m_gpuHandle) { return false; }
@@ -161,6 +166,7 @@ bool TextureGpu::createWithData(u32 width, u32 height, const void* buffer, MagFi
 
 bool TextureGpu::update(const void* buffer, size_t size, s32 layer, s32 mipLevel)
 {
+	if (!m_gpuHandle) { return false; }
 	s32 layerCount = layer < 0 ? m_layers : 1;
 	s32 layerIndex = layer < 0 ? 0 : layer;
 	//if (mipLevel == 0 && size < m_width * m_height * m_channels * layerCount) { return false; }
@@ -188,6 +194,7 @@ bool TextureGpu::update(const void* buffer, size_t size, s32 layer, s32 mipLevel
 
 void TextureGpu::setFilter(MagFilter magFilter, MinFilter minFilter, bool isArray) const
 {
+	if (TFE_RenderBackend::isHeadless()) { return; }
 	glTexParameteri(isArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter == MAG_FILTER_LINEAR ? GL_LINEAR : GL_NEAREST);
 	if (minFilter == MIN_FILTER_MIPMAP && m_mipCount > 1)
 	{
@@ -209,6 +216,7 @@ void TextureGpu::setFilter(MagFilter magFilter, MinFilter minFilter, bool isArra
 
 void TextureGpu::bind(u32 slot/* = 0*/) const
 {
+	if (TFE_RenderBackend::isHeadless()) { return; }
 	glActiveTexture(GL_TEXTURE0 + slot);
 	if (m_layers == 1)
 	{
@@ -222,12 +230,14 @@ void TextureGpu::bind(u32 slot/* = 0*/) const
 
 void TextureGpu::clear(u32 slot/* = 0*/)
 {
+	if (TFE_RenderBackend::isHeadless()) { return; }
 	glActiveTexture(GL_TEXTURE0 + slot);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void TextureGpu::clearSlots(u32 count, u32 start/* = 0*/)
 {
+	if (TFE_RenderBackend::isHeadless()) { return; }
 	for (u32 i = 0; i < count; i++)
 	{
 		glActiveTexture(GL_TEXTURE0 + i + start);
@@ -237,6 +247,7 @@ void TextureGpu::clearSlots(u32 count, u32 start/* = 0*/)
 
 void TextureGpu::readCpu(u8* image)
 {
+	if (!m_gpuHandle) { return; }
 	glBindTexture(GL_TEXTURE_2D, m_gpuHandle);
 	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
 	glBindTexture(GL_TEXTURE_2D, 0);
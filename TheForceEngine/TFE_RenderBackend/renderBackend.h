@@ -18,6 +18,7 @@ enum WindowFlags
 {
 	WINFLAG_FULLSCREEN = 1 << 0,
 	WINFLAG_VSYNC = 1 << 1,
+	WINFLAG_HEADLESS = 1 << 2,	// No window or GPU context, frames are presented to a memory surface (see headlessDisplay.h).
 };
 
 enum DisplayMode
@@ -92,6 +93,7 @@ namespace TFE_RenderBackend
 {
 	bool init(const WindowState& state);
 	void destroy();
+	bool isHeadless();
 	bool getVsyncEnabled();
 	void enableVsync(bool enable);
 
@@ -345,6 +345,7 @@ namespace TFE_Settings
 		writeKeyValue_Float(settings, "anisotropyQuality", s_graphicsSettings.anisotropyQuality);
 
 		writeKeyValue_Int(settings, "frameRateLimit", s_graphicsSettings.frameRateLimit);
+		writeKeyValue_Bool(settings, "lateLatchInput", s_graphicsSettings.lateLatchInput);
 		writeKeyValue_Float(settings, "brightness", s_graphicsSettings.brightness);
 		writeKeyValue_Float(settings, "contrast", s_graphicsSettings.contrast);
 		writeKeyValue_Float(settings, "saturation", s_graphicsSettings.saturation);
@@ -686,6 +687,10 @@ namespace TFE_Settings
 		{
 			s_graphicsSettings.frameRateLimit = parseInt(value);
 		}
+		else if (strcasecmp("lateLatchInput", key) == 0)
+		{
+			s_graphicsSettings.lateLatchInput = parseBool(value);
+		}
 		else if (strcasecmp("brightness", key) == 0)
 		{
 			s_graphicsSettings.brightness = parseFloat(value);
@@ -60,6 +60,7 @@ struct TFE_Settings_Graphics
 	bool  fix3doNormalOverflow = true;
 	bool  ignore3doLimits = true;
 	s32   frameRateLimit = 240;
+	bool  lateLatchInput = false;	// Poll input again right before the game simulation to reduce input latency.
 	f32   brightness = 1.0f;
 	f32   contrast = 1.0f;
 	f32   saturation = 1.0f;
@@ -1,11 +1,35 @@
 #include <TFE_System/frameLimiter.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <timeapi.h>
+#undef min
+#undef max
+#pragma comment( lib, "winmm.lib" )
+// Only defined by newer Windows SDKs, older versions of Windows fail to create the timer and the limiter falls back to Sleep().
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <time.h>
+#endif
 
 namespace TFE_System
 {
 	static const f64 c_expAveF0 = 0.95;
 	static const f64 c_expAveF1 = 1.0 - c_expAveF0;
 	static const f64 c_epsilon = DBL_EPSILON;
-	
+	// Limits of the spin margin - the time before the deadline where the limiter stops sleeping and spins.
+	static const f64 c_minSpinMargin = 0.0001;	// 0.1 ms
+	static const f64 c_maxSpinMargin = 0.004;	// 4 ms
+	// Sleep requests shorter than this are not worth it, spin instead.
+	static const f64 c_minSleep = 0.0002;
+
 	static f64 s_limitFPS = 0.0;
 	static f64 s_limitDelta = 0.0;
 	static f64 s_limitDeltaActual = 0.0;
@@ -13,6 +37,79 @@ namespace TFE_System
 	static f64 s_accuracyAve = 0.0;
 	static u64 s_beginTicks = 0;
 
+	// Sleep calibration, the observed sleep overshoot (actual - requested) in seconds.
+	static f64 s_overshootMean = 0.001;
+	static f64 s_overshootVar = 0.0;
+	static f64 s_spinMargin = 0.002;
+	static FrameLimiterStats s_stats = {};
+
+#ifdef _WIN32
+	static HANDLE s_timer = nullptr;
+	static bool s_timerPeriodSet = false;
+
+	static void setTimerResolution(bool enable)
+	{
+		if (enable && !s_timer)
+		{
+			s_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		}
+		// Without a high resolution timer, Sleep() needs a 1 ms system timer period to be usable.
+		const bool setPeriod = enable && !s_timer;
+		if (setPeriod != s_timerPeriodSet)
+		{
+			if (setPeriod) { timeBeginPeriod(1); }
+			else { timeEndPeriod(1); }
+			s_timerPeriodSet = setPeriod;
+		}
+	}
+
+	static void sleepSeconds(f64 seconds)
+	{
+		if (s_timer)
+		{
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -LONGLONG(seconds * 1.0e7);	// relative time in 100ns units.
+			if (SetWaitableTimer(s_timer, &dueTime, 0, nullptr, nullptr, FALSE))
+			{
+				WaitForSingleObject(s_timer, INFINITE);
+				return;
+			}
+		}
+		Sleep(std::max(DWORD(seconds * 1000.0), DWORD(1)));
+	}
+#else
+	static void setTimerResolution(bool enable)
+	{
+	}
+
+	static void sleepSeconds(f64 seconds)
+	{
+		struct timespec ts;
+		ts.tv_sec = time_t(seconds);
+		ts.tv_nsec = long((seconds - f64(ts.tv_sec)) * 1.0e9);
+		nanosleep(&ts, nullptr);
+	}
+#endif
+
+	static f64 getElapsed(f64 beginSec)
+	{
+		return convertFromTicksToSeconds(getCurrentTimeInTicks()) - beginSec;
+	}
+
+	static void updateSpinMargin(f64 overshoot)
+	{
+		// Exponential mean and variance of the overshoot, spin for long enough to cover most sleeps that wake up late.
+		const f64 diff = overshoot - s_overshootMean;
+		s_overshootMean += c_expAveF1 * diff;
+		s_overshootVar = c_expAveF0 * (s_overshootVar + c_expAveF1 * diff * diff);
+		s_spinMargin = std::min(std::max(s_overshootMean + 2.0 * sqrt(s_overshootVar), c_minSpinMargin), c_maxSpinMargin);
+	}
+
+	static f64 expAve(f64 ave, f64 value)
+	{
+		return ave * c_expAveF0 + value * c_expAveF1;
+	}
+
 	// Set the frame limit in Frames Per Second (FPS).
 	// A value of 0 sets no limit.
 	void frameLimiter_set(f64 limitFPS/* = 0.0*/)
@@ -35,6 +132,8 @@ namespace TFE_System
 			s_accuracy    = 0.0;
 			s_accuracyAve = 0.0;
 		}
+		setTimerResolution(s_limitDelta != 0.0);
+		s_stats = {};
 	}
 
 	void frameLimiter_begin()
@@ -46,31 +145,75 @@ namespace TFE_System
 	{
 		if (s_limitDelta == 0.0) { return; }
 
-		u64 curTick = TFE_System::getCurrentTimeInTicks();
-		if (curTick >= s_beginTicks)
+		const u64 curTick = TFE_System::getCurrentTimeInTicks();
+		if (curTick < s_beginTicks) { return; }
+
+		const f64 beginSec = TFE_System::convertFromTicksToSeconds(s_beginTicks);
+		const f64 workTime = TFE_System::convertFromTicksToSeconds(curTick) - beginSec;
+		f64 dt = workTime;
+
+		// Sleep until shortly before the deadline.
+		f64 sleepTime = 0.0;
+		const f64 sleepRequest = s_limitDelta - dt - s_spinMargin;
+		if (sleepRequest >= c_minSleep)
 		{
-			const f64 beginSec = TFE_System::convertFromTicksToSeconds(s_beginTicks);
-			f64 curSec = TFE_System::convertFromTicksToSeconds(curTick);
-			f64 dt = curSec - beginSec;
-			while (dt < s_limitDelta)
-			{
-				// Give other threads a time slice.
-				TFE_System::sleep(0);
-				// Update delta time.
-				curTick = TFE_System::getCurrentTimeInTicks();
-				curSec = TFE_System::convertFromTicksToSeconds(curTick);
-				dt = curSec - beginSec;
-			}
-			// Accuracy - how close is delta time to the desired delta?
-			// 1.0 = 100% accurate, 0.0 = fully inaccurate (dt = 0)
-			// > 1.0 : frame is too long; < 1.0 : frame is too short.
-			s_accuracy = 1.0 - (dt - s_limitDeltaActual) / s_limitDeltaActual;
-			s_accuracyAve = (s_accuracyAve == 0.0) ? s_accuracy : s_accuracyAve*c_expAveF0 + s_accuracy*c_expAveF1;
+			sleepSeconds(sleepRequest);
+			const f64 sleepEnd = getElapsed(beginSec);
+			sleepTime = sleepEnd - dt;
+			updateSpinMargin(sleepTime - sleepRequest);
+			dt = sleepEnd;
+		}
+
+		// Then spin for the remaining time.
+		const f64 spinStart = dt;
+		while (dt < s_limitDelta)
+		{
+			// Give other threads a time slice.
+			std::this_thread::yield();
+			dt = getElapsed(beginSec);
+		}
+		const f64 spinTime = dt - spinStart;
+
+		// Accuracy - how close is delta time to the desired delta?
+		// 1.0 = 100% accurate, 0.0 = fully inaccurate (dt = 0)
+		// > 1.0 : frame is too long; < 1.0 : frame is too short.
+		s_accuracy = 1.0 - (dt - s_limitDeltaActual) / s_limitDeltaActual;
+		s_accuracyAve = (s_accuracyAve == 0.0) ? s_accuracy : s_accuracyAve*c_expAveF0 + s_accuracy*c_expAveF1;
+
+		// Statistics.
+		const f64 error = dt - s_limitDeltaActual;
+		const f64 cpuUsage = (dt - sleepTime) / dt;
+		if (s_stats.frameCount == 0)
+		{
+			s_stats.frameTime = dt;
+			s_stats.jitter    = fabs(error);
+			s_stats.workTime  = workTime;
+			s_stats.sleepTime = sleepTime;
+			s_stats.spinTime  = spinTime;
+			s_stats.cpuUsage  = cpuUsage;
 		}
+		else
+		{
+			s_stats.frameTime = expAve(s_stats.frameTime, dt);
+			s_stats.jitter    = sqrt(expAve(s_stats.jitter * s_stats.jitter, error * error));
+			s_stats.workTime  = expAve(s_stats.workTime, workTime);
+			s_stats.sleepTime = expAve(s_stats.sleepTime, sleepTime);
+			s_stats.spinTime  = expAve(s_stats.spinTime, spinTime);
+			s_stats.cpuUsage  = expAve(s_stats.cpuUsage, cpuUsage);
+		}
+		s_stats.maxError = std::max(s_stats.maxError, fabs(error));
+		s_stats.frameCount++;
 	}
 
 	f64 frameLimiter_getAccuracy()
 	{
 		return s_accuracyAve;
 	}
-}
\ No newline at end of file
+
+	void frameLimiter_getStats(FrameLimiterStats* stats)
+	{
+		*stats = s_stats;
+		stats->targetTime = s_limitDeltaActual;
+		stats->spinMargin = s_spinMargin;
+	}
+}
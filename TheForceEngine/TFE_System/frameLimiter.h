@@ -2,16 +2,38 @@
 //////////////////////////////////////////////////////////////////////
 // The Force Engine System Library
 // System functionality, such as timers and logging.
+//
+// The frame limiter sleeps until shortly before the end of the frame
+// and then spins for the remaining time. The spin margin is calibrated
+// at runtime from how late the OS sleeps actually wake up, so the
+// limiter only spins for a fraction of a millisecond on systems with
+// accurate timers.
 //////////////////////////////////////////////////////////////////////
 
 #include "system.h"
 
 namespace TFE_System
 {
+	// Times are in seconds, averages are exponential moving averages.
+	struct FrameLimiterStats
+	{
+		u32 frameCount;		// frames limited since the limit was set.
+		f64 targetTime;		// target frame time.
+		f64 frameTime;		// average frame time.
+		f64 jitter;			// RMS difference between the frame time and the target.
+		f64 maxError;		// largest difference between the frame time and the target.
+		f64 workTime;		// average time spent before the limiter starts waiting.
+		f64 sleepTime;
+		f64 spinTime;
+		f64 spinMargin;		// current calibrated spin margin.
+		f64 cpuUsage;		// average fraction of the frame the main thread is not sleeping.
+	};
+
 	// Set the frame limit in Frames Per Second (FPS).
 	// A value of 0 sets no limit.
 	void frameLimiter_set(f64 limitFPS = 0.0);
 	f64 frameLimiter_getAccuracy();
+	void frameLimiter_getStats(FrameLimiterStats* stats);
 
 	void frameLimiter_begin();
 	void frameLimiter_end();
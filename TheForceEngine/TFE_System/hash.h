@@ -0,0 +1,43 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Simple non-cryptographic hashing (FNV-1a), used to build keys for
+// cached data derived from game assets.
+//////////////////////////////////////////////////////////////////////
+#include "types.h"
+
+namespace TFE_Hash
+{
+	enum : u64
+	{
+		FNV64_OFFSET = 0xcbf29ce484222325ull,
+		FNV64_PRIME  = 0x00000100000001b3ull,
+	};
+
+	// Pass the previous result as 'hash' to hash data in several parts.
+	inline u64 fnv1a64(const void* data, size_t size, u64 hash = FNV64_OFFSET)
+	{
+		const u8* bytes = (const u8*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= FNV64_PRIME;
+		}
+		return hash;
+	}
+
+	inline u64 fnv1a64(const char* str, u64 hash = FNV64_OFFSET)
+	{
+		for (; *str; str++)
+		{
+			hash ^= u8(*str);
+			hash *= FNV64_PRIME;
+		}
+		return hash;
+	}
+
+	template <typename T>
+	inline u64 fnv1a64Value(const T& value, u64 hash)
+	{
+		return fnv1a64(&value, sizeof(T), hash);
+	}
+}
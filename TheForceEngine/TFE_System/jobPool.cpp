@@ -0,0 +1,191 @@
+#include "jobPool.h"
+#include "system.h"
+#include <SDL_atomic.h>
+#include <SDL_cpuinfo.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+#include <algorithm>
+#include <vector>
+
+namespace TFE_JobPool
+{
+	enum
+	{
+		MAX_WORKER_COUNT = 16,
+	};
+
+	static std::vector<SDL_Thread*> s_threads;
+	static SDL_mutex* s_mutex = nullptr;
+	static SDL_cond* s_workCond = nullptr;
+	static SDL_cond* s_doneCond = nullptr;
+	static bool s_runThreads = false;
+	static bool s_created = false;	// init() has run, either directly or on first use.
+
+	// The current job, set while holding s_mutex before the workers are woken up.
+	static JobFunc s_func = nullptr;
+	static void* s_userData = nullptr;
+	static s32 s_count = 0;
+	static s32 s_batchSize = 1;
+	static u32 s_jobId = 0;
+	static u32 s_firstJobId = 0;	// s_jobId when the workers were created.
+	static s32 s_activeWorkers = 0;
+	static SDL_atomic_t s_nextIndex;
+
+	int workerThreadFunc(void* userData);
+
+	bool init(s32 workerCount)
+	{
+		if (s_created) { return !s_threads.empty(); }
+		s_created = true;
+
+		if (workerCount < 0)
+		{
+			workerCount = SDL_GetCPUCount() - 1;
+		}
+		workerCount = std::min(workerCount, s32(MAX_WORKER_COUNT));
+		if (workerCount <= 0)
+		{
+			TFE_System::logWrite(LOG_MSG, "JobPool", "No worker threads, jobs run on the calling thread.");
+			return true;
+		}
+
+		s_mutex = SDL_CreateMutex();
+		s_workCond = SDL_CreateCond();
+		s_doneCond = SDL_CreateCond();
+		if (!s_mutex || !s_workCond || !s_doneCond)
+		{
+			TFE_System::logWrite(LOG_ERROR, "JobPool", "Cannot create the synchronization objects, jobs run on the calling thread.");
+			destroy();
+			// Do not try again on every use.
+			s_created = true;
+			return false;
+		}
+
+		s_runThreads = true;
+		s_firstJobId = s_jobId;
+		for (s32 i = 0; i < workerCount; i++)
+		{
+			SDL_Thread* thread = SDL_CreateThread(workerThreadFunc, "TFE_JobWorker", nullptr);
+			if (!thread)
+			{
+				TFE_System::logWrite(LOG_WARNING, "JobPool", "Cannot create worker thread %d.", i);
+				break;
+			}
+			s_threads.push_back(thread);
+		}
+		TFE_System::logWrite(LOG_MSG, "JobPool", "Created %d worker thread(s).", s32(s_threads.size()));
+		return !s_threads.empty();
+	}
+
+	void destroy()
+	{
+		if (!s_threads.empty())
+		{
+			SDL_LockMutex(s_mutex);
+			s_runThreads = false;
+			SDL_CondBroadcast(s_workCond);
+			SDL_UnlockMutex(s_mutex);
+
+			for (size_t i = 0; i < s_threads.size(); i++)
+			{
+				SDL_WaitThread(s_threads[i], nullptr);
+			}
+			s_threads.clear();
+		}
+
+		if (s_doneCond) { SDL_DestroyCond(s_doneCond); }
+		if (s_workCond) { SDL_DestroyCond(s_workCond); }
+		if (s_mutex) { SDL_DestroyMutex(s_mutex); }
+		s_doneCond = nullptr;
+		s_workCond = nullptr;
+		s_mutex = nullptr;
+		s_created = false;
+	}
+
+	static void runBatches()
+	{
+		for (;;)
+		{
+			const s32 start = SDL_AtomicAdd(&s_nextIndex, s_batchSize);
+			if (start >= s_count) { break; }
+
+			const s32 end = std::min(start + s_batchSize, s_count);
+			for (s32 i = start; i < end; i++)
+			{
+				s_func(i, s_userData);
+			}
+		}
+	}
+
+	void parallelFor(s32 count, JobFunc func, void* userData, s32 batchSize)
+	{
+		if (count <= 0 || !func) { return; }
+		batchSize = std::max(batchSize, 1);
+		if (count > batchSize && !s_created) { init(); }
+		if (s_threads.empty() || count <= batchSize)
+		{
+			for (s32 i = 0; i < count; i++)
+			{
+				func(i, userData);
+			}
+			return;
+		}
+
+		SDL_LockMutex(s_mutex);
+		s_func = func;
+		s_userData = userData;
+		s_count = count;
+		s_batchSize = batchSize;
+		SDL_AtomicSet(&s_nextIndex, 0);
+		s_activeWorkers = s32(s_threads.size());
+		s_jobId++;
+		SDL_CondBroadcast(s_workCond);
+		SDL_UnlockMutex(s_mutex);
+
+		// The calling thread works on the loop as well.
+		runBatches();
+
+		SDL_LockMutex(s_mutex);
+		while (s_activeWorkers > 0)
+		{
+			SDL_CondWait(s_doneCond, s_mutex);
+		}
+		SDL_UnlockMutex(s_mutex);
+	}
+
+	s32 getWorkerCount()
+	{
+		if (!s_created) { init(); }
+		return s32(s_threads.size());
+	}
+
+	////////////////////////////////////////////
+	// Internal
+	////////////////////////////////////////////
+	int workerThreadFunc(void* userData)
+	{
+		u32 jobId = s_firstJobId;
+		SDL_LockMutex(s_mutex);
+		for (;;)
+		{
+			while (s_runThreads && s_jobId == jobId)
+			{
+				SDL_CondWait(s_workCond, s_mutex);
+			}
+			if (!s_runThreads) { break; }
+			jobId = s_jobId;
+			SDL_UnlockMutex(s_mutex);
+
+			runBatches();
+
+			SDL_LockMutex(s_mutex);
+			s_activeWorkers--;
+			if (s_activeWorkers == 0)
+			{
+				SDL_CondSignal(s_doneCond);
+			}
+		}
+		SDL_UnlockMutex(s_mutex);
+		return 0;
+	}
+}
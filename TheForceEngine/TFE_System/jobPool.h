@@ -0,0 +1,31 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// Job pool
+// A small pool of worker threads for data parallel loops. parallelFor()
+// splits an index range over the workers and the calling thread and
+// returns once every index has been processed, so the caller never
+// observes partial results.
+//
+// Jobs must only read shared state and write to their own outputs,
+// anything order dependent is left to the caller once the loop returns.
+//
+// The workers are created on first use, so nothing is spawned unless a
+// feature that uses the pool is enabled.
+//////////////////////////////////////////////////////////////////////
+#include "types.h"
+
+typedef void(*JobFunc)(s32 index, void* userData);
+
+namespace TFE_JobPool
+{
+	// Create the workers now rather than on first use, does nothing if they already exist.
+	// workerCount < 0 uses one worker per logical CPU, minus the calling thread.
+	bool init(s32 workerCount = -1);
+	void destroy();
+
+	// Calls func(i, userData) for every i in [0, count). Indices are handed out in batches of 'batchSize'.
+	// If the pool has no workers the loop runs on the calling thread.
+	void parallelFor(s32 count, JobFunc func, void* userData, s32 batchSize = 1);
+	// Creates the workers if needed.
+	s32  getWorkerCount();
+}
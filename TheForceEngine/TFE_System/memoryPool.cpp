@@ -4,10 +4,44 @@
 #include <TFE_System/system.h>
 #include <algorithm>
 
-MemoryPool::MemoryPool() : m_poolSize(0), m_waterMark(0), m_ptr(0) {}
+// Pools are usually static, so the list is created on first use.
+static std::vector<MemoryPool*>& getPoolList()
+{
+	static std::vector<MemoryPool*> s_pools;
+	return s_pools;
+}
+
+MemoryPool::MemoryPool() : m_poolSize(0), m_waterMark(0), m_ptr(0), m_peak(0), m_failCount(0) {}
+
+MemoryPool::~MemoryPool()
+{
+	std::vector<MemoryPool*>& pools = getPoolList();
+	const auto iter = std::find(pools.begin(), pools.end(), this);
+	if (iter != pools.end())
+	{
+		pools.erase(iter);
+	}
+}
+
+s32 MemoryPool::getPoolCount()
+{
+	return (s32)getPoolList().size();
+}
+
+MemoryPool* MemoryPool::getPool(s32 index)
+{
+	std::vector<MemoryPool*>& pools = getPoolList();
+	return index >= 0 && index < (s32)pools.size() ? pools[index] : nullptr;
+}
 
 void MemoryPool::init(size_t poolSize, const char* name)
 {
+	std::vector<MemoryPool*>& pools = getPoolList();
+	if (std::find(pools.begin(), pools.end(), this) == pools.end())
+	{
+		pools.push_back(this);
+	}
+
 	if (poolSize > m_poolSize)
 	{
 		m_poolSize = poolSize;
@@ -31,6 +65,7 @@ void* MemoryPool::allocate(size_t size)
 	if (m_ptr + size > m_poolSize)
 	{
 		TFE_System::logWrite(LOG_ERROR, "MemoryPool", "Allocate of size %u bytes failed for memory pool \"%s\"", size, m_name.c_str());
+		m_failCount++;
 		return nullptr;
 	}
 	else if (m_ptr + size >= m_waterMark && m_waterMark > 0u)
@@ -42,6 +77,7 @@ void* MemoryPool::allocate(size_t size)
 
 	u8* memory = m_memory.data() + m_ptr;
 	m_ptr += size;
+	m_peak = std::max(m_peak, m_ptr);
 
 	return memory;
 }
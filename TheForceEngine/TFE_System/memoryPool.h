@@ -2,6 +2,8 @@
 //////////////////////////////////////////////////////////////////////
 // The Force Engine Memory Pool
 // A frame based memory allocator
+// Pools keep their peak usage, so they can be sized from real data,
+// initialized pools can be listed with getPoolCount()/getPool().
 //////////////////////////////////////////////////////////////////////
 
 #include "types.h"
@@ -12,6 +14,7 @@ class MemoryPool
 {
 public:
 	MemoryPool();
+	~MemoryPool();
 
 	void init(size_t poolSize, const char* name);
 
@@ -25,6 +28,16 @@ public:
 
 	size_t getMemoryUsed()  const { return m_ptr; }
 	f32    getPercentUsed() const { return m_poolSize ? f32(m_ptr) / f32(m_poolSize) : 0.0f; }
+	// The high watermark since the pool was initialized or the peak was reset.
+	size_t getPeakUsed()    const { return m_peak; }
+	size_t getPoolSize()    const { return m_poolSize; }
+	// Number of allocations that did not fit in the pool.
+	u32    getFailCount()   const { return m_failCount; }
+	const char* getName()   const { return m_name.c_str(); }
+	void   resetPeak() { m_peak = m_ptr; m_failCount = 0; }
+
+	static s32 getPoolCount();
+	static MemoryPool* getPool(s32 index);
 
 private:
 	std::vector<u8> m_memory;
@@ -32,4 +45,6 @@ private:
 	size_t m_poolSize;
 	size_t m_waterMark;
 	size_t m_ptr;
+	size_t m_peak;
+	u32 m_failCount;
 };
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <cmath>
 
 #include "parser.h"
 #include <algorithm>
@@ -23,6 +24,27 @@ namespace
 		}
 		return false;
 	}
+
+	// Whitespace as defined by sscanf().
+	bool isSpace(const char c)
+	{
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+	const char* skipSpace(const char* str)
+	{
+		while (isSpace(*str)) { str++; }
+		return str;
+	}
+
+	// Exact powers of 10 representable as doubles.
+	// Powers of 10 that are exact in single precision (5^10 < 2^24).
+	static const f32 c_pow10[] =
+	{
+		1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+	};
+	// Largest integer mantissa that is exact in single precision.
+	static const u64 c_maxExactMantissa = 1ull << 24;
 }
 
 TFE_Parser::TFE_Parser() : m_buffer(nullptr), m_bufferLen(0u), m_enableBlockComments(false), m_blockComment(false), m_enableColorSeperator(false), m_convertToUppercase(false) {}
@@ -232,3 +254,234 @@ void TFE_Parser::tokenizeLine(const char* line, TokenList& tokens)
 		tokens.push_back(curToken);
 	}
 }
+
+void TFE_Parser::tokenizeLine(const char* line, TokenSpanList& tokens, bool upperCase)
+{
+	tokens.clear();
+
+	const size_t len = strlen(line);
+	// Worst case: every character is copied and each is a separate token with a terminator.
+	if (m_scratch.size() < 2 * len + 2)
+	{
+		m_scratch.resize(2 * len + 2);
+	}
+	char* scratch = m_scratch.data();
+	size_t scratchPos = 0;
+
+	// first move past leading whitespace and ending white space.
+	size_t start = 0, end = 0;
+	for (size_t c = 0; c < len; c++)
+	{
+		if (!isWhitespace(line[c]))
+		{
+			if (start == 0 && end == 0) { start = c; }
+			end = c + 1;
+		}
+	}
+
+	bool inQuote = false;
+	bool copied = false;
+	TokenSpan token = { line, 0 };
+	for (size_t c = start; c <= end; c++)
+	{
+		const char ch = c < end ? line[c] : 0;
+		bool endToken = (c == end);
+		bool addChar = false;
+		if (c == end)
+		{
+			// Flush the last token.
+		}
+		else if (ch == '"')
+		{
+			if (inQuote && token.len == 0)
+			{
+				tokens.push_back({ upperCase ? &scratch[scratchPos] : &line[c], 0 });
+				if (upperCase) { scratch[scratchPos++] = 0; }
+			}
+			inQuote = !inQuote;
+		}
+		else if (!inQuote && (isWhitespace(ch) || isSeparator(ch)))
+		{
+			endToken = true;
+		}
+		else if (!inQuote && m_enableColorSeperator && ch == ':')
+		{
+			addChar = true;
+			endToken = true;
+		}
+		else
+		{
+			addChar = true;
+		}
+
+		if (addChar)
+		{
+			if (!copied && !upperCase && (token.len == 0 || token.str + token.len == &line[c]))
+			{
+				// Still contiguous in the source line.
+				if (token.len == 0) { token.str = &line[c]; }
+				token.len++;
+			}
+			else
+			{
+				if (!copied)
+				{
+					memcpy(&scratch[scratchPos], token.str, token.len);
+					token.str = &scratch[scratchPos];
+					copied = true;
+				}
+				scratch[scratchPos + token.len] = upperCase ? toupper(ch) : ch;
+				token.len++;
+			}
+		}
+		if (endToken && token.len)
+		{
+			if (copied)
+			{
+				scratch[scratchPos + token.len] = 0;
+				scratchPos += token.len + 1;
+			}
+			tokens.push_back(token);
+			token.len = 0;
+			copied = false;
+		}
+	}
+}
+
+const char* TFE_Parser::matchString(const char* str, const char* expected)
+{
+	if (!str) { return nullptr; }
+	for (; *expected; expected++)
+	{
+		if (isSpace(*expected))
+		{
+			str = skipSpace(str);
+		}
+		else if (*str == *expected)
+		{
+			str++;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+	return str;
+}
+
+const char* TFE_Parser::readInt(const char* str, s32* value)
+{
+	if (!str) { return nullptr; }
+	str = skipSpace(str);
+
+	const bool negative = (*str == '-');
+	if (*str == '-' || *str == '+') { str++; }
+	if (*str < '0' || *str > '9') { return nullptr; }
+
+	s64 result = 0;
+	for (; *str >= '0' && *str <= '9'; str++)
+	{
+		result = result * 10 + (*str - '0');
+		if (result > 0xffffffffll) { result = 0xffffffffll; }
+	}
+	*value = s32(negative ? -result : result);
+	return str;
+}
+
+const char* TFE_Parser::readFloat(const char* str, f32* value)
+{
+	if (!str) { return nullptr; }
+	str = skipSpace(str);
+
+	const char* start = str;
+	const bool negative = (*str == '-');
+	if (*str == '-' || *str == '+') { str++; }
+
+	// Accumulate up to 19 significant digits, which fit in 64 bits.
+	u64 mantissa = 0;
+	s32 digits = 0, exponent = 0;
+	bool hasDigits = false;
+	for (; *str >= '0' && *str <= '9'; str++)
+	{
+		hasDigits = true;
+		if (digits < 19) { mantissa = mantissa * 10 + (*str - '0'); if (mantissa) { digits++; } }
+		else { exponent++; }
+	}
+	if (*str == '.')
+	{
+		str++;
+		for (; *str >= '0' && *str <= '9'; str++)
+		{
+			hasDigits = true;
+			if (digits < 19) { mantissa = mantissa * 10 + (*str - '0'); if (mantissa) { digits++; } exponent--; }
+		}
+	}
+	if (!hasDigits) { return nullptr; }
+
+	if (*str == 'e' || *str == 'E')
+	{
+		const char* expStart = str + 1;
+		s32 expValue;
+		const char* expEnd = (*expStart == '-' || *expStart == '+' || (*expStart >= '0' && *expStart <= '9')) ? readInt(expStart, &expValue) : nullptr;
+		if (expEnd)
+		{
+			exponent += expValue;
+			str = expEnd;
+		}
+	}
+
+	// If both the mantissa and power of 10 are exact in single precision, a single rounded multiply or divide
+	// gives the same result as strtof(). Computing in double and narrowing would round twice, so the (rare)
+	// long or large numbers are left to strtof().
+	const s32 maxExponent = s32(TFE_ARRAYSIZE(c_pow10)) - 1;
+	if (mantissa <= c_maxExactMantissa && exponent >= -maxExponent && exponent <= maxExponent)
+	{
+		f32 result = f32(mantissa);
+		result = (exponent < 0) ? result / c_pow10[-exponent] : result * c_pow10[exponent];
+		*value = negative ? -result : result;
+		return str;
+	}
+
+	// Only pass the characters parsed above, strtof() also accepts forms that sscanf("%f") does not (such as hex).
+	char buffer[64];
+	const size_t len = size_t(str - start);
+	if (len < sizeof(buffer))
+	{
+		memcpy(buffer, start, len);
+		buffer[len] = 0;
+		*value = strtof(buffer, nullptr);
+	}
+	else
+	{
+		*value = strtof(std::string(start, len).c_str(), nullptr);
+	}
+	return str;
+}
+
+bool TFE_Parser::tokenEquals(const TokenSpan& token, const char* str)
+{
+	return strncasecmp(token.str, str, token.len) == 0 && str[token.len] == 0;
+}
+
+bool TFE_Parser::tokenToInt(const TokenSpan& token, s32* value)
+{
+	// Tokens are not null terminated, so copy into a small buffer first.
+	char buffer[64];
+	if (token.len == 0 || token.len >= sizeof(buffer)) { return false; }
+	memcpy(buffer, token.str, token.len);
+	buffer[token.len] = 0;
+
+	const char* end = readInt(buffer, value);
+	return end && *end == 0;
+}
+
+bool TFE_Parser::tokenToFloat(const TokenSpan& token, f32* value)
+{
+	char buffer[64];
+	if (token.len == 0 || token.len >= sizeof(buffer)) { return false; }
+	memcpy(buffer, token.str, token.len);
+	buffer[token.len] = 0;
+
+	const char* end = readFloat(buffer, value);
+	return end && *end == 0;
+}
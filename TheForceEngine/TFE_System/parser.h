@@ -10,6 +10,15 @@
 
 typedef std::vector<std::string> TokenList;
 
+// A token that references memory owned by someone else (string_view style) and is not null terminated,
+// unless it was copied into the parser scratch memory.
+struct TokenSpan
+{
+	const char* str;
+	u32 len;
+};
+typedef std::vector<TokenSpan> TokenSpanList;
+
 class TFE_Parser
 {
 public:
@@ -35,6 +44,22 @@ public:
 	// Split a line into tokens using space, comma or equals as separators.
 	// Note strings with spaces still work, they need to be closed in quotes, which are removed upon tokenizing.
 	void tokenizeLine(const char* line, TokenList& tokens);
+	// Same rules as above but without allocating a string per token. Tokens point into 'line' when possible, otherwise
+	// (quotes inside of a token or 'upperCase' is true) they are copied, null terminated, into the parser scratch memory.
+	// Tokens are valid until the next call.
+	void tokenizeLine(const char* line, TokenSpanList& tokens, bool upperCase = false);
+
+	// Fast replacements for sscanf() on hot paths.
+	// These skip leading whitespace and return the position after the match/value or null on failure.
+	// A null input returns null so calls can be chained, with a single check at the end.
+	// matchString() follows sscanf() format rules: a space matches any amount of whitespace, other characters must match exactly.
+	static const char* matchString(const char* str, const char* expected);
+	static const char* readInt(const char* str, s32* value);
+	static const char* readFloat(const char* str, f32* value);
+
+	static bool tokenEquals(const TokenSpan& token, const char* str);	// case insensitive.
+	static bool tokenToInt(const TokenSpan& token, s32* value);
+	static bool tokenToFloat(const TokenSpan& token, f32* value);
 
 private:
 	const char* m_buffer;
@@ -44,6 +69,7 @@ private:
 	bool m_blockComment;
 	bool m_enableColorSeperator;
 	bool m_convertToUppercase;
+	std::vector<char> m_scratch;
 
 private:
 	bool isComment(const char* buffer);
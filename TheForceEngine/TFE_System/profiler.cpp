@@ -1,6 +1,7 @@
 #include <cstring>
 
 #include "profiler.h"
+#include "telemetry.h"
 #include <assert.h>
 #include <algorithm>
 #include <vector>
@@ -31,6 +32,7 @@ namespace TFE_Profiler
 
 		u32  child = NULL_ZONE;
 		u32  sibling = NULL_ZONE;
+		s32  telemetryColumn;
 	};
 
 	struct Counter
@@ -38,6 +40,7 @@ namespace TFE_Profiler
 		u32  id;
 		s32* ptr;
 		s32  prevValue;
+		s32  telemetryColumn;
 
 		char name[64];
 	};
@@ -64,6 +67,7 @@ namespace TFE_Profiler
 	static u32 s_zoneStack[MAX_ZONE_STACK];
 	static u64 s_currentFrame = 1;
 	static u64 s_currentPath;
+	static s32 s_frameTimeColumn = TFE_Telemetry::TELEMETRY_INVALID_COLUMN;
 
 	void addZoneChild(u32 parentId, u32 zoneId)
 	{
@@ -119,6 +123,10 @@ namespace TFE_Profiler
 			zone.timeInZoneAve = 0.0;
 			zone.fractOfParentAve = 0.0;
 			zone.frame = 0;
+
+			char columnName[80];
+			sprintf(columnName, "%s (ms)", name);
+			zone.telemetryColumn = TFE_Telemetry::addColumn(columnName);
 			
 			s_zoneList.push_back(zone);
 			s_zoneMap[name] = id;
@@ -167,6 +175,7 @@ namespace TFE_Profiler
 			newCounter.id = id;
 			newCounter.prevValue = *counter;
 			newCounter.ptr = counter;
+			newCounter.telemetryColumn = TFE_Telemetry::addColumn(name);
 			strcpy(newCounter.name, name);
 
 			s_counterList.push_back(newCounter);
@@ -224,6 +233,30 @@ namespace TFE_Profiler
 		}
 	}
 
+	// Add the times and counters from this frame to the telemetry ring.
+	void recordTelemetry()
+	{
+		if (!TFE_Telemetry::isEnabled()) { return; }
+		if (s_frameTimeColumn == TFE_Telemetry::TELEMETRY_INVALID_COLUMN)
+		{
+			s_frameTimeColumn = TFE_Telemetry::addColumn("Frame Time (ms)");
+		}
+
+		TFE_Telemetry::beginFrame();
+		TFE_Telemetry::setValue(s_frameTimeColumn, s_frameTime * 1000.0);
+		const size_t zoneCount = s_zoneList.size();
+		for (size_t i = 0; i < zoneCount; i++)
+		{
+			TFE_Telemetry::setValue(s_zoneList[i].telemetryColumn, s_zoneList[i].timeInZone[s_writeBuffer] * 1000.0);
+		}
+		const size_t counterCount = s_counterList.size();
+		for (size_t i = 0; i < counterCount; i++)
+		{
+			TFE_Telemetry::setValue(s_counterList[i].telemetryColumn, *s_counterList[i].ptr);
+		}
+		TFE_Telemetry::endFrame();
+	}
+
 	void frameEnd()
 	{
 		s_frameTime = TFE_System::convertFromTicksToSeconds(TFE_System::getCurrentTimeInTicks() - s_frameBegin);
@@ -260,6 +293,7 @@ namespace TFE_Profiler
 			s_zoneList[i].sibling = NULL_ZONE;
 		}
 
+		recordTelemetry();
 		s_currentFrame++;
 	}
 
@@ -0,0 +1,206 @@
+#include <cstring>
+
+#include "telemetry.h"
+#include "system.h"
+#include <TFE_FileSystem/filestream.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace TFE_Telemetry
+{
+	struct Source
+	{
+		s32 column;
+		TelemetrySource func;
+		void* userData;
+	};
+
+	struct FrameInfo
+	{
+		u64 frame;
+		f64 time;
+	};
+
+	static atomic_bool s_enabled(false);	// read by the audio thread.
+	static std::vector<std::string> s_columns;
+	static std::vector<Source> s_sources;
+	// Ring of TELEMETRY_FRAME_COUNT rows of TELEMETRY_MAX_COLUMNS values, allocated when the first frame is recorded.
+	static std::vector<f32> s_values;
+	static std::vector<FrameInfo> s_frameInfo;
+	static u32 s_frameCount = 0;	// number of valid rows.
+	static u32 s_writeRow = 0;		// row being recorded or the next row.
+	static u64 s_frame = 0;
+	static bool s_inFrame = false;
+
+	void setEnabled(bool enable)
+	{
+		s_enabled = enable;
+		if (!enable)
+		{
+			clear();
+		}
+	}
+
+	bool isEnabled()
+	{
+		return s_enabled;
+	}
+
+	void clear()
+	{
+		s_values.clear();
+		s_values.shrink_to_fit();
+		s_frameInfo.clear();
+		s_frameInfo.shrink_to_fit();
+		s_frameCount = 0;
+		s_writeRow = 0;
+		s_inFrame = false;
+	}
+
+	s32 addColumn(const char* name)
+	{
+		const s32 count = (s32)s_columns.size();
+		for (s32 i = 0; i < count; i++)
+		{
+			if (s_columns[i] == name) { return i; }
+		}
+		if (count >= TELEMETRY_MAX_COLUMNS)
+		{
+			return TELEMETRY_INVALID_COLUMN;
+		}
+		s_columns.push_back(name);
+		return count;
+	}
+
+	void addSource(const char* name, TelemetrySource source, void* userData)
+	{
+		const s32 column = addColumn(name);
+		if (column == TELEMETRY_INVALID_COLUMN) { return; }
+		s_sources.push_back({ column, source, userData });
+	}
+
+	void beginFrame()
+	{
+		s_frame++;
+		if (!s_enabled) { return; }
+
+		if (s_values.empty())
+		{
+			s_values.resize(TELEMETRY_FRAME_COUNT * TELEMETRY_MAX_COLUMNS);
+			s_frameInfo.resize(TELEMETRY_FRAME_COUNT);
+		}
+		memset(&s_values[s_writeRow * TELEMETRY_MAX_COLUMNS], 0, sizeof(f32) * TELEMETRY_MAX_COLUMNS);
+		s_frameInfo[s_writeRow] = { s_frame, TFE_System::getTime() };
+		s_inFrame = true;
+	}
+
+	void setValue(s32 column, f64 value)
+	{
+		if (!s_inFrame || column < 0 || column >= TELEMETRY_MAX_COLUMNS) { return; }
+		s_values[s_writeRow * TELEMETRY_MAX_COLUMNS + column] = f32(value);
+	}
+
+	void endFrame()
+	{
+		if (!s_inFrame) { return; }
+
+		const size_t sourceCount = s_sources.size();
+		for (size_t i = 0; i < sourceCount; i++)
+		{
+			setValue(s_sources[i].column, s_sources[i].func(s_sources[i].userData));
+		}
+
+		s_inFrame = false;
+		s_writeRow = (s_writeRow + 1) % TELEMETRY_FRAME_COUNT;
+		s_frameCount = std::min(s_frameCount + 1, (u32)TELEMETRY_FRAME_COUNT);
+	}
+
+	u32 getFrameCount()
+	{
+		return s_frameCount;
+	}
+
+	// Quote a column name, CSV doubles the quotes and JSON escapes them.
+	static void appendQuoted(std::string& out, const std::string& str, TelemetryFormat format)
+	{
+		out += '"';
+		for (size_t i = 0; i < str.length(); i++)
+		{
+			if (str[i] == '"') { out += format == TELEMETRY_CSV ? '"' : '\\'; }
+			else if (str[i] == '\\' && format == TELEMETRY_JSON) { out += '\\'; }
+			out += str[i];
+		}
+		out += '"';
+	}
+
+	bool write(const char* path, TelemetryFormat format)
+	{
+		if (!s_frameCount) { return false; }
+
+		const u32 columnCount = (u32)s_columns.size();
+		const u32 firstRow = (s_writeRow + TELEMETRY_FRAME_COUNT - s_frameCount) % TELEMETRY_FRAME_COUNT;
+		std::string out;
+		char value[64];
+
+		if (format == TELEMETRY_CSV)
+		{
+			out += "frame,time";
+			for (u32 c = 0; c < columnCount; c++)
+			{
+				out += ',';
+				appendQuoted(out, s_columns[c], format);
+			}
+			out += '\n';
+
+			for (u32 i = 0; i < s_frameCount; i++)
+			{
+				const u32 row = (firstRow + i) % TELEMETRY_FRAME_COUNT;
+				sprintf(value, "%llu,%0.4f", (unsigned long long)s_frameInfo[row].frame, s_frameInfo[row].time);
+				out += value;
+				const f32* values = &s_values[row * TELEMETRY_MAX_COLUMNS];
+				for (u32 c = 0; c < columnCount; c++)
+				{
+					sprintf(value, ",%g", values[c]);
+					out += value;
+				}
+				out += '\n';
+			}
+		}
+		else
+		{
+			out += "{\n\t\"columns\": [\"frame\", \"time\"";
+			for (u32 c = 0; c < columnCount; c++)
+			{
+				out += ", ";
+				appendQuoted(out, s_columns[c], format);
+			}
+			out += "],\n\t\"frames\": [\n";
+
+			for (u32 i = 0; i < s_frameCount; i++)
+			{
+				const u32 row = (firstRow + i) % TELEMETRY_FRAME_COUNT;
+				sprintf(value, "\t\t[%llu, %0.4f", (unsigned long long)s_frameInfo[row].frame, s_frameInfo[row].time);
+				out += value;
+				const f32* values = &s_values[row * TELEMETRY_MAX_COLUMNS];
+				for (u32 c = 0; c < columnCount; c++)
+				{
+					sprintf(value, ", %g", values[c]);
+					out += value;
+				}
+				out += i + 1 < s_frameCount ? "],\n" : "]\n";
+			}
+			out += "\t]\n}\n";
+		}
+
+		FileStream file;
+		if (!file.open(path, Stream::MODE_WRITE))
+		{
+			TFE_System::logWrite(LOG_ERROR, "Telemetry", "Cannot write telemetry to '%s'.", path);
+			return false;
+		}
+		file.writeBuffer(out.data(), (u32)out.length());
+		file.close();
+		return true;
+	}
+}
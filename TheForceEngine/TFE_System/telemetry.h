@@ -0,0 +1,53 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////
+// The Force Engine Telemetry
+// A fixed size ring holding one row of values per profiled frame: the
+// frame time, the time spent in each profiler zone, the profiler
+// counters and any registered sources (such as memory usage). The
+// profiler fills in a row at the end of each frame.
+//
+// The ring can be written out as CSV or JSON, so a slow frame can be
+// looked at after the fact.
+//
+// Recording is off by default, use the "telemetry on" console command.
+// isEnabled() can be called from any thread, everything else is main
+// thread only.
+//////////////////////////////////////////////////////////////////////
+#include "types.h"
+
+namespace TFE_Telemetry
+{
+	enum TelemetryConstants
+	{
+		TELEMETRY_FRAME_COUNT = 2048,
+		TELEMETRY_MAX_COLUMNS = 128,
+		TELEMETRY_INVALID_COLUMN = -1,
+	};
+
+	enum TelemetryFormat
+	{
+		TELEMETRY_CSV = 0,
+		TELEMETRY_JSON,
+	};
+
+	// Returns the value of a source for the current frame.
+	typedef f64(*TelemetrySource)(void* userData);
+
+	void setEnabled(bool enable);
+	bool isEnabled();
+	// Free the recorded frames, columns are kept.
+	void clear();
+
+	// Returns the column with the given name, adding it if needed, or TELEMETRY_INVALID_COLUMN if there is no room.
+	s32  addColumn(const char* name);
+	// Add a column sampled at the end of each frame.
+	void addSource(const char* name, TelemetrySource source, void* userData = nullptr);
+
+	// Called by the profiler, values that are not set in a frame are 0.
+	void beginFrame();
+	void setValue(s32 column, f64 value);
+	void endFrame();
+
+	u32  getFrameCount();
+	bool write(const char* path, TelemetryFormat format);
+}
@@ -1,6 +1,8 @@
 #include <TFE_Ui/ui.h>
 #include <TFE_FileSystem/paths.h>
 #include <TFE_FileSystem/fileutil.h>
+#include <TFE_RenderBackend/renderBackend.h>
+#include <TFE_System/system.h>
 
 #include "imGUI/imgui.h"
 #include "imGUI/imgui_impl_sdl.h"
@@ -31,9 +33,13 @@ bool init(void* window, void* context, s32 uiScale)
 	ImGui::StyleColorsDark();
 
 	// Setup Platform/Renderer bindings
+	// There are no bindings in headless mode (no window), the UI is still updated but never drawn.
 	s_window = (SDL_Window*)window;
-	ImGui_ImplSDL2_InitForOpenGL(s_window, context);
-	ImGui_ImplOpenGL3_Init(glsl_version);
+	if (s_window)
+	{
+		ImGui_ImplSDL2_InitForOpenGL(s_window, context);
+		ImGui_ImplOpenGL3_Init(glsl_version);
+	}
 
 	// Set the default font (13 px)
 	// TODO: Allow scaled UI, so loading a different font for larger scales.
@@ -65,8 +71,11 @@ void shutdown()
 {
 	TFE_Markdown::shutdown();
 
-	ImGui_ImplOpenGL3_Shutdown();
-	ImGui_ImplSDL2_Shutdown();
+	if (s_window)
+	{
+		ImGui_ImplOpenGL3_Shutdown();
+		ImGui_ImplSDL2_Shutdown();
+	}
 	ImGui::DestroyContext();
 }
 
@@ -82,25 +91,52 @@ s32 getUiScale()
 
 void setUiInput(const void* inputEvent)
 {
+	if (!s_window) { return; }
 	const SDL_Event* sdlEvent = (SDL_Event*)inputEvent;
 	ImGui_ImplSDL2_ProcessEvent(sdlEvent);
 }
 
+void beginHeadless()
+{
+	ImGuiIO& io = ImGui::GetIO();
+	if (!io.Fonts->IsBuilt())
+	{
+		io.Fonts->Build();
+	}
+
+	DisplayInfo displayInfo;
+	TFE_RenderBackend::getDisplayInfo(&displayInfo);
+	io.DisplaySize = ImVec2(f32(displayInfo.width), f32(displayInfo.height));
+	const f32 dt = f32(TFE_System::getDeltaTime());
+	io.DeltaTime = dt > 0.0f ? dt : 1.0f / 60.0f;
+}
+
 void begin()
 {
-	ImGui_ImplOpenGL3_NewFrame();
-	ImGui_ImplSDL2_NewFrame(s_window);
+	if (s_window)
+	{
+		ImGui_ImplOpenGL3_NewFrame();
+		ImGui_ImplSDL2_NewFrame(s_window);
+	}
+	else
+	{
+		beginHeadless();
+	}
 	ImGui::NewFrame();
 }
 
 void render()
 {
 	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	if (s_window)
+	{
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	}
 }
 
 void invalidateFontAtlas()
 {
+	if (!s_window) { return; }
 	ImGui_ImplOpenGL3_DestroyFontsTexture();
 }
 
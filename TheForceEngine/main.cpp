@@ -14,6 +14,7 @@
 #include <TFE_FileSystem/paths.h>
 #include <TFE_Polygon/polygon.h>
 #include <TFE_RenderBackend/renderBackend.h>
+#include <TFE_RenderBackend/Headless/headlessDisplay.h>
 #include <TFE_Input/inputMapping.h>
 #include <TFE_Settings/settings.h>
 #include <TFE_System/system.h>
@@ -79,6 +80,12 @@ static char s_screenshotTime[TFE_MAX_PATH];
 static s32  s_startupGame = -1;
 static IGame* s_curGame = nullptr;
 static const char* s_loadRequestFilename = nullptr;
+// Headless mode, see parseOption().
+static bool s_headless = false;
+static u32  s_headlessFrameLimit = 0;
+static HeadlessOutput s_frameOutput = HOUT_NONE;
+static const char* s_frameOutputPath = nullptr;
+static u32  s_frameOutputInterval = 1;
 
 void parseOption(const char* name, const std::vector<const char*>& values, bool longName);
 bool validatePath();
@@ -244,8 +251,31 @@ void handleEvent(SDL_Event& Event)
 	}
 }
 
+// Poll the system events and update the input state.
+// If 'latch' is true, this is the second poll in the same frame and the mouse movement is added to the movement read earlier.
+void pollInput(bool latch)
+{
+	SDL_Event event;
+	while (SDL_PollEvent(&event)) { handleEvent(event); }
+
+	// Handle mouse state.
+	s32 mouseX, mouseY;
+	s32 mouseAbsX, mouseAbsY;
+	SDL_GetRelativeMouseState(&mouseX, &mouseY);
+	SDL_GetMouseState(&mouseAbsX, &mouseAbsY);
+	if (latch) { TFE_Input::addRelativeMousePos(mouseX, mouseY); }
+	else { TFE_Input::setRelativeMousePos(mouseX, mouseY); }
+	TFE_Input::setMousePos(mouseAbsX, mouseAbsY);
+	inputMapping_updateInput();
+}
+
 bool sdlInit()
 {
+	// Use the dummy video driver so no display server is required.
+	if (s_headless)
+	{
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+	}
 	const int code = SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_GAMECONTROLLER | SDL_INIT_AUDIO);
 	if (code != 0) { return false; }
 
@@ -617,6 +647,12 @@ int main(int argc, char* argv[])
 	u32 windowFlags = 0;
 	if (windowSettings->fullscreen) { TFE_System::logWrite(LOG_MSG, "Display", "Fullscreen enabled."); windowFlags |= WINFLAG_FULLSCREEN; }
 	if (graphics->vsync) { TFE_System::logWrite(LOG_MSG, "Display", "Vertical Sync enabled."); windowFlags |= WINFLAG_VSYNC; }
+	if (s_headless)
+	{
+		TFE_System::logWrite(LOG_MSG, "Display", "Headless mode enabled.");
+		windowFlags |= WINFLAG_HEADLESS;
+		windowFlags &= ~(WINFLAG_FULLSCREEN | WINFLAG_VSYNC);
+	}
 	
 	WindowState windowState =
 	{
@@ -637,6 +673,10 @@ int main(int argc, char* argv[])
 		TFE_System::logClose();
 		return PROGRAM_ERROR;
 	}
+	if (s_headless && s_frameOutput != HOUT_NONE)
+	{
+		TFE_HeadlessDisplay::setOutput(s_frameOutput, s_frameOutputPath, s_frameOutputInterval);
+	}
 	TFE_FrontEndUI::initConsole();
 	TFE_Audio::init(s_nullAudioDevice, TFE_Settings::getSoundSettings()->audioDevice);
 	TFE_MidiPlayer::init(TFE_Settings::getSoundSettings()->midiOutput, (MidiDeviceType)TFE_Settings::getSoundSettings()->midiType);
@@ -701,17 +741,7 @@ int main(int argc, char* argv[])
 		}
 
 		// System events
-		SDL_Event event;
-		while (SDL_PollEvent(&event)) { handleEvent(event); }
-
-		// Handle mouse state.
-		s32 mouseX, mouseY;
-		s32 mouseAbsX, mouseAbsY;
-		u32 state = SDL_GetRelativeMouseState(&mouseX, &mouseY);
-		SDL_GetMouseState(&mouseAbsX, &mouseAbsY);
-		TFE_Input::setRelativeMousePos(mouseX, mouseY);
-		TFE_Input::setMousePos(mouseAbsX, mouseAbsY);
-		inputMapping_updateInput();
+		pollInput(false);
 
 		// Can we save?
 		TFE_FrontEndUI::setCanSave(s_curGame ? s_curGame->canSave() : false);
@@ -854,6 +884,11 @@ int main(int argc, char* argv[])
 			}
 			else
 			{
+				// Sample input again as late as possible, anything that arrived since the start of the frame is added.
+				if (graphics->lateLatchInput && !isConsoleOpen)
+				{
+					pollInput(true);
+				}
 				TFE_SaveSystem::update();
 				s_curGame->loopGame();
 				endInputFrame = TFE_Jedi::task_run() != 0;
@@ -903,6 +938,12 @@ int main(int argc, char* argv[])
 		{
 			TFE_FRAME_END();
 		}
+
+		if (s_headlessFrameLimit && frame >= s_headlessFrameLimit)
+		{
+			TFE_System::logWrite(LOG_MSG, "Progam Flow", "Headless frame limit (%u) reached.", s_headlessFrameLimit);
+			s_loop = false;
+		}
 	}
 
 	if (s_curGame)
@@ -975,5 +1016,31 @@ void parseOption(const char* name, const std::vector<const char*>& values, bool
 			// --noaudio
 			s_nullAudioDevice = true;
 		}
+		else if (strcasecmp(name, "headless") == 0)
+		{
+			// --headless [frameCount]
+			// Run without a window or GPU, optionally quitting after frameCount frames.
+			s_headless = true;
+			if (values.size() >= 1)
+			{
+				s_headlessFrameLimit = (u32)strtoul(values[0], nullptr, 10);
+			}
+		}
+		else if (strcasecmp(name, "frameOutput") == 0 && values.size() >= 2)
+		{
+			// --frameOutput png|raw path [interval]
+			// Headless only: write the presented frames as PNG images into a directory or appended to a single raw RGBA file.
+			if (!strcasecmp(values[0], "png"))      { s_frameOutput = HOUT_PNG; }
+			else if (!strcasecmp(values[0], "raw")) { s_frameOutput = HOUT_RAW; }
+			else
+			{
+				TFE_System::logWrite(LOG_WARNING, "CommandLine", "Unknown frame output format '%s', expected 'png' or 'raw'.", values[0]);
+			}
+			s_frameOutputPath = values[1];
+			if (values.size() >= 3)
+			{
+				s_frameOutputInterval = (u32)strtoul(values[2], nullptr, 10);
+			}
+		}
 	}
 }
\ No newline at end of file